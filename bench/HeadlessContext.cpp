@@ -0,0 +1,127 @@
+#include "HeadlessContext.h"
+#include <EGL/eglext.h>
+#include <sstream>
+
+#include "../src/rhi/RHI.h"
+
+/**
+ * Finds whether a space separated list of EGL extensions contains the given extension.
+ *
+ * @param extensions the extension list, or nullptr if it could not be queried
+ * @param name the name of the extension
+ * @returns whether the extension is in the list
+ */
+static bool hasExtension(const char* extensions, std::string_view name) {
+    if (extensions == nullptr) {
+        return false;
+    }
+
+    std::string_view list(extensions);
+    for (size_t start = 0; start < list.size();) {
+        size_t end = list.find(' ', start);
+        if (end == std::string_view::npos) {
+            end = list.size();
+        }
+        if (list.substr(start, end - start) == name) {
+            return true;
+        }
+        start = end + 1;
+    }
+    return false;
+}
+
+/**
+ * @param message what failed
+ * @returns an error describing what failed and the last EGL error
+ */
+static std::runtime_error eglError(const std::string& message) {
+    std::ostringstream stream;
+    stream << message << " (EGL error 0x" << std::hex << eglGetError() << ")";
+    return std::runtime_error(stream.str());
+}
+
+HeadlessContext::HeadlessContext(int major, int minor)
+    : m_display(EGL_NO_DISPLAY), m_context(EGL_NO_CONTEXT), m_surface(EGL_NO_SURFACE) {
+    // prefer the surfaceless platform, which needs neither a display server nor a gpu device
+    const char* clientExtensions = eglQueryString(EGL_NO_DISPLAY, EGL_EXTENSIONS);
+    auto getPlatformDisplay = (PFNEGLGETPLATFORMDISPLAYEXTPROC)eglGetProcAddress("eglGetPlatformDisplayEXT");
+    if (getPlatformDisplay != nullptr && hasExtension(clientExtensions, "EGL_MESA_platform_surfaceless")) {
+        m_display = getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr);
+    }
+    if (m_display == EGL_NO_DISPLAY) {
+        m_display = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+    }
+    if (m_display == EGL_NO_DISPLAY || eglInitialize(m_display, nullptr, nullptr) != EGL_TRUE) {
+        throw eglError("Failed to find an EGL display.");
+    }
+
+    try {
+        if (eglBindAPI(EGL_OPENGL_API) != EGL_TRUE) {
+            throw eglError("EGL does not support OpenGL.");
+        }
+
+        // without surfaceless contexts, any config that can create the pbuffer will do
+        bool surfaceless = hasExtension(eglQueryString(m_display, EGL_EXTENSIONS), "EGL_KHR_surfaceless_context");
+        const EGLint configAttributes[] = {
+            EGL_SURFACE_TYPE, surfaceless ? 0 : EGL_PBUFFER_BIT,
+            EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+            EGL_RED_SIZE, 8,
+            EGL_GREEN_SIZE, 8,
+            EGL_BLUE_SIZE, 8,
+            EGL_ALPHA_SIZE, 8,
+            EGL_NONE,
+        };
+        EGLConfig config;
+        EGLint numConfigs = 0;
+        if (eglChooseConfig(m_display, configAttributes, &config, 1, &numConfigs) != EGL_TRUE || numConfigs == 0) {
+            throw eglError("Failed to find an EGL config for OpenGL.");
+        }
+
+        const EGLint contextAttributes[] = {
+            EGL_CONTEXT_MAJOR_VERSION, major,
+            EGL_CONTEXT_MINOR_VERSION, minor,
+            EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT,
+            EGL_NONE,
+        };
+        m_context = eglCreateContext(m_display, config, EGL_NO_CONTEXT, contextAttributes);
+        if (m_context == EGL_NO_CONTEXT) {
+            throw eglError("Failed to create an OpenGL context.");
+        }
+
+        if (!surfaceless) {
+            const EGLint surfaceAttributes[] = {
+                EGL_WIDTH, 1,
+                EGL_HEIGHT, 1,
+                EGL_NONE,
+            };
+            m_surface = eglCreatePbufferSurface(m_display, config, surfaceAttributes);
+            if (m_surface == EGL_NO_SURFACE) {
+                throw eglError("Failed to create a pbuffer surface.");
+            }
+        }
+
+        if (eglMakeCurrent(m_display, m_surface, m_surface, m_context) != EGL_TRUE) {
+            throw eglError("Failed to make the OpenGL context current.");
+        }
+
+        // create the render api
+        RHI::create();
+    } catch (...) {
+        // terminating the display destroys the context and surface, if they were created, once released
+        eglMakeCurrent(m_display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+        eglTerminate(m_display);
+        throw;
+    }
+}
+
+HeadlessContext::~HeadlessContext() {
+    // the render api deletes its objects, so must be destroyed while the context is current
+    RHI::destroy();
+
+    eglMakeCurrent(m_display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+    if (m_surface != EGL_NO_SURFACE) {
+        eglDestroySurface(m_display, m_surface);
+    }
+    eglDestroyContext(m_display, m_context);
+    eglTerminate(m_display);
+}
@@ -0,0 +1,39 @@
+#ifndef OPENGL_RENDERER_HEADLESSCONTEXT_H
+#define OPENGL_RENDERER_HEADLESSCONTEXT_H
+
+#define EGL_NO_X11
+#include <EGL/egl.h>
+
+/**
+ * An OpenGL context without a window, created with EGL, for rendering only into framebuffers on
+ * machines without a display. Mesa's surfaceless platform is used where available, so no display
+ * server or gpu device is needed, and software drivers such as llvmpipe work.
+ *
+ * The context is made current without a surface where the driver supports it, and otherwise with a
+ * minimal pbuffer surface that is never rendered to. The render api is created once the context is current.
+ */
+class HeadlessContext {
+public:
+    /**
+     * Creates a core profile context of the given version, makes it current on the calling thread and
+     * creates the OpenGL render api.
+     *
+     * @param major the major OpenGL version
+     * @param minor the minor OpenGL version
+     */
+    explicit HeadlessContext(int major = 4, int minor = 6);
+    HeadlessContext(const HeadlessContext&) = delete;
+
+    /**
+     * Destroys the render api, then the context.
+     */
+    ~HeadlessContext();
+
+private:
+    EGLDisplay m_display;
+    EGLContext m_context;
+    EGLSurface m_surface; // EGL_NO_SURFACE when the context is surfaceless
+};
+
+
+#endif //OPENGL_RENDERER_HEADLESSCONTEXT_H
@@ -0,0 +1,661 @@
+#include <fstream>
+
+#include "HeadlessContext.h"
+#include "../src/rhi/RHI.h"
+#include "../src/rhi/PipelineCache.h"
+#include "../src/rhi/null/NullRHI.h"
+#include "../src/engine/Renderer3D.h"
+#include "../src/engine/StaticMeshLoader.h"
+#include "../src/engine/Grid.h"
+#include "../src/engine/Light.h"
+#include "../src/util/angle.h"
+
+/**
+ * Renders a scripted scene for a fixed number of frames without a window, then reports the cpu and
+ * gpu time of each frame along with what was drawn as json, so that performance can be compared between
+ * builds on machines without a display.
+ *
+ * The scene is a square field of monkeys over a grid, lit by a ring of lights, which the camera orbits
+ * once over the measured frames. Everything in the scene depends only on the frame index, so every run
+ * renders the same frames.
+ *
+ * With --overdraw-scene, the field is replaced by a dense block of monkeys viewed from a fixed corner and
+ * submitted back to front, so that most pixels are drawn many times over, for comparing pass modes.
+ *
+ * With --cluster-only, nothing is rendered. The lights of each frame are only binned into clusters, both
+ * with SSE2 and one lane at a time, and the report compares the times taken by each.
+ */
+
+static const char* usage =
+    "usage: render_bench [options]\n"
+    "  --backend=opengl|null|software\n"
+    "                              render with a headless OpenGL context, only measure cpu costs, or\n"
+    "                              rasterize on the cpu\n"
+    "  --frames=N                  the number of measured frames (default 300)\n"
+    "  --warmup=N                  the number of unmeasured frames rendered first (default 30)\n"
+    "  --width=N --height=N        the size of the framebuffer (default 1280x720)\n"
+    "  --samples=N                 the number of samples per pixel, resolved each frame (default 1)\n"
+    "  --meshes=N                  the number of monkeys in the scene (default 400)\n"
+    "  --lights=N                  the number of lights in the scene (default 64)\n"
+    "  --pass-mode=submission|front-to-back|depth-prepass\n"
+    "  --occlusion-culling         cull monkeys hidden behind others\n"
+    "  --overdraw-scene            draw a dense 9x5x9 block of monkeys back to front from a fixed camera, in\n"
+    "                              place of the field, to compare pass modes\n"
+    "  --cluster-only              only bin the lights into clusters each frame, with SSE2 and without, and\n"
+    "                              report both times\n"
+    "  --pipeline-cache=DIR        persist linked programs to a directory, to load on the next run\n"
+    "  --output=FILE               write the report to a file rather than stdout\n";
+
+struct BenchOptions {
+    RHI::Backend backend = RHI::Backend::OpenGL;
+    uint32_t frames = 300;
+    uint32_t warmup = 30;
+    uint32_t width = 1280;
+    uint32_t height = 720;
+    uint32_t samples = 1;
+    uint32_t meshes = 400;
+    uint32_t lights = 64;
+    Renderer3D::PassMode pass_mode = Renderer3D::PassMode::FrontToBack;
+    bool occlusion_culling = false;
+    bool overdraw_scene = false;
+    bool cluster_only = false;
+    std::string pipeline_cache;
+    std::string output;
+};
+
+/**
+ * The measurements of a single frame.
+ */
+struct FrameRecord {
+    double cpu; // the time taken to record and submit the frame, in milliseconds
+    double frame; // the time between the start of the frame and the next, in milliseconds
+    double gpu; // the time the gpu took to render the frame, in milliseconds, or negative if unknown
+    Renderer3D::Statistics renderer;
+    NullRHI::Statistics calls; // counted only by the null backend
+};
+
+/**
+ * The times taken to bin the lights of a single frame into clusters.
+ */
+struct ClusterRecord {
+    double vectorized; // with SSE2, in milliseconds, or negative if it is not available
+    double scalar; // one lane at a time, in milliseconds
+    uint32_t lightIndices; // the number of light indices over all clusters
+};
+
+// the distance between neighbouring monkeys
+static constexpr float monkey_spacing = 2.5f;
+
+// the number of monkeys along each axis of the overdraw scene's block, and the distance between them, which is
+// less than their size so that they overlap
+static constexpr std::array<int32_t, 3> overdraw_counts = {9, 5, 9};
+static constexpr float overdraw_spacing = 0.6f;
+
+/**
+ * Parses an unsigned integer option of the form "--name=value".
+ *
+ * @param arg the argument to parse
+ * @param prefix the name of the option followed by '='
+ * @param value set to the value of the option if the argument is the option
+ * @param minimum the smallest valid value
+ * @returns whether the argument is the option
+ * @throws std::invalid_argument if the value is not an integer of at least the minimum
+ */
+static bool parse_count(const std::string& arg, std::string_view prefix, uint32_t& value, uint32_t minimum = 1) {
+    if (!arg.starts_with(prefix)) {
+        return false;
+    }
+
+    std::string text = arg.substr(prefix.size());
+    if (text.empty() || text.find_first_not_of("0123456789") != std::string::npos || text.size() > 9
+        || std::stoul(text) < minimum) {
+        throw std::invalid_argument("Invalid value for option: " + arg);
+    }
+    value = (uint32_t)std::stoul(text);
+    return true;
+}
+
+/**
+ * @param argc the number of arguments
+ * @param argv the arguments, starting with the program name
+ * @returns the options given by the arguments
+ * @throws std::invalid_argument if an argument is not a valid option
+ */
+static BenchOptions parse_options(int argc, char* argv[]) {
+    BenchOptions options;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (parse_count(arg, "--frames=", options.frames) || parse_count(arg, "--width=", options.width)
+            || parse_count(arg, "--height=", options.height) || parse_count(arg, "--samples=", options.samples)
+            || parse_count(arg, "--meshes=", options.meshes) || parse_count(arg, "--lights=", options.lights, 0)
+            || parse_count(arg, "--warmup=", options.warmup, 0)) {
+            continue;
+        } else if (arg == "--backend=opengl") {
+            options.backend = RHI::Backend::OpenGL;
+        } else if (arg == "--backend=null") {
+            options.backend = RHI::Backend::Null;
+        } else if (arg == "--backend=software") {
+            options.backend = RHI::Backend::Software;
+        } else if (arg == "--pass-mode=submission") {
+            options.pass_mode = Renderer3D::PassMode::Submission;
+        } else if (arg == "--pass-mode=front-to-back") {
+            options.pass_mode = Renderer3D::PassMode::FrontToBack;
+        } else if (arg == "--pass-mode=depth-prepass") {
+            options.pass_mode = Renderer3D::PassMode::DepthPrepass;
+        } else if (arg == "--occlusion-culling") {
+            options.occlusion_culling = true;
+        } else if (arg == "--overdraw-scene") {
+            options.overdraw_scene = true;
+        } else if (arg == "--cluster-only") {
+            options.cluster_only = true;
+        } else if (arg.starts_with("--pipeline-cache=") && arg.size() > 17) {
+            options.pipeline_cache = arg.substr(17);
+        } else if (arg.starts_with("--output=") && arg.size() > 9) {
+            options.output = arg.substr(9);
+        } else {
+            throw std::invalid_argument("Unknown option: " + arg);
+        }
+    }
+    return options;
+}
+
+/**
+ * @param options the options of the benchmark
+ * @returns half the width of the square field of monkeys, or of the overdraw scene's block
+ */
+static float field_half_size(const BenchOptions& options) {
+    if (options.overdraw_scene) {
+        return overdraw_spacing * (float)(overdraw_counts[0] + 1) * 0.5f;
+    }
+
+    auto side = (uint32_t)std::ceil(std::sqrt((double)options.meshes));
+    return monkey_spacing * (float)side * 0.5f;
+}
+
+/**
+ * @param options the options of the benchmark
+ * @param half_size half the width of the field of monkeys
+ * @returns the camera the scene is viewed from
+ */
+static std::shared_ptr<Camera3D> create_camera(const BenchOptions& options, float half_size) {
+    return Camera3D::createPerspective(45.0f, (float)options.width / (float)options.height, 0.1f,
+                                       4.0f * half_size + 100.0f);
+}
+
+/**
+ * Moves the camera along its orbit, which it completes once over the measured frames.
+ *
+ * @param camera the camera to move
+ * @param t the fraction of the orbit completed
+ * @param half_size half the width of the field of monkeys
+ */
+static void orbit_camera(Camera3D& camera, float t, float half_size) {
+    float camera_angle = degreesToRadians(360.0f * t);
+    float camera_distance = 1.5f * half_size + 5.0f;
+    camera.moveTo(Vec3(camera_distance * std::cos(camera_angle), 0.5f * camera_distance,
+                       camera_distance * std::sin(camera_angle)));
+    camera.lookAt({0.0f, 0.0f, 0.0f}, true);
+}
+
+/**
+ * @returns the transforms of the overdraw scene's monkeys, ordered back to front as seen from the corner the
+ *          scene is viewed from
+ */
+static std::vector<Mat4> overdraw_transforms() {
+    std::vector<Mat4> transforms;
+    for (int32_t z = 0; z < overdraw_counts[2]; z++) {
+        for (int32_t y = 0; y < overdraw_counts[1]; y++) {
+            for (int32_t x = 0; x < overdraw_counts[0]; x++) {
+                Mat4 transform(1.0f);
+                transform[3] = Vec4(overdraw_spacing * (float)(x - overdraw_counts[0] / 2),
+                                    overdraw_spacing * (float)(y - overdraw_counts[1] / 2),
+                                    overdraw_spacing * (float)(z - overdraw_counts[2] / 2), 1.0f);
+                transforms.push_back(transform);
+            }
+        }
+    }
+    return transforms;
+}
+
+/**
+ * @param index the index of the light in the ring
+ * @param count the number of lights in the ring
+ * @param t the fraction of the camera's orbit completed, as the lights orbit the other way
+ * @param half_size half the width of the field of monkeys
+ * @returns the light
+ */
+static PointLight ring_light(uint32_t index, uint32_t count, float t, float half_size) {
+    const std::array<Vec3, 4> light_colors = {
+        Vec3(1.0f, 0.2f, 0.2f), Vec3(0.2f, 1.0f, 0.2f), Vec3(0.2f, 0.2f, 1.0f), Vec3(1.0f, 0.8f, 0.2f),
+    };
+
+    float angle = degreesToRadians(360.0f * ((float)index / (float)count - t));
+    float distance = half_size * (0.3f + 0.6f * (float)(index % 3) / 2.0f);
+    return PointLight{
+        .position = Vec3(distance * std::cos(angle), 1.0f, distance * std::sin(angle)),
+        .radius = 6.0f,
+        .color = light_colors[index % light_colors.size()],
+        .intensity = 1.5f,
+    };
+}
+
+/**
+ * Renders the scripted scene with the current render api.
+ *
+ * @param options the options of the benchmark
+ * @returns the measurements of each measured frame
+ */
+static std::vector<FrameRecord> run_bench(const BenchOptions& options) {
+    RHI& rhi = RHI::current();
+    auto* null_rhi = dynamic_cast<NullRHI*>(&rhi);
+    rhi.pipelineCache().setDirectory(options.pipeline_cache);
+
+    std::shared_ptr<Framebuffer> framebuffer = rhi.createFramebufferBuilder()
+        ->setDimensions(options.width, options.height)
+        ->setColorAttachment(rhi.createTexture2D(Format::RGBA8, options.width, options.height, options.samples))
+        ->setDepthAttachment(rhi.createTexture2D(Format::D32F, options.width, options.height, options.samples))
+        ->build();
+    std::unique_ptr<Texture2D> resolved;
+    if (options.samples > 1) {
+        resolved = rhi.createTexture2D(Format::RGBA8, options.width, options.height);
+    }
+
+    // a square field of monkeys sharing one mesh, centered over the grid, or the overdraw scene's block
+    auto side = (uint32_t)std::ceil(std::sqrt((double)options.meshes));
+    float half_size = field_half_size(options);
+
+    StaticMeshLoader loader(Material::createDefault());
+    loader.setLodGeneration(4, 0.5f);
+    loader.setOccluderGeneration(true);
+    StaticMesh monkey_mesh = loader.load("../assets/flat-monkey.obj");
+    StaticMesh grid_mesh = Grid::make(half_size + monkey_spacing, 1.0f);
+
+    std::vector<Mat4> monkey_transforms;
+    if (options.overdraw_scene) {
+        monkey_transforms = overdraw_transforms();
+    } else {
+        for (uint32_t i = 0; i < options.meshes; i++) {
+            Mat4 transform(1.0f);
+            transform[3] = Vec4(monkey_spacing * ((float)(i % side) + 0.5f) - half_size, 0.0f,
+                                monkey_spacing * ((float)(i / side) + 0.5f) - half_size, 1.0f);
+            monkey_transforms.push_back(transform);
+        }
+    }
+    // every monkey keeps its own level of detail between frames, as they share a mesh at different distances
+    std::vector<LodSelection> monkey_lods(monkey_transforms.size());
+
+    // the overdraw scene is viewed from a fixed corner, so that its monkeys stay in back to front order
+    std::shared_ptr<Camera3D> camera = create_camera(options, half_size);
+    if (options.overdraw_scene) {
+        camera->moveTo(Vec3(3.5f, 4.95f, 3.5f));
+        camera->lookAt({0.0f, 0.0f, 0.0f}, true);
+    }
+    Renderer3D renderer(camera);
+    renderer.setPassMode(options.pass_mode);
+    renderer.setOcclusionCulling(options.occlusion_culling);
+
+    // the pipelines requested while loading were built at once, and are finished before the first frame
+    rhi.pipelineCache().wait();
+
+    // gpu times arrive some frames late, and are matched to their frame by index
+    uint32_t total_frames = options.warmup + options.frames;
+    std::vector<FrameRecord> records(options.frames, FrameRecord{.gpu = -1.0});
+    renderer.setGpuTimeListener([&](uint64_t frame, float gpu_time) {
+        if (frame >= options.warmup && frame < total_frames) {
+            records[frame - options.warmup].gpu = gpu_time;
+        }
+    });
+
+    Timestamp previous_start{};
+    for (uint32_t frame = 0; frame < total_frames; frame++) {
+        Timestamp frame_start = std::chrono::steady_clock::now();
+        if (frame > options.warmup) {
+            records[frame - options.warmup - 1].frame =
+                std::chrono::duration<double, std::milli>(frame_start - previous_start).count();
+        }
+        previous_start = frame_start;
+
+        // the camera orbits once over the measured frames, while the lights orbit the other way
+        float t = (float)frame / (float)options.frames;
+        if (!options.overdraw_scene) {
+            orbit_camera(*camera, t, half_size);
+        }
+
+        if (null_rhi != nullptr) {
+            null_rhi->resetStatistics();
+        }
+
+        rhi.frameContext().beginFrame();
+        renderer.begin(framebuffer);
+        for (uint32_t i = 0; i < options.lights; i++) {
+            renderer.submitLight(ring_light(i, options.lights, t, half_size));
+        }
+        renderer.submit(grid_mesh, Mat4(1.0f));
+        for (size_t i = 0; i < monkey_transforms.size(); i++) {
+            renderer.submit(monkey_mesh, monkey_transforms[i], &monkey_lods[i]);
+        }
+        renderer.end();
+
+        if (resolved != nullptr) {
+            GpuScope scope(rhi, "resolve");
+            rhi.resolveTexture2D(framebuffer->colorAttachment(), *resolved);
+        }
+        rhi.frameContext().endFrame();
+
+        if (frame >= options.warmup) {
+            FrameRecord& record = records[frame - options.warmup];
+            record.cpu = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - frame_start)
+                .count();
+            record.renderer = renderer.statistics();
+            if (null_rhi != nullptr) {
+                record.calls = null_rhi->statistics();
+            }
+        }
+    }
+
+    // wait for the last frames to finish, so that their times are known
+    rhi.createFence()->wait();
+    records.back().frame = std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now() - previous_start).count();
+    renderer.readTimerQueries();
+    renderer.setGpuTimeListener(nullptr);
+
+    return records;
+}
+
+/**
+ * Bins the lights of the scripted scene into clusters each frame, as the renderer would, once with SSE2
+ * and once one lane at a time, without rendering anything.
+ *
+ * @param options the options of the benchmark
+ * @returns the measurements of each measured frame
+ * @throws std::runtime_error if the two ways of binning give different clusters
+ */
+static std::vector<ClusterRecord> run_cluster_bench(const BenchOptions& options) {
+    float half_size = field_half_size(options);
+    std::shared_ptr<Camera3D> camera = create_camera(options, half_size);
+    LightClusterer clusterer(Renderer3D::clusterCountX, Renderer3D::clusterCountY, Renderer3D::clusterCountZ);
+    bool can_vectorize = clusterer.isVectorized();
+    ThreadPool& pool = ThreadPool::shared();
+
+    std::vector<PointLight> lights(options.lights);
+    std::vector<uint32_t> scalar_indices;
+    std::vector<ClusterRecord> records;
+    for (uint32_t frame = 0; frame < options.warmup + options.frames; frame++) {
+        float t = (float)frame / (float)options.frames;
+        orbit_camera(*camera, t, half_size);
+        for (uint32_t i = 0; i < options.lights; i++) {
+            lights[i] = ring_light(i, options.lights, t, half_size);
+        }
+
+        auto time_build = [&](bool vectorized) {
+            clusterer.setVectorized(vectorized);
+            Timestamp start = std::chrono::steady_clock::now();
+            clusterer.build(lights, camera->viewMatrix(), camera->projectionMatrix(), camera->nearPlane(),
+                            camera->farPlane(), pool);
+            return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        };
+
+        ClusterRecord record{.vectorized = -1.0};
+        record.scalar = time_build(false);
+        scalar_indices = clusterer.lightIndices();
+        if (can_vectorize) {
+            record.vectorized = time_build(true);
+            if (clusterer.lightIndices() != scalar_indices) {
+                throw std::runtime_error("Binning lights with SSE2 gave different clusters to binning them without.");
+            }
+        }
+        record.lightIndices = (uint32_t)scalar_indices.size();
+
+        if (frame >= options.warmup) {
+            records.push_back(record);
+        }
+    }
+    return records;
+}
+
+/**
+ * Writes the mean, percentiles and extremes of some times as a json object.
+ *
+ * @param out the stream to write to
+ * @param times the times, in milliseconds, where negative times are unknown and skipped
+ */
+static void write_summary(std::ostream& out, std::vector<double> times) {
+    std::erase_if(times, [](double time) { return time < 0.0; });
+    if (times.empty()) {
+        out << "null";
+        return;
+    }
+
+    std::sort(times.begin(), times.end());
+    double total = 0.0;
+    for (double time: times) {
+        total += time;
+    }
+    auto percentile = [&](double p) {
+        return times[std::min(times.size() - 1, (size_t)(p / 100.0 * (double)times.size()))];
+    };
+
+    out << "{\"count\": " << times.size()
+        << ", \"mean\": " << total / (double)times.size()
+        << ", \"median\": " << percentile(50.0)
+        << ", \"p95\": " << percentile(95.0)
+        << ", \"p99\": " << percentile(99.0)
+        << ", \"min\": " << times.front()
+        << ", \"max\": " << times.back() << "}";
+}
+
+/**
+ * Writes a string as a json string, escaping characters that cannot appear in one.
+ *
+ * @param out the stream to write to
+ * @param text the string
+ */
+static void write_string(std::ostream& out, std::string_view text) {
+    out << '"';
+    for (char c: text) {
+        if (c == '"' || c == '\\') {
+            out << '\\' << c;
+        } else if ((unsigned char)c < 0x20) {
+            out << ' ';
+        } else {
+            out << c;
+        }
+    }
+    out << '"';
+}
+
+/**
+ * Writes the report of a benchmark as json.
+ *
+ * @param out the stream to write to
+ * @param options the options of the benchmark
+ * @param device the name of the device rendered with
+ * @param records the measurements of each measured frame
+ */
+static void write_report(std::ostream& out, const BenchOptions& options, std::string_view device,
+                         const std::vector<FrameRecord>& records) {
+    const char* pass_modes[] = {"submission", "front-to-back", "depth-prepass"};
+    const char* backends[] = {"opengl", "null", "software"};
+    bool null_backend = options.backend == RHI::Backend::Null;
+
+    out << "{\n";
+    out << "  \"backend\": \"" << backends[(int)options.backend] << "\",\n";
+    out << "  \"device\": ";
+    write_string(out, device);
+    out << ",\n";
+    out << "  \"width\": " << options.width << ", \"height\": " << options.height
+        << ", \"samples\": " << options.samples << ",\n";
+    uint32_t meshes = options.overdraw_scene ? overdraw_counts[0] * overdraw_counts[1] * overdraw_counts[2]
+                                             : options.meshes;
+    out << "  \"scene\": \"" << (options.overdraw_scene ? "overdraw" : "field") << "\",\n";
+    out << "  \"meshes\": " << meshes << ", \"lights\": " << options.lights
+        << ", \"passMode\": \"" << pass_modes[(int)options.pass_mode] << "\""
+        << ", \"occlusionCulling\": " << (options.occlusion_culling ? "true" : "false") << ",\n";
+    out << "  \"warmup\": " << options.warmup << ",\n";
+
+    // pipelines loaded from the cache's directory were built without compiling
+    const PipelineCache& pipeline_cache = RHI::current().pipelineCache();
+    out << "  \"pipelines\": " << pipeline_cache.size() << ", \"pipelinesCompiled\": "
+        << pipeline_cache.numCompiled() << ",\n";
+
+    std::vector<double> cpu_times, frame_times, gpu_times;
+    for (const FrameRecord& record: records) {
+        cpu_times.push_back(record.cpu);
+        frame_times.push_back(record.frame);
+        gpu_times.push_back(record.gpu);
+    }
+    out << "  \"cpu\": ";
+    write_summary(out, cpu_times);
+    out << ",\n  \"frame\": ";
+    write_summary(out, frame_times);
+    out << ",\n  \"gpu\": ";
+    write_summary(out, gpu_times);
+    out << ",\n";
+
+    // the profiler keeps only the most recent samples of each scope
+    out << "  \"scopes\": [";
+    std::vector<Profiler::Scope> scopes = RHI::current().profiler().scopes();
+    for (size_t i = 0; i < scopes.size(); i++) {
+        const Profiler::Scope& scope = scopes[i];
+        out << (i == 0 ? "\n" : ",\n") << "    {\"name\": ";
+        write_string(out, scope.name);
+        out << ", \"count\": " << scope.count
+            << ", \"cpu\": " << std::chrono::duration<double, std::milli>(scope.cpu.mean).count()
+            << ", \"gpu\": " << std::chrono::duration<double, std::milli>(scope.gpu.mean).count() << "}";
+    }
+    out << "\n  ],\n";
+
+    out << "  \"frames\": [";
+    for (size_t i = 0; i < records.size(); i++) {
+        const FrameRecord& record = records[i];
+        out << (i == 0 ? "\n" : ",\n")
+            << "    {\"cpu\": " << record.cpu << ", \"frame\": " << record.frame << ", \"gpu\": ";
+        if (record.gpu < 0.0) {
+            out << "null";
+        } else {
+            out << record.gpu;
+        }
+        out << ", \"submitted\": " << record.renderer.submitted
+            << ", \"occluded\": " << record.renderer.occluded
+            << ", \"depthPrepassed\": " << record.renderer.depthPrepassed
+            << ", \"lights\": " << record.renderer.lights;
+        if (null_backend) {
+            out << ", \"binds\": " << record.calls.binds
+                << ", \"stateChanges\": " << record.calls.stateChanges
+                << ", \"draws\": " << record.calls.draws
+                << ", \"vertices\": " << record.calls.vertices
+                << ", \"bytesUploaded\": " << record.calls.bytesUploaded
+                << ", \"commandLists\": " << record.calls.commandLists;
+        }
+        out << "}";
+    }
+    out << "\n  ]\n}\n";
+}
+
+/**
+ * Writes the report of a clustering benchmark as json.
+ *
+ * @param out the stream to write to
+ * @param options the options of the benchmark
+ * @param records the measurements of each measured frame
+ */
+static void write_cluster_report(std::ostream& out, const BenchOptions& options,
+                                 const std::vector<ClusterRecord>& records) {
+    out << "{\n";
+    out << "  \"mode\": \"cluster-only\",\n";
+    out << "  \"lights\": " << options.lights << ", \"clusters\": [" << Renderer3D::clusterCountX << ", "
+        << Renderer3D::clusterCountY << ", " << Renderer3D::clusterCountZ << "]"
+        << ", \"threads\": " << ThreadPool::shared().size() << ",\n";
+    out << "  \"warmup\": " << options.warmup << ",\n";
+
+    std::vector<double> vectorized_times, scalar_times;
+    for (const ClusterRecord& record: records) {
+        vectorized_times.push_back(record.vectorized);
+        scalar_times.push_back(record.scalar);
+    }
+    out << "  \"sse2\": ";
+    write_summary(out, vectorized_times);
+    out << ",\n  \"scalar\": ";
+    write_summary(out, scalar_times);
+    out << ",\n";
+
+    out << "  \"frames\": [";
+    for (size_t i = 0; i < records.size(); i++) {
+        const ClusterRecord& record = records[i];
+        out << (i == 0 ? "\n" : ",\n") << "    {\"sse2\": ";
+        if (record.vectorized < 0.0) {
+            out << "null";
+        } else {
+            out << record.vectorized;
+        }
+        out << ", \"scalar\": " << record.scalar << ", \"lightIndices\": " << record.lightIndices << "}";
+    }
+    out << "\n  ]\n}\n";
+}
+
+int main(int argc, char* argv[])
+{
+    BenchOptions options;
+    try {
+        options = parse_options(argc, argv);
+    } catch (const std::invalid_argument& e) {
+        std::cerr << e.what() << "\n" << usage;
+        return 1;
+    }
+
+    // clustering runs entirely on the cpu, so needs no render api
+    if (options.cluster_only) {
+        std::vector<ClusterRecord> records;
+        try {
+            records = run_cluster_bench(options);
+        } catch (const std::runtime_error& e) {
+            std::cerr << "ERR: " << e.what() << std::endl;
+            return 1;
+        }
+        if (options.output.empty()) {
+            write_cluster_report(std::cout, options, records);
+        } else {
+            std::ofstream file(options.output);
+            write_cluster_report(file, options, records);
+            if (!file.good()) {
+                std::cerr << "ERR: failed to write report: " << options.output << std::endl;
+                return 1;
+            }
+        }
+        return 0;
+    }
+
+    // the context must outlive everything rendered with it
+    std::unique_ptr<HeadlessContext> context;
+    std::string device = options.backend == RHI::Backend::Software ? "software" : "null";
+    if (options.backend == RHI::Backend::OpenGL) {
+        try {
+            context = std::make_unique<HeadlessContext>();
+        } catch (const std::runtime_error& e) {
+            std::cerr << "ERR: " << e.what() << std::endl;
+            return 1;
+        }
+        device = (const char*)glGetString(GL_RENDERER);
+    } else {
+        RHI::create(options.backend);
+    }
+
+    std::vector<FrameRecord> records = run_bench(options);
+
+    if (options.output.empty()) {
+        write_report(std::cout, options, device, records);
+    } else {
+        std::ofstream file(options.output);
+        write_report(file, options, device, records);
+        if (!file.good()) {
+            std::cerr << "ERR: failed to write report: " << options.output << std::endl;
+            return 1;
+        }
+    }
+
+    if (context == nullptr) {
+        RHI::destroy();
+    }
+    return 0;
+}
@@ -0,0 +1,325 @@
+#include <fstream>
+
+#include "../src/rhi/RHI.h"
+#include "../src/rhi/PipelineCache.h"
+#include "../src/rhi/null/NullRHI.h"
+#include "../src/ui/Renderer.h"
+#include "../src/engine/StaticMeshLoader.h"
+#include "../src/util/angle.h"
+
+/**
+ * Renders scripted ui frames through ui::Renderer on the null render api for a fixed number of frames, then
+ * reports the cpu time of each frame along with the calls it made as json, so that the cost of submitting
+ * the ui can be compared between builds on any machine. Nothing is drawn, so it needs no gpu, display or gl
+ * libraries.
+ *
+ * Each frame draws a grid of rects and of images, which sample a few textures in turn, and drift with the
+ * frame index. With --meshes, a small scene of monkeys is also rendered into a framebuffer that the first
+ * image samples, as a 3d viewport would be. Everything depends only on the frame index, so every run
+ * submits the same frames.
+ */
+
+static const char* usage =
+    "usage: ui_bench [options]\n"
+    "  --frames=N                  the number of measured frames (default 300)\n"
+    "  --warmup=N                  the number of unmeasured frames rendered first (default 30)\n"
+    "  --rects=N                   the number of rects drawn each frame (default 2048)\n"
+    "  --images=N                  the number of images drawn each frame (default 512)\n"
+    "  --textures=N                the number of textures the images sample (default 16)\n"
+    "  --meshes=N                  the number of monkeys in a scene drawn as the first image, or 0 for no\n"
+    "                              scene (default 0)\n"
+    "  --output=FILE               write the report to a file rather than stdout\n";
+
+struct BenchOptions {
+    uint32_t frames = 300;
+    uint32_t warmup = 30;
+    uint32_t rects = 2048;
+    uint32_t images = 512;
+    uint32_t textures = 16;
+    uint32_t meshes = 0;
+    std::string output;
+};
+
+/**
+ * The measurements of a single frame.
+ */
+struct FrameRecord {
+    double cpu; // the time taken to render the render list, in milliseconds
+    NullRHI::Statistics calls;
+};
+
+// the size of the ui coordinate space, and of the scene's framebuffer
+static constexpr float ui_width = 1280.0f;
+static constexpr float ui_height = 720.0f;
+static constexpr uint32_t scene_width = 640;
+static constexpr uint32_t scene_height = 360;
+
+/**
+ * Parses an unsigned integer option of the form "--name=value".
+ *
+ * @param arg the argument to parse
+ * @param prefix the name of the option followed by '='
+ * @param value set to the value of the option if the argument is the option
+ * @param minimum the smallest valid value
+ * @returns whether the argument is the option
+ * @throws std::invalid_argument if the value is not an integer of at least the minimum
+ */
+static bool parse_count(const std::string& arg, std::string_view prefix, uint32_t& value, uint32_t minimum = 1) {
+    if (!arg.starts_with(prefix)) {
+        return false;
+    }
+
+    std::string text = arg.substr(prefix.size());
+    if (text.empty() || text.find_first_not_of("0123456789") != std::string::npos || text.size() > 9
+        || std::stoul(text) < minimum) {
+        throw std::invalid_argument("Invalid value for option: " + arg);
+    }
+    value = (uint32_t)std::stoul(text);
+    return true;
+}
+
+/**
+ * @param argc the number of arguments
+ * @param argv the arguments, starting with the program name
+ * @returns the options given by the arguments
+ * @throws std::invalid_argument if an argument is not a valid option
+ */
+static BenchOptions parse_options(int argc, char* argv[]) {
+    BenchOptions options;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (parse_count(arg, "--frames=", options.frames) || parse_count(arg, "--warmup=", options.warmup, 0)
+            || parse_count(arg, "--rects=", options.rects, 0) || parse_count(arg, "--images=", options.images, 0)
+            || parse_count(arg, "--textures=", options.textures) || parse_count(arg, "--meshes=", options.meshes, 0)) {
+            continue;
+        } else if (arg.starts_with("--output=") && arg.size() > 9) {
+            options.output = arg.substr(9);
+        } else {
+            throw std::invalid_argument("Unknown option: " + arg);
+        }
+    }
+    return options;
+}
+
+/**
+ * Lays out the n-th of some quads in a grid covering the ui, drifting with the frame.
+ *
+ * @param index the index of the quad
+ * @param count the number of quads in the grid
+ * @param t the fraction of the measured frames completed
+ * @param z the depth of the quads
+ * @returns the position of the quad's top-left corner, and its size
+ */
+static std::pair<ui::Position, ui::Size> grid_quad(uint32_t index, uint32_t count, float t, float z) {
+    auto columns = (uint32_t)std::ceil(std::sqrt((double)count));
+    float width = ui_width / (float)columns;
+    float height = ui_height / (float)columns;
+    float drift = 0.25f * width * std::sin(degreesToRadians(360.0f * t));
+    return {
+        ui::Position{width * (float)(index % columns) + drift, height * (float)(index / columns), z},
+        ui::Size{0.75f * width, 0.75f * height},
+    };
+}
+
+/**
+ * Renders the scripted ui frames with the current render api, which must be the null api.
+ *
+ * @param options the options of the benchmark
+ * @returns the measurements of each measured frame
+ * @throws std::length_error if there are more images and rects than the renderer can draw in a frame
+ */
+static std::vector<FrameRecord> run_bench(const BenchOptions& options) {
+    RHI& rhi = RHI::current();
+    NullRHI& null_rhi = NullRHI::from(rhi);
+
+    std::vector<std::unique_ptr<Texture2D>> textures;
+    for (uint32_t i = 0; i < options.textures; i++) {
+        textures.push_back(rhi.createTexture2D(Format::RGBA8, 64, 64));
+    }
+
+    // the scene is a row of monkeys in front of the camera, drawn into a framebuffer sampled by the first image
+    std::shared_ptr<Renderer3D> scene_renderer;
+    std::shared_ptr<Framebuffer> framebuffer;
+    std::shared_ptr<Camera3D> camera;
+    std::unique_ptr<StaticMesh> monkey_mesh;
+    std::vector<Mat4> monkey_transforms;
+    if (options.meshes > 0) {
+        framebuffer = rhi.createFramebufferBuilder()
+            ->setDimensions(scene_width, scene_height)
+            ->setColorAttachment(rhi.createTexture2D(Format::RGBA8, scene_width, scene_height))
+            ->setDepthAttachment(rhi.createTexture2D(Format::D32F, scene_width, scene_height))
+            ->build();
+        camera = Camera3D::createPerspective(45.0f, (float)scene_width / (float)scene_height, 0.1f, 100.0f);
+        camera->moveTo(Vec3(0.0f, 2.0f, 10.0f));
+        camera->lookAt({0.0f, 0.0f, 0.0f}, true);
+        scene_renderer = std::make_shared<Renderer3D>(camera);
+
+        StaticMeshLoader loader(Material::createDefault());
+        monkey_mesh = std::make_unique<StaticMesh>(loader.load("../assets/flat-monkey.obj"));
+        for (uint32_t i = 0; i < options.meshes; i++) {
+            Mat4 transform(1.0f);
+            transform[3] = Vec4(2.5f * ((float)i - 0.5f * (float)(options.meshes - 1)), 0.0f, 0.0f, 1.0f);
+            monkey_transforms.push_back(transform);
+        }
+    }
+
+    ui::Renderer renderer(ui_width, ui_height);
+
+    // the pipelines requested while constructing were built at once, and are finished before the first frame
+    rhi.pipelineCache().wait();
+
+    ui::RenderList list;
+    std::vector<FrameRecord> records;
+    for (uint32_t frame = 0; frame < options.warmup + options.frames; frame++) {
+        float t = (float)frame / (float)options.frames;
+
+        // the list is built as components would build it, outside the measured time
+        list.clear();
+        if (scene_renderer != nullptr) {
+            ui::SceneInfo scene{
+                .renderer = scene_renderer,
+                .framebuffer = framebuffer,
+                .camera = camera,
+                .lights = {PointLight{
+                    .position = Vec3(0.0f, 3.0f, 3.0f),
+                    .radius = 20.0f,
+                    .color = Vec3(1.0f, 1.0f, 1.0f),
+                    .intensity = 1.0f,
+                }},
+            };
+            for (const Mat4& transform : monkey_transforms) {
+                scene.draws.push_back(ui::SceneDraw{.mesh = monkey_mesh.get(), .transform = transform});
+            }
+            list.submit_scene(std::move(scene));
+        }
+        for (uint32_t i = 0; i < options.images; i++) {
+            auto [position, size] = grid_quad(i, options.images, t, 0.5f);
+            Texture2D& texture = i == 0 && framebuffer != nullptr ? framebuffer->colorAttachment()
+                                                                  : *textures[i % textures.size()];
+            list.submit_image(ui::ImageInfo{.position = position, .size = size, .texture2d = texture});
+        }
+        for (uint32_t i = 0; i < options.rects; i++) {
+            auto [position, size] = grid_quad(i, options.rects, -t, 0.25f);
+            list.submit_rect(ui::RectInfo{
+                .position = position,
+                .size = size,
+                .color = ui::Color{(float)(i % 7) / 6.0f, (float)(i % 5) / 4.0f, (float)(i % 3) / 2.0f, 0.5f},
+            });
+        }
+
+        null_rhi.resetStatistics();
+        Timestamp start = std::chrono::steady_clock::now();
+        renderer.render(list);
+        double cpu = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+        if (frame >= options.warmup) {
+            records.push_back(FrameRecord{.cpu = cpu, .calls = null_rhi.statistics()});
+        }
+    }
+
+    return records;
+}
+
+/**
+ * Writes the mean, percentiles and extremes of some times as a json object.
+ *
+ * @param out the stream to write to
+ * @param times the times, in milliseconds
+ */
+static void write_summary(std::ostream& out, std::vector<double> times) {
+    if (times.empty()) {
+        out << "null";
+        return;
+    }
+
+    std::sort(times.begin(), times.end());
+    double total = 0.0;
+    for (double time: times) {
+        total += time;
+    }
+    auto percentile = [&](double p) {
+        return times[std::min(times.size() - 1, (size_t)(p / 100.0 * (double)times.size()))];
+    };
+
+    out << "{\"count\": " << times.size()
+        << ", \"mean\": " << total / (double)times.size()
+        << ", \"median\": " << percentile(50.0)
+        << ", \"p95\": " << percentile(95.0)
+        << ", \"p99\": " << percentile(99.0)
+        << ", \"min\": " << times.front()
+        << ", \"max\": " << times.back() << "}";
+}
+
+/**
+ * Writes the report of a benchmark as json.
+ *
+ * @param out the stream to write to
+ * @param options the options of the benchmark
+ * @param records the measurements of each measured frame
+ */
+static void write_report(std::ostream& out, const BenchOptions& options, const std::vector<FrameRecord>& records) {
+    out << "{\n";
+    out << "  \"backend\": \"null\",\n";
+    out << "  \"rects\": " << options.rects << ", \"images\": " << options.images
+        << ", \"textures\": " << options.textures << ", \"meshes\": " << options.meshes << ",\n";
+    out << "  \"warmup\": " << options.warmup << ",\n";
+
+    std::vector<double> cpu_times;
+    for (const FrameRecord& record: records) {
+        cpu_times.push_back(record.cpu);
+    }
+    out << "  \"cpu\": ";
+    write_summary(out, cpu_times);
+    out << ",\n";
+
+    out << "  \"frames\": [";
+    for (size_t i = 0; i < records.size(); i++) {
+        const FrameRecord& record = records[i];
+        out << (i == 0 ? "\n" : ",\n")
+            << "    {\"cpu\": " << record.cpu
+            << ", \"binds\": " << record.calls.binds
+            << ", \"stateChanges\": " << record.calls.stateChanges
+            << ", \"draws\": " << record.calls.draws
+            << ", \"vertices\": " << record.calls.vertices
+            << ", \"bytesUploaded\": " << record.calls.bytesUploaded
+            << ", \"commandLists\": " << record.calls.commandLists << "}";
+    }
+    out << "\n  ]\n}\n";
+}
+
+int main(int argc, char* argv[])
+{
+    BenchOptions options;
+    try {
+        options = parse_options(argc, argv);
+    } catch (const std::invalid_argument& e) {
+        std::cerr << e.what() << "\n" << usage;
+        return 1;
+    }
+
+    RHI::create(RHI::Backend::Null);
+
+    std::vector<FrameRecord> records;
+    try {
+        records = run_bench(options);
+    } catch (const std::length_error& e) {
+        std::cerr << "ERR: " << e.what() << std::endl;
+        RHI::destroy();
+        return 1;
+    }
+
+    if (options.output.empty()) {
+        write_report(std::cout, options, records);
+    } else {
+        std::ofstream file(options.output);
+        write_report(file, options, records);
+        if (!file.good()) {
+            std::cerr << "ERR: failed to write report: " << options.output << std::endl;
+            RHI::destroy();
+            return 1;
+        }
+    }
+
+    RHI::destroy();
+    return 0;
+}
@@ -1,20 +1,54 @@
 #include "src/ui/Window.h"
 #include "src/ui/Renderer.h"
+#include "src/ui/RenderThread.h"
 #include "src/ui/App.h"
+#include "src/rhi/PipelineCache.h"
 
 int main(int argc, char* argv[])
 {
+    // rendering runs on a dedicated thread if requested, overlapping with simulation
+    bool use_render_thread = false;
+    Renderer3D::PassMode pass_mode = Renderer3D::PassMode::FrontToBack;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--render-thread") {
+            use_render_thread = true;
+        } else if (arg == "--pass-mode=submission") {
+            pass_mode = Renderer3D::PassMode::Submission;
+        } else if (arg == "--pass-mode=front-to-back") {
+            pass_mode = Renderer3D::PassMode::FrontToBack;
+        } else if (arg == "--pass-mode=depth-prepass") {
+            pass_mode = Renderer3D::PassMode::DepthPrepass;
+        }
+    }
+
     int width = 1290, height = 730;
     ui::Window window(width, height, "OpenGL Test");
 
-    std::unique_ptr<ui::Component> app = std::make_unique<ui::App>();
+    // linked programs are kept between launches, so later launches start without compiling shaders
+    RHI::current().pipelineCache().setDirectory("pipeline-cache");
+
+    std::unique_ptr<ui::Component> app = std::make_unique<ui::App>(pass_mode);
 
     ui::Renderer renderer((float)width, (float)height);
+
+    // the pipelines requested while loading were built at once, and are finished before the first frame
+    RHI::current().pipelineCache().wait();
+
     app->reposition(0, 0);
     app->resize((float)window.dimensions().x, (float)window.dimensions().y);
 
+    FrameTimeHistogram simulation_times;
+    FrameTimeHistogram render_times;
+    std::unique_ptr<ui::RenderThread> render_thread;
+    if (use_render_thread) {
+        render_thread = std::make_unique<ui::RenderThread>(window, renderer);
+    }
+
+    ui::RenderList list;
     Timestep timestep = Timestep::start();
     while (!window.should_close()) {
+        Timestamp frame_start = std::chrono::steady_clock::now();
 
         // process pending events
         for (auto event: window.poll()) {
@@ -25,15 +59,35 @@ int main(int argc, char* argv[])
         timestep = Timestep::now(timestep);
         app->update(timestep);
 
-        ui::RenderList list;
+        if (render_thread != nullptr) {
+            // hand the frame over to the render thread
+            app->draw(render_thread->begin_frame());
+            render_thread->end_frame();
+            continue;
+        }
 
+        list.clear();
         app->draw(list);
 
+        Timestamp render_start = std::chrono::steady_clock::now();
+        simulation_times.record(render_start - frame_start);
+
         // draw the final ui to default framebuffer
         renderer.render(list);
 
         window.swap();
+        render_times.record(std::chrono::steady_clock::now() - render_start);
     }
 
+    if (render_thread != nullptr) {
+        render_thread->stop();
+        simulation_times = render_thread->simulation_times();
+        render_times = render_thread->render_times();
+    }
+
+    std::cout << "simulation: " << simulation_times.summary() << std::endl;
+    std::cout << "render: " << render_times.summary() << std::endl;
+    std::cout << RHI::current().profiler().summary();
+
     return 0;
 }
@@ -10,6 +10,11 @@
 #include <functional>
 #include <exception>
 #include <utility>
+#include <span>
+#include <cmath>
+#include <cstring>
+#include <algorithm>
+#include <stdexcept>
 
 // graphics library includes
 #include <SDL2/SDL.h>
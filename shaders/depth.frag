@@ -0,0 +1,6 @@
+#version 460 core
+
+void main()
+{
+    // only depth is written
+}
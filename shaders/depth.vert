@@ -0,0 +1,15 @@
+#version 460 core
+
+layout(location = 0) in vec3 vPosition;
+
+layout(std140, binding = 0) uniform DrawUniforms {
+    mat4 ModelViewProjection;
+};
+
+// must match the depth of later passes exactly, so that they can test for equal depth
+invariant gl_Position;
+
+void main()
+{
+    gl_Position = ModelViewProjection * vec4(vPosition, 1.0f);
+}
@@ -2,9 +2,12 @@
 
 layout(location = 0) in vec3 iPos;
 
-layout(location = 0) uniform mat4 MVP;
+layout(std140, binding = 0) uniform DrawUniforms {
+    mat4 ModelViewProjection;
+    mat4 Model;
+};
 
 void main()
 {
-    gl_Position = MVP * vec4(iPos, 1.0f);
+    gl_Position = ModelViewProjection * vec4(iPos, 1.0f);
 }
@@ -6,21 +6,63 @@ in vec3 fNormal;
 
 out vec3 oColor;
 
-layout(location = 1) uniform vec3 LightPosition = vec3(5.0f, 5.0f, 5.0f);
+struct PointLight {
+    vec3 position;
+    float radius;
+    vec3 color;
+    float intensity;
+};
+
+layout(std140, binding = 1) uniform LightClusters {
+    mat4 View;
+    uvec4 ClusterCounts; // x, y and z counts, then the number of lights
+    vec4 DepthSlicing; // depth scale and bias, then the viewport width and height
+};
+
+layout(std430, binding = 2) readonly buffer Lights {
+    PointLight lights[];
+};
+
+// the offset and count of each cluster's range of light indices
+layout(std430, binding = 3) readonly buffer Clusters {
+    uvec2 clusters[];
+};
+
+layout(std430, binding = 4) readonly buffer LightIndices {
+    uint lightIndices[];
+};
 
 layout(binding = 0) uniform sampler2D AlbedoTexture;
 
 void main()
 {
-    vec3 lightColor = vec3(1.0f, 1.0f, 1.0f);
     //vec3 albedo = texture(AlbedoTexture, fTexCoord).rgb;
     vec3 albedo = vec3(0.6f, 0.6f, 0.6f);
 
     float ambientLevel = 0.1f;
 
-    vec3 lightDir = normalize(LightPosition - fPosition);
+    // find the cluster of the fragment from its screen position and view depth
+    float depth = -(View * vec4(fPosition, 1.0f)).z;
+    uvec3 cluster = uvec3(
+        uint(gl_FragCoord.x / DepthSlicing.z * float(ClusterCounts.x)),
+        uint(gl_FragCoord.y / DepthSlicing.w * float(ClusterCounts.y)),
+        uint(max(floor(log(depth) * DepthSlicing.x + DepthSlicing.y), 0.0f))
+    );
+    cluster = min(cluster, ClusterCounts.xyz - 1u);
+    uvec2 range = clusters[(cluster.z * ClusterCounts.y + cluster.y) * ClusterCounts.x + cluster.x];
+
     vec3 normalDir = normalize(fNormal);
-    float diffuseLevel = max(dot(normalDir, lightDir), 0.0f);
+    vec3 lighting = vec3(ambientLevel);
+    for (uint i = 0u; i < range.y; i++) {
+        PointLight light = lights[lightIndices[range.x + i]];
+
+        vec3 toLight = light.position - fPosition;
+        float lightDistance = length(toLight);
+        float falloff = clamp(1.0f - lightDistance / light.radius, 0.0f, 1.0f);
+        float diffuseLevel = max(dot(normalDir, toLight / max(lightDistance, 1e-4f)), 0.0f);
+
+        lighting += light.color * (light.intensity * diffuseLevel * falloff * falloff);
+    }
 
-    oColor = albedo * lightColor * (ambientLevel + diffuseLevel);
+    oColor = albedo * lighting;
 }
@@ -8,12 +8,19 @@ out vec3 fPosition;
 out vec2 fTexCoord;
 out vec3 fNormal;
 
-layout(location = 0) uniform mat4 ModelViewProjection;
+layout(std140, binding = 0) uniform DrawUniforms {
+    mat4 ModelViewProjection;
+    mat4 Model;
+};
+
+// must match the depth pre-pass exactly, so that it can be tested for equal depth
+invariant gl_Position;
 
 void main()
 {
-    fPosition = vPosition;
+    // lighting is computed in world space
+    fPosition = (Model * vec4(vPosition, 1.0f)).xyz;
     fTexCoord = vTexCoord;
-    fNormal = vNormal;
+    fNormal = mat3(Model) * vNormal;
     gl_Position = ModelViewProjection * vec4(vPosition, 1.0f);
 }
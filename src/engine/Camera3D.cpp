@@ -11,7 +11,7 @@ void Camera3D::moveTo(const Vec3& destination) {
 void Camera3D::lookAt(const Vec3& target, bool keepRoll) {
     // get the new normalized direction vector
     m_direction = m_position - target;
-    m_direction = m_direction * (1 / std::sqrtf(m_direction.dot(m_direction)));
+    m_direction = m_direction * (1 / std::sqrt(m_direction.dot(m_direction)));
 
     // update the angles
     if (!keepRoll) {
@@ -45,9 +45,9 @@ void Camera3D::rotate(float pitch, float yaw, float roll) {
     updateViewProjectionMatrix();
 }
 
-Camera3D::Camera3D(Mat4 projection)
+Camera3D::Camera3D(Mat4 projection, float zNear, float zFar)
         : m_position(0.0f, 0.0f, 0.0f), m_direction(0.0f, 0.0f, 1.0f), m_pitch(0.0f), m_yaw(0.0f), m_roll(0.0f),
-          m_projection(projection), m_view(), m_viewProjection() {
+          m_projection(projection), m_zNear(zNear), m_zFar(zFar), m_view(), m_viewProjection() {
     updateViewProjectionMatrix();
 }
 
@@ -85,7 +85,7 @@ std::shared_ptr<Camera3D> Camera3D::createOrthographic(float width, float height
         Vec4(0.0f, 0.0f, -2.0f / (zFar - zNear), 0.0f),
         Vec4(0.0f, 0.0f, -(zNear + zFar) / 2.0f, 1.0f),
     });
-    return std::make_shared<Camera3D>(projection);
+    return std::make_shared<Camera3D>(projection, zNear, zFar);
 }
 
 std::shared_ptr<Camera3D> Camera3D::createPerspective(float fieldOfView, float aspectRatio, float zNear, float zFar) {
@@ -99,5 +99,5 @@ std::shared_ptr<Camera3D> Camera3D::createPerspective(float fieldOfView, float a
         Vec4(0.0f, 0.0f, -(zFar + zNear) / (zFar - zNear), -1.0f),
         Vec4(0.0f, 0.0f, -2.0f * zFar * zNear / (zFar - zNear), 0.0f),
     });
-    return std::make_shared<Camera3D>(projection);
+    return std::make_shared<Camera3D>(projection, zNear, zFar);
 }
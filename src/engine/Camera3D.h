@@ -10,8 +10,10 @@ public:
      * Constructs the camera with the given projection matrix.
      *
      * @param projection the projection matrix for the camera
+     * @param zNear the distance to the near plane of the projection
+     * @param zFar the distance to the far plane of the projection
      */
-    explicit Camera3D(Mat4 projection);
+    Camera3D(Mat4 projection, float zNear, float zFar);
 
     /**
      * Creates an orthographic camera with the given viewport width and height and
@@ -76,6 +78,34 @@ public:
         return m_direction;
     }
 
+    /**
+     * @return the projection matrix of the camera
+     */
+    const Mat4& projectionMatrix() const {
+        return m_projection;
+    }
+
+    /**
+     * @return the view matrix of the camera, which looks down the -z axis
+     */
+    const Mat4& viewMatrix() const {
+        return m_view;
+    }
+
+    /**
+     * @return the distance to the near plane of the projection
+     */
+    float nearPlane() const {
+        return m_zNear;
+    }
+
+    /**
+     * @return the distance to the far plane of the projection
+     */
+    float farPlane() const {
+        return m_zFar;
+    }
+
     /**
      * @return the view projection (view then projection transform) matrix of the camera
      */
@@ -94,6 +124,7 @@ private:
     Vec3 m_direction;
     float m_pitch, m_yaw, m_roll; // in radians
     const Mat4 m_projection;
+    float m_zNear, m_zFar;
     Mat4 m_view;
     Mat4 m_viewProjection;
 };
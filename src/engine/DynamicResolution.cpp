@@ -0,0 +1,38 @@
+#include "DynamicResolution.h"
+
+DynamicResolution::DynamicResolution(float targetFrameTime, float minScale, float maxScale)
+    : m_targetFrameTime(targetFrameTime), m_minScale(minScale), m_maxScale(maxScale), m_smoothedFrameTime(0.0f),
+      m_scale(maxScale) {
+    if (targetFrameTime <= 0.0f || minScale <= 0.0f || minScale > maxScale) {
+        throw std::invalid_argument("Invalid dynamic resolution parameters.");
+    }
+}
+
+void DynamicResolution::update(float gpuFrameTime) {
+    if (gpuFrameTime <= 0.0f) return;
+
+    m_smoothedFrameTime = m_smoothedFrameTime == 0.0f
+                          ? gpuFrameTime
+                          : m_smoothedFrameTime + (gpuFrameTime - m_smoothedFrameTime) * smoothing;
+
+    // shrink as soon as the budget is exceeded, but only grow once well within it
+    float scale = m_scale.load(std::memory_order_relaxed);
+    bool isOver = m_smoothedFrameTime > m_targetFrameTime;
+    bool isUnder = m_smoothedFrameTime < m_targetFrameTime * headroom;
+    if (!isOver && !isUnder) return;
+
+    float target = isOver ? m_targetFrameTime : m_targetFrameTime * headroom;
+    float ratio = std::sqrt(target / m_smoothedFrameTime);
+    ratio = std::clamp(ratio, 1.0f - maxStep, 1.0f + maxStep);
+    m_scale.store(std::clamp(scale * ratio, m_minScale, m_maxScale), std::memory_order_relaxed);
+}
+
+Vector<uint32_t, 2> DynamicResolution::extent(Vector<uint32_t, 2> maxExtent) const {
+    float fraction = scale() / m_maxScale;
+    auto scaleAxis = [&](uint32_t size) {
+        auto scaled = (uint32_t)((float)size * fraction) / alignment * alignment;
+        return std::clamp(scaled, std::min(alignment, size), size);
+    };
+
+    return {scaleAxis(maxExtent.x), scaleAxis(maxExtent.y)};
+}
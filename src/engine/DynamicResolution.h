@@ -0,0 +1,65 @@
+#ifndef OPENGL_RENDERER_DYNAMICRESOLUTION_H
+#define OPENGL_RENDERER_DYNAMICRESOLUTION_H
+
+#include <atomic>
+#include "../util/Vector.h"
+
+/**
+ * Scales the resolution a view is rendered at to keep its gpu frame time within a budget.
+ *
+ * Gpu frame times are smoothed, and since rendering cost is roughly proportional to the number of pixels,
+ * the scale is moved towards the square root of the ratio of the budget to the smoothed time. The scale
+ * only grows once there is enough headroom, and changes by a limited step per frame, so that it settles
+ * rather than oscillating.
+ *
+ * Times are given on the thread that renders, while the scale may be read from any thread.
+ */
+class DynamicResolution {
+public:
+    /**
+     * Constructs a controller starting at the maximum scale.
+     *
+     * @param targetFrameTime the gpu frame time budget, in milliseconds
+     * @param minScale the smallest scale of each axis, in (0, maxScale]
+     * @param maxScale the largest scale of each axis
+     */
+    DynamicResolution(float targetFrameTime, float minScale, float maxScale);
+
+    /**
+     * Adjusts the scale given the gpu time of a rendered frame.
+     *
+     * @param gpuFrameTime the gpu time of the frame, in milliseconds, which is ignored if not positive
+     */
+    void update(float gpuFrameTime);
+
+    /**
+     * @returns the current scale of each axis
+     */
+    float scale() const {
+        return m_scale.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * Finds the extent to render at, given the extent at the maximum scale. The extent is rounded to a
+     * multiple of the alignment so that small changes in scale do not change it every frame.
+     *
+     * @param maxExtent the extent at the maximum scale, in pixels
+     * @returns the extent at the current scale, in pixels, which is at most the maximum extent
+     */
+    Vector<uint32_t, 2> extent(Vector<uint32_t, 2> maxExtent) const;
+
+private:
+    static constexpr float smoothing = 0.1f; // weight of each new frame time
+    static constexpr float headroom = 0.85f; // fraction of the budget frame times must be under to grow
+    static constexpr float maxStep = 0.05f; // the largest relative change in scale per frame
+    static constexpr uint32_t alignment = 8;
+
+    float m_targetFrameTime;
+    float m_minScale;
+    float m_maxScale;
+    float m_smoothedFrameTime;
+    std::atomic<float> m_scale;
+};
+
+
+#endif //OPENGL_RENDERER_DYNAMICRESOLUTION_H
@@ -1,6 +1,8 @@
 #include "Grid.h"
 
 #include "ShaderLoader.h"
+#include "../rhi/UploadQueue.h"
+#include "../rhi/PipelineCache.h"
 
 StaticMesh Grid::make(float width, float tileSize) {
     RHI& rhi = RHI::current();
@@ -29,8 +31,7 @@ StaticMesh Grid::make(float width, float tileSize) {
     }
 
     uint32_t m_numVertices = lines.size();
-    auto buffer = rhi.createBuffer(m_numVertices * sizeof(GridVertex), sizeof(GridVertex));
-    std::memcpy(buffer->map(), lines.data(), buffer->size());
+    auto buffer = rhi.uploadQueue().createBuffer(lines.data(), m_numVertices * sizeof(GridVertex), sizeof(GridVertex));
 
     std::vector<VertexBinding> bindings = {
         VertexBinding(0, buffer->size(), {
@@ -38,21 +39,20 @@ StaticMesh Grid::make(float width, float tileSize) {
         })
     };
 
-    VertexLayout vertexLayout(std::move(bindings));
-
-    std::unique_ptr<Shader> vertShader = shaderFromFile("../shaders/grid.vert");
-    std::unique_ptr<Shader> fragShader = shaderFromFile("../shaders/grid.frag");
-
-    auto pipeline = rhi.createPipelineBuilder()
-        ->setTopology(Topology::Lines)
-        ->setVertexLayout(vertexLayout)
-        ->setVertexShader(*vertShader)
-        ->setFragmentShader(*fragShader)
-        ->build();
+    std::shared_ptr<Pipeline> pipeline = rhi.pipelineCache().get(PipelineDescription{
+        .vertexShader = shaderSourceFromFile("../shaders/grid.vert"),
+        .fragmentShader = shaderSourceFromFile("../shaders/grid.frag"),
+        .vertexLayout = VertexLayout(std::move(bindings)),
+        .topology = Topology::Lines,
+    });
 
     return StaticMesh{
         .vertexBuffer = std::move(buffer),
         .indexBuffer = nullptr,
-        .material = std::make_shared<Material>(std::move(pipeline))
+        .material = std::make_shared<Material>(std::move(pipeline)),
+        .bounds = Bounds{
+            .min = Vec3(negBound, 0.0f, negBound),
+            .max = Vec3(posBound, 0.0f, posBound),
+        },
     };
 }
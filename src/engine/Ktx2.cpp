@@ -0,0 +1,307 @@
+#include "Ktx2.h"
+
+#include <numeric>
+#include <optional>
+
+namespace {
+    constexpr uint8_t identifier[12] = {0xAB, 'K', 'T', 'X', ' ', '2', '0', 0xBB, '\r', '\n', 0x1A, '\n'};
+    constexpr size_t headerSize = 80; // the identifier, header and index, which the level index follows
+    constexpr size_t levelIndexEntrySize = 24;
+
+    // the identifier, header and index, as they are laid out at the start of the file
+    struct Header {
+        uint8_t identifier[12];
+        uint32_t vkFormat;
+        uint32_t typeSize;
+        uint32_t pixelWidth;
+        uint32_t pixelHeight;
+        uint32_t pixelDepth;
+        uint32_t layerCount;
+        uint32_t faceCount;
+        uint32_t levelCount;
+        uint32_t supercompressionScheme;
+        uint32_t dfdByteOffset;
+        uint32_t dfdByteLength;
+        uint32_t kvdByteOffset;
+        uint32_t kvdByteLength;
+        uint64_t sgdByteOffset;
+        uint64_t sgdByteLength;
+    };
+    static_assert(sizeof(Header) == headerSize);
+
+    struct LevelIndexEntry {
+        uint64_t byteOffset;
+        uint64_t byteLength;
+        uint64_t uncompressedByteLength;
+    };
+    static_assert(sizeof(LevelIndexEntry) == levelIndexEntrySize);
+
+    // the data format descriptor's color models, channels and sample qualifiers
+    enum ColorModel : uint8_t {
+        modelRGBSDA = 1, modelBC1A = 128, modelBC3 = 130, modelBC4 = 131, modelBC5 = 132, modelBC7 = 134,
+    };
+    enum Channel : uint8_t {
+        channelRed = 0, channelGreen = 1, channelBlue = 2, channelDepth = 14, channelAlpha = 15,
+    };
+    constexpr uint8_t qualifierSigned = 0x40;
+    constexpr uint8_t qualifierFloat = 0x80;
+    constexpr uint32_t floatOne = 0x3F800000;
+    constexpr uint32_t floatMinusOne = 0xBF800000;
+
+    struct Sample {
+        uint16_t bitOffset;
+        uint8_t bitLength;
+        uint8_t channel;
+        uint32_t lower;
+        uint32_t upper;
+    };
+
+    struct FormatDescription {
+        uint32_t vkFormat;
+        uint32_t typeSize; // the size of the values that are byte swapped on big endian machines
+        ColorModel colorModel;
+        std::vector<Sample> samples;
+    };
+
+    /**
+     * @returns the vulkan format of a texture format, and the channels of its data format descriptor
+     * @throws std::invalid_argument if the format cannot be stored in a KTX 2.0 file
+     */
+    FormatDescription describe(Format format) {
+        switch (format) {
+            case Format::RGB8:
+                return {23, 1, modelRGBSDA, {
+                    {0, 8, channelRed, 0, 255}, {8, 8, channelGreen, 0, 255}, {16, 8, channelBlue, 0, 255},
+                }};
+            case Format::RGBA8:
+                return {37, 1, modelRGBSDA, {
+                    {0, 8, channelRed, 0, 255}, {8, 8, channelGreen, 0, 255}, {16, 8, channelBlue, 0, 255},
+                    {24, 8, channelAlpha, 0, 255},
+                }};
+            case Format::RGBA16F: {
+                constexpr uint8_t type = qualifierFloat | qualifierSigned;
+                return {97, 2, modelRGBSDA, {
+                    {0, 16, channelRed | type, 0xBC00, 0x3C00}, {16, 16, channelGreen | type, 0xBC00, 0x3C00},
+                    {32, 16, channelBlue | type, 0xBC00, 0x3C00}, {48, 16, channelAlpha | type, 0xBC00, 0x3C00},
+                }};
+            }
+            case Format::RG32F: {
+                constexpr uint8_t type = qualifierFloat | qualifierSigned;
+                return {103, 4, modelRGBSDA, {
+                    {0, 32, channelRed | type, floatMinusOne, floatOne},
+                    {32, 32, channelGreen | type, floatMinusOne, floatOne},
+                }};
+            }
+            case Format::RGB32F: {
+                constexpr uint8_t type = qualifierFloat | qualifierSigned;
+                return {106, 4, modelRGBSDA, {
+                    {0, 32, channelRed | type, floatMinusOne, floatOne},
+                    {32, 32, channelGreen | type, floatMinusOne, floatOne},
+                    {64, 32, channelBlue | type, floatMinusOne, floatOne},
+                }};
+            }
+            case Format::RGBA32F: {
+                constexpr uint8_t type = qualifierFloat | qualifierSigned;
+                return {109, 4, modelRGBSDA, {
+                    {0, 32, channelRed | type, floatMinusOne, floatOne},
+                    {32, 32, channelGreen | type, floatMinusOne, floatOne},
+                    {64, 32, channelBlue | type, floatMinusOne, floatOne},
+                    {96, 32, channelAlpha | type, floatMinusOne, floatOne},
+                }};
+            }
+            case Format::R11G11B10F:
+                return {122, 4, modelRGBSDA, {
+                    {0, 11, channelRed | qualifierFloat, 0, floatOne},
+                    {11, 11, channelGreen | qualifierFloat, 0, floatOne},
+                    {22, 10, channelBlue | qualifierFloat, 0, floatOne},
+                }};
+            case Format::D32F:
+                return {126, 4, modelRGBSDA, {
+                    {0, 32, channelDepth | qualifierFloat | qualifierSigned, 0, floatOne},
+                }};
+            case Format::BC1:
+                return {133, 1, modelBC1A, {{0, 64, 1, 0, UINT32_MAX}}};
+            case Format::BC3:
+                return {137, 1, modelBC3, {{0, 64, channelAlpha, 0, UINT32_MAX}, {64, 64, 0, 0, UINT32_MAX}}};
+            case Format::BC4:
+                return {139, 1, modelBC4, {{0, 64, 0, 0, UINT32_MAX}}};
+            case Format::BC5:
+                return {141, 1, modelBC5, {{0, 64, 0, 0, UINT32_MAX}, {64, 64, 1, 0, UINT32_MAX}}};
+            case Format::BC7:
+                return {145, 1, modelBC7, {{0, 128, 0, 0, UINT32_MAX}}};
+        }
+        throw std::invalid_argument("The format cannot be stored in a KTX 2.0 file.");
+    }
+
+    /**
+     * @returns the texture format of a vulkan format, or nothing if it has none
+     */
+    std::optional<Format> formatOf(uint32_t vkFormat) {
+        switch (vkFormat) {
+            case 23: return Format::RGB8;
+            case 37: return Format::RGBA8;
+            case 97: return Format::RGBA16F;
+            case 103: return Format::RG32F;
+            case 106: return Format::RGB32F;
+            case 109: return Format::RGBA32F;
+            case 122: return Format::R11G11B10F;
+            case 126: return Format::D32F;
+            case 131: // the opaque variant of BC1 decodes the same colors, with transparent pixels black instead
+            case 133: return Format::BC1;
+            case 137: return Format::BC3;
+            case 139: return Format::BC4;
+            case 141: return Format::BC5;
+            case 145: return Format::BC7;
+            default: return std::nullopt;
+        }
+    }
+
+    /**
+     * @returns the data format descriptor of a format, including its total size
+     */
+    std::vector<uint8_t> dataFormatDescriptor(Format format, const FormatDescription& description) {
+        auto blockSize = (uint16_t)(24 + 16 * description.samples.size());
+        std::vector<uint8_t> dfd(4 + blockSize, 0);
+        auto totalSize = (uint32_t)dfd.size();
+        std::memcpy(&dfd[0], &totalSize, 4);
+
+        // the vendor and descriptor type are those of the basic descriptor, which are 0, followed by version 2
+        uint16_t version = 2;
+        std::memcpy(&dfd[8], &version, 2);
+        std::memcpy(&dfd[10], &blockSize, 2);
+        dfd[12] = description.colorModel;
+        dfd[13] = 1; // bt.709 primaries
+        dfd[14] = 1; // linear transfer function
+        dfd[15] = 0; // straight alpha
+        if (isBlockCompressed(format)) {
+            dfd[16] = 3; // the dimensions of a block, minus one
+            dfd[17] = 3;
+        }
+        dfd[20] = (uint8_t)formatBlockSize(format);
+
+        for (size_t i = 0; i < description.samples.size(); i++) {
+            const Sample& sample = description.samples[i];
+            uint8_t* out = &dfd[28 + 16 * i];
+            std::memcpy(&out[0], &sample.bitOffset, 2);
+            out[2] = sample.bitLength - 1;
+            out[3] = sample.channel;
+            std::memcpy(&out[8], &sample.lower, 4);
+            std::memcpy(&out[12], &sample.upper, 4);
+        }
+        return dfd;
+    }
+
+    uint64_t alignUp(uint64_t value, uint64_t alignment) {
+        return (value + alignment - 1) / alignment * alignment;
+    }
+}
+
+Ktx2Texture parseKtx2(std::span<const uint8_t> data) {
+    if (data.size() < headerSize || std::memcmp(data.data(), identifier, sizeof(identifier)) != 0) {
+        throw std::runtime_error("The file is not a KTX 2.0 file.");
+    }
+
+    Header header{};
+    std::memcpy(&header, data.data(), sizeof(header));
+
+    std::optional<Format> format = formatOf(header.vkFormat);
+    if (!format.has_value()) {
+        throw std::runtime_error("The format of the KTX 2.0 texture is not supported: " +
+                                 std::to_string(header.vkFormat));
+    }
+    if (header.pixelWidth == 0 || header.pixelHeight == 0 || header.pixelDepth != 0 || header.layerCount != 0 ||
+        header.faceCount != 1) {
+        throw std::runtime_error("Only single 2d KTX 2.0 textures are supported.");
+    }
+    if (header.supercompressionScheme != 0) {
+        throw std::runtime_error("Supercompressed KTX 2.0 textures are not supported.");
+    }
+
+    // a level count of 0 asks for levels to be generated, which is left to the caller
+    uint32_t numLevels = std::max(header.levelCount, 1u);
+    if (numLevels > 32 || (std::max(header.pixelWidth, header.pixelHeight) >> (numLevels - 1)) == 0) {
+        throw std::runtime_error("The KTX 2.0 texture has more levels than its size allows.");
+    }
+    if (data.size() < headerSize + numLevels * levelIndexEntrySize) {
+        throw std::runtime_error("The KTX 2.0 file is truncated.");
+    }
+
+    Ktx2Texture texture{
+        .format = *format,
+        .width = header.pixelWidth,
+        .height = header.pixelHeight,
+    };
+    for (uint32_t level = 0; level < numLevels; level++) {
+        LevelIndexEntry entry{};
+        std::memcpy(&entry, data.data() + headerSize + level * levelIndexEntrySize, sizeof(entry));
+
+        uint32_t width = std::max(texture.width >> level, 1u);
+        uint32_t height = std::max(texture.height >> level, 1u);
+        if (entry.byteLength != imageSize(texture.format, width, height)) {
+            throw std::runtime_error("A level of the KTX 2.0 texture is not the size of its dimensions.");
+        }
+        if (entry.byteOffset > data.size() || entry.byteLength > data.size() - entry.byteOffset) {
+            throw std::runtime_error("The KTX 2.0 file is truncated.");
+        }
+        texture.levels.push_back(data.subspan(entry.byteOffset, entry.byteLength));
+    }
+
+    return texture;
+}
+
+std::vector<uint8_t> writeKtx2(Format format, uint32_t width, uint32_t height,
+                               const std::vector<std::vector<uint8_t>>& levels) {
+    if (width == 0 || height == 0 || levels.empty() || levels.size() > 32 ||
+        (std::max(width, height) >> (levels.size() - 1)) == 0) {
+        throw std::invalid_argument("A KTX 2.0 texture must have at least one level, each at least one pixel in size.");
+    }
+    for (size_t level = 0; level < levels.size(); level++) {
+        if (levels[level].size() != imageSize(format, std::max(width >> level, 1u), std::max(height >> level, 1u))) {
+            throw std::invalid_argument("A level must be the size of an image of its dimensions.");
+        }
+    }
+
+    FormatDescription description = describe(format);
+    std::vector<uint8_t> dfd = dataFormatDescriptor(format, description);
+
+    auto numLevels = (uint32_t)levels.size();
+    size_t dfdOffset = headerSize + numLevels * levelIndexEntrySize;
+    Header header{
+        .identifier = {},
+        .vkFormat = description.vkFormat,
+        .typeSize = description.typeSize,
+        .pixelWidth = width,
+        .pixelHeight = height,
+        .pixelDepth = 0,
+        .layerCount = 0,
+        .faceCount = 1,
+        .levelCount = numLevels,
+        .supercompressionScheme = 0,
+        .dfdByteOffset = (uint32_t)dfdOffset,
+        .dfdByteLength = (uint32_t)dfd.size(),
+        .kvdByteOffset = 0,
+        .kvdByteLength = 0,
+        .sgdByteOffset = 0,
+        .sgdByteLength = 0,
+    };
+
+    // levels are stored from the smallest to the largest, each aligned to both its blocks and 4 bytes
+    uint64_t alignment = std::lcm<uint64_t>(formatBlockSize(format), 4);
+    std::vector<LevelIndexEntry> levelIndex(numLevels);
+    uint64_t offset = dfdOffset + dfd.size();
+    for (uint32_t level = numLevels; level-- > 0;) {
+        offset = alignUp(offset, alignment);
+        levelIndex[level] = {offset, levels[level].size(), levels[level].size()};
+        offset += levels[level].size();
+    }
+
+    std::vector<uint8_t> file(offset, 0);
+    std::memcpy(header.identifier, identifier, sizeof(identifier));
+    std::memcpy(&file[0], &header, sizeof(header));
+    std::memcpy(&file[headerSize], levelIndex.data(), numLevels * levelIndexEntrySize);
+    std::memcpy(&file[dfdOffset], dfd.data(), dfd.size());
+    for (uint32_t level = 0; level < numLevels; level++) {
+        std::memcpy(&file[levelIndex[level].byteOffset], levels[level].data(), levels[level].size());
+    }
+    return file;
+}
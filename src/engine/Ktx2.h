@@ -0,0 +1,45 @@
+#ifndef OPENGL_RENDERER_KTX2_H
+#define OPENGL_RENDERER_KTX2_H
+
+#include <span>
+#include <vector>
+
+#include "../rhi/Format.h"
+
+/**
+ * A 2d texture stored in the KTX 2.0 container, whose levels are viewed in place within the memory that
+ * holds the file, so that they can be copied to staging memory without an intermediate buffer.
+ */
+struct Ktx2Texture {
+    Format format;
+    uint32_t width;
+    uint32_t height;
+    std::vector<std::span<const uint8_t>> levels; // from the largest level to the smallest
+};
+
+/**
+ * Reads the header and level index of a KTX 2.0 file holding a single 2d texture. Only formats that
+ * have a Format are supported, which excludes srgb formats, and levels must not be supercompressed.
+ *
+ * @param data the contents of the file, which must outlive the returned levels
+ * @returns the texture, with the levels stored in the file
+ * @throws std::runtime_error if the file is not a KTX 2.0 file, or holds a texture that is not supported
+ */
+Ktx2Texture parseKtx2(std::span<const uint8_t> data);
+
+/**
+ * Writes a 2d texture to a KTX 2.0 file, with a basic data format descriptor and no key/value data.
+ *
+ * @param format the format of the texture
+ * @param width the width of the texture, in pixels
+ * @param height the height of the texture, in pixels
+ * @param levels the pixels of each level with tightly packed rows, from the largest level to the smallest
+ * @returns the contents of the file
+ * @throws std::invalid_argument if a level is not the size of an image of its dimensions, or the format
+ *                               cannot be stored in a KTX 2.0 file
+ */
+std::vector<uint8_t> writeKtx2(Format format, uint32_t width, uint32_t height,
+                               const std::vector<std::vector<uint8_t>>& levels);
+
+
+#endif //OPENGL_RENDERER_KTX2_H
@@ -0,0 +1,25 @@
+#ifndef OPENGL_RENDERER_LIGHT_H
+#define OPENGL_RENDERER_LIGHT_H
+
+#include "../rhi/UniformLayout.h"
+
+/**
+ * A light that shines equally in all directions from a point, fading out to nothing at its radius.
+ * The struct matches the std430 layout of the lights read by shaders, so can be copied as is.
+ */
+struct PointLight {
+    Vec3 position; // in world space
+    float radius;
+    Vec3 color;
+    float intensity;
+};
+
+static_assert(hasBufferLayout<BufferLayout::Std430>(
+        BufferField(&PointLight::position, offsetof(PointLight, position)),
+        BufferField(&PointLight::radius, offsetof(PointLight, radius)),
+        BufferField(&PointLight::color, offsetof(PointLight, color)),
+        BufferField(&PointLight::intensity, offsetof(PointLight, intensity))),
+    "PointLight must follow the std430 layout.");
+
+
+#endif //OPENGL_RENDERER_LIGHT_H
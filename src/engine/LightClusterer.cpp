@@ -0,0 +1,265 @@
+#include "LightClusterer.h"
+
+#include <bit>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define LIGHT_CLUSTERER_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace {
+    // lights transformed and bounded by each task
+    constexpr uint32_t lightsPerTask = 256;
+
+    /**
+     * Finds the range of tiles overlapped by each of four spheres, given the planes between tiles.
+     * Empty ranges have a minimum greater than their maximum.
+     */
+    void findTileRange(const std::vector<Vec4>& planes, const float* x, const float* y, const float* z,
+                       const float* radius, int32_t* min, int32_t* max, [[maybe_unused]] bool vectorized) {
+        auto numTiles = (uint32_t)planes.size() - 1;
+
+#ifdef LIGHT_CLUSTERER_SSE2
+        if (vectorized) {
+            __m128 vx = _mm_loadu_ps(x), vy = _mm_loadu_ps(y), vz = _mm_loadu_ps(z);
+            __m128 vr = _mm_loadu_ps(radius);
+            __m128 negR = _mm_sub_ps(_mm_setzero_ps(), vr);
+
+            auto distance = [&](const Vec4& plane) {
+                __m128 d = _mm_add_ps(_mm_mul_ps(vx, _mm_set1_ps(plane.x)),
+                                      _mm_mul_ps(vy, _mm_set1_ps(plane.y)));
+                d = _mm_add_ps(d, _mm_mul_ps(vz, _mm_set1_ps(plane.z)));
+                return _mm_add_ps(d, _mm_set1_ps(plane.w));
+            };
+
+            // a sphere overlaps a tile unless it is entirely left of its left plane or right of its right
+            // plane
+            __m128 noTile = _mm_set1_ps((float)numTiles);
+            __m128 minTile = noTile;
+            __m128 noTileMax = _mm_set1_ps(-1.0f);
+            __m128 maxTile = noTileMax;
+            __m128 left = distance(planes[0]);
+            for (uint32_t tile = 0; tile < numTiles; tile++) {
+                __m128 right = distance(planes[tile + 1]);
+                __m128 overlaps = _mm_and_ps(_mm_cmpge_ps(left, negR), _mm_cmple_ps(right, vr));
+
+                __m128 index = _mm_set1_ps((float)tile);
+                minTile = _mm_min_ps(minTile,
+                                     _mm_or_ps(_mm_and_ps(overlaps, index), _mm_andnot_ps(overlaps, noTile)));
+                maxTile = _mm_max_ps(maxTile,
+                                     _mm_or_ps(_mm_and_ps(overlaps, index), _mm_andnot_ps(overlaps, noTileMax)));
+                left = right;
+            }
+
+            _mm_storeu_si128((__m128i*)min, _mm_cvttps_epi32(minTile));
+            _mm_storeu_si128((__m128i*)max, _mm_cvttps_epi32(maxTile));
+            return;
+        }
+#endif
+
+        for (uint32_t lane = 0; lane < 4; lane++) {
+            auto distance = [&](const Vec4& plane) {
+                return x[lane] * plane.x + y[lane] * plane.y + z[lane] * plane.z + plane.w;
+            };
+
+            min[lane] = (int32_t)numTiles;
+            max[lane] = -1;
+            float left = distance(planes[0]);
+            for (uint32_t tile = 0; tile < numTiles; tile++) {
+                float right = distance(planes[tile + 1]);
+                if (left >= -radius[lane] && right <= radius[lane]) {
+                    min[lane] = std::min(min[lane], (int32_t)tile);
+                    max[lane] = (int32_t)tile;
+                }
+                left = right;
+            }
+        }
+    }
+}
+
+LightClusterer::LightClusterer(uint32_t countX, uint32_t countY, uint32_t countZ)
+        : m_countX(countX), m_countY(countY), m_countZ(countZ), m_zNear(0.0f), m_zFar(0.0f),
+          m_depthScale(0.0f), m_depthBias(0.0f), m_vectorized(false),
+          m_sliceIndices(countZ), m_clusters(countX * countY * countZ) {
+    if (countX == 0 || countY == 0 || countZ == 0) {
+        throw std::invalid_argument("LightClusterer requires at least one cluster along each axis.");
+    }
+
+    setVectorized(true);
+}
+
+void LightClusterer::setVectorized(bool vectorized) {
+#ifdef LIGHT_CLUSTERER_SSE2
+    m_vectorized = vectorized;
+#else
+    m_vectorized = false;
+#endif
+}
+
+void LightClusterer::build(std::span<const PointLight> lights, const Mat4& view, const Mat4& projection,
+                           float zNear, float zFar, ThreadPool& pool) {
+    if (zNear <= 0.0f || zFar <= zNear) {
+        throw std::invalid_argument("LightClusterer requires 0 < zNear < zFar.");
+    }
+
+    m_zNear = zNear;
+    m_zFar = zFar;
+
+    // slices are spaced exponentially, so each is roughly as deep as it is wide
+    float logRatio = std::log(zFar / zNear);
+    m_depthScale = (float)m_countZ / logRatio;
+    m_depthBias = -(float)m_countZ * std::log(zNear) / logRatio;
+
+    // the planes between tiles pass through where clip space x (or y) equals a multiple of w
+    auto findPlanes = [&](std::vector<Vec4>& planes, uint32_t count, uint32_t row) {
+        planes.resize(count + 1);
+        Vec4 axis = projection.row(row);
+        Vec4 w = projection.row(3);
+        for (uint32_t i = 0; i <= count; i++) {
+            float ndc = -1.0f + 2.0f * (float)i / (float)count;
+            Vec4 plane = axis - w * ndc;
+            float length = std::sqrt(plane.x * plane.x + plane.y * plane.y + plane.z * plane.z);
+            planes[i] = plane * (1.0f / length);
+        }
+    };
+    findPlanes(m_planesX, m_countX, 0);
+    findPlanes(m_planesY, m_countY, 1);
+
+    // transform the lights to view space, padding with lights that never overlap any slice
+    auto numLights = (uint32_t)lights.size();
+    uint32_t numPadded = (numLights + 3) / 4 * 4;
+    for (auto* values: {&m_lightX, &m_lightY, &m_lightZ, &m_lightRadius}) {
+        values->assign(numPadded, 0.0f);
+    }
+    for (auto* values: {&m_minX, &m_maxX, &m_minY, &m_maxY}) {
+        values->resize(numPadded);
+    }
+    m_minZ.assign(numPadded, 1);
+    m_maxZ.assign(numPadded, 0);
+
+    uint32_t numTasks = (numPadded + lightsPerTask - 1) / lightsPerTask;
+    pool.parallelFor(numTasks, [&](uint32_t task) {
+        uint32_t first = task * lightsPerTask;
+        uint32_t last = std::min(first + lightsPerTask, numLights);
+        for (uint32_t i = first; i < last; i++) {
+            const Vec3& position = lights[i].position;
+            Vec4 viewPosition = view.column(0) * position.x + view.column(1) * position.y
+                                + view.column(2) * position.z + view.column(3);
+            m_lightX[i] = viewPosition.x;
+            m_lightY[i] = viewPosition.y;
+            m_lightZ[i] = viewPosition.z;
+            m_lightRadius[i] = lights[i].radius;
+        }
+
+        for (uint32_t i = first; i < std::min(first + lightsPerTask, numPadded); i += 4) {
+            findLightRanges(i);
+        }
+    });
+
+    // fill each slice separately, then join them into one list
+    pool.parallelFor(m_countZ, [&](uint32_t slice) {
+        fillSlice(slice);
+    });
+
+    uint32_t numClustersPerSlice = m_countX * m_countY;
+    uint32_t base = 0;
+    for (uint32_t slice = 0; slice < m_countZ; slice++) {
+        for (uint32_t i = 0; i < numClustersPerSlice; i++) {
+            m_clusters[slice * numClustersPerSlice + i].offset += base;
+        }
+        base += (uint32_t)m_sliceIndices[slice].size();
+    }
+
+    m_lightIndices.resize(base);
+    base = 0;
+    for (const std::vector<uint32_t>& indices: m_sliceIndices) {
+        std::copy(indices.begin(), indices.end(), m_lightIndices.begin() + base);
+        base += (uint32_t)indices.size();
+    }
+}
+
+void LightClusterer::findLightRanges(uint32_t first) {
+    findTileRange(m_planesX, &m_lightX[first], &m_lightY[first], &m_lightZ[first], &m_lightRadius[first],
+                  &m_minX[first], &m_maxX[first], m_vectorized);
+    findTileRange(m_planesY, &m_lightX[first], &m_lightY[first], &m_lightZ[first], &m_lightRadius[first],
+                  &m_minY[first], &m_maxY[first], m_vectorized);
+
+    for (uint32_t i = first; i < first + 4; i++) {
+        // lights with no radius are padding, or contribute nothing anyway
+        float radius = m_lightRadius[i];
+        float depth = -m_lightZ[i];
+        if (radius <= 0.0f || m_minX[i] > m_maxX[i] || m_minY[i] > m_maxY[i]) continue;
+
+        // the range of slices between the nearest and farthest depth of the sphere
+        float nearest = std::max(depth - radius, m_zNear);
+        float farthest = depth + radius;
+        if (farthest <= nearest || nearest >= m_zFar) continue;
+
+        auto lastSlice = (int32_t)m_countZ - 1;
+        m_minZ[i] = std::clamp((int32_t)std::floor(std::log(nearest) * m_depthScale + m_depthBias), 0, lastSlice);
+        m_maxZ[i] = std::clamp((int32_t)std::floor(std::log(farthest) * m_depthScale + m_depthBias), -1, lastSlice);
+    }
+}
+
+void LightClusterer::fillSlice(uint32_t slice) {
+    uint32_t numClustersPerSlice = m_countX * m_countY;
+    Cluster* clusters = &m_clusters[slice * numClustersPerSlice];
+    std::fill(clusters, clusters + numClustersPerSlice, Cluster{0, 0});
+
+    // find the lights overlapping the slice, four at a time
+    auto forEachLight = [&](auto&& func) {
+        auto numPadded = (uint32_t)m_minZ.size();
+#ifdef LIGHT_CLUSTERER_SSE2
+        if (m_vectorized) {
+            __m128i index = _mm_set1_epi32((int32_t)slice);
+            for (uint32_t first = 0; first < numPadded; first += 4) {
+                __m128i minZ = _mm_loadu_si128((const __m128i*)&m_minZ[first]);
+                __m128i maxZ = _mm_loadu_si128((const __m128i*)&m_maxZ[first]);
+                __m128i outside = _mm_or_si128(_mm_cmpgt_epi32(minZ, index), _mm_cmpgt_epi32(index, maxZ));
+                auto inside = (uint32_t)(~_mm_movemask_ps(_mm_castsi128_ps(outside)) & 0xF);
+                while (inside != 0) {
+                    func(first + std::countr_zero(inside));
+                    inside &= inside - 1;
+                }
+            }
+            return;
+        }
+#endif
+
+        for (uint32_t i = 0; i < numPadded; i++) {
+            if (m_minZ[i] <= (int32_t)slice && (int32_t)slice <= m_maxZ[i]) {
+                func(i);
+            }
+        }
+    };
+
+    // count the lights in each cluster, then give each cluster its range and fill them
+    forEachLight([&](uint32_t light) {
+        for (int32_t y = m_minY[light]; y <= m_maxY[light]; y++) {
+            for (int32_t x = m_minX[light]; x <= m_maxX[light]; x++) {
+                Cluster& cluster = clusters[y * m_countX + x];
+                cluster.count = std::min(cluster.count + 1, maxLightsPerCluster);
+            }
+        }
+    });
+
+    uint32_t offset = 0;
+    for (uint32_t i = 0; i < numClustersPerSlice; i++) {
+        clusters[i].offset = offset;
+        offset += clusters[i].count;
+        clusters[i].count = 0;
+    }
+
+    std::vector<uint32_t>& indices = m_sliceIndices[slice];
+    indices.resize(offset);
+    forEachLight([&](uint32_t light) {
+        for (int32_t y = m_minY[light]; y <= m_maxY[light]; y++) {
+            for (int32_t x = m_minX[light]; x <= m_maxX[light]; x++) {
+                Cluster& cluster = clusters[y * m_countX + x];
+                if (cluster.count < maxLightsPerCluster) {
+                    indices[cluster.offset + cluster.count++] = light;
+                }
+            }
+        }
+    });
+}
@@ -0,0 +1,144 @@
+#ifndef OPENGL_RENDERER_LIGHTCLUSTERER_H
+#define OPENGL_RENDERER_LIGHTCLUSTERER_H
+
+#include "../util/Vector.h"
+#include "../util/Matrix.h"
+#include "../util/ThreadPool.h"
+#include "Light.h"
+
+/**
+ * Bins lights into clusters of the view frustum, so that shading only considers the lights that can
+ * reach each cluster.
+ *
+ * The frustum is divided into a grid of tiles on screen, and each tile into slices of view depth that
+ * grow exponentially with distance. Each light's range of tiles and slices is found by testing its
+ * bounding sphere against the planes between tiles, four lights at a time with SSE2 where available.
+ * Slices are then filled in parallel, giving each cluster a contiguous range of a shared list of light
+ * indices.
+ */
+class LightClusterer {
+public:
+    /**
+     * A range of the light index list.
+     */
+    struct Cluster {
+        uint32_t offset;
+        uint32_t count;
+    };
+
+    /**
+     * Constructs a light clusterer with the given number of clusters along each axis.
+     *
+     * @param countX the number of tiles across the screen
+     * @param countY the number of tiles up the screen
+     * @param countZ the number of depth slices
+     */
+    LightClusterer(uint32_t countX, uint32_t countY, uint32_t countZ);
+
+    /**
+     * Bins the lights into clusters for the given view.
+     *
+     * @param lights the lights to bin
+     * @param view the view matrix, looking down the -z axis
+     * @param projection the projection matrix
+     * @param zNear the distance to the near plane, must be positive
+     * @param zFar the distance to the far plane, must be greater than zNear
+     * @param pool the thread pool to bin with
+     */
+    void build(std::span<const PointLight> lights, const Mat4& view, const Mat4& projection, float zNear,
+               float zFar, ThreadPool& pool);
+
+    /**
+     * Sets whether lights are binned with SSE2, which is the default where it is available, or one lane at
+     * a time. Both give the same clusters, so this only serves to compare their speed.
+     *
+     * @param vectorized whether to bin with SSE2, which is ignored if it is not available
+     */
+    void setVectorized(bool vectorized);
+
+    /**
+     * @returns whether lights are binned with SSE2
+     */
+    bool isVectorized() const {
+        return m_vectorized;
+    }
+
+    /**
+     * @returns the clusters, ordered by x, then y (up the screen), then depth slice
+     */
+    const std::vector<Cluster>& clusters() const {
+        return m_clusters;
+    }
+
+    /**
+     * @returns the indices of the lights in each cluster
+     */
+    const std::vector<uint32_t>& lightIndices() const {
+        return m_lightIndices;
+    }
+
+    /**
+     * @returns the number of clusters along each axis
+     */
+    Vector<uint32_t, 3> dimensions() const {
+        return {m_countX, m_countY, m_countZ};
+    }
+
+    /**
+     * The depth slice of a view depth d is floor(log(d) * scale + bias).
+     *
+     * @returns the scale of the depth slicing
+     */
+    float depthScale() const {
+        return m_depthScale;
+    }
+
+    /**
+     * @returns the bias of the depth slicing
+     */
+    float depthBias() const {
+        return m_depthBias;
+    }
+
+    /**
+     * The maximum number of lights in a single cluster. Further lights are dropped from the cluster.
+     */
+    static constexpr uint32_t maxLightsPerCluster = 256;
+
+private:
+    /**
+     * Finds the ranges of clusters overlapped by a group of four lights.
+     *
+     * @param first the index of the first light in the group
+     */
+    void findLightRanges(uint32_t first);
+
+    /**
+     * Fills the clusters of a depth slice with the lights overlapping them.
+     *
+     * @param slice the index of the depth slice
+     */
+    void fillSlice(uint32_t slice);
+
+    uint32_t m_countX;
+    uint32_t m_countY;
+    uint32_t m_countZ;
+    float m_zNear;
+    float m_zFar;
+    float m_depthScale;
+    float m_depthBias;
+    bool m_vectorized;
+    std::vector<Vec4> m_planesX; // the planes between tiles across the screen, facing right
+    std::vector<Vec4> m_planesY; // the planes between tiles up the screen, facing up
+
+    // view space bounding spheres and cluster ranges of each light, padded to a multiple of four
+    std::vector<float> m_lightX, m_lightY, m_lightZ, m_lightRadius;
+    std::vector<int32_t> m_minX, m_maxX, m_minY, m_maxY, m_minZ, m_maxZ;
+
+    std::vector<std::vector<uint32_t>> m_sliceIndices; // per depth slice, reused between frames
+    std::vector<Cluster> m_clusters;
+    std::vector<uint32_t> m_lightIndices;
+};
+
+
+#endif //OPENGL_RENDERER_LIGHTCLUSTERER_H
@@ -1,6 +1,7 @@
 #include "Material.h"
 #include "StaticMeshLoader.h"
 #include "ShaderLoader.h"
+#include "../rhi/PipelineCache.h"
 
 std::shared_ptr<Material> Material::createDefault() {
     RHI& rhi = RHI::current();
@@ -13,17 +14,19 @@ std::shared_ptr<Material> Material::createDefault() {
         })
     };
 
-    VertexLayout layout(std::move(bindings));
-
-    std::unique_ptr<Shader> vertShader = shaderFromFile("../shaders/shader.vert");
-    std::unique_ptr<Shader> fragShader = shaderFromFile("../shaders/shader.frag");
+    // meshes are closed, so their back faces are always hidden behind their front faces
+    PipelineDescription description{
+        .vertexShader = shaderSourceFromFile("../shaders/shader.vert"),
+        .fragmentShader = shaderSourceFromFile("../shaders/shader.frag"),
+        .vertexLayout = VertexLayout(std::move(bindings)),
+        .topology = Topology::Triangles,
+        .rasterState = RasterState{.cullMode = CullMode::Back},
+    };
+    std::shared_ptr<Pipeline> pipeline = rhi.pipelineCache().get(description);
 
-    std::unique_ptr<Pipeline> pipeline = rhi.createPipelineBuilder()
-        ->setTopology(Topology::Triangles)
-        ->setVertexLayout(layout)
-        ->setVertexShader(*vertShader)
-        ->setFragmentShader(*fragShader)
-        ->build();
+    // shades meshes whose depth was already written by a pre-pass, so only the visible fragments are shaded
+    description.depthState = DepthState{.testEnabled = true, .writeEnabled = false, .compareOp = CompareOp::Equal};
+    std::shared_ptr<Pipeline> depthEqualPipeline = rhi.pipelineCache().get(description);
 
-    return std::make_shared<Material>(std::move(pipeline));
+    return std::make_shared<Material>(std::move(pipeline), std::move(depthEqualPipeline));
 }
@@ -2,20 +2,47 @@
 #define OPENGL_RENDERER_MATERIAL_H
 
 #include "../rhi/RHI.h"
+#include "../rhi/UniformLayout.h"
+#include "../rhi/UniformRing.h"
+
+/**
+ * The per-draw uniforms of a material, laid out to match the std140 DrawUniforms block of its shaders.
+ */
+struct DrawUniforms {
+    Mat4 modelViewProjection;
+    Mat4 model;
+};
+
+static_assert(hasBufferLayout<BufferLayout::Std140>(
+        BufferField(&DrawUniforms::modelViewProjection, offsetof(DrawUniforms, modelViewProjection)),
+        BufferField(&DrawUniforms::model, offsetof(DrawUniforms, model))),
+    "DrawUniforms must follow the std140 layout.");
 
 /**
  * A material that references a rendering pipeline, and contains any uniform and texture data
- * to be used by the pipeline.
+ * to be used by the pipeline. Lights are not part of the material, and are bound by the renderer
+ * for the whole frame.
+ *
+ * A material may also have a variant of its pipeline that tests for equal depth without writing it,
+ * used to shade opaque meshes after their depth has been laid down by a depth pre-pass.
  */
 class Material {
 public:
-    explicit Material(std::shared_ptr<Pipeline> pipeline)
-        : m_pipeline(std::move(pipeline)), m_descriptorSet(RHI::current().createDescriptorSet({})) {
+    explicit Material(std::shared_ptr<Pipeline> pipeline, std::shared_ptr<Pipeline> depthEqualPipeline = nullptr)
+        : m_pipeline(std::move(pipeline)), m_depthEqualPipeline(std::move(depthEqualPipeline)),
+          m_descriptorSet(RHI::current().createDescriptorSet({})) {
         if (m_pipeline == nullptr) {
             throw std::invalid_argument("Material requires a valid pipeline.");
         }
     }
 
+    /**
+     * @returns whether the material can be shaded after a depth pre-pass, testing for equal depth
+     */
+    bool hasDepthEqualPipeline() const {
+        return m_depthEqualPipeline != nullptr;
+    }
+
     /**
      * Sets the model view projection matrix for the material, if one exists. The matrix is
      * generally used to compute vertex positions, but the material is not required to use it.
@@ -23,40 +50,60 @@ public:
      * @param modelViewProjection the model view projection matrix
      */
     virtual void setModelViewProjection(const Mat4& modelViewProjection) {
-        m_modelViewProjection = modelViewProjection;
+        m_uniforms.modelViewProjection = modelViewProjection;
     }
 
     /**
-     * Sets the lights for the material. The lights are generally used for computing final
-     * fragment color, but the material is not required to use all, or even any, of the lights.
+     * Sets the model matrix for the material, if one exists. The matrix is generally used to
+     * find world space positions for lighting, but the material is not required to use it.
      *
-     * @param lightPositions the positions of each light to use
+     * @param model the model matrix
      */
-    virtual void setLights(const std::vector<Vec3>& lightPositions) {
-        if (!lightPositions.empty()) {
-            m_lightPosition = lightPositions[0];
-        }
+    virtual void setModel(const Mat4& model) {
+        m_uniforms.model = model;
     }
 
     /**
-     * Binds the material to be used for rendering.
+     * Binds the material to be used for rendering. The material's uniforms are written to the
+     * current frame of the given uniform ring.
+     *
+     * @param uniformRing the uniform ring to write the material's uniforms to
      */
-    virtual void bind() const {
+    virtual void bind(UniformRing& uniformRing) const {
         RHI& rhi = RHI::current();
 
         rhi.bindPipeline(*m_pipeline);
 
-        std::vector<Uniform*> uniforms = {
-            MatrixUniform<4, 4>::make(m_modelViewProjection),
-            VectorUniform<float, 3>::make(m_lightPosition)
-        };
-
-        UniformBlock uniformBlock(std::move(uniforms));
-        rhi.bindUniforms(uniformBlock);
+        uniformRing.bind(m_uniforms);
 
         rhi.bindDescriptorSet(*m_descriptorSet);
     };
 
+    /**
+     * Records binding the material with the given parameters, leaving the material's own parameters
+     * unchanged. Unlike the setters and bind(), this may be called from multiple threads at once.
+     *
+     * @param commandList the command list to record the binds in
+     * @param uniformRing the uniform ring to write the material's uniforms to
+     * @param model the model matrix
+     * @param modelViewProjection the model view projection matrix
+     * @param depthEqual whether to use the depth-equal pipeline, which the material must have
+     */
+    virtual void record(CommandList& commandList, UniformRing& uniformRing, const Mat4& model,
+                        const Mat4& modelViewProjection, bool depthEqual = false) const {
+        if (depthEqual && m_depthEqualPipeline == nullptr) {
+            throw std::invalid_argument("Material does not have a depth-equal pipeline.");
+        }
+
+        DrawUniforms uniforms = m_uniforms;
+        uniforms.modelViewProjection = modelViewProjection;
+        uniforms.model = model;
+
+        commandList.bindPipeline(depthEqual ? *m_depthEqualPipeline : *m_pipeline);
+        uniformRing.record(commandList, uniforms);
+        commandList.bindDescriptorSet(*m_descriptorSet);
+    }
+
     /**
      * Creates a default material that (describe the rendering)
      *
@@ -66,9 +113,9 @@ public:
 
 private:
     std::shared_ptr<Pipeline> m_pipeline;
+    std::shared_ptr<Pipeline> m_depthEqualPipeline;
     std::unique_ptr<DescriptorSet> m_descriptorSet;
-    Vec3 m_lightPosition;
-    Mat4 m_modelViewProjection;
+    DrawUniforms m_uniforms{};
 };
 
 
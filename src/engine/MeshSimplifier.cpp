@@ -0,0 +1,284 @@
+#include "MeshSimplifier.h"
+
+#include <algorithm>
+#include <unordered_map>
+
+void MeshSimplifier::Quadric::addPlane(double a, double b, double c, double d) {
+    a2 += a * a; ab += a * b; ac += a * c; ad += a * d;
+    b2 += b * b; bc += b * c; bd += b * d;
+    c2 += c * c; cd += c * d;
+    d2 += d * d;
+}
+
+void MeshSimplifier::Quadric::add(const Quadric& other) {
+    a2 += other.a2; ab += other.ab; ac += other.ac; ad += other.ad;
+    b2 += other.b2; bc += other.bc; bd += other.bd;
+    c2 += other.c2; cd += other.cd;
+    d2 += other.d2;
+}
+
+double MeshSimplifier::Quadric::error(const Vec3& point) const {
+    double x = point.x, y = point.y, z = point.z;
+    double error = a2 * x * x + 2 * ab * x * y + 2 * ac * x * z + 2 * ad * x
+                 + b2 * y * y + 2 * bc * y * z + 2 * bd * y
+                 + c2 * z * z + 2 * cd * z
+                 + d2;
+
+    // rounding can make the error slightly negative
+    return std::max(error, 0.0);
+}
+
+MeshSimplifier::MeshSimplifier(const float* positions, const float* normals, uint32_t stride, uint32_t numVertices)
+        : m_positions(reinterpret_cast<const unsigned char*>(positions)),
+          m_normals(reinterpret_cast<const unsigned char*>(normals)), m_stride(stride), m_numVertices(numVertices),
+          m_canonical(numVertices), m_siblingOffsets(numVertices + 1, 0), m_siblings(numVertices) {
+    struct PositionKey {
+        uint32_t x, y, z;
+
+        bool operator==(const PositionKey& rhs) const {
+            return x == rhs.x && y == rhs.y && z == rhs.z;
+        }
+    };
+
+    struct PositionHash {
+        size_t operator()(const PositionKey& key) const {
+            return (key.x * 73856093u) ^ (key.y * 19349663u) ^ (key.z * 83492791u);
+        }
+    };
+
+    // weld vertices by exact position, so that attribute seams do not split the surface
+    std::unordered_map<PositionKey, uint32_t, PositionHash> firstWithPosition;
+    firstWithPosition.reserve(numVertices);
+    for (uint32_t vertex = 0; vertex < numVertices; vertex++) {
+        PositionKey key{};
+        std::memcpy(&key, m_positions + vertex * m_stride, sizeof(key));
+        auto [iter, inserted] = firstWithPosition.try_emplace(key, vertex);
+        m_canonical[vertex] = iter->second;
+        m_siblingOffsets[iter->second + 1]++;
+    }
+
+    // group the vertices sharing each position
+    for (uint32_t vertex = 0; vertex < numVertices; vertex++) {
+        m_siblingOffsets[vertex + 1] += m_siblingOffsets[vertex];
+    }
+    std::vector<uint32_t> fill(m_siblingOffsets.begin(), m_siblingOffsets.end() - 1);
+    for (uint32_t vertex = 0; vertex < numVertices; vertex++) {
+        m_siblings[fill[m_canonical[vertex]]++] = vertex;
+    }
+}
+
+Vec3 MeshSimplifier::position(uint32_t vertex) const {
+    Vec3 position;
+    std::memcpy(&position, m_positions + vertex * m_stride, sizeof(Vec3));
+    return position;
+}
+
+Vec3 MeshSimplifier::normal(uint32_t vertex) const {
+    Vec3 normal;
+    std::memcpy(&normal, m_normals + vertex * m_stride, sizeof(Vec3));
+    return normal;
+}
+
+std::vector<uint32_t> MeshSimplifier::simplify(const std::vector<uint32_t>& indices, uint32_t targetIndexCount,
+                                               float targetError, float* resultError) const {
+    // triangles are simplified in terms of welded vertices, remembering the original corners
+    std::vector<uint32_t> corners = indices;
+    std::vector<uint32_t> welded(indices.size());
+    for (size_t i = 0; i < indices.size(); i++) {
+        welded[i] = m_canonical[indices[i]];
+    }
+
+    struct Collapse {
+        uint32_t source;
+        uint32_t target;
+        double cost;
+    };
+
+    std::vector<Quadric> quadrics(m_numVertices);
+    std::vector<uint32_t> triangleOffsets(m_numVertices + 1);
+    std::vector<uint32_t> triangles;
+    std::vector<uint64_t> edges;
+    std::vector<Collapse> collapses;
+    std::vector<uint32_t> collapsedTo(m_numVertices);
+    std::vector<bool> locked(m_numVertices);
+    std::vector<bool> touched(m_numVertices);
+
+    float error = 0.0f;
+    while (welded.size() > targetIndexCount) {
+        uint32_t numTriangles = welded.size() / 3;
+
+        // accumulate the planes of adjacent triangles into each vertex's quadric
+        std::fill(quadrics.begin(), quadrics.end(), Quadric{});
+        for (uint32_t t = 0; t < numTriangles; t++) {
+            Vec3 p0 = position(welded[3 * t]);
+            Vec3 n = (position(welded[3 * t + 1]) - p0).cross(position(welded[3 * t + 2]) - p0);
+            float length = std::sqrt(n.dot(n));
+            if (length == 0.0f) continue;
+            n = n * (1.0f / length);
+
+            Quadric plane{};
+            plane.addPlane(n.x, n.y, n.z, -n.dot(p0));
+            for (uint32_t i = 0; i < 3; i++) {
+                quadrics[welded[3 * t + i]].add(plane);
+            }
+        }
+
+        // list the triangles adjacent to each vertex
+        std::fill(triangleOffsets.begin(), triangleOffsets.end(), 0);
+        for (uint32_t vertex: welded) {
+            triangleOffsets[vertex + 1]++;
+        }
+        for (uint32_t vertex = 0; vertex < m_numVertices; vertex++) {
+            triangleOffsets[vertex + 1] += triangleOffsets[vertex];
+        }
+        triangles.resize(welded.size());
+        std::vector<uint32_t> fill(triangleOffsets.begin(), triangleOffsets.end() - 1);
+        for (uint32_t i = 0; i < welded.size(); i++) {
+            triangles[fill[welded[i]]++] = i / 3;
+        }
+
+        // find the unique edges, locking vertices on open borders so the silhouette is kept
+        edges.clear();
+        for (uint32_t t = 0; t < numTriangles; t++) {
+            for (uint32_t i = 0; i < 3; i++) {
+                uint32_t a = welded[3 * t + i];
+                uint32_t b = welded[3 * t + (i + 1) % 3];
+                edges.push_back((uint64_t)std::min(a, b) << 32 | std::max(a, b));
+            }
+        }
+        std::sort(edges.begin(), edges.end());
+        std::fill(locked.begin(), locked.end(), false);
+        for (size_t i = 0; i < edges.size();) {
+            size_t run = i + 1;
+            while (run < edges.size() && edges[run] == edges[i]) run++;
+            if (run - i == 1) {
+                locked[edges[i] >> 32] = true;
+                locked[edges[i] & 0xFFFFFFFF] = true;
+            }
+            i = run;
+        }
+        edges.erase(std::unique(edges.begin(), edges.end()), edges.end());
+
+        // rank every edge by the cheapest direction it can be collapsed in
+        collapses.clear();
+        for (uint64_t edge: edges) {
+            auto a = (uint32_t)(edge >> 32);
+            auto b = (uint32_t)(edge & 0xFFFFFFFF);
+            if (locked[a] && locked[b]) continue;
+
+            Quadric quadric = quadrics[a];
+            quadric.add(quadrics[b]);
+            double costToB = locked[a] ? INFINITY : quadric.error(position(b));
+            double costToA = locked[b] ? INFINITY : quadric.error(position(a));
+            if (costToB <= costToA) {
+                collapses.push_back({a, b, costToB});
+            } else {
+                collapses.push_back({b, a, costToA});
+            }
+        }
+        std::sort(collapses.begin(), collapses.end(), [](const Collapse& lhs, const Collapse& rhs) {
+            return lhs.cost < rhs.cost;
+        });
+
+        // greedily apply the cheapest collapses that do not overlap each other
+        for (uint32_t vertex = 0; vertex < m_numVertices; vertex++) {
+            collapsedTo[vertex] = vertex;
+        }
+        std::fill(touched.begin(), touched.end(), false);
+        uint32_t remainingTriangles = numTriangles;
+        uint32_t numCollapses = 0;
+        double passCost = 0.0;
+        for (const Collapse& collapse: collapses) {
+            if (remainingTriangles * 3 <= targetIndexCount) break;
+            if (error + (float)std::sqrt(collapse.cost) > targetError) break;
+            if (touched[collapse.source] || touched[collapse.target]) continue;
+
+            // reject the collapse if it would flip any of the surrounding triangles
+            bool flips = false;
+            uint32_t removedTriangles = 0;
+            Vec3 source = position(collapse.source);
+            Vec3 target = position(collapse.target);
+            for (uint32_t i = triangleOffsets[collapse.source]; i < triangleOffsets[collapse.source + 1]; i++) {
+                const uint32_t* triangle = &welded[3 * triangles[i]];
+                if (triangle[0] == collapse.target || triangle[1] == collapse.target ||
+                    triangle[2] == collapse.target) {
+                    removedTriangles++;
+                    continue;
+                }
+
+                // rotate the triangle so that the source is the first corner
+                uint32_t first = triangle[0] == collapse.source ? 0 : (triangle[1] == collapse.source ? 1 : 2);
+                Vec3 p1 = position(triangle[(first + 1) % 3]);
+                Vec3 p2 = position(triangle[(first + 2) % 3]);
+                Vec3 before = (p1 - source).cross(p2 - source);
+                Vec3 after = (p1 - target).cross(p2 - target);
+                if (before.dot(after) <= 0.0f) {
+                    flips = true;
+                    break;
+                }
+            }
+            if (flips) continue;
+
+            collapsedTo[collapse.source] = collapse.target;
+            for (uint32_t i = triangleOffsets[collapse.source]; i < triangleOffsets[collapse.source + 1]; i++) {
+                for (uint32_t j = 0; j < 3; j++) {
+                    touched[welded[3 * triangles[i] + j]] = true;
+                }
+            }
+            remainingTriangles -= removedTriangles;
+            passCost = std::max(passCost, collapse.cost);
+            numCollapses++;
+        }
+
+        if (numCollapses == 0) break;
+        error += (float)std::sqrt(passCost);
+
+        // rebuild the triangles, dropping the ones that collapsed to a line
+        uint32_t kept = 0;
+        for (uint32_t t = 0; t < numTriangles; t++) {
+            uint32_t a = collapsedTo[welded[3 * t]];
+            uint32_t b = collapsedTo[welded[3 * t + 1]];
+            uint32_t c = collapsedTo[welded[3 * t + 2]];
+            if (a == b || b == c || c == a) continue;
+
+            welded[3 * kept] = a;
+            welded[3 * kept + 1] = b;
+            welded[3 * kept + 2] = c;
+            for (uint32_t i = 0; i < 3; i++) {
+                corners[3 * kept + i] = corners[3 * t + i];
+            }
+            kept++;
+        }
+        welded.resize(3 * kept);
+        corners.resize(3 * kept);
+    }
+
+    // moved corners take the vertex at their new position with the most similar normal
+    std::vector<uint32_t> result(welded.size());
+    for (size_t i = 0; i < welded.size(); i++) {
+        uint32_t corner = corners[i];
+        if (m_canonical[corner] == welded[i]) {
+            result[i] = corner;
+            continue;
+        }
+
+        uint32_t best = welded[i];
+        if (m_normals != nullptr) {
+            float bestSimilarity = -INFINITY;
+            Vec3 cornerNormal = normal(corner);
+            for (uint32_t j = m_siblingOffsets[welded[i]]; j < m_siblingOffsets[welded[i] + 1]; j++) {
+                float similarity = cornerNormal.dot(normal(m_siblings[j]));
+                if (similarity > bestSimilarity) {
+                    bestSimilarity = similarity;
+                    best = m_siblings[j];
+                }
+            }
+        }
+        result[i] = best;
+    }
+
+    if (resultError != nullptr) {
+        *resultError = error;
+    }
+    return result;
+}
@@ -0,0 +1,62 @@
+#ifndef OPENGL_RENDERER_MESHSIMPLIFIER_H
+#define OPENGL_RENDERER_MESHSIMPLIFIER_H
+
+#include "../util/Vector.h"
+
+/**
+ * Simplifies indexed triangle meshes using quadric error metric edge collapses. Vertices are
+ * only ever collapsed onto existing vertices, so simplified meshes reuse the original vertex
+ * buffer and only a new index buffer is produced.
+ */
+class MeshSimplifier {
+public:
+    /**
+     * Constructs a simplifier for the given vertices. The vertex data must outlive the simplifier.
+     *
+     * @param positions a pointer to the position of the first vertex, as three floats
+     * @param normals a pointer to the normal of the first vertex, as three floats, or nullptr if none exist
+     * @param stride the distance between consecutive vertices, in bytes
+     * @param numVertices the number of vertices
+     */
+    MeshSimplifier(const float* positions, const float* normals, uint32_t stride, uint32_t numVertices);
+
+    /**
+     * Simplifies the triangles given by the indices until at most the target number of indices remain,
+     * or no collapse can be made without exceeding the target error.
+     *
+     * @param indices the indices of the triangles to simplify
+     * @param targetIndexCount the number of indices to simplify down to
+     * @param targetError the maximum geometric error allowed for the simplified mesh, in model units
+     * @param resultError the geometric error of the simplified mesh, in model units, written if not nullptr
+     * @returns the indices of the simplified triangles
+     */
+    std::vector<uint32_t> simplify(const std::vector<uint32_t>& indices, uint32_t targetIndexCount,
+                                   float targetError, float* resultError = nullptr) const;
+
+private:
+    /**
+     * A symmetric 4x4 matrix that measures the sum of squared distances to a set of planes.
+     */
+    struct Quadric {
+        double a2, ab, ac, ad, b2, bc, bd, c2, cd, d2;
+
+        void addPlane(double a, double b, double c, double d);
+        void add(const Quadric& other);
+        double error(const Vec3& point) const;
+    };
+
+    Vec3 position(uint32_t vertex) const;
+    Vec3 normal(uint32_t vertex) const;
+
+    const unsigned char* m_positions;
+    const unsigned char* m_normals;
+    uint32_t m_stride;
+    uint32_t m_numVertices;
+
+    std::vector<uint32_t> m_canonical; // maps each vertex to the first vertex sharing its position
+    std::vector<uint32_t> m_siblingOffsets; // offset of each canonical vertex's siblings in m_siblings
+    std::vector<uint32_t> m_siblings; // vertices grouped by the canonical vertex they share a position with
+};
+
+
+#endif //OPENGL_RENDERER_MESHSIMPLIFIER_H
@@ -0,0 +1,152 @@
+#include "MipGenerator.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define MIP_GENERATOR_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace {
+    constexpr uint32_t linearSteps = 8191; // linear values are encoded through a table of this many steps
+
+    float srgbToLinear(float value) {
+        return value <= 0.04045f ? value / 12.92f : std::pow((value + 0.055f) / 1.055f, 2.4f);
+    }
+
+    float linearToSrgb(float value) {
+        return value <= 0.0031308f ? value * 12.92f : 1.055f * std::pow(value, 1.0f / 2.4f) - 0.055f;
+    }
+
+    /**
+     * The tables that convert between srgb encoded bytes and linear values, built once on first use.
+     */
+    struct SrgbTables {
+        float toLinear[256];
+        uint8_t toSrgb[linearSteps + 1];
+
+        SrgbTables() : toLinear(), toSrgb() {
+            for (uint32_t i = 0; i < 256; i++) {
+                toLinear[i] = srgbToLinear((float)i / 255.0f);
+            }
+            for (uint32_t i = 0; i <= linearSteps; i++) {
+                toSrgb[i] = (uint8_t)std::lround(linearToSrgb((float)i / linearSteps) * 255.0f);
+            }
+        }
+
+        static const SrgbTables& get() {
+            static const SrgbTables tables;
+            return tables;
+        }
+    };
+
+    /**
+     * @param size the size of a level along an axis
+     * @param half the index of a texel of the next level along the axis
+     * @returns how many texels of the level are averaged into the texel, folding in the last of an odd size
+     */
+    uint32_t boxSize(uint32_t size, uint32_t half) {
+        if (size == 1) {
+            return 1;
+        }
+        return size % 2 == 1 && half == size / 2 - 1 ? 3 : 2;
+    }
+
+    /**
+     * Halves the size of a level of rgba pixels, averaging each 2x2 box.
+     */
+    std::vector<float> halve(const std::vector<float>& pixels, uint32_t width, uint32_t height) {
+        uint32_t halfWidth = std::max(width / 2, 1u);
+        uint32_t halfHeight = std::max(height / 2, 1u);
+        std::vector<float> half((size_t)halfWidth * halfHeight * 4);
+
+        for (uint32_t y = 0; y < halfHeight; y++) {
+            uint32_t numRows = boxSize(height, y);
+            float* out = &half[(size_t)y * halfWidth * 4];
+            for (uint32_t x = 0; x < halfWidth; x++) {
+                uint32_t numColumns = boxSize(width, x);
+                float weight = 1.0f / (float)(numRows * numColumns);
+#ifdef MIP_GENERATOR_SSE2
+                // the four channels of a pixel are filtered together
+                __m128 sum = _mm_setzero_ps();
+                for (uint32_t row = 0; row < numRows; row++) {
+                    const float* in = &pixels[((size_t)(y * 2 + row) * width + x * 2) * 4];
+                    for (uint32_t column = 0; column < numColumns; column++) {
+                        sum = _mm_add_ps(sum, _mm_loadu_ps(in + column * 4));
+                    }
+                }
+                _mm_storeu_ps(out + x * 4, _mm_mul_ps(sum, _mm_set1_ps(weight)));
+#else
+                float sum[4] = {};
+                for (uint32_t row = 0; row < numRows; row++) {
+                    const float* in = &pixels[((size_t)(y * 2 + row) * width + x * 2) * 4];
+                    for (uint32_t column = 0; column < numColumns; column++) {
+                        for (uint32_t c = 0; c < 4; c++) {
+                            sum[c] += in[column * 4 + c];
+                        }
+                    }
+                }
+                for (uint32_t c = 0; c < 4; c++) {
+                    out[x * 4 + c] = sum[c] * weight;
+                }
+#endif
+            }
+        }
+        return half;
+    }
+
+    /**
+     * Encodes a level of rgba pixels as rgba8, rounding each channel to a byte.
+     */
+    std::vector<uint8_t> encode(const std::vector<float>& pixels) {
+        std::vector<uint8_t> encoded(pixels.size());
+        for (size_t i = 0; i < pixels.size(); i++) {
+            encoded[i] = (uint8_t)std::lround(std::clamp(pixels[i], 0.0f, 1.0f) * 255.0f);
+        }
+        return encoded;
+    }
+
+    /**
+     * Encodes a level of linear rgba pixels as rgba8, with srgb encoded colors.
+     */
+    std::vector<uint8_t> encodeSrgb(const std::vector<float>& pixels) {
+        const SrgbTables& tables = SrgbTables::get();
+        std::vector<uint8_t> encoded(pixels.size());
+
+        for (size_t i = 0; i < pixels.size(); i += 4) {
+            int32_t steps[4];
+#ifdef MIP_GENERATOR_SSE2
+            // colors are rounded to a step of the encoding table, and alpha to a byte
+            __m128 scale = _mm_setr_ps((float)linearSteps, (float)linearSteps, (float)linearSteps, 255.0f);
+            __m128 value = _mm_min_ps(_mm_max_ps(_mm_loadu_ps(&pixels[i]), _mm_setzero_ps()), _mm_set1_ps(1.0f));
+            _mm_storeu_si128((__m128i*)steps, _mm_cvtps_epi32(_mm_mul_ps(value, scale)));
+#else
+            for (uint32_t c = 0; c < 4; c++) {
+                float scale = c < 3 ? (float)linearSteps : 255.0f;
+                steps[c] = (int32_t)std::lround(std::clamp(pixels[i + c], 0.0f, 1.0f) * scale);
+            }
+#endif
+            encoded[i] = tables.toSrgb[steps[0]];
+            encoded[i + 1] = tables.toSrgb[steps[1]];
+            encoded[i + 2] = tables.toSrgb[steps[2]];
+            encoded[i + 3] = (uint8_t)steps[3];
+        }
+        return encoded;
+    }
+}
+
+std::vector<std::vector<uint8_t>> generateMips(const uint8_t* pixels, uint32_t width, uint32_t height, bool srgb) {
+    const SrgbTables& tables = SrgbTables::get();
+
+    std::vector<float> level((size_t)width * height * 4);
+    for (size_t i = 0; i < level.size(); i++) {
+        level[i] = srgb && i % 4 != 3 ? tables.toLinear[pixels[i]] : (float)pixels[i] / 255.0f;
+    }
+
+    std::vector<std::vector<uint8_t>> mips;
+    while (width > 1 || height > 1) {
+        level = halve(level, width, height);
+        width = std::max(width / 2, 1u);
+        height = std::max(height / 2, 1u);
+        mips.push_back(srgb ? encodeSrgb(level) : encode(level));
+    }
+    return mips;
+}
@@ -0,0 +1,26 @@
+#ifndef OPENGL_RENDERER_MIPGENERATOR_H
+#define OPENGL_RENDERER_MIPGENERATOR_H
+
+#include <vector>
+
+/**
+ * Generates the mip-map levels below an rgba8 image on the cpu, each halving the size of the last with a
+ * 2x2 box filter. Where a level has an odd number of rows or columns, the last row or column is folded into
+ * the texels of the one before, which then average a 2x3, 3x2 or 3x3 box.
+ *
+ * Channels are averaged as they are stored, as suits data sampled without conversion, such as normal maps
+ * and masks. Color channels of srgb encoded images are instead averaged in linear light, so that levels do
+ * not darken where bright and dark pixels meet, and are encoded back to srgb. Either way, levels are
+ * filtered from the unrounded values of the level above, so rounding errors do not accumulate down the
+ * chain, and alpha is averaged as it is stored.
+ *
+ * @param pixels the rgba8 pixels of the image, with tightly packed rows
+ * @param width the width of the image, in pixels
+ * @param height the height of the image, in pixels
+ * @param srgb whether the color channels are srgb encoded, which should only be so for srgb formats
+ * @returns the rgba8 pixels of each level below the image, from half its size down to 1x1
+ */
+std::vector<std::vector<uint8_t>> generateMips(const uint8_t* pixels, uint32_t width, uint32_t height, bool srgb);
+
+
+#endif //OPENGL_RENDERER_MIPGENERATOR_H
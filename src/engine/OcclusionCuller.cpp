@@ -0,0 +1,288 @@
+#include "OcclusionCuller.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define OCCLUSION_CULLER_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace {
+    // rows of the depth buffer rasterized by each task
+    constexpr uint32_t bandHeight = 8;
+
+    Vec4 transformPoint(const Mat4& matrix, const Vec3& point) {
+        return matrix.column(0) * point.x + matrix.column(1) * point.y + matrix.column(2) * point.z
+               + matrix.column(3);
+    }
+}
+
+OcclusionCuller::OcclusionCuller(uint32_t width, uint32_t height)
+        : m_width(width), m_height(height), m_viewProjection(1.0f) {
+    if (width == 0 || height == 0 || width % 4 != 0) {
+        throw std::invalid_argument("OcclusionCuller requires a non-empty width that is a multiple of 4.");
+    }
+
+    // each level halves the last, until a single pixel remains
+    Vector<uint32_t, 2> dimensions(width, height);
+    while (true) {
+        m_levelDimensions.push_back(dimensions);
+        m_levels.emplace_back(dimensions.x * dimensions.y, 0.0f);
+        if (dimensions.x == 1 && dimensions.y == 1) break;
+        dimensions = {(dimensions.x + 1) / 2, (dimensions.y + 1) / 2};
+    }
+}
+
+void OcclusionCuller::begin(const Mat4& viewProjection) {
+    m_viewProjection = viewProjection;
+    m_occluders.clear();
+    std::fill(m_levels[0].begin(), m_levels[0].end(), 0.0f);
+}
+
+void OcclusionCuller::addOccluder(const OccluderMesh& occluder, const Mat4& transform) {
+    m_occluders.push_back(Occluder{
+        .mesh = std::addressof(occluder),
+        .modelViewProjection = m_viewProjection * transform,
+    });
+}
+
+void OcclusionCuller::rasterize(ThreadPool& pool) {
+    if (m_triangles.size() < m_occluders.size()) {
+        m_triangles.resize(m_occluders.size());
+    }
+
+    // transform and set up the triangles of each occluder in parallel
+    pool.parallelFor(m_occluders.size(), [&](uint32_t index) {
+        m_triangles[index].clear();
+        setupTriangles(m_occluders[index], m_triangles[index]);
+    });
+
+    // then rasterize every triangle in parallel bands of rows, which never overlap
+    uint32_t numBands = (m_height + bandHeight - 1) / bandHeight;
+    pool.parallelFor(numBands, [&](uint32_t band) {
+        uint32_t minRow = band * bandHeight;
+        uint32_t maxRow = std::min(minRow + bandHeight, m_height) - 1;
+        for (uint32_t i = 0; i < m_occluders.size(); i++) {
+            for (const ScreenTriangle& triangle: m_triangles[i]) {
+                if (triangle.maxY < (int32_t)minRow || triangle.minY > (int32_t)maxRow) continue;
+                rasterizeBand(triangle, minRow, maxRow);
+            }
+        }
+    });
+
+    buildHierarchy();
+}
+
+void OcclusionCuller::setupTriangles(const Occluder& occluder, std::vector<ScreenTriangle>& triangles) const {
+    const OccluderMesh& mesh = *occluder.mesh;
+
+    std::vector<Vec4> clip(mesh.positions.size());
+    for (size_t i = 0; i < mesh.positions.size(); i++) {
+        clip[i] = transformPoint(occluder.modelViewProjection, mesh.positions[i]);
+    }
+
+    for (size_t i = 0; i + 2 < mesh.indices.size(); i += 3) {
+        Vec4 corners[3] = {clip[mesh.indices[i]], clip[mesh.indices[i + 1]], clip[mesh.indices[i + 2]]};
+
+        // skip triangles entirely behind the near plane, and clip the ones crossing it
+        uint32_t numBehind = (corners[0].z < 0.0f) + (corners[1].z < 0.0f) + (corners[2].z < 0.0f);
+        if (numBehind == 3) continue;
+        if (numBehind == 0) {
+            addClippedTriangle(corners, triangles);
+            continue;
+        }
+
+        Vec4 polygon[4];
+        uint32_t numVertices = 0;
+        for (uint32_t j = 0; j < 3; j++) {
+            const Vec4& current = corners[j];
+            const Vec4& next = corners[(j + 1) % 3];
+            if (current.z >= 0.0f) {
+                polygon[numVertices++] = current;
+            }
+            if ((current.z >= 0.0f) != (next.z >= 0.0f)) {
+                float t = current.z / (current.z - next.z);
+                polygon[numVertices++] = current + (next - current) * t;
+            }
+        }
+
+        for (uint32_t j = 1; j + 1 < numVertices; j++) {
+            Vec4 fan[3] = {polygon[0], polygon[j], polygon[j + 1]};
+            addClippedTriangle(fan, triangles);
+        }
+    }
+}
+
+void OcclusionCuller::addClippedTriangle(const Vec4 clip[3], std::vector<ScreenTriangle>& triangles) const {
+    ScreenTriangle triangle{};
+    float minX = INFINITY, maxX = -INFINITY, minY = INFINITY, maxY = -INFINITY;
+    for (uint32_t i = 0; i < 3; i++) {
+        if (clip[i].w <= 0.0f) return;
+
+        triangle.invW[i] = 1.0f / clip[i].w;
+        triangle.x[i] = (clip[i].x * triangle.invW[i] * 0.5f + 0.5f) * (float)m_width;
+        triangle.y[i] = (clip[i].y * triangle.invW[i] * 0.5f + 0.5f) * (float)m_height;
+        minX = std::min(minX, triangle.x[i]);
+        maxX = std::max(maxX, triangle.x[i]);
+        minY = std::min(minY, triangle.y[i]);
+        maxY = std::max(maxY, triangle.y[i]);
+    }
+
+    // find the range of pixels whose centers the triangle could cover
+    triangle.minX = std::max((int32_t)std::ceil(minX - 0.5f), 0);
+    triangle.maxX = std::min((int32_t)std::floor(maxX - 0.5f), (int32_t)m_width - 1);
+    triangle.minY = std::max((int32_t)std::ceil(minY - 0.5f), 0);
+    triangle.maxY = std::min((int32_t)std::floor(maxY - 0.5f), (int32_t)m_height - 1);
+    if (triangle.minX > triangle.maxX || triangle.minY > triangle.maxY) return;
+
+    triangles.push_back(triangle);
+}
+
+void OcclusionCuller::rasterizeBand(const ScreenTriangle& triangle, uint32_t minRow, uint32_t maxRow) {
+    // order the corners counter-clockwise, so the inside is to the left of every edge
+    uint32_t order[3] = {0, 1, 2};
+    float area = (triangle.x[1] - triangle.x[0]) * (triangle.y[2] - triangle.y[0])
+                 - (triangle.x[2] - triangle.x[0]) * (triangle.y[1] - triangle.y[0]);
+    if (area == 0.0f) return;
+    if (area < 0.0f) {
+        std::swap(order[1], order[2]);
+        area = -area;
+    }
+
+    // edge i goes from corner i to corner i + 1, as a * x + b * y + c
+    float a[3], b[3], c[3];
+    for (uint32_t i = 0; i < 3; i++) {
+        uint32_t from = order[i];
+        uint32_t to = order[(i + 1) % 3];
+        a[i] = triangle.y[from] - triangle.y[to];
+        b[i] = triangle.x[to] - triangle.x[from];
+        c[i] = -(a[i] * triangle.x[from] + b[i] * triangle.y[from]);
+    }
+
+    // inverse depth is linear in screen space, weighted by the edge opposite each corner
+    float w0 = triangle.invW[order[0]] / area;
+    float w1 = triangle.invW[order[1]] / area;
+    float w2 = triangle.invW[order[2]] / area;
+    float depthA = a[1] * w0 + a[2] * w1 + a[0] * w2;
+    float depthB = b[1] * w0 + b[2] * w1 + b[0] * w2;
+    float depthC = c[1] * w0 + c[2] * w1 + c[0] * w2;
+
+    auto firstRow = (uint32_t)std::max(triangle.minY, (int32_t)minRow);
+    auto lastRow = (uint32_t)std::min(triangle.maxY, (int32_t)maxRow);
+    uint32_t firstColumn = triangle.minX & ~3u;
+    std::vector<float>& depth = m_levels[0];
+
+    for (uint32_t row = firstRow; row <= lastRow; row++) {
+        float y = (float)row + 0.5f;
+        float* line = depth.data() + row * m_width;
+
+#ifdef OCCLUSION_CULLER_SSE2
+        __m128 edgeA[3], edgeRow[3];
+        for (uint32_t i = 0; i < 3; i++) {
+            edgeA[i] = _mm_set1_ps(a[i]);
+            edgeRow[i] = _mm_set1_ps(b[i] * y + c[i]);
+        }
+        __m128 zA = _mm_set1_ps(depthA);
+        __m128 zRow = _mm_set1_ps(depthB * y + depthC);
+        __m128 zero = _mm_setzero_ps();
+
+        for (uint32_t column = firstColumn; column <= (uint32_t)triangle.maxX; column += 4) {
+            auto fColumn = (float)column + 0.5f;
+            __m128 x = _mm_setr_ps(fColumn, fColumn + 1.0f, fColumn + 2.0f, fColumn + 3.0f);
+
+            __m128 inside = _mm_cmpge_ps(_mm_add_ps(_mm_mul_ps(edgeA[0], x), edgeRow[0]), zero);
+            inside = _mm_and_ps(inside, _mm_cmpge_ps(_mm_add_ps(_mm_mul_ps(edgeA[1], x), edgeRow[1]), zero));
+            inside = _mm_and_ps(inside, _mm_cmpge_ps(_mm_add_ps(_mm_mul_ps(edgeA[2], x), edgeRow[2]), zero));
+            if (_mm_movemask_ps(inside) == 0) continue;
+
+            // pixels outside the triangle contribute zero, which never replaces a stored depth
+            __m128 z = _mm_and_ps(inside, _mm_add_ps(_mm_mul_ps(zA, x), zRow));
+            _mm_storeu_ps(line + column, _mm_max_ps(_mm_loadu_ps(line + column), z));
+        }
+#else
+        for (uint32_t column = firstColumn; column <= (uint32_t)triangle.maxX; column++) {
+            float x = (float)column + 0.5f;
+            if (a[0] * x + b[0] * y + c[0] < 0.0f || a[1] * x + b[1] * y + c[1] < 0.0f ||
+                a[2] * x + b[2] * y + c[2] < 0.0f) {
+                continue;
+            }
+            line[column] = std::max(line[column], depthA * x + depthB * y + depthC);
+        }
+#endif
+    }
+}
+
+void OcclusionCuller::buildHierarchy() {
+    for (uint32_t level = 1; level < m_levels.size(); level++) {
+        const std::vector<float>& source = m_levels[level - 1];
+        Vector<uint32_t, 2> sourceDimensions = m_levelDimensions[level - 1];
+        std::vector<float>& destination = m_levels[level];
+        Vector<uint32_t, 2> dimensions = m_levelDimensions[level];
+
+        for (uint32_t y = 0; y < dimensions.y; y++) {
+            uint32_t y0 = 2 * y;
+            uint32_t y1 = std::min(y0 + 1, sourceDimensions.y - 1);
+            for (uint32_t x = 0; x < dimensions.x; x++) {
+                uint32_t x0 = 2 * x;
+                uint32_t x1 = std::min(x0 + 1, sourceDimensions.x - 1);
+                destination[y * dimensions.x + x] = std::min({
+                    source[y0 * sourceDimensions.x + x0], source[y0 * sourceDimensions.x + x1],
+                    source[y1 * sourceDimensions.x + x0], source[y1 * sourceDimensions.x + x1],
+                });
+            }
+        }
+    }
+}
+
+bool OcclusionCuller::isVisible(const Bounds& bounds, const Mat4& transform) const {
+    Mat4 modelViewProjection = m_viewProjection * transform;
+
+    // project the corners of the box, keeping its nearest depth
+    float minX = INFINITY, maxX = -INFINITY, minY = INFINITY, maxY = -INFINITY;
+    float nearest = 0.0f;
+    for (uint32_t i = 0; i < 8; i++) {
+        Vec3 corner((i & 1) ? bounds.max.x : bounds.min.x,
+                    (i & 2) ? bounds.max.y : bounds.min.y,
+                    (i & 4) ? bounds.max.z : bounds.min.z);
+        Vec4 clip = transformPoint(modelViewProjection, corner);
+
+        // boxes crossing the near plane are always considered visible
+        if (clip.z < 0.0f || clip.w <= 0.0f) return true;
+
+        float invW = 1.0f / clip.w;
+        float x = (clip.x * invW * 0.5f + 0.5f) * (float)m_width;
+        float y = (clip.y * invW * 0.5f + 0.5f) * (float)m_height;
+        minX = std::min(minX, x);
+        maxX = std::max(maxX, x);
+        minY = std::min(minY, y);
+        maxY = std::max(maxY, y);
+        nearest = std::max(nearest, invW);
+    }
+
+    if (maxX < 0.0f || minX > (float)m_width || maxY < 0.0f || minY > (float)m_height) {
+        return false;
+    }
+
+    auto x0 = (uint32_t)std::max(minX, 0.0f);
+    auto x1 = (uint32_t)std::min(maxX, (float)m_width - 1.0f);
+    auto y0 = (uint32_t)std::max(minY, 0.0f);
+    auto y1 = (uint32_t)std::min(maxY, (float)m_height - 1.0f);
+
+    // move up the hierarchy until the box covers at most 4x4 pixels
+    uint32_t level = 0;
+    while ((x1 - x0 > 3 || y1 - y0 > 3) && level + 1 < m_levels.size()) {
+        x0 >>= 1;
+        x1 >>= 1;
+        y0 >>= 1;
+        y1 >>= 1;
+        level++;
+    }
+
+    // the box is hidden only if every covered pixel has an occluder strictly in front of it
+    const std::vector<float>& depth = m_levels[level];
+    uint32_t width = m_levelDimensions[level].x;
+    for (uint32_t y = y0; y <= y1; y++) {
+        for (uint32_t x = x0; x <= x1; x++) {
+            if (depth[y * width + x] <= nearest) return true;
+        }
+    }
+    return false;
+}
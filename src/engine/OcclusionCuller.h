@@ -0,0 +1,101 @@
+#ifndef OPENGL_RENDERER_OCCLUSIONCULLER_H
+#define OPENGL_RENDERER_OCCLUSIONCULLER_H
+
+#include "../util/Vector.h"
+#include "../util/Matrix.h"
+#include "../util/ThreadPool.h"
+#include "StaticMesh.h"
+
+/**
+ * Culls meshes hidden behind occluders using a low resolution depth buffer rasterized on the cpu.
+ *
+ * Each frame, occluders are added and then rasterized in parallel, with each worker filling a band
+ * of rows. A hierarchy of conservative (farthest) depths is then built, which bounding boxes are
+ * tested against. The depth buffer stores inverse view depth, so larger values are closer.
+ */
+class OcclusionCuller {
+public:
+    /**
+     * Constructs an occlusion culler with a depth buffer of the given size.
+     *
+     * @param width the width of the depth buffer, in pixels, must be a multiple of 4
+     * @param height the height of the depth buffer, in pixels
+     */
+    OcclusionCuller(uint32_t width, uint32_t height);
+
+    /**
+     * Clears the occluders and depth buffer for a new frame.
+     *
+     * @param viewProjection the view projection matrix of the camera
+     */
+    void begin(const Mat4& viewProjection);
+
+    /**
+     * Adds an occluder to be rasterized. The occluder must outlive the call to rasterize().
+     *
+     * @param occluder the occluder geometry, in model space
+     * @param transform the model transform of the occluder
+     */
+    void addOccluder(const OccluderMesh& occluder, const Mat4& transform);
+
+    /**
+     * Rasterizes the added occluders into the depth buffer and builds the depth hierarchy.
+     *
+     * @param pool the thread pool to rasterize with
+     */
+    void rasterize(ThreadPool& pool);
+
+    /**
+     * Tests whether any part of a bounding box could be visible past the rasterized occluders.
+     *
+     * @param bounds the bounding box, in model space
+     * @param transform the model transform of the bounding box
+     * @returns false if the box is completely hidden or outside the view, true otherwise
+     */
+    bool isVisible(const Bounds& bounds, const Mat4& transform) const;
+
+    /**
+     * @returns the rasterized inverse depth of each pixel, in rows from the bottom of the view
+     */
+    const std::vector<float>& depth() const {
+        return m_levels[0];
+    }
+
+    /**
+     * @returns the 2d dimensions of the depth buffer, in pixels
+     */
+    Vector<uint32_t, 2> dimensions() const {
+        return {m_width, m_height};
+    }
+
+private:
+    struct Occluder {
+        const OccluderMesh* mesh;
+        Mat4 modelViewProjection;
+    };
+
+    /**
+     * A triangle in screen space, with inverse depth as a plane over the screen.
+     */
+    struct ScreenTriangle {
+        float x[3], y[3];
+        float invW[3];
+        int32_t minX, maxX, minY, maxY;
+    };
+
+    void setupTriangles(const Occluder& occluder, std::vector<ScreenTriangle>& triangles) const;
+    void addClippedTriangle(const Vec4 clip[3], std::vector<ScreenTriangle>& triangles) const;
+    void rasterizeBand(const ScreenTriangle& triangle, uint32_t minRow, uint32_t maxRow);
+    void buildHierarchy();
+
+    uint32_t m_width;
+    uint32_t m_height;
+    Mat4 m_viewProjection;
+    std::vector<Occluder> m_occluders;
+    std::vector<std::vector<ScreenTriangle>> m_triangles; // per occluder, reused between frames
+    std::vector<std::vector<float>> m_levels; // each level stores the farthest depth of 2x2 pixels of the last
+    std::vector<Vector<uint32_t, 2>> m_levelDimensions;
+};
+
+
+#endif //OPENGL_RENDERER_OCCLUSIONCULLER_H
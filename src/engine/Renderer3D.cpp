@@ -1,55 +1,347 @@
 #include "Renderer3D.h"
+#include "ShaderLoader.h"
+#include "../rhi/PipelineCache.h"
 
-void Renderer3D::begin(std::shared_ptr<Framebuffer> framebuffer) {
+void Renderer3D::setPassMode(PassMode passMode) {
+    if (passMode == PassMode::DepthPrepass && m_depthPipeline == nullptr) {
+        // depth is drawn from tightly packed positions, without fetching the rest of each vertex
+        m_depthPipeline = RHI::current().pipelineCache().get(PipelineDescription{
+            .vertexShader = shaderSourceFromFile("../shaders/depth.vert"),
+            .fragmentShader = shaderSourceFromFile("../shaders/depth.frag"),
+            .vertexLayout = VertexLayout({
+                VertexBinding(0, sizeof(Vec3), {
+                    VertexAttribute(0, Format::RGB32F, 0),
+                })
+            }),
+            .topology = Topology::Triangles,
+            .rasterState = RasterState{.cullMode = CullMode::Back},
+            .colorWriteEnabled = false,
+        });
+    }
+
+    m_passMode = passMode;
+}
+
+void Renderer3D::begin(std::shared_ptr<Framebuffer> framebuffer, Vector<uint32_t, 2> extent) {
     if (framebuffer == nullptr) {
         throw std::invalid_argument("Renderer3D requires a framebuffer to render to.");
     }
+    Vector<uint32_t, 2> dimensions = framebuffer->dimensions();
+    if (extent.x == 0 && extent.y == 0) {
+        extent = dimensions;
+    } else if (extent.x == 0 || extent.y == 0 || extent.x > dimensions.x || extent.y > dimensions.y) {
+        throw std::invalid_argument("Renderer3D must render within its framebuffer.");
+    }
     m_framebuffer = std::move(framebuffer);
+    m_extent = extent;
+
+    // time the frame, reading the times of earlier frames that have arrived
+    readTimerQueries();
+    m_timerQueryIndex = (m_timerQueryIndex + 1) % numTimerQueries;
+    m_timerQueries[m_timerQueryIndex]->begin();
+    m_timerQueriesPending[m_timerQueryIndex] = false;
+    m_timerQueryFrames[m_timerQueryIndex] = m_frame++;
 
     // bind framebuffer for subsequent rendering
     RHI& rhi = RHI::current();
     rhi.bindFramebuffer(*m_framebuffer);
 
-    // clear the framebuffer attachments and set viewport to entire framebuffer
+    // clear the framebuffer attachments and set viewport to the rendered extent
     rhi.clearAttachments(0.12f, 0.12f, 0.12f, 1.0f, 1.0f); // TODO: remove magic number
-    Vector<uint32_t, 2> dimensions = m_framebuffer->dimensions();
-    rhi.setViewport(0, 0, dimensions.x, dimensions.y);
+    rhi.setViewport(0, 0, m_extent.x, m_extent.y);
 }
 
 void Renderer3D::end() {
-    // for now this renders nothing, but could wait till now to actually render
+    m_statistics = Statistics{
+        .submitted = (uint32_t)m_draws.size(),
+        .occluded = 0,
+        .depthPrepassed = 0,
+        .lights = (uint32_t)m_lights.size(),
+    };
+    RHI& rhi = RHI::current();
+
+    // rasterize every occluder before testing any mesh against them
+    rhi.beginGpuScope("cull");
+    if (m_occlusionCuller != nullptr) {
+        m_occlusionCuller->begin(m_camera->viewProjectionMatrix());
+        for (const DrawItem& item: m_draws) {
+            if (item.mesh->occluder != nullptr) {
+                m_occlusionCuller->addOccluder(*item.mesh->occluder, item.transform);
+            }
+        }
+        m_occlusionCuller->rasterize(ThreadPool::shared());
+    }
+
+    // remove hidden meshes and choose the level of detail of the rest, which updates their selections so is serial
+    bool depthPrepass = m_passMode == PassMode::DepthPrepass;
+    size_t numVisible = 0;
+    for (DrawItem& item: m_draws) {
+        // meshes without bounds cannot be tested, so are always drawn
+        bool hasBounds = item.mesh->bounds.radius() > 0.0f;
+        if (m_occlusionCuller != nullptr && hasBounds &&
+            !m_occlusionCuller->isVisible(item.mesh->bounds, item.transform)) {
+            m_statistics.occluded++;
+            continue;
+        }
+
+        if (item.mesh->isIndexed() && !item.mesh->lods.empty()) {
+            uint32_t previousLod = item.lodSelection != nullptr ? item.lodSelection->lod : 0;
+            item.lod = selectLod(*item.mesh, item.transform, previousLod);
+            if (item.lodSelection != nullptr) {
+                item.lodSelection->lod = item.lod;
+            }
+        }
+
+        item.depthPrepassed = depthPrepass && item.mesh->positionBuffer != nullptr
+                              && item.mesh->material->hasDepthEqualPipeline();
+        if (item.depthPrepassed) {
+            m_statistics.depthPrepassed++;
+        }
+        m_draws[numVisible++] = item;
+    }
+    m_draws.resize(numVisible);
+
+    // draw nearer meshes first, so that the fragments of meshes behind them fail the depth test
+    if (m_passMode != PassMode::Submission) {
+        Vec4 depthRow = m_camera->viewMatrix().row(2);
+        for (DrawItem& item: m_draws) {
+            Vec3 center = item.mesh->bounds.center();
+            Vec4 worldCenter = item.transform.column(0) * center.x + item.transform.column(1) * center.y
+                               + item.transform.column(2) * center.z + item.transform.column(3);
+            item.depth = -depthRow.dot(worldCenter); // the view looks down negative z
+        }
+        std::sort(m_draws.begin(), m_draws.end(), [](const DrawItem& a, const DrawItem& b) {
+            return a.depth < b.depth;
+        });
+    }
+    rhi.endGpuScope();
+
+    rhi.beginGpuScope("lights");
+    prepareLights();
+    rhi.endGpuScope();
+
+    // record the draws in chunks, in parallel if there are enough of them to be worth it
+    rhi.beginGpuScope("record");
+    ThreadPool& pool = ThreadPool::shared();
+    auto numChunks = (uint32_t)(m_draws.size() + recordChunkSize - 1) / recordChunkSize;
+    if (m_draws.size() < parallelRecordThreshold || pool.size() == 0) {
+        numChunks = std::min(numChunks, 1u);
+    }
+
+    // the pre-pass has its own command lists, which precede those of the shading pass
+    uint32_t numLists = numChunks * (depthPrepass ? 2 : 1);
+    if (m_commandLists.size() < numLists) {
+        m_commandLists.resize(numLists);
+    }
+
+    auto recordChunk = [this, numChunks, depthPrepass](uint32_t list) {
+        bool isDepthPass = depthPrepass && list < numChunks;
+        uint32_t chunk = list % numChunks;
+        CommandList& commandList = m_commandLists[list];
+        commandList.reset();
+        if (!isDepthPass) {
+            commandList.bindDescriptorSet(*m_lightDescriptorSet);
+        }
+
+        size_t chunkSize = (m_draws.size() + numChunks - 1) / numChunks;
+        size_t first = chunk * chunkSize;
+        size_t last = std::min(first + chunkSize, m_draws.size());
+        for (size_t i = first; i < last; i++) {
+            if (!isDepthPass) {
+                record(commandList, m_draws[i]);
+            } else if (m_draws[i].depthPrepassed) {
+                recordDepth(commandList, m_draws[i]);
+            }
+        }
+    };
+    if (numChunks > 1) {
+        pool.parallelFor(numLists, recordChunk);
+    } else {
+        for (uint32_t list = 0; list < numLists; list++) {
+            recordChunk(list);
+        }
+    }
+
+    rhi.endGpuScope();
+
+    // submit in list order so that draws happen in the order they were sorted
+    uint32_t numDepthLists = depthPrepass ? numChunks : 0;
+    if (numDepthLists > 0) {
+        GpuScope scope(rhi, "depth prepass");
+        for (uint32_t list = 0; list < numDepthLists; list++) {
+            rhi.submit(m_commandLists[list]);
+        }
+    }
+    {
+        GpuScope scope(rhi, "shading");
+        for (uint32_t list = numDepthLists; list < numLists; list++) {
+            rhi.submit(m_commandLists[list]);
+        }
+    }
+
+    m_timerQueries[m_timerQueryIndex]->end();
+    m_timerQueriesPending[m_timerQueryIndex] = true;
+    m_draws.clear();
+    m_lights.clear();
     m_framebuffer.reset();
 }
 
-void Renderer3D::submit(const StaticMesh& mesh, const Mat4& transform) {
+void Renderer3D::submit(const StaticMesh& mesh, const Mat4& transform, LodSelection* lodSelection) {
     if (m_framebuffer == nullptr) {
         throw std::invalid_argument("Renderer3D requires a framebuffer to render to.");
     }
 
-    RHI& rhi = RHI::current();
-
     // must be renderable
     if (!mesh.isRenderable()) {
         throw std::invalid_argument("StaticMesh must be renderable to submit.");
     }
 
+    m_draws.push_back(DrawItem{
+        .mesh = std::addressof(mesh),
+        .transform = transform,
+        .lodSelection = lodSelection,
+        .lod = 0,
+        .depth = 0.0f,
+        .depthPrepassed = false,
+    });
+}
+
+void Renderer3D::submitLight(const PointLight& light) {
+    if (m_framebuffer == nullptr) {
+        throw std::invalid_argument("Renderer3D requires a framebuffer to render to.");
+    }
+
+    m_lights.push_back(light);
+}
+
+void Renderer3D::prepareLights() {
+    m_lightClusterer.build(m_lights, m_camera->viewMatrix(), m_camera->projectionMatrix(), m_camera->nearPlane(),
+                           m_camera->farPlane(), ThreadPool::shared());
+
+    Vector<uint32_t, 3> counts = m_lightClusterer.dimensions();
+    LightUniforms uniforms{
+        .view = m_camera->viewMatrix(),
+        .clusterCounts = {counts.x, counts.y, counts.z, (uint32_t)m_lights.size()},
+        .depthSlicing = {m_lightClusterer.depthScale(), m_lightClusterer.depthBias(),
+                         (float)m_extent.x, (float)m_extent.y},
+    };
+    uint32_t offset = m_uniformRing.push(&uniforms, sizeof(uniforms));
+    m_lightDescriptorSet->bindUniformBuffer(lightUniformsBinding, m_uniformRing.buffer(), offset, sizeof(uniforms));
+
+    // storage buffer ranges must not be empty, so empty arrays are given a single unused element
+    auto bindArray = [&](uint32_t binding, const void* data, uint32_t size, uint32_t elementSize) {
+        static constexpr std::array<uint8_t, 32> empty{};
+        if (size == 0) {
+            data = empty.data();
+            size = elementSize;
+        }
+        uint32_t arrayOffset = m_uniformRing.push(data, size);
+        m_lightDescriptorSet->bindStorageBuffer(binding, m_uniformRing.buffer(), arrayOffset, size);
+    };
+
+    const auto& clusters = m_lightClusterer.clusters();
+    const auto& lightIndices = m_lightClusterer.lightIndices();
+    bindArray(lightsBinding, m_lights.data(), m_lights.size() * sizeof(PointLight), sizeof(PointLight));
+    bindArray(clustersBinding, clusters.data(), clusters.size() * sizeof(LightClusterer::Cluster),
+              sizeof(LightClusterer::Cluster));
+    bindArray(lightIndicesBinding, lightIndices.data(), lightIndices.size() * sizeof(uint32_t), sizeof(uint32_t));
+}
+
+void Renderer3D::readTimerQueries() {
+    // read from the oldest query, so that the most recent time available is kept
+    for (uint32_t i = 1; i <= numTimerQueries; i++) {
+        uint32_t index = (m_timerQueryIndex + i) % numTimerQueries;
+        if (m_timerQueriesPending[index] && m_timerQueries[index]->isAvailable()) {
+            m_gpuTime = (float)m_timerQueries[index]->elapsed() / 1e6f;
+            m_timerQueriesPending[index] = false;
+            if (m_gpuTimeListener) {
+                m_gpuTimeListener(m_timerQueryFrames[index], m_gpuTime);
+            }
+        }
+    }
+}
+
+void Renderer3D::record(CommandList& commandList, const DrawItem& item) {
+    const StaticMesh& mesh = *item.mesh;
+
     // bind the material with parameters
-    Material& material = *(mesh.material);
-    Mat4 modelViewProjection = m_camera->viewProjectionMatrix() * transform;
-    material.setModelViewProjection(modelViewProjection);
-    material.setLights({m_camera->position()});
-    material.bind();
+    Mat4 modelViewProjection = m_camera->viewProjectionMatrix() * item.transform;
+    mesh.material->record(commandList, m_uniformRing, item.transform, modelViewProjection, item.depthPrepassed);
 
     // bind the vertex buffer
     Buffer& vertexBuffer = *(mesh.vertexBuffer);
-    rhi.bindVertexBuffer(vertexBuffer, 0);
+    commandList.bindVertexBuffer(vertexBuffer, 0);
+    recordGeometry(commandList, item, vertexBuffer.size() / vertexBuffer.stride());
+}
+
+void Renderer3D::recordDepth(CommandList& commandList, const DrawItem& item) {
+    const StaticMesh& mesh = *item.mesh;
+
+    // computed exactly as in the shading pass, so that the depths are equal
+    Mat4 modelViewProjection = m_camera->viewProjectionMatrix() * item.transform;
+    commandList.bindPipeline(*m_depthPipeline);
+    m_uniformRing.record(commandList, modelViewProjection);
+
+    Buffer& positionBuffer = *(mesh.positionBuffer);
+    commandList.bindVertexBuffer(positionBuffer, 0);
+    recordGeometry(commandList, item, positionBuffer.size() / positionBuffer.stride());
+}
+
+void Renderer3D::recordGeometry(CommandList& commandList, const DrawItem& item, uint32_t vertexCount) {
+    const StaticMesh& mesh = *item.mesh;
 
     // bind the index buffer, if applicable, then draw
     if (mesh.indexBuffer == nullptr) {
-        rhi.draw(vertexBuffer.size() / vertexBuffer.stride(), 0);
+        commandList.draw(vertexCount, 0);
     } else {
         Buffer& indexBuffer = *(mesh.indexBuffer);
-        rhi.bindIndexBuffer(indexBuffer);
-        rhi.drawIndexed(indexBuffer.size() / indexBuffer.stride(), 0, 0);
+        commandList.bindIndexBuffer(indexBuffer);
+        if (mesh.lods.empty()) {
+            commandList.drawIndexed(indexBuffer.size() / indexBuffer.stride(), 0, 0);
+        } else {
+            const MeshLod& lod = mesh.lods[item.lod];
+            commandList.drawIndexed(lod.indexCount, lod.baseIndex, 0);
+        }
+    }
+}
+
+uint32_t Renderer3D::selectLod(const StaticMesh& mesh, const Mat4& transform, uint32_t previousLod) const {
+    auto lastLod = (uint32_t)mesh.lods.size() - 1;
+    uint32_t lod = std::min(previousLod, lastLod);
+
+    // find the world space center of the mesh and the largest scale of its transform
+    Vec3 center = mesh.bounds.center();
+    Vec3 axes[3];
+    for (uint32_t i = 0; i < 3; i++) {
+        Vec4 column = transform.column(i);
+        axes[i] = Vec3(column.x, column.y, column.z);
+    }
+    Vec4 translation = transform.column(3);
+    Vec3 worldCenter = axes[0] * center.x + axes[1] * center.y + axes[2] * center.z
+                       + Vec3(translation.x, translation.y, translation.z);
+    float scale = std::sqrt(std::max({axes[0].dot(axes[0]), axes[1].dot(axes[1]), axes[2].dot(axes[2])}));
+
+    // use full detail when the camera is within the mesh's bounds
+    Vec3 offset = worldCenter - m_camera->position();
+    float distance = std::sqrt(offset.dot(offset));
+    if (distance <= mesh.bounds.radius() * scale) {
+        return 0;
+    }
+
+    // pixels per world unit at the mesh's distance
+    float pixelScale = scale * m_camera->projectionMatrix().column(1).y / distance
+                       * (float)m_extent.y * 0.5f;
+    auto projectedError = [&](uint32_t index) {
+        return mesh.lods[index].error * pixelScale;
+    };
+
+    // refine while the current level is too coarse, then coarsen while the next level is well within the threshold
+    while (lod > 0 && projectedError(lod) > m_lodThreshold) {
+        lod--;
     }
+    while (lod < lastLod && projectedError(lod + 1) <= m_lodThreshold * (1.0f - m_lodHysteresis)) {
+        lod++;
+    }
+
+    return lod;
 }
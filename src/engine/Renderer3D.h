@@ -4,17 +4,58 @@
 #include "../rhi/RHI.h"
 #include "StaticMesh.h"
 #include "Camera3D.h"
+#include "OcclusionCuller.h"
+#include "LightClusterer.h"
+#include "../rhi/UniformLayout.h"
+#include "../rhi/UniformRing.h"
 
 /**
- * A 3d renderer that renders meshes to a framebuffer.
+ * A 3d renderer that renders meshes to a framebuffer. Submitted meshes are collected and only
+ * drawn once rendering ends, so that they can be culled against every occluder in the frame.
+ * Draws are recorded into command lists, split into chunks recorded in parallel for large scenes.
+ *
+ * Submitted lights are binned into clusters of the view each frame, which shaders read from storage
+ * buffers so that each fragment is only lit by the lights that can reach it.
+ *
+ * To reduce shading of overdrawn pixels, draws can be sorted front to back, and can be preceded by
+ * a depth-only pre-pass so that only the visible fragment of each pixel is shaded.
+ *
+ * Per-frame uniforms are written into memory recycled by the api's frame context, so the application
+ * must begin and end frames of the context around rendering.
  */
 class Renderer3D {
 public:
+    /**
+     * How the opaque meshes of a frame are ordered and drawn.
+     */
+    enum class PassMode {
+        Submission, // drawn in the order they are submitted
+        FrontToBack, // sorted front to back by view depth
+        DepthPrepass, // sorted front to back, with depth laid down by a pre-pass before shading with equal depth
+    };
+
+    // the number of light clusters across and up the screen, and in depth
+    static constexpr uint32_t clusterCountX = 16;
+    static constexpr uint32_t clusterCountY = 9;
+    static constexpr uint32_t clusterCountZ = 24;
+
     explicit Renderer3D(std::shared_ptr<const Camera3D> camera)
-        : m_camera(std::move(camera)) {
+        : m_camera(std::move(camera)), m_lodThreshold(1.0f), m_lodHysteresis(0.25f),
+          m_passMode(PassMode::Submission), m_occlusionCuller(nullptr), m_uniformRing(uniformRingCapacity),
+          m_lightClusterer(clusterCountX, clusterCountY, clusterCountZ),
+          m_lightDescriptorSet(RHI::current().createDescriptorSet({
+              DescriptorSetBinding{.binding = lightUniformsBinding, .type = DescriptorType::UniformBuffer},
+              DescriptorSetBinding{.binding = lightsBinding, .type = DescriptorType::StorageBuffer},
+              DescriptorSetBinding{.binding = clustersBinding, .type = DescriptorType::StorageBuffer},
+              DescriptorSetBinding{.binding = lightIndicesBinding, .type = DescriptorType::StorageBuffer},
+          })) {
         if (m_camera == nullptr) {
             throw std::invalid_argument("Renderer3D must have a camera.");
         }
+
+        for (std::unique_ptr<TimerQuery>& timerQuery: m_timerQueries) {
+            timerQuery = RHI::current().createTimerQuery();
+        }
     }
 
     /**
@@ -31,16 +72,101 @@ public:
         m_camera = std::move(camera);
     }
 
+    /**
+     * Sets how levels of detail are chosen for meshes that have them. The least detailed level
+     * whose error projects to at most the threshold on screen is used. To avoid flickering between
+     * levels, a coarser level is only switched to once its error is below the threshold reduced by
+     * the hysteresis fraction.
+     *
+     * @param threshold the maximum projected error, in pixels
+     * @param hysteresis the fraction of the threshold needed as margin to switch to a coarser level, in [0, 1)
+     */
+    void setLodThreshold(float threshold, float hysteresis) {
+        if (threshold < 0.0f || hysteresis < 0.0f || hysteresis >= 1.0f) {
+            throw std::invalid_argument("Invalid level of detail threshold.");
+        }
+
+        m_lodThreshold = threshold;
+        m_lodHysteresis = hysteresis;
+    }
+
+    /**
+     * Sets whether meshes hidden behind occluder meshes are culled before they are drawn.
+     *
+     * @param enabled whether occlusion culling is enabled
+     */
+    void setOcclusionCulling(bool enabled) {
+        if (enabled && m_occlusionCuller == nullptr) {
+            m_occlusionCuller = std::make_unique<OcclusionCuller>(occlusionWidth, occlusionHeight);
+        } else if (!enabled) {
+            m_occlusionCuller.reset();
+        }
+    }
+
+    /**
+     * Sets how opaque meshes are ordered and drawn. In the depth pre-pass mode, only meshes that have
+     * a position buffer and a material with a depth-equal pipeline are drawn in the pre-pass, while
+     * other meshes are shaded with their own depth test.
+     *
+     * @param passMode the pass mode
+     */
+    void setPassMode(PassMode passMode);
+
+    /**
+     * Counts of the meshes handled in the last frame.
+     */
+    struct Statistics {
+        uint32_t submitted;
+        uint32_t occluded;
+        uint32_t depthPrepassed;
+        uint32_t lights;
+    };
+
+    /**
+     * @returns the statistics of the last frame rendered
+     */
+    const Statistics& statistics() const {
+        return m_statistics;
+    }
+
+    /**
+     * @returns the gpu time of the most recent frame whose time is known, in milliseconds, or zero if none is.
+     * Times are read a few frames late so that the gpu is never waited on.
+     */
+    float gpuTime() const {
+        return m_gpuTime;
+    }
+
+    /**
+     * Sets a function to call with the gpu time of each frame once it is read, for measuring frames
+     * individually rather than only the most recent. Times are lost if more frames are in flight than
+     * there are timer queries, so callers should limit how far ahead of the gpu they render.
+     *
+     * @param listener the function called with the index of a frame, counting frames begun from zero,
+     *                 and its gpu time in milliseconds, or nullptr to stop listening
+     */
+    void setGpuTimeListener(std::function<void(uint64_t frame, float gpuTime)> listener) {
+        m_gpuTimeListener = std::move(listener);
+    }
+
+    /**
+     * Reads the results of any timer queries that have arrived, without waiting for the others.
+     * This is done whenever a frame begins, and can be done after waiting on the gpu to read the
+     * times of the last frames rendered.
+     */
+    void readTimerQueries();
+
     /**
      * Begins rendering to the given framebuffer. This binds the framebuffer, clears attachments,
-     * and sets the viewport to render into the framebuffer.
+     * and sets the viewport to render into the given extent of the framebuffer, from its origin.
      *
      * @param framebuffer the framebuffer to render to, must not be nullptr
+     * @param extent the extent to render into, or zero to render into the whole framebuffer
      */
-    void begin(std::shared_ptr<Framebuffer> framebuffer);
+    void begin(std::shared_ptr<Framebuffer> framebuffer, Vector<uint32_t, 2> extent = {});
 
     /**
-     * Ends rendering to the framebuffer.
+     * Ends rendering to the framebuffer, culling and drawing all submitted meshes.
      */
     void end();
 
@@ -48,14 +174,122 @@ public:
      * Submits a static mesh to be rendered with the given model transform.
      * This function should only be called between calls to begin() and end().
      *
-     * @param mesh the mesh to render, must be renderable
+     * @param mesh the mesh to render, must be renderable and remain valid until end()
      * @param transform the model transform for the mesh
+     * @param lodSelection the level of detail last rendered for this instance of the mesh, updated by end() and
+     *                     so must remain valid until then, or nullptr to choose the level without hysteresis
+     */
+    void submit(const StaticMesh& mesh, const Mat4& transform, LodSelection* lodSelection = nullptr);
+
+    /**
+     * Submits a light to light the meshes rendered in the frame.
+     * This function should only be called between calls to begin() and end().
+     *
+     * @param light the light, in world space
      */
-    void submit(const StaticMesh& mesh, const Mat4& transform);
+    void submitLight(const PointLight& light);
 
 private:
+    static constexpr uint32_t occlusionWidth = 320;
+    static constexpr uint32_t occlusionHeight = 180;
+    static constexpr uint32_t uniformRingCapacity = 4 << 20; // per frame, enough for thousands of draws and lights
+    static constexpr uint32_t parallelRecordThreshold = 512; // fewer draws are recorded on the calling thread
+    static constexpr uint32_t recordChunkSize = 128;
+    static constexpr uint32_t numTimerQueries = 4; // enough for results to arrive without waiting
+
+    // binding indices of the light data, matching the shaders
+    static constexpr uint32_t lightUniformsBinding = 1;
+    static constexpr uint32_t lightsBinding = 2;
+    static constexpr uint32_t clustersBinding = 3;
+    static constexpr uint32_t lightIndicesBinding = 4;
+
+    /**
+     * The per-frame uniforms describing the light clusters, matching the std140 LightClusters block.
+     */
+    struct LightUniforms {
+        Mat4 view;
+        Vector<uint32_t, 4> clusterCounts; // x, y and z counts, then the number of lights
+        Vec4 depthSlicing; // depth scale and bias, then the viewport width and height
+    };
+
+    static_assert(hasBufferLayout<BufferLayout::Std140>(
+            BufferField(&LightUniforms::view, offsetof(LightUniforms, view)),
+            BufferField(&LightUniforms::clusterCounts, offsetof(LightUniforms, clusterCounts)),
+            BufferField(&LightUniforms::depthSlicing, offsetof(LightUniforms, depthSlicing))),
+        "LightUniforms must follow the std140 layout.");
+
+    struct DrawItem {
+        const StaticMesh* mesh;
+        Mat4 transform;
+        LodSelection* lodSelection;
+        uint32_t lod;
+        float depth; // the view depth of the center of the mesh, used for sorting
+        bool depthPrepassed; // whether the mesh's depth is drawn in the pre-pass
+    };
+
+    /**
+     * Records drawing a submitted mesh. This may be called from multiple threads at once.
+     *
+     * @param commandList the command list to record the draw in
+     * @param item the submitted mesh, its transform and its chosen level of detail
+     */
+    void record(CommandList& commandList, const DrawItem& item);
+
+    /**
+     * Records drawing the depth of a submitted mesh in the pre-pass, using its position buffer.
+     * This may be called from multiple threads at once.
+     *
+     * @param commandList the command list to record the draw in
+     * @param item the submitted mesh, its transform and its chosen level of detail
+     */
+    void recordDepth(CommandList& commandList, const DrawItem& item);
+
+    /**
+     * Records drawing the geometry of a submitted mesh, after its vertex buffer has been bound.
+     *
+     * @param commandList the command list to record the draw in
+     * @param item the submitted mesh, its transform and its chosen level of detail
+     * @param vertexCount the number of vertices in the bound vertex buffer
+     */
+    static void recordGeometry(CommandList& commandList, const DrawItem& item, uint32_t vertexCount);
+
+    /**
+     * Chooses the level of detail to render a mesh at given its model transform.
+     *
+     * @param mesh the mesh to choose the level of detail for
+     * @param transform the model transform for the mesh
+     * @param previousLod the level last rendered for this instance, from which switching needs a margin
+     * @returns the index of the level of detail in the mesh
+     */
+    uint32_t selectLod(const StaticMesh& mesh, const Mat4& transform, uint32_t previousLod) const;
+
+    /**
+     * Bins the submitted lights into clusters and writes them to the uniform ring for this frame.
+     */
+    void prepareLights();
+
     std::shared_ptr<Framebuffer> m_framebuffer;
+    Vector<uint32_t, 2> m_extent;
     std::shared_ptr<const Camera3D> m_camera;
+    float m_lodThreshold;
+    float m_lodHysteresis;
+    PassMode m_passMode;
+    std::shared_ptr<Pipeline> m_depthPipeline; // created when the depth pre-pass is first used
+    std::vector<DrawItem> m_draws;
+    std::vector<CommandList> m_commandLists; // reused between frames to keep their memory
+    std::unique_ptr<OcclusionCuller> m_occlusionCuller;
+    Statistics m_statistics{};
+    UniformRing m_uniformRing;
+    std::vector<PointLight> m_lights;
+    LightClusterer m_lightClusterer;
+    std::unique_ptr<DescriptorSet> m_lightDescriptorSet;
+    std::array<std::unique_ptr<TimerQuery>, numTimerQueries> m_timerQueries;
+    std::array<bool, numTimerQueries> m_timerQueriesPending{};
+    std::array<uint64_t, numTimerQueries> m_timerQueryFrames{}; // the frame timed by each query
+    uint32_t m_timerQueryIndex = 0; // the query timing the current frame
+    uint64_t m_frame = 0; // the number of frames begun
+    float m_gpuTime = 0.0f;
+    std::function<void(uint64_t, float)> m_gpuTimeListener;
 };
 
 
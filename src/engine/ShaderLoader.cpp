@@ -2,7 +2,7 @@
 #include <fstream>
 #include <sstream>
 
-std::unique_ptr<Shader> shaderFromFile(const std::string& filename) {
+ShaderSource shaderSourceFromFile(const std::string& filename) {
     ShaderType type = ShaderType::Vertex;
     if (filename.find(".vert") != std::string::npos) {
         type = ShaderType::Vertex;
@@ -19,5 +19,15 @@ std::unique_ptr<Shader> shaderFromFile(const std::string& filename) {
     buffer << file.rdbuf();
     file.close();
 
-    return RHI::current().createShader((void*)buffer.str().c_str(), buffer.str().size(), type);
+    // shaders are named by their file name, without the directory
+    return ShaderSource{
+        .type = type,
+        .name = filename.substr(filename.find_last_of("/\\") + 1),
+        .code = buffer.str(),
+    };
+}
+
+std::unique_ptr<Shader> shaderFromFile(const std::string& filename) {
+    ShaderSource source = shaderSourceFromFile(filename);
+    return RHI::current().createShader(source.code.data(), source.code.size(), source.type, source.name);
 }
@@ -3,6 +3,14 @@
 
 #include "../rhi/RHI.h"
 
+/**
+ * Reads the source of a shader from a file, typed by its extension and named by its file name.
+ *
+ * @param filename the path of the shader's file, ending in .vert or .frag
+ * @returns the shader's source
+ */
+ShaderSource shaderSourceFromFile(const std::string& filename);
+
 std::unique_ptr<Shader> shaderFromFile(const std::string& filename);
 
 
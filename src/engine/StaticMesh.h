@@ -4,15 +4,74 @@
 #include "../rhi/RHI.h"
 #include "Material.h"
 
+/**
+ * An axis-aligned bounding box in model space.
+ */
+struct Bounds {
+    Vec3 min;
+    Vec3 max;
+
+    /**
+     * @returns the center of the bounding box
+     */
+    Vec3 center() const {
+        return (min + max) * 0.5f;
+    }
+
+    /**
+     * @returns the radius of the sphere that encloses the bounding box
+     */
+    float radius() const {
+        Vec3 extent = (max - min) * 0.5f;
+        return std::sqrt(extent.dot(extent));
+    }
+};
+
+/**
+ * A level of detail of a mesh, given as a range of its index buffer.
+ */
+struct MeshLod {
+    uint32_t baseIndex;
+    uint32_t indexCount;
+    float error; // the geometric error compared to the full detail mesh, in model units
+};
+
+/**
+ * The level of detail last rendered for one instance of a mesh, which the renderer keeps between frames
+ * so that an instance near a switching distance does not alternate between levels. Instances of the same
+ * mesh are at different distances, so each needs its own.
+ */
+struct LodSelection {
+    uint32_t lod = 0;
+};
+
+/**
+ * Simplified geometry of a mesh used to hide other meshes behind it, kept on the cpu.
+ */
+struct OccluderMesh {
+    std::vector<Vec3> positions;
+    std::vector<uint32_t> indices;
+};
+
 /**
  * A static mesh which has a vertex buffer, index buffer, and a single material that dictates
  * how to draw the mesh. The vertices in the vertex buffer are of unspecified format.
  * The mesh is considered renderable if it have at least a valid vertex buffer and material.
+ *
+ * Indexed meshes may have levels of detail, ordered from the most to least detailed, which
+ * are ranges of the index buffer that the renderer chooses between based on screen size.
+ * Meshes with occluder geometry hide other meshes behind them when occlusion culling is enabled.
+ * Meshes with a position buffer, holding only the tightly packed positions of their vertices, can be
+ * drawn in depth-only passes without fetching the rest of each vertex.
  */
 struct StaticMesh {
     std::unique_ptr<Buffer> vertexBuffer;
     std::unique_ptr<Buffer> indexBuffer;
+    std::unique_ptr<Buffer> positionBuffer;
     std::shared_ptr<Material> material;
+    Bounds bounds{};
+    std::vector<MeshLod> lods;
+    std::shared_ptr<const OccluderMesh> occluder;
 
     /**
      * @returns whether the mesh has a vertex buffer and material, and is thus renderable
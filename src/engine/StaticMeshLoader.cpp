@@ -1,30 +1,154 @@
 #include "StaticMeshLoader.h"
+#include "MeshSimplifier.h"
+#include "../rhi/UploadQueue.h"
+
+static_assert(sizeof(Vec3) == 3 * sizeof(float), "Position buffers must be tightly packed.");
+
+/**
+ * Moves the vertices of the given triangles inwards, against the normal of the surface around them, so that
+ * every triangle they touch moves by at least the given distance. Vertices sharing a position are moved
+ * together, so that the surface does not crack open along seams in the texture coordinates or normals.
+ *
+ * @param positions the positions of the vertices, modified in place
+ * @param indices the indices of the triangles
+ * @param distance the distance to move each triangle by
+ */
+static void shrinkTriangles(std::vector<Vec3>& positions, const std::vector<uint32_t>& indices, float distance) {
+    std::map<std::array<float, 3>, uint32_t> groups;
+    std::vector<uint32_t> groupOf(positions.size(), ~0u);
+    for (uint32_t index: indices) {
+        const Vec3& position = positions[index];
+        groupOf[index] = groups.try_emplace({position.x, position.y, position.z}, groups.size()).first->second;
+    }
+
+    // the area weighted normal of each position, then how closely it follows its least aligned triangle
+    std::vector<Vec3> normals(groups.size(), Vec3(0.0f, 0.0f, 0.0f));
+    std::vector<float> minAlignments(groups.size(), 1.0f);
+    for (size_t i = 0; i + 2 < indices.size(); i += 3) {
+        const Vec3& p0 = positions[indices[i]];
+        Vec3 normal = (positions[indices[i + 1]] - p0).cross(positions[indices[i + 2]] - p0);
+        for (size_t j = 0; j < 3; j++) {
+            normals[groupOf[indices[i + j]]] = normals[groupOf[indices[i + j]]] + normal;
+        }
+    }
+    for (Vec3& normal: normals) {
+        float length = std::sqrt(normal.dot(normal));
+        normal = length > 0.0f ? normal * (1.0f / length) : Vec3(0.0f, 0.0f, 0.0f);
+    }
+    for (size_t i = 0; i + 2 < indices.size(); i += 3) {
+        const Vec3& p0 = positions[indices[i]];
+        Vec3 normal = (positions[indices[i + 1]] - p0).cross(positions[indices[i + 2]] - p0);
+        float length = std::sqrt(normal.dot(normal));
+        if (length == 0.0f) continue;
+
+        for (size_t j = 0; j < 3; j++) {
+            uint32_t group = groupOf[indices[i + j]];
+            minAlignments[group] = std::min(minAlignments[group], normals[group].dot(normal) / length);
+        }
+    }
+
+    // moving along the normal only moves a triangle by the cosine between them, so sharp corners move
+    // further, up to a limit past which they would cross the mesh instead
+    for (uint32_t vertex = 0; vertex < positions.size(); vertex++) {
+        if (groupOf[vertex] == ~0u) continue;
+
+        uint32_t group = groupOf[vertex];
+        positions[vertex] = positions[vertex] - normals[group] * (distance / std::max(minAlignments[group], 0.25f));
+    }
+}
 
 StaticMesh StaticMeshLoader::load(const std::string& filename) {
     RHI& rhi = RHI::current();
     m_objLoader.load(filename);
 
     std::vector<Vertex> vertices;
+    Bounds bounds{
+        .min = Vec3(INFINITY, INFINITY, INFINITY),
+        .max = Vec3(-INFINITY, -INFINITY, -INFINITY),
+    };
     for (ObjLoader::Vertex objVertex: m_objLoader.getVertices()) {
         vertices.push_back(Vertex{
             {objVertex.position.x, objVertex.position.y, objVertex.position.z},
             {objVertex.texCoord.u, objVertex.texCoord.v},
             {objVertex.normal.x,   objVertex.normal.y,   objVertex.normal.z},
         });
+
+        bounds.min = Vec3(std::min(bounds.min.x, objVertex.position.x), std::min(bounds.min.y, objVertex.position.y),
+                          std::min(bounds.min.z, objVertex.position.z));
+        bounds.max = Vec3(std::max(bounds.max.x, objVertex.position.x), std::max(bounds.max.y, objVertex.position.y),
+                          std::max(bounds.max.z, objVertex.position.z));
+    }
+    if (vertices.empty()) {
+        bounds = Bounds{};
+    }
+
+    // the full detail mesh is the first level of detail, followed by any simplified levels
+    std::vector<uint32_t> indices = m_objLoader.getIndices();
+    std::vector<MeshLod> lods = {
+        MeshLod{.baseIndex = 0, .indexCount = (uint32_t)indices.size(), .error = 0.0f},
+    };
+    std::unique_ptr<MeshSimplifier> simplifier;
+    if (!vertices.empty() && (m_maxLods > 1 || m_generateOccluders)) {
+        simplifier = std::make_unique<MeshSimplifier>(vertices[0].position, vertices[0].normal, sizeof(Vertex),
+                                                      vertices.size());
     }
+    if (m_maxLods > 1 && simplifier != nullptr) {
+        std::vector<uint32_t> previous = indices;
+        while (lods.size() < m_maxLods) {
+            auto targetIndexCount = (uint32_t)((float)previous.size() * m_lodReduction) / 3 * 3;
+            float error;
+            std::vector<uint32_t> simplified = simplifier->simplify(previous, targetIndexCount, bounds.radius(),
+                                                                    &error);
 
-    std::unique_ptr<Buffer> vertexBuffer = rhi.createBuffer(vertices.size() * sizeof(Vertex), sizeof(Vertex));
-    std::memcpy(vertexBuffer->map(), vertices.data(), vertexBuffer->size());
-    vertexBuffer->unmap();
+            // stop once the mesh can no longer be meaningfully simplified
+            if (simplified.empty() || simplified.size() * 10 > previous.size() * 9) break;
+
+            lods.push_back(MeshLod{
+                .baseIndex = (uint32_t)indices.size(),
+                .indexCount = (uint32_t)simplified.size(),
+                .error = lods.back().error + error,
+            });
+            indices.insert(indices.end(), simplified.begin(), simplified.end());
+            previous = std::move(simplified);
+        }
+    }
+
+    std::vector<Vec3> positions;
+    positions.reserve(vertices.size());
+    for (const Vertex& vertex: vertices) {
+        positions.emplace_back(vertex.position[0], vertex.position[1], vertex.position[2]);
+    }
+
+    // the levels of detail may bulge past the mesh by up to their error, which would hide meshes that are
+    // visible, so occluders are simplified separately within a tight error and then shrunk back inside
+    std::shared_ptr<OccluderMesh> occluder;
+    if (m_generateOccluders && simplifier != nullptr) {
+        occluder = std::make_shared<OccluderMesh>();
+        occluder->positions = positions;
+        float error = 0.0f;
+        occluder->indices = simplifier->simplify(m_objLoader.getIndices(), 0, m_occluderError * bounds.radius(),
+                                                 &error);
+        if (error > 0.0f) {
+            shrinkTriangles(occluder->positions, occluder->indices, error);
+        }
+    }
 
-    std::unique_ptr<Buffer> indexBuffer = rhi.createBuffer(m_objLoader.getIndices().size() * sizeof(uint32_t),
-                                                           sizeof(uint32_t));
-    std::memcpy(indexBuffer->map(), m_objLoader.getIndices().data(), indexBuffer->size());
-    indexBuffer->unmap();
+    // the geometry never changes, so is uploaded into static buffers that only the gpu reads
+    UploadQueue& uploadQueue = rhi.uploadQueue();
+    std::unique_ptr<Buffer> vertexBuffer = uploadQueue.createBuffer(vertices.data(), vertices.size() * sizeof(Vertex),
+                                                                    sizeof(Vertex));
+    std::unique_ptr<Buffer> indexBuffer = uploadQueue.createBuffer(indices.data(), indices.size() * sizeof(uint32_t),
+                                                                   sizeof(uint32_t));
+    std::unique_ptr<Buffer> positionBuffer = uploadQueue.createBuffer(positions.data(), positions.size() * sizeof(Vec3),
+                                                                      sizeof(Vec3));
 
     return StaticMesh{
         .vertexBuffer = std::move(vertexBuffer),
         .indexBuffer = std::move(indexBuffer),
+        .positionBuffer = std::move(positionBuffer),
         .material = m_defaultMaterial,
+        .bounds = bounds,
+        .lods = std::move(lods),
+        .occluder = std::move(occluder),
     };
 }
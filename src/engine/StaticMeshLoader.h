@@ -21,16 +21,52 @@ public:
      * @param defaultMaterial the default material to apply to loaded meshes, must not be nullptr
      */
     explicit StaticMeshLoader(std::shared_ptr<Material> defaultMaterial)
-        : m_defaultMaterial(std::move(defaultMaterial)) {
+        : m_defaultMaterial(std::move(defaultMaterial)), m_maxLods(1), m_lodReduction(0.5f),
+          m_generateOccluders(false), m_occluderError(0.0f) {
         if (m_defaultMaterial == nullptr) {
             throw std::invalid_argument("StaticMeshLoader requires a default material.");
         }
     }
 
+    /**
+     * Sets how many levels of detail are generated for subsequently loaded meshes. Each level
+     * is simplified from the previous one, keeping the given fraction of its triangles. Generation
+     * stops early once a mesh cannot be simplified further.
+     *
+     * @param maxLods the maximum number of levels of detail, including the full detail mesh
+     * @param reduction the fraction of triangles kept by each level, in (0, 1)
+     */
+    void setLodGeneration(uint32_t maxLods, float reduction) {
+        if (maxLods == 0 || reduction <= 0.0f || reduction >= 1.0f) {
+            throw std::invalid_argument("Invalid level of detail generation parameters.");
+        }
+
+        m_maxLods = maxLods;
+        m_lodReduction = reduction;
+    }
+
+    /**
+     * Sets whether subsequently loaded meshes are given occluder geometry, so that they hide other meshes
+     * when occlusion culling is enabled. Occluders must never cover more than their mesh, so each is
+     * simplified from the full detail mesh only as far as the given error allows, then shrunk inwards by
+     * the error it reached.
+     *
+     * @param generateOccluders whether to generate occluder geometry
+     * @param maxError the maximum simplification error of occluders, as a fraction of the mesh's bounding radius
+     */
+    void setOccluderGeneration(bool generateOccluders, float maxError = 0.01f) {
+        if (maxError < 0.0f) {
+            throw std::invalid_argument("The occluder error must not be negative.");
+        }
+
+        m_generateOccluders = generateOccluders;
+        m_occluderError = maxError;
+    }
+
     /**
      * Loads a static mesh from the given file. The mesh is assigned a default material
      * so that it is renderable immediately. Meshes returned by this function contain vertices
-     * that follow the format given by the Vertex struct.
+     * that follow the format given by the Vertex struct, and a position buffer for depth-only passes.
      *
      * @see Vertex
      * @param filename the name of the file
@@ -41,6 +77,10 @@ public:
 private:
     std::shared_ptr<Material> m_defaultMaterial;
     ObjLoader m_objLoader;
+    uint32_t m_maxLods;
+    float m_lodReduction;
+    bool m_generateOccluders;
+    float m_occluderError;
 };
 
 
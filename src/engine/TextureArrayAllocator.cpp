@@ -0,0 +1,99 @@
+#include "TextureArrayAllocator.h"
+#include "MipGenerator.h"
+#include "../rhi/UploadQueue.h"
+
+#include <bit>
+
+TextureArrayAllocator::TextureArrayAllocator(uint32_t layersPerArray) : m_layersPerArray(layersPerArray) {
+    if (layersPerArray == 0) {
+        throw std::invalid_argument("TextureArrayAllocator requires arrays of at least one layer.");
+    }
+}
+
+TextureLayer TextureArrayAllocator::allocate(Format format, uint32_t width, uint32_t height) {
+    std::vector<Page>& pages = m_pages[ArrayKey{format, width, height}];
+    auto page = std::ranges::find_if(pages, [](const Page& page) {
+        return !page.freeLayers.empty();
+    });
+
+    if (page == pages.end()) {
+        uint32_t numLevels = format == Format::RGBA8 ? std::bit_width(std::max(width, height)) : 1;
+        Page newPage{
+            .array = RHI::current().createTexture2DArray(format, width, height, m_layersPerArray, numLevels),
+        };
+        for (uint32_t layer = m_layersPerArray; layer > 0; layer--) {
+            newPage.freeLayers.push_back(layer - 1);
+        }
+        pages.push_back(std::move(newPage));
+        page = pages.end() - 1;
+    }
+
+    uint32_t layer = page->freeLayers.back();
+    page->freeLayers.pop_back();
+    return TextureLayer{page->array.get(), layer};
+}
+
+TextureLayer TextureArrayAllocator::create(Format format, uint32_t width, uint32_t height,
+                                           std::span<const uint8_t> pixels) {
+    TextureLayer layer = allocate(format, width, height);
+    try {
+        upload(layer, pixels);
+    } catch (...) {
+        free(layer);
+        throw;
+    }
+    return layer;
+}
+
+void TextureArrayAllocator::upload(const TextureLayer& layer, std::span<const uint8_t> pixels) {
+    Texture2DArray& array = *layer.array;
+    Vector<uint32_t, 3> size = array.dimensions();
+    if (pixels.size() != imageSize(array.format(), size.x, size.y)) {
+        throw std::invalid_argument("The uploaded pixels must cover the whole layer.");
+    }
+
+    UploadQueue& uploadQueue = RHI::current().uploadQueue();
+    uploadQueue.uploadTexture2DArray(array, layer.layer, 0, pixels.data(), pixels.size());
+
+    // only the levels of the uploaded layer are generated, rather than those of the whole array
+    if (array.numLevels() > 1) {
+        std::vector<std::vector<uint8_t>> mips = generateMips(pixels.data(), size.x, size.y, false);
+        for (uint32_t level = 1; level < array.numLevels(); level++) {
+            const std::vector<uint8_t>& mip = mips[level - 1];
+            uploadQueue.uploadTexture2DArray(array, layer.layer, level, mip.data(), mip.size());
+        }
+    }
+}
+
+void TextureArrayAllocator::free(const TextureLayer& layer) {
+    Page& page = findPage(layer);
+    if (layer.layer >= m_layersPerArray || std::ranges::find(page.freeLayers, layer.layer) != page.freeLayers.end()) {
+        throw std::invalid_argument("The layer is not allocated.");
+    }
+
+    page.freeLayers.push_back(layer.layer);
+}
+
+size_t TextureArrayAllocator::numArrays() const {
+    size_t numArrays = 0;
+    for (const auto& [key, pages]: m_pages) {
+        numArrays += pages.size();
+    }
+    return numArrays;
+}
+
+TextureArrayAllocator::Page& TextureArrayAllocator::findPage(const TextureLayer& layer) {
+    if (layer.array != nullptr) {
+        Vector<uint32_t, 3> size = layer.array->dimensions();
+        auto pages = m_pages.find(ArrayKey{layer.array->format(), size.x, size.y});
+        if (pages != m_pages.end()) {
+            for (Page& page: pages->second) {
+                if (page.array.get() == layer.array) {
+                    return page;
+                }
+            }
+        }
+    }
+
+    throw std::invalid_argument("The layer was not allocated by this allocator.");
+}
@@ -0,0 +1,119 @@
+#ifndef OPENGL_RENDERER_TEXTUREARRAYALLOCATOR_H
+#define OPENGL_RENDERER_TEXTUREARRAYALLOCATOR_H
+
+#include "../rhi/RHI.h"
+
+/**
+ * A texture packed into a layer of a texture array by a TextureArrayAllocator.
+ */
+struct TextureLayer {
+    Texture2DArray* array;
+    uint32_t layer;
+};
+
+/**
+ * Packs textures of the same format and size into the layers of shared texture arrays, so that materials
+ * whose textures differ only by layer can bind one array and be drawn together, selecting their layer
+ * per instance rather than binding a texture per draw.
+ *
+ * Arrays are created as needed, with a fixed number of layers each, and kept until the allocator is
+ * destroyed. Freed layers are reused by later allocations of the same format and size.
+ *
+ * Arrays of rgba8 textures have a full chain of mip-map levels, generated on the cpu for each uploaded layer
+ * as described by generateMips(), so filling an array costs the same for every layer. Arrays of other formats
+ * have a single level, as their pixels are uploaded as they are.
+ */
+class TextureArrayAllocator {
+public:
+    static constexpr uint32_t defaultLayersPerArray = 64;
+
+    /**
+     * Constructs an allocator without any arrays.
+     *
+     * @param layersPerArray the number of layers of each array created
+     * @throws std::invalid_argument if the number of layers is zero
+     */
+    explicit TextureArrayAllocator(uint32_t layersPerArray = defaultLayersPerArray);
+
+    TextureArrayAllocator(const TextureArrayAllocator&) = delete;
+
+    /**
+     * Allocates a layer for a texture of the given format and size, creating an array if every array of
+     * that format and size is full. The layer's pixels are undefined until uploaded.
+     *
+     * @param format the format of the texture's pixels
+     * @param width the width of the texture, in pixels
+     * @param height the height of the texture, in pixels
+     * @returns the array and layer holding the texture
+     */
+    TextureLayer allocate(Format format, uint32_t width, uint32_t height);
+
+    /**
+     * Allocates a layer for a texture and uploads its pixels.
+     *
+     * @param format the format of the texture's pixels
+     * @param width the width of the texture, in pixels
+     * @param height the height of the texture, in pixels
+     * @param pixels the pixels of the texture in its format, in tightly packed rows from the bottom
+     * @returns the array and layer holding the texture
+     * @throws std::invalid_argument if the pixels are not the size of the texture
+     */
+    TextureLayer create(Format format, uint32_t width, uint32_t height, std::span<const uint8_t> pixels);
+
+    /**
+     * Overwrites the pixels of an allocated layer through the api's upload queue, along with its other levels
+     * if it has them.
+     *
+     * @param layer the layer to write
+     * @param pixels the pixels of the texture in the array's format, in tightly packed rows from the bottom
+     * @throws std::invalid_argument if the pixels are not the size of the layer
+     */
+    void upload(const TextureLayer& layer, std::span<const uint8_t> pixels);
+
+    /**
+     * Frees a layer, so that it can be reused by a later allocation. Draws already submitted may still
+     * read the layer, so it should only be freed once no draws of the current frame use it.
+     *
+     * @param layer the layer to free
+     * @throws std::invalid_argument if the layer was not allocated by this allocator, or is already free
+     */
+    void free(const TextureLayer& layer);
+
+    /**
+     * @returns the number of arrays created
+     */
+    size_t numArrays() const;
+
+private:
+    /**
+     * The format and size shared by the textures in an array.
+     */
+    struct ArrayKey {
+        Format format;
+        uint32_t width;
+        uint32_t height;
+
+        auto operator<=>(const ArrayKey&) const = default;
+    };
+
+    /**
+     * An array and the layers of it that are not allocated.
+     */
+    struct Page {
+        std::unique_ptr<Texture2DArray> array;
+        std::vector<uint32_t> freeLayers; // in the order they are allocated, from the back
+    };
+
+    /**
+     * @param layer a layer allocated by this allocator
+     * @returns the page holding the layer
+     * @throws std::invalid_argument if the layer was not allocated by this allocator
+     */
+    Page& findPage(const TextureLayer& layer);
+
+    uint32_t m_layersPerArray;
+    std::map<ArrayKey, std::vector<Page>> m_pages;
+};
+
+
+#endif //OPENGL_RENDERER_TEXTUREARRAYALLOCATOR_H
@@ -0,0 +1,367 @@
+#include "TextureEncoder.h"
+#include "../util/ThreadPool.h"
+
+namespace {
+    using BlockPixels = std::array<std::array<uint8_t, 4>, 16>;
+
+    /**
+     * Reads the 4x4 block of pixels at the given block coordinates, repeating the last row and column of the
+     * image for blocks that extend past its edge.
+     */
+    BlockPixels loadBlock(const uint8_t* pixels, uint32_t width, uint32_t height, uint32_t blockX, uint32_t blockY) {
+        BlockPixels block{};
+        for (uint32_t y = 0; y < 4; y++) {
+            uint32_t pixelY = std::min(blockY * 4 + y, height - 1);
+            for (uint32_t x = 0; x < 4; x++) {
+                uint32_t pixelX = std::min(blockX * 4 + x, width - 1);
+                std::memcpy(block[y * 4 + x].data(), &pixels[((size_t)pixelY * width + pixelX) * 4], 4);
+            }
+        }
+        return block;
+    }
+
+    /**
+     * Fits a pair of endpoints to the first N channels of a set of pixels, at the extremes of their projection
+     * onto the principal axis of their covariance, inset slightly so that the interpolated values between
+     * them are spent where most pixels lie.
+     *
+     * @param pixels the pixels to fit
+     * @param count the number of pixels, at least one
+     * @param low set to the endpoint at the low end of the axis
+     * @param high set to the endpoint at the high end of the axis
+     */
+    template<int N>
+    void fitEndpoints(const std::array<uint8_t, 4>* pixels, uint32_t count, float (&low)[N], float (&high)[N]) {
+        float mean[N] = {};
+        for (uint32_t i = 0; i < count; i++) {
+            for (int c = 0; c < N; c++) {
+                mean[c] += pixels[i][c];
+            }
+        }
+        for (float& value: mean) {
+            value /= (float)count;
+        }
+
+        float covariance[N][N] = {};
+        for (uint32_t i = 0; i < count; i++) {
+            for (int a = 0; a < N; a++) {
+                for (int b = 0; b < N; b++) {
+                    covariance[a][b] += ((float)pixels[i][a] - mean[a]) * ((float)pixels[i][b] - mean[b]);
+                }
+            }
+        }
+
+        // the principal axis is found by power iteration, which converges in a few steps for 16 pixels
+        float axis[N];
+        std::fill(axis, axis + N, 1.0f);
+        for (int iteration = 0; iteration < 8; iteration++) {
+            float next[N] = {};
+            float length = 0.0f;
+            for (int a = 0; a < N; a++) {
+                for (int b = 0; b < N; b++) {
+                    next[a] += covariance[a][b] * axis[b];
+                }
+                length = std::max(length, std::abs(next[a]));
+            }
+            if (length == 0.0f) {
+                break;
+            }
+            for (int a = 0; a < N; a++) {
+                axis[a] = next[a] / length;
+            }
+        }
+
+        float lengthSquared = 0.0f;
+        for (float value: axis) {
+            lengthSquared += value * value;
+        }
+        float minT = 0.0f;
+        float maxT = 0.0f;
+        if (lengthSquared > 0.0f) {
+            minT = INFINITY;
+            maxT = -INFINITY;
+            for (uint32_t i = 0; i < count; i++) {
+                float t = 0.0f;
+                for (int c = 0; c < N; c++) {
+                    t += ((float)pixels[i][c] - mean[c]) * axis[c];
+                }
+                minT = std::min(minT, t / lengthSquared);
+                maxT = std::max(maxT, t / lengthSquared);
+            }
+        }
+
+        float inset = (maxT - minT) / 16.0f;
+        for (int c = 0; c < N; c++) {
+            low[c] = std::clamp(mean[c] + axis[c] * (minT + inset), 0.0f, 255.0f);
+            high[c] = std::clamp(mean[c] + axis[c] * (maxT - inset), 0.0f, 255.0f);
+        }
+    }
+
+    template<int N>
+    int distanceSquared(const int (&a)[N], const uint8_t* b) {
+        int distance = 0;
+        for (int c = 0; c < N; c++) {
+            distance += (a[c] - b[c]) * (a[c] - b[c]);
+        }
+        return distance;
+    }
+
+    /**
+     * Encodes a single channel of a block in 8 bytes, as BC4 and the alpha of BC3 store it.
+     */
+    void encodeBC4(const BlockPixels& block, int channel, uint8_t* out) {
+        uint8_t low = 255;
+        uint8_t high = 0;
+        for (const auto& pixel: block) {
+            low = std::min(low, pixel[channel]);
+            high = std::max(high, pixel[channel]);
+        }
+
+        // with the first endpoint greater, the endpoints are followed by six values evenly between them
+        int palette[8] = {high, low};
+        for (int i = 2; i < 8; i++) {
+            palette[i] = ((8 - i) * high + (i - 1) * low) / 7;
+        }
+
+        uint64_t indices = 0;
+        if (high > low) {
+            for (int i = 0; i < 16; i++) {
+                int best = 0;
+                for (int j = 1; j < 8; j++) {
+                    if (std::abs(palette[j] - block[i][channel]) < std::abs(palette[best] - block[i][channel])) {
+                        best = j;
+                    }
+                }
+                indices |= (uint64_t)best << (3 * i);
+            }
+        }
+
+        out[0] = high;
+        out[1] = low;
+        for (int i = 0; i < 6; i++) {
+            out[2 + i] = (uint8_t)(indices >> (8 * i));
+        }
+    }
+
+    uint16_t toRGB565(const float (&color)[3]) {
+        auto r = (uint16_t)std::lround(color[0] * 31.0f / 255.0f);
+        auto g = (uint16_t)std::lround(color[1] * 63.0f / 255.0f);
+        auto b = (uint16_t)std::lround(color[2] * 31.0f / 255.0f);
+        return (uint16_t)(r << 11 | g << 5 | b);
+    }
+
+    void fromRGB565(uint16_t value, int (&color)[3]) {
+        int r = value >> 11 & 31;
+        int g = value >> 5 & 63;
+        int b = value & 31;
+        color[0] = r << 3 | r >> 2;
+        color[1] = g << 2 | g >> 4;
+        color[2] = b << 3 | b >> 2;
+    }
+
+    /**
+     * Encodes the colors of a block in 8 bytes, as BC1 and BC3 store them. With transparency allowed, pixels
+     * of less than half alpha are stored as transparent, which BC1 interpolates one fewer color for.
+     */
+    void encodeBC1(const BlockPixels& block, bool allowTransparency, uint8_t* out) {
+        std::array<std::array<uint8_t, 4>, 16> opaque{};
+        uint32_t numOpaque = 0;
+        for (const auto& pixel: block) {
+            if (!allowTransparency || pixel[3] >= 128) {
+                opaque[numOpaque++] = pixel;
+            }
+        }
+        bool transparent = numOpaque < 16;
+
+        uint16_t color0 = 0;
+        uint16_t color1 = 0;
+        if (numOpaque > 0) {
+            float low[3];
+            float high[3];
+            fitEndpoints<3>(opaque.data(), numOpaque, low, high);
+            color0 = toRGB565(high);
+            color1 = toRGB565(low);
+        }
+
+        // the order of the endpoints selects whether the block has four colors, or three and transparency
+        if (transparent ? color0 > color1 : color0 < color1) {
+            std::swap(color0, color1);
+        }
+        int numColors = color0 > color1 ? 4 : 3;
+
+        int palette[4][3];
+        fromRGB565(color0, palette[0]);
+        fromRGB565(color1, palette[1]);
+        for (int c = 0; c < 3; c++) {
+            if (numColors == 4) {
+                palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+                palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+            } else {
+                palette[2][c] = (palette[0][c] + palette[1][c]) / 2;
+                palette[3][c] = 0;
+            }
+        }
+
+        uint32_t indices = 0;
+        for (int i = 0; i < 16; i++) {
+            int best = 0;
+            if (allowTransparency && block[i][3] < 128) {
+                best = 3;
+            } else {
+                for (int j = 1; j < numColors; j++) {
+                    if (distanceSquared(palette[j], block[i].data()) < distanceSquared(palette[best], block[i].data())) {
+                        best = j;
+                    }
+                }
+            }
+            indices |= (uint32_t)best << (2 * i);
+        }
+
+        std::memcpy(&out[0], &color0, 2);
+        std::memcpy(&out[2], &color1, 2);
+        std::memcpy(&out[4], &indices, 4);
+    }
+
+    /**
+     * Writes values to a block a number of bits at a time, from the least significant bit of the block.
+     */
+    class BitWriter {
+    public:
+        explicit BitWriter(uint8_t* out) : m_out(out), m_position(0) {}
+
+        void write(uint32_t value, uint32_t numBits) {
+            for (uint32_t i = 0; i < numBits; i++, m_position++) {
+                m_out[m_position / 8] |= (uint8_t)((value >> i & 1) << m_position % 8);
+            }
+        }
+
+    private:
+        uint8_t* m_out;
+        uint32_t m_position;
+    };
+
+    // a 7-bit rgba endpoint of BC7 mode 6, extended to 8 bits by a p-bit shared by its channels
+    struct BC7Endpoint {
+        uint32_t color[4];
+        uint32_t pBit;
+    };
+
+    BC7Endpoint quantizeBC7(const float (&endpoint)[4]) {
+        BC7Endpoint best{};
+        float bestError = INFINITY;
+        for (uint32_t pBit = 0; pBit < 2; pBit++) {
+            BC7Endpoint quantized{.pBit = pBit};
+            float error = 0.0f;
+            for (int c = 0; c < 4; c++) {
+                quantized.color[c] = (uint32_t)std::clamp(std::lround((endpoint[c] - (float)pBit) / 2.0f), 0l, 127l);
+                float value = (float)(quantized.color[c] << 1 | pBit);
+                error += (value - endpoint[c]) * (value - endpoint[c]);
+            }
+            if (error < bestError) {
+                best = quantized;
+                bestError = error;
+            }
+        }
+        return best;
+    }
+
+    /**
+     * Encodes a block in 16 bytes as BC7 mode 6, a single subset of rgba endpoints with 16 values between.
+     */
+    void encodeBC7(const BlockPixels& block, uint8_t* out) {
+        constexpr int weights[16] = {0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64};
+
+        float low[4];
+        float high[4];
+        fitEndpoints<4>(block.data(), 16, low, high);
+        BC7Endpoint endpoints[2] = {quantizeBC7(low), quantizeBC7(high)};
+
+        int palette[16][4];
+        for (int i = 0; i < 16; i++) {
+            for (int c = 0; c < 4; c++) {
+                auto value0 = (int)(endpoints[0].color[c] << 1 | endpoints[0].pBit);
+                auto value1 = (int)(endpoints[1].color[c] << 1 | endpoints[1].pBit);
+                palette[i][c] = ((64 - weights[i]) * value0 + weights[i] * value1 + 32) >> 6;
+            }
+        }
+
+        uint32_t indices[16];
+        for (int i = 0; i < 16; i++) {
+            int best = 0;
+            int bestDistance = distanceSquared(palette[0], block[i].data());
+            for (int j = 1; j < 16; j++) {
+                int distance = distanceSquared(palette[j], block[i].data());
+                if (distance < bestDistance) {
+                    best = j;
+                    bestDistance = distance;
+                }
+            }
+            indices[i] = best;
+        }
+
+        // the most significant bit of the first pixel's index is not stored, and must be 0
+        if (indices[0] >= 8) {
+            std::swap(endpoints[0], endpoints[1]);
+            for (uint32_t& index: indices) {
+                index = 15 - index;
+            }
+        }
+
+        std::memset(out, 0, 16);
+        BitWriter writer(out);
+        writer.write(1 << 6, 7);
+        for (int c = 0; c < 4; c++) {
+            writer.write(endpoints[0].color[c], 7);
+            writer.write(endpoints[1].color[c], 7);
+        }
+        writer.write(endpoints[0].pBit, 1);
+        writer.write(endpoints[1].pBit, 1);
+        for (int i = 0; i < 16; i++) {
+            writer.write(indices[i], i == 0 ? 3 : 4);
+        }
+    }
+
+    void encodeBlock(Format format, const BlockPixels& block, uint8_t* out) {
+        switch (format) {
+            case Format::BC1:
+                encodeBC1(block, true, out);
+                break;
+            case Format::BC3:
+                encodeBC4(block, 3, out);
+                encodeBC1(block, false, out + 8);
+                break;
+            case Format::BC4:
+                encodeBC4(block, 0, out);
+                break;
+            case Format::BC5:
+                encodeBC4(block, 0, out);
+                encodeBC4(block, 1, out + 8);
+                break;
+            case Format::BC7:
+                encodeBC7(block, out);
+                break;
+            default:
+                break;
+        }
+    }
+}
+
+std::vector<uint8_t> encodeBlocks(Format format, const uint8_t* pixels, uint32_t width, uint32_t height) {
+    if (!isBlockCompressed(format)) {
+        throw std::invalid_argument("Images can only be encoded in block-compressed formats.");
+    }
+
+    uint32_t blocksX = (width + 3) / 4;
+    uint32_t blocksY = (height + 3) / 4;
+    uint32_t blockSize = formatBlockSize(format);
+    std::vector<uint8_t> blocks(imageSize(format, width, height));
+
+    // rows of blocks are encoded independently, spread across the engine's threads
+    ThreadPool::shared().parallelFor(blocksY, [&](uint32_t blockY) {
+        for (uint32_t blockX = 0; blockX < blocksX; blockX++) {
+            BlockPixels block = loadBlock(pixels, width, height, blockX, blockY);
+            encodeBlock(format, block, &blocks[((size_t)blockY * blocksX + blockX) * blockSize]);
+        }
+    });
+    return blocks;
+}
@@ -0,0 +1,27 @@
+#ifndef OPENGL_RENDERER_TEXTUREENCODER_H
+#define OPENGL_RENDERER_TEXTUREENCODER_H
+
+#include <vector>
+
+#include "../rhi/Format.h"
+
+/**
+ * Encodes an image of rgba8 pixels in a block-compressed format, for textures that are compressed offline
+ * by the art pipeline. BC4 stores the red channel and BC5 the red and green channels, while BC1 stores
+ * pixels with less than half alpha as transparent.
+ *
+ * Each block's endpoints are fit to the range of its pixels along their principal axis, which is fast and
+ * close in quality to an exhaustive search for all but blocks of several distinct colors. BC7 is encoded in
+ * its single-subset mode of 7-bit rgba endpoints, which suits the smooth gradients of most textures.
+ *
+ * @param format the block-compressed format to encode in
+ * @param pixels the rgba8 pixels of the image, with tightly packed rows
+ * @param width the width of the image, in pixels
+ * @param height the height of the image, in pixels
+ * @returns the blocks of the image, with tightly packed rows of blocks
+ * @throws std::invalid_argument if the format is not block-compressed
+ */
+std::vector<uint8_t> encodeBlocks(Format format, const uint8_t* pixels, uint32_t width, uint32_t height);
+
+
+#endif //OPENGL_RENDERER_TEXTUREENCODER_H
@@ -1 +1,81 @@
 #include "TextureLoader.h"
+#include "Ktx2.h"
+#include "MipGenerator.h"
+#include "../rhi/UploadQueue.h"
+#include "../util/MappedFile.h"
+
+#include <deque>
+
+std::unique_ptr<Texture2D> TextureLoader::load(const std::string& filename) {
+    return upload(decode(filename));
+}
+
+std::vector<std::unique_ptr<Texture2D>> TextureLoader::loadAll(const std::vector<std::string>& filenames) {
+    // each worker has an image waiting to upload while it decodes the next, so neither side waits long
+    size_t maxDecoding = 2 * (size_t)m_pool.size();
+    std::deque<std::future<DecodedImage>> decoding;
+    size_t numSubmitted = 0;
+
+    std::vector<std::unique_ptr<Texture2D>> textures;
+    textures.reserve(filenames.size());
+    while (textures.size() < filenames.size()) {
+        while (numSubmitted < filenames.size() && decoding.size() < maxDecoding) {
+            // the name is copied, as decodes still queued when one throws outlive the call
+            decoding.push_back(m_pool.submit([filename = filenames[numSubmitted]]() {
+                return decode(filename);
+            }));
+            numSubmitted++;
+        }
+
+        DecodedImage image = decoding.front().get();
+        decoding.pop_front();
+        textures.push_back(upload(image));
+    }
+    return textures;
+}
+
+std::unique_ptr<Texture2D> TextureLoader::loadKtx2(const std::string& filename) {
+    RHI& rhi = RHI::current();
+    MappedFile file(filename);
+    Ktx2Texture ktx2 = parseKtx2(file.data());
+
+    std::unique_ptr<Texture2D> texture = rhi.createTexture2D(ktx2.format, ktx2.width, ktx2.height, 1,
+                                                             (uint32_t)ktx2.levels.size());
+    for (uint32_t level = 0; level < ktx2.levels.size(); level++) {
+        rhi.uploadQueue().uploadTexture2D(*texture, level, ktx2.levels[level].data(), ktx2.levels[level].size());
+    }
+    return texture;
+}
+
+TextureLoader::DecodedImage TextureLoader::decode(const std::string& filename) {
+    int width;
+    int height;
+    int channels;
+    stbi_uc* pixels = stbi_load(filename.c_str(), &width, &height, &channels, 4);
+    if (pixels == nullptr) {
+        throw std::runtime_error("Failed to decode image " + filename + ": " + stbi_failure_reason());
+    }
+
+    DecodedImage image{
+        .width = (uint32_t)width,
+        .height = (uint32_t)height,
+        .pixels = {pixels, stbi_image_free},
+    };
+    // rgba8 textures are sampled without srgb conversion, so their levels average the stored values
+    image.mips = generateMips(image.pixels.get(), image.width, image.height, false);
+    return image;
+}
+
+std::unique_ptr<Texture2D> TextureLoader::upload(const DecodedImage& image) {
+    RHI& rhi = RHI::current();
+    auto numLevels = (uint32_t)image.mips.size() + 1;
+    std::unique_ptr<Texture2D> texture = rhi.createTexture2D(Format::RGBA8, image.width, image.height, 1, numLevels);
+
+    UploadQueue& uploadQueue = rhi.uploadQueue();
+    uploadQueue.uploadTexture2D(*texture, 0, image.pixels.get(), imageSize(Format::RGBA8, image.width, image.height));
+    for (uint32_t level = 1; level < numLevels; level++) {
+        const std::vector<uint8_t>& mip = image.mips[level - 1];
+        uploadQueue.uploadTexture2D(*texture, level, mip.data(), mip.size());
+    }
+    return texture;
+}
@@ -1,9 +1,72 @@
 #ifndef OPENGL_RENDERER_TEXTURELOADER_H
 #define OPENGL_RENDERER_TEXTURELOADER_H
 
+#include "../rhi/RHI.h"
+#include "../util/ThreadPool.h"
 
 class TextureLoader {
+public:
+    /**
+     * Constructs a texture loader that decodes images on the given pool.
+     *
+     * @param pool the pool to decode images on, which must outlive the loader
+     */
+    explicit TextureLoader(ThreadPool& pool = ThreadPool::shared()) : m_pool(pool) {}
 
+    /**
+     * Loads an rgba8 2d texture from an image file, such as a png or jpeg, with a full chain of mip-map
+     * levels generated on the cpu as described by generateMips().
+     *
+     * @param filename the path of the file
+     * @returns the texture
+     * @throws std::runtime_error if the file cannot be read or decoded
+     */
+    std::unique_ptr<Texture2D> load(const std::string& filename);
+
+    /**
+     * Loads many textures as load() does. Images are decoded and their levels generated on the pool, while
+     * the calling thread streams the levels of those already decoded into the upload queue's staging memory,
+     * so loading scales with the number of threads in the pool. Decoding is kept a few images ahead of
+     * uploading, which bounds the memory held by decoded images however many files are loaded.
+     *
+     * @param filenames the paths of the files
+     * @returns the textures, in the order of their files
+     * @throws std::runtime_error if a file cannot be read or decoded
+     */
+    std::vector<std::unique_ptr<Texture2D>> loadAll(const std::vector<std::string>& filenames);
+
+    /**
+     * Loads a 2d texture from a KTX 2.0 file, such as one written by the texture_compress tool. The file is
+     * mapped into memory and each of its levels is copied from there to staging memory, so that textures
+     * compressed offline reach the gpu without being decoded or copied on the cpu first.
+     *
+     * @param filename the path of the file
+     * @returns the texture, with the levels stored in the file
+     * @throws std::runtime_error if the file cannot be read, or holds a texture that is not supported
+     * @throws std::invalid_argument if the api cannot create textures of the file's format
+     */
+    std::unique_ptr<Texture2D> loadKtx2(const std::string& filename);
+
+private:
+    // the pixels of an image and the levels generated below it, which are all rgba8
+    struct DecodedImage {
+        uint32_t width;
+        uint32_t height;
+        std::unique_ptr<uint8_t, void (*)(void*)> pixels;
+        std::vector<std::vector<uint8_t>> mips;
+    };
+
+    /**
+     * Decodes an image file and generates its levels, on any thread.
+     */
+    static DecodedImage decode(const std::string& filename);
+
+    /**
+     * Creates the texture of a decoded image and uploads its levels, on the thread that owns the api.
+     */
+    static std::unique_ptr<Texture2D> upload(const DecodedImage& image);
+
+    ThreadPool& m_pool;
 };
 
 
@@ -1,13 +1,33 @@
 #ifndef OPENGL_RENDERER_BUFFER_H
 #define OPENGL_RENDERER_BUFFER_H
 
+#include "ResourceId.h"
+
+/**
+ * How a buffer is written and read, which decides where its memory is placed.
+ */
+enum class BufferUsage {
+    Static, // written once through an UploadQueue, then only read by the gpu, placed in the fastest memory
+    Dynamic, // written by the cpu occasionally, and read by the gpu many times in between
+    Stream, // written by the cpu every frame, and read by the gpu a few times, such as uniform rings
+    Staging, // written by the cpu, and only copied from by the gpu
+    Readback, // written by the gpu, and read by the cpu
+};
 
 class Buffer {
 public:
-    explicit Buffer(uint32_t size, uint32_t stride) : m_size(size), m_stride(stride) {}
+    Buffer(uint32_t size, uint32_t stride, BufferUsage usage)
+        : m_id(nextResourceId()), m_size(size), m_stride(stride), m_usage(usage) {}
 
     virtual ~Buffer() = default;
 
+    /**
+     * @returns the id of the buffer, which is unique among all resources ever created
+     */
+    uint64_t id() const {
+        return m_id;
+    }
+
     /**
      * @returns the size of the buffer, in bytes
      */
@@ -23,20 +43,38 @@ public:
     }
 
     /**
-     * Maps the entire buffer to host memory through which it can be written to.
+     * @returns how the buffer is written and read
+     */
+    BufferUsage usage() const {
+        return m_usage;
+    }
+
+    /**
+     * @returns whether the buffer can be mapped, which static buffers cannot
+     */
+    bool isMappable() const {
+        return m_usage != BufferUsage::Static;
+    }
+
+    /**
+     * Maps the entire buffer to host memory through which it can be written to, or read from for
+     * readback buffers.
      *
      * @returns a pointer to mapped region of host memory
+     * @throws std::domain_error if the buffer is static
      */
     void* map() {
         return map(0, m_size);
     }
 
     /**
-     * Maps a region of the buffer to host memory through which it can be written to.
+     * Maps a region of the buffer to host memory through which it can be written to, or read from for
+     * readback buffers.
      *
      * @param offset the offset of region into the buffer, in bytes
      * @param size the size of the region, in bytes
      * @returns a pointer to mapped region of host memory
+     * @throws std::domain_error if the buffer is static
      */
     virtual void* map(uint32_t offset, uint32_t size) = 0;
 
@@ -50,9 +88,21 @@ public:
      */
     virtual bool isMapped() const = 0;
 
+    /**
+     * Marks a range of a persistently mapped buffer as written by the cpu, once the writes to it are
+     * complete. Mappings are coherent on every api, so this does nothing by default, but apis that track
+     * uploads count the range.
+     *
+     * @param offset the offset of the range into the buffer, in bytes
+     * @param size the size of the range, in bytes
+     */
+    virtual void flush([[maybe_unused]] uint32_t offset, [[maybe_unused]] uint32_t size) {}
+
 private:
+    uint64_t m_id;
     uint32_t m_size;
     uint32_t m_stride;
+    BufferUsage m_usage;
 };
 
 
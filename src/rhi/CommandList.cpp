@@ -0,0 +1,114 @@
+#include "CommandList.h"
+#include "RHI.h"
+
+template<typename T>
+uint8_t* CommandList::append(CommandType type, const T& command, uint32_t extraSize) {
+    static_assert(std::is_trivially_copyable_v<T>, "Commands must be trivially copyable.");
+    static_assert(alignof(T) <= commandAlignment, "Commands must not need more alignment than their header.");
+
+    // the command directly follows its header, and is padded to keep the next command aligned
+    uint32_t size = (sizeof(CommandHeader) + sizeof(T) + extraSize + commandAlignment - 1)
+                    / commandAlignment * commandAlignment;
+
+    size_t start = m_data.size();
+    m_data.resize(start + size);
+    uint8_t* data = m_data.data() + start;
+
+    CommandHeader header{.type = type, .size = size};
+    std::memcpy(data, &header, sizeof(header));
+    std::memcpy(data + sizeof(CommandHeader), &command, sizeof(T));
+
+    m_numCommands++;
+    return data + sizeof(CommandHeader) + sizeof(T);
+}
+
+void CommandList::bindPipeline(const Pipeline& pipeline) {
+    append(CommandType::BindPipeline, BindPipelineCommand{std::addressof(pipeline)});
+}
+
+void CommandList::bindVertexBuffer(const Buffer& buffer, uint32_t binding, uint32_t offset, uint32_t stride) {
+    append(CommandType::BindVertexBuffer, BindVertexBufferCommand{std::addressof(buffer), binding, offset, stride});
+}
+
+void CommandList::bindIndexBuffer(const Buffer& buffer) {
+    append(CommandType::BindIndexBuffer, BindIndexBufferCommand{std::addressof(buffer)});
+}
+
+void CommandList::bindDescriptorSet(const DescriptorSet& descriptorSet, std::span<const uint32_t> dynamicOffsets) {
+    auto numDynamicOffsets = (uint32_t)dynamicOffsets.size();
+    uint8_t* offsets = append(CommandType::BindDescriptorSet,
+                              BindDescriptorSetCommand{std::addressof(descriptorSet), numDynamicOffsets},
+                              numDynamicOffsets * sizeof(uint32_t));
+    if (numDynamicOffsets > 0) {
+        std::memcpy(offsets, dynamicOffsets.data(), dynamicOffsets.size_bytes());
+    }
+}
+
+void CommandList::setViewport(uint32_t x, uint32_t y, uint32_t width, uint32_t height) {
+    append(CommandType::SetViewport, SetViewportCommand{x, y, width, height});
+}
+
+void CommandList::draw(uint32_t vertexCount, uint32_t baseVertex) {
+    append(CommandType::Draw, DrawCommand{vertexCount, baseVertex});
+}
+
+void CommandList::drawIndexed(uint32_t indexCount, uint32_t baseIndex, uint32_t baseVertex) {
+    append(CommandType::DrawIndexed, DrawIndexedCommand{indexCount, baseIndex, baseVertex});
+}
+
+void CommandList::copyBufferToTexture2D(Buffer& source, Texture2D& destination) {
+    append(CommandType::CopyBufferToTexture2D,
+           CopyBufferToTexture2DCommand{std::addressof(source), std::addressof(destination)});
+}
+
+void CommandList::execute(RHI& rhi) const {
+    const uint8_t* data = m_data.data();
+    const uint8_t* end = data + m_data.size();
+
+    while (data < end) {
+        CommandHeader header{};
+        std::memcpy(&header, data, sizeof(header));
+
+        switch (header.type) {
+            case CommandType::BindPipeline:
+                rhi.bindPipeline(*read<BindPipelineCommand>(data).pipeline);
+                break;
+            case CommandType::BindVertexBuffer: {
+                const auto& bind = read<BindVertexBufferCommand>(data);
+                rhi.bindVertexBuffer(*bind.buffer, bind.binding, bind.offset, bind.stride);
+                break;
+            }
+            case CommandType::BindIndexBuffer:
+                rhi.bindIndexBuffer(*read<BindIndexBufferCommand>(data).buffer);
+                break;
+            case CommandType::BindDescriptorSet: {
+                const auto& bind = read<BindDescriptorSetCommand>(data);
+                auto offsets = reinterpret_cast<const uint32_t*>(&bind + 1);
+                rhi.bindDescriptorSet(*bind.descriptorSet, std::span<const uint32_t>(offsets, bind.numDynamicOffsets));
+                break;
+            }
+            case CommandType::SetViewport: {
+                const auto& viewport = read<SetViewportCommand>(data);
+                rhi.setViewport(viewport.x, viewport.y, viewport.width, viewport.height);
+                break;
+            }
+            case CommandType::Draw: {
+                const auto& draw = read<DrawCommand>(data);
+                rhi.draw(draw.vertexCount, draw.baseVertex);
+                break;
+            }
+            case CommandType::DrawIndexed: {
+                const auto& draw = read<DrawIndexedCommand>(data);
+                rhi.drawIndexed(draw.indexCount, draw.baseIndex, draw.baseVertex);
+                break;
+            }
+            case CommandType::CopyBufferToTexture2D: {
+                const auto& copy = read<CopyBufferToTexture2DCommand>(data);
+                rhi.copyBufferToTexture2D(*copy.source, *copy.destination);
+                break;
+            }
+        }
+
+        data += header.size;
+    }
+}
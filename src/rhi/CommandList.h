@@ -0,0 +1,202 @@
+#ifndef OPENGL_RENDERER_COMMANDLIST_H
+#define OPENGL_RENDERER_COMMANDLIST_H
+
+#include "Buffer.h"
+#include "Texture2D.h"
+#include "Pipeline.h"
+#include "DescriptorSet.h"
+
+class RHI;
+
+/**
+ * A list of bind, draw and copy commands recorded for later submission through RHI::submit().
+ *
+ * Commands are stored in a compact linear stream of bytes, which keeps its capacity when the list is
+ * reset, so recording a list every frame does not allocate once the stream is large enough. Recording
+ * makes no api calls, so separate command lists may be recorded on separate threads. Resources are
+ * referenced rather than owned, and must remain valid until the list is submitted.
+ */
+class CommandList {
+public:
+    CommandList() = default;
+    CommandList(const CommandList&) = delete;
+    CommandList(CommandList&&) = default;
+    CommandList& operator=(CommandList&&) = default;
+
+    /**
+     * Records binding a pipeline.
+     *
+     * @see RHI::bindPipeline()
+     */
+    void bindPipeline(const Pipeline& pipeline);
+
+    /**
+     * Records binding a vertex buffer.
+     *
+     * @see RHI::bindVertexBuffer()
+     */
+    void bindVertexBuffer(const Buffer& buffer, uint32_t binding) {
+        bindVertexBuffer(buffer, binding, 0, buffer.stride());
+    }
+
+    /**
+     * Records binding a range of a buffer as a vertex buffer.
+     *
+     * @see RHI::bindVertexBuffer()
+     */
+    void bindVertexBuffer(const Buffer& buffer, uint32_t binding, uint32_t offset, uint32_t stride);
+
+    /**
+     * Records binding an index buffer.
+     *
+     * @see RHI::bindIndexBuffer()
+     */
+    void bindIndexBuffer(const Buffer& buffer);
+
+    /**
+     * Records binding a descriptor set. The dynamic offsets are copied into the list.
+     *
+     * @see RHI::bindDescriptorSet()
+     */
+    void bindDescriptorSet(const DescriptorSet& descriptorSet, std::span<const uint32_t> dynamicOffsets = {});
+
+    /**
+     * Records setting the viewport.
+     *
+     * @see RHI::setViewport()
+     */
+    void setViewport(uint32_t x, uint32_t y, uint32_t width, uint32_t height);
+
+    /**
+     * Records a draw with direct vertices.
+     *
+     * @see RHI::draw()
+     */
+    void draw(uint32_t vertexCount, uint32_t baseVertex);
+
+    /**
+     * Records a draw with indexed vertices.
+     *
+     * @see RHI::drawIndexed()
+     */
+    void drawIndexed(uint32_t indexCount, uint32_t baseIndex, uint32_t baseVertex);
+
+    /**
+     * Records a copy from a buffer to a 2d texture.
+     *
+     * @see RHI::copyBufferToTexture2D()
+     */
+    void copyBufferToTexture2D(Buffer& source, Texture2D& destination);
+
+    /**
+     * Replays the recorded commands, in order of recording, through the given api.
+     *
+     * @param rhi the api to issue the commands to
+     */
+    void execute(RHI& rhi) const;
+
+    /**
+     * Removes all recorded commands, keeping the memory allocated for them.
+     */
+    void reset() {
+        m_data.clear();
+        m_numCommands = 0;
+    }
+
+    /**
+     * @returns the number of commands recorded
+     */
+    uint32_t numCommands() const {
+        return m_numCommands;
+    }
+
+    /**
+     * @returns whether no commands are recorded
+     */
+    bool empty() const {
+        return m_numCommands == 0;
+    }
+
+private:
+    enum class CommandType : uint32_t {
+        BindPipeline, BindVertexBuffer, BindIndexBuffer, BindDescriptorSet, SetViewport, Draw, DrawIndexed,
+        CopyBufferToTexture2D,
+    };
+
+    /**
+     * Precedes each command in the stream. The size includes the header and any padding, so that the
+     * next command starts aligned.
+     */
+    struct alignas(8) CommandHeader {
+        CommandType type;
+        uint32_t size;
+    };
+
+    struct BindPipelineCommand {
+        const Pipeline* pipeline;
+    };
+
+    struct BindVertexBufferCommand {
+        const Buffer* buffer;
+        uint32_t binding;
+        uint32_t offset;
+        uint32_t stride;
+    };
+
+    struct BindIndexBufferCommand {
+        const Buffer* buffer;
+    };
+
+    struct BindDescriptorSetCommand {
+        const DescriptorSet* descriptorSet;
+        uint32_t numDynamicOffsets; // followed by the dynamic offsets
+    };
+
+    struct SetViewportCommand {
+        uint32_t x, y, width, height;
+    };
+
+    struct DrawCommand {
+        uint32_t vertexCount;
+        uint32_t baseVertex;
+    };
+
+    struct DrawIndexedCommand {
+        uint32_t indexCount;
+        uint32_t baseIndex;
+        uint32_t baseVertex;
+    };
+
+    struct CopyBufferToTexture2DCommand {
+        Buffer* source;
+        Texture2D* destination;
+    };
+
+    static constexpr uint32_t commandAlignment = alignof(CommandHeader);
+
+    /**
+     * Appends a command to the stream, with room for trailing data.
+     *
+     * @param type the type of the command
+     * @param command the command's parameters
+     * @param extraSize the size of the data following the command, in bytes
+     * @returns a pointer to the trailing data
+     */
+    template<typename T>
+    uint8_t* append(CommandType type, const T& command, uint32_t extraSize = 0);
+
+    /**
+     * @param data a pointer to the header of a command in the stream
+     * @returns the command's parameters
+     */
+    template<typename T>
+    static const T& read(const uint8_t* data) {
+        return *reinterpret_cast<const T*>(data + sizeof(CommandHeader));
+    }
+
+    std::vector<uint8_t> m_data;
+    uint32_t m_numCommands = 0;
+};
+
+
+#endif //OPENGL_RENDERER_COMMANDLIST_H
@@ -0,0 +1,49 @@
+#include "DeletionQueue.h"
+
+DeletionQueue::DeletionQueue() : m_frameNumber(0) {}
+
+void DeletionQueue::push(std::function<void()> deleter) {
+    std::lock_guard lock(m_mutex);
+    m_entries.push_back(Entry{
+        .frameNumber = m_frameNumber,
+        .deleter = std::move(deleter),
+    });
+}
+
+void DeletionQueue::setFrame(uint64_t frameNumber) {
+    std::lock_guard lock(m_mutex);
+    m_frameNumber = frameNumber;
+}
+
+void DeletionQueue::release(uint64_t completedFrames) {
+    // deleters run outside the lock, as destroying what they capture may push more deleters
+    std::vector<std::function<void()>> deleters;
+    {
+        std::lock_guard lock(m_mutex);
+        while (!m_entries.empty() && m_entries.front().frameNumber < completedFrames) {
+            deleters.push_back(std::move(m_entries.front().deleter));
+            m_entries.pop_front();
+        }
+    }
+
+    for (std::function<void()>& deleter: deleters) {
+        deleter();
+    }
+}
+
+void DeletionQueue::releaseAll() {
+    while (true) {
+        std::deque<Entry> entries;
+        {
+            std::lock_guard lock(m_mutex);
+            if (m_entries.empty()) {
+                return;
+            }
+            entries.swap(m_entries);
+        }
+
+        for (Entry& entry: entries) {
+            entry.deleter();
+        }
+    }
+}
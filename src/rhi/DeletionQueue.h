@@ -0,0 +1,60 @@
+#ifndef OPENGL_RENDERER_DELETIONQUEUE_H
+#define OPENGL_RENDERER_DELETIONQUEUE_H
+
+#include <deque>
+#include <functional>
+#include <mutex>
+
+/**
+ * Delays freeing the api objects behind destroyed resources until the gpu has finished the frames that
+ * may have used them, so destroying a resource never stalls on the gpu.
+ *
+ * Each deleter is stamped with the first frame whose fence covers the commands submitted so far, and runs
+ * once that frame is complete. Deleters may be pushed from any thread, such as a worker dropping the last
+ * reference to a mesh, but are run on the thread that owns the render api.
+ */
+class DeletionQueue {
+public:
+    DeletionQueue();
+
+    DeletionQueue(const DeletionQueue&) = delete;
+
+    /**
+     * Queues a deleter to run once the commands submitted so far have completed. Thread-safe.
+     *
+     * @param deleter frees the api objects of a resource
+     */
+    void push(std::function<void()> deleter);
+
+    /**
+     * Sets the frame that the commands submitted from now on are fenced with.
+     *
+     * @param frameNumber the number of the frame
+     */
+    void setFrame(uint64_t frameNumber);
+
+    /**
+     * Runs the deleters queued during frames that are complete, in the order they were pushed.
+     *
+     * @param completedFrames the frames before this number are complete
+     */
+    void release(uint64_t completedFrames);
+
+    /**
+     * Runs every queued deleter, such as when the api is destroyed.
+     */
+    void releaseAll();
+
+private:
+    struct Entry {
+        uint64_t frameNumber;
+        std::function<void()> deleter;
+    };
+
+    std::mutex m_mutex;
+    uint64_t m_frameNumber;
+    std::deque<Entry> m_entries; // in order of frame number
+};
+
+
+#endif //OPENGL_RENDERER_DELETIONQUEUE_H
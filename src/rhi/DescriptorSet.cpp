@@ -0,0 +1,48 @@
+#include "DescriptorSet.h"
+
+DescriptorSetLayout::DescriptorSetLayout(std::span<const DescriptorSetBinding> bindings) : m_bindings(0) {
+    for (const DescriptorSetBinding& binding: bindings) {
+        if (binding.binding >= maxBindings) {
+            throw std::invalid_argument("The binding index is not supported.");
+        }
+        if (contains(binding.binding)) {
+            throw std::invalid_argument("Each binding index may only be used once.");
+        }
+
+        m_types[binding.binding] = binding.type;
+        m_bindings |= 1u << binding.binding;
+        m_typeBindings[(size_t)binding.type] |= 1u << binding.binding;
+    }
+}
+
+void DescriptorSet::makeImmutable() {
+    if (m_writtenBindings != m_layout.bindings()) {
+        throw std::invalid_argument("Every binding of an immutable descriptor set requires a descriptor.");
+    }
+
+    m_isImmutable = true;
+}
+
+void DescriptorSet::writeBinding(uint32_t binding, DescriptorType type) {
+    if (m_isImmutable) {
+        throw std::domain_error("The descriptors of an immutable descriptor set cannot be changed.");
+    }
+
+    bool accepts = m_layout.contains(binding) && (m_layout.type(binding) == type ||
+        (type == DescriptorType::UniformBuffer && m_layout.type(binding) == DescriptorType::UniformBufferDynamic));
+    if (!accepts) {
+        switch (type) {
+            case DescriptorType::Texture2D:
+                throw std::invalid_argument("Binding index does not accept Texture2D");
+            case DescriptorType::Texture2DArray:
+                throw std::invalid_argument("Binding index does not accept Texture2DArray");
+            case DescriptorType::UniformBuffer:
+            case DescriptorType::UniformBufferDynamic:
+                throw std::invalid_argument("Binding index does not accept UniformBuffer");
+            case DescriptorType::StorageBuffer:
+                throw std::invalid_argument("Binding index does not accept StorageBuffer");
+        }
+    }
+
+    m_writtenBindings |= 1u << binding;
+}
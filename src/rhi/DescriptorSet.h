@@ -1,11 +1,18 @@
 #ifndef OPENGL_RENDERER_DESCRIPTORSET_H
 #define OPENGL_RENDERER_DESCRIPTORSET_H
 
+#include <bit>
+
 #include "Texture2D.h"
+#include "Texture2DArray.h"
 #include "Buffer.h"
 
+/**
+ * The types of resources a descriptor can bind. A dynamic uniform buffer has an additional offset
+ * supplied each time its descriptor set is bound, so that one descriptor can address many ranges.
+ */
 enum class DescriptorType {
-    Texture2D, UniformBuffer, StorageBuffer
+    Texture2D, UniformBuffer, UniformBufferDynamic, StorageBuffer, Texture2DArray
 };
 
 struct DescriptorSetBinding {
@@ -13,9 +20,80 @@ struct DescriptorSetBinding {
     const DescriptorType type;
 };
 
+/**
+ * The types of the descriptors of a set, indexed by binding, with a mask of the bindings of each type so
+ * that descriptors of the same class of resource can be walked without searching.
+ */
+class DescriptorSetLayout {
+public:
+    static constexpr uint32_t maxBindings = 16;
+
+    /**
+     * Constructs the layout of a set with the given bindings.
+     *
+     * @param bindings the bindings of the set, in any order
+     * @throws std::invalid_argument if a binding index is at least maxBindings or is repeated
+     */
+    explicit DescriptorSetLayout(std::span<const DescriptorSetBinding> bindings);
+
+    /**
+     * @param binding the binding index
+     * @returns whether the set has a descriptor at the binding index
+     */
+    bool contains(uint32_t binding) const {
+        return binding < maxBindings && (m_bindings & (1u << binding)) != 0;
+    }
+
+    /**
+     * @param binding the binding index, which must be in the set
+     * @returns the type of the descriptor at the binding index
+     */
+    DescriptorType type(uint32_t binding) const {
+        return m_types[binding];
+    }
+
+    /**
+     * @returns a mask of the binding indices in the set
+     */
+    uint32_t bindings() const {
+        return m_bindings;
+    }
+
+    /**
+     * @param type the type of descriptor
+     * @returns a mask of the binding indices of descriptors of the given type
+     */
+    uint32_t bindings(DescriptorType type) const {
+        return m_typeBindings[(size_t)type];
+    }
+
+    /**
+     * Calls a function for each run of consecutive binding indices in a mask, in order, so that the
+     * descriptors of each run can be bound with one call.
+     *
+     * @param bindings the mask of binding indices
+     * @param function called with the first binding index and the number of bindings of each run
+     */
+    template<typename Function>
+    static void forEachRange(uint32_t bindings, Function&& function) {
+        while (bindings != 0) {
+            uint32_t first = std::countr_zero(bindings);
+            uint32_t count = std::countr_one(bindings >> first);
+            function(first, count);
+            bindings &= ~(((1u << count) - 1) << first);
+        }
+    }
+
+private:
+    std::array<DescriptorType, maxBindings> m_types{};
+    uint32_t m_bindings;
+    std::array<uint32_t, 5> m_typeBindings{}; // indexed by DescriptorType
+};
+
 class DescriptorSet {
 public:
-    DescriptorSet() = default;
+    explicit DescriptorSet(DescriptorSetLayout layout)
+        : m_layout(layout), m_writtenBindings(0), m_isImmutable(false) {}
     DescriptorSet(const DescriptorSet&) = delete;
     virtual ~DescriptorSet() = default;
 
@@ -24,18 +102,31 @@ public:
      *
      * @param binding the binding index of the descriptor
      * @param texture2D the 2d texture to bind
-     * @returns the constructed descriptor
+     * @throws std::domain_error if the set is immutable
+     * @throws std::invalid_argument if the binding index does not accept textures
      */
     virtual void bindTexture2D(uint32_t binding, Texture2D& texture2D) = 0;
 
     /**
-     * Creates a descriptor binding the given uniform buffer at the given index.
+     * Creates a descriptor binding the given 2d texture array at the given index.
+     *
+     * @param binding the binding index of the descriptor
+     * @param textureArray the 2d texture array to bind
+     * @throws std::domain_error if the set is immutable
+     * @throws std::invalid_argument if the binding index does not accept texture arrays
+     */
+    virtual void bindTexture2DArray(uint32_t binding, Texture2DArray& textureArray) = 0;
+
+    /**
+     * Creates a descriptor binding the given uniform buffer at the given index. For dynamic uniform
+     * buffers, the offset is the base to which the dynamic offset is added when the set is bound.
      *
      * @param binding the binding index of the descriptor
      * @param buffer the uniform buffer to bind
      * @param offset the offset into the buffer to bind, in bytes
      * @param range the range of the buffer to bind, in bytes
-     * @returns the constructed descriptor
+     * @throws std::domain_error if the set is immutable
+     * @throws std::invalid_argument if the binding index does not accept uniform buffers
      */
     virtual void bindUniformBuffer(uint32_t binding, const Buffer& buffer, uint32_t offset, uint32_t range) = 0;
 
@@ -46,9 +137,56 @@ public:
      * @param buffer the storage buffer to bind
      * @param offset the offset into the buffer to bind, in bytes
      * @param range the range of the buffer to bind, in bytes
-     * @returns the constructed descriptor
+     * @throws std::domain_error if the set is immutable
+     * @throws std::invalid_argument if the binding index does not accept storage buffers
      */
     virtual void bindStorageBuffer(uint32_t binding, const Buffer& buffer, uint32_t offset, uint32_t range) = 0;
+
+    /**
+     * Makes the set immutable once every binding has a descriptor. Immutable sets are validated once here
+     * rather than as they change, and can be shared, such as by a DescriptorSetCache.
+     *
+     * @throws std::invalid_argument if a binding has no descriptor
+     */
+    void makeImmutable();
+
+    /**
+     * @returns whether the descriptors of the set can no longer change
+     */
+    bool isImmutable() const {
+        return m_isImmutable;
+    }
+
+    /**
+     * @returns the layout of the set
+     */
+    const DescriptorSetLayout& layout() const {
+        return m_layout;
+    }
+
+    /**
+     * @returns a mask of the binding indices that have descriptors
+     */
+    uint32_t writtenBindings() const {
+        return m_writtenBindings;
+    }
+
+protected:
+    /**
+     * Checks that a descriptor of the given type can be written at a binding, then marks the binding as
+     * written. Uniform buffer bindings accept both static and dynamic uniform buffers.
+     *
+     * @param binding the binding index of the descriptor
+     * @param type the type of the descriptor
+     * @throws std::domain_error if the set is immutable
+     * @throws std::invalid_argument if the binding index does not accept the type
+     */
+    void writeBinding(uint32_t binding, DescriptorType type);
+
+private:
+    DescriptorSetLayout m_layout;
+    uint32_t m_writtenBindings;
+    bool m_isImmutable;
 };
 
 
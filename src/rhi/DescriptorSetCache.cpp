@@ -0,0 +1,80 @@
+#include "DescriptorSetCache.h"
+
+DescriptorSetCache::DescriptorSetCache(std::vector<DescriptorSetBinding> bindings)
+    : m_bindings(std::move(bindings)), m_frameContext(RHI::current().frameContext()) {
+    // validate the bindings up front, rather than on the first lookup
+    DescriptorSetLayout layout(m_bindings);
+    m_frameContext.addResource(*this);
+}
+
+DescriptorSetCache::~DescriptorSetCache() {
+    m_frameContext.removeResource(*this);
+}
+
+void DescriptorSetCache::recycle(uint32_t) {
+    // a set used during the frame framesInFlight() before this one has been finished by the gpu
+    uint64_t frameNumber = m_frameContext.frameNumber();
+    uint64_t framesInFlight = m_frameContext.framesInFlight();
+    std::erase_if(m_entries, [&](const auto& entry) {
+        return entry.second.lastUsedFrame + framesInFlight <= frameNumber;
+    });
+}
+
+const DescriptorSet& DescriptorSetCache::get(std::span<const DescriptorWrite> descriptors) {
+    if (descriptors.size() != m_bindings.size()) {
+        throw std::invalid_argument("A descriptor is required for each binding of the layout.");
+    }
+
+    std::array<Key, DescriptorSetLayout::maxBindings> keys;
+    size_t hash = 0;
+    for (size_t i = 0; i < descriptors.size(); i++) {
+        const DescriptorWrite& descriptor = descriptors[i];
+        keys[i] = Key{
+            .binding = descriptor.binding,
+            .resourceId = descriptor.texture2D != nullptr ? descriptor.texture2D->id()
+                          : descriptor.texture2DArray != nullptr ? descriptor.texture2DArray->id()
+                          : descriptor.buffer != nullptr ? descriptor.buffer->id() : 0,
+            .offset = descriptor.offset,
+            .range = descriptor.range,
+        };
+        for (uint64_t value: {(uint64_t)keys[i].binding, keys[i].resourceId, (uint64_t)keys[i].offset,
+                              (uint64_t)keys[i].range}) {
+            hash ^= std::hash<uint64_t>{}(value) + 0x9e3779b97f4a7c15 + (hash << 6) + (hash >> 2);
+        }
+    }
+    std::span<const Key> keySpan(keys.data(), descriptors.size());
+
+    auto [first, last] = m_entries.equal_range(hash);
+    for (auto it = first; it != last; ++it) {
+        if (std::ranges::equal(it->second.keys, keySpan)) {
+            it->second.lastUsedFrame = m_frameContext.frameNumber();
+            return *it->second.descriptorSet;
+        }
+    }
+
+    std::unique_ptr<DescriptorSet> descriptorSet = RHI::current().createDescriptorSet(m_bindings);
+    for (const DescriptorWrite& descriptor: descriptors) {
+        if (descriptor.texture2D != nullptr) {
+            descriptorSet->bindTexture2D(descriptor.binding, *descriptor.texture2D);
+        } else if (descriptor.texture2DArray != nullptr) {
+            descriptorSet->bindTexture2DArray(descriptor.binding, *descriptor.texture2DArray);
+        } else if (descriptor.buffer == nullptr) {
+            throw std::invalid_argument("A descriptor requires a texture or a buffer.");
+        } else if (descriptorSet->layout().contains(descriptor.binding) &&
+                   descriptorSet->layout().type(descriptor.binding) == DescriptorType::StorageBuffer) {
+            descriptorSet->bindStorageBuffer(descriptor.binding, *descriptor.buffer, descriptor.offset,
+                                             descriptor.range);
+        } else {
+            descriptorSet->bindUniformBuffer(descriptor.binding, *descriptor.buffer, descriptor.offset,
+                                             descriptor.range);
+        }
+    }
+    descriptorSet->makeImmutable();
+
+    auto it = m_entries.emplace(hash, Entry{
+        .keys = std::vector<Key>(keySpan.begin(), keySpan.end()),
+        .descriptorSet = std::move(descriptorSet),
+        .lastUsedFrame = m_frameContext.frameNumber(),
+    });
+    return *it->second.descriptorSet;
+}
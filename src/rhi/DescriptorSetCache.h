@@ -0,0 +1,84 @@
+#ifndef OPENGL_RENDERER_DESCRIPTORSETCACHE_H
+#define OPENGL_RENDERER_DESCRIPTORSETCACHE_H
+
+#include <unordered_map>
+
+#include "RHI.h"
+
+/**
+ * A descriptor written into a set looked up in a DescriptorSetCache.
+ */
+struct DescriptorWrite {
+    uint32_t binding;
+    Texture2D* texture2D; // nullptr unless binding a 2d texture
+    Texture2DArray* texture2DArray; // nullptr unless binding a 2d texture array
+    const Buffer* buffer; // nullptr for textures
+    uint32_t offset; // in bytes, for buffers
+    uint32_t range; // in bytes, for buffers
+};
+
+/**
+ * Reuses immutable descriptor sets of one layout across draws and frames, so that descriptors that change
+ * between draws, such as the texture of each ui image, need not be written into a set before every draw.
+ *
+ * Sets are looked up by a hash of their descriptors, which identifies resources by id rather than address.
+ * A set that has not been used for a full round of frames in flight is destroyed as a frame begins, once
+ * the gpu can no longer be reading it. The cache is used from the thread that owns the render api.
+ */
+class DescriptorSetCache : public FrameResource {
+public:
+    /**
+     * Constructs an empty cache of sets with the given bindings.
+     *
+     * @param bindings the bindings of the cached sets
+     * @throws std::invalid_argument if a binding index is not supported or is repeated
+     */
+    explicit DescriptorSetCache(std::vector<DescriptorSetBinding> bindings);
+
+    DescriptorSetCache(const DescriptorSetCache&) = delete;
+    ~DescriptorSetCache() override;
+
+    void recycle(uint32_t frameIndex) override;
+
+    /**
+     * Finds the immutable set holding the given descriptors, creating it if it is not cached.
+     *
+     * @param descriptors a descriptor for every binding of the layout, in the same order on every lookup
+     * @returns the set, which is valid until a round of frames in flight has passed without it being used
+     * @throws std::invalid_argument if the descriptors do not match the bindings of the layout
+     */
+    const DescriptorSet& get(std::span<const DescriptorWrite> descriptors);
+
+    /**
+     * @returns the number of cached sets
+     */
+    size_t size() const {
+        return m_entries.size();
+    }
+
+private:
+    /**
+     * The identity of a descriptor, compared to find a cached set.
+     */
+    struct Key {
+        uint32_t binding;
+        uint64_t resourceId;
+        uint32_t offset;
+        uint32_t range;
+
+        bool operator==(const Key&) const = default;
+    };
+
+    struct Entry {
+        std::vector<Key> keys;
+        std::unique_ptr<DescriptorSet> descriptorSet;
+        uint64_t lastUsedFrame;
+    };
+
+    std::vector<DescriptorSetBinding> m_bindings;
+    FrameContext& m_frameContext;
+    std::unordered_multimap<size_t, Entry> m_entries; // by hash of the keys
+};
+
+
+#endif //OPENGL_RENDERER_DESCRIPTORSETCACHE_H
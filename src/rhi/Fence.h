@@ -0,0 +1,27 @@
+#ifndef OPENGL_RENDERER_FENCE_H
+#define OPENGL_RENDERER_FENCE_H
+
+
+/**
+ * A synchronization primitive that is signaled once the gpu has finished all commands
+ * submitted before the fence was created.
+ */
+class Fence {
+public:
+    Fence() = default;
+    Fence(const Fence&) = delete;
+    virtual ~Fence() = default;
+
+    /**
+     * @returns whether the gpu has finished all commands submitted before the fence, without blocking
+     */
+    virtual bool isSignaled() = 0;
+
+    /**
+     * Blocks until the gpu has finished all commands submitted before the fence.
+     */
+    virtual void wait() = 0;
+};
+
+
+#endif //OPENGL_RENDERER_FENCE_H
@@ -2,11 +2,65 @@
 #define OPENGL_RENDERER_FORMAT_H
 
 
+/**
+ * The format of the pixels of a texture, or of a vertex attribute. The block-compressed formats store
+ * blocks of 4x4 pixels in 8 bytes (BC1, BC4) or 16 bytes (BC3, BC5, BC7), and can only be sampled.
+ */
 enum class Format {
     RGB8, RGBA8,
     RG32F, RGB32F, RGBA32F,
     D32F,
+    RGBA16F, R11G11B10F,
+    BC1, // rgb with 1-bit alpha
+    BC3, // rgba, with alpha stored as in BC4
+    BC4, // r
+    BC5, // rg, with each stored as in BC4
+    BC7, // rgba, with higher quality than BC1 and BC3
 };
 
+/**
+ * @param format a format
+ * @returns whether the format stores pixels in compressed blocks of 4x4
+ */
+constexpr bool isBlockCompressed(Format format) {
+    return format >= Format::BC1;
+}
+
+/**
+ * @param format a format
+ * @returns the size of a pixel of the format, or of a block of pixels if it is block-compressed, in bytes
+ */
+constexpr uint32_t formatBlockSize(Format format) {
+    switch (format) {
+        case Format::RGB8: return 3;
+        case Format::RGBA8: return 4;
+        case Format::RG32F: return 8;
+        case Format::RGB32F: return 12;
+        case Format::RGBA32F: return 16;
+        case Format::D32F: return 4;
+        case Format::RGBA16F: return 8;
+        case Format::R11G11B10F: return 4;
+        case Format::BC1: return 8;
+        case Format::BC3: return 16;
+        case Format::BC4: return 8;
+        case Format::BC5: return 16;
+        case Format::BC7: return 16;
+    }
+    return 0;
+}
+
+/**
+ * @param format a format
+ * @param width the width of the image, in pixels
+ * @param height the height of the image, in pixels
+ * @returns the size of an image of the format with tightly packed rows, in bytes
+ */
+constexpr uint64_t imageSize(Format format, uint32_t width, uint32_t height) {
+    if (isBlockCompressed(format)) {
+        return (uint64_t)((width + 3) / 4) * ((height + 3) / 4) * formatBlockSize(format);
+    }
+    return (uint64_t)width * height * formatBlockSize(format);
+}
+
 
 #endif //OPENGL_RENDERER_FORMAT_H
@@ -0,0 +1,61 @@
+#include "FrameContext.h"
+#include "RHI.h"
+
+FrameContext::FrameContext(RHI& rhi, uint32_t framesInFlight)
+    : m_rhi(rhi), m_frameNumber(0), m_endedFrames(0), m_completedFrames(0), m_fences(framesInFlight) {
+    if (framesInFlight == 0) {
+        throw std::invalid_argument("FrameContext requires a non-zero number of frames.");
+    }
+}
+
+void FrameContext::beginFrame() {
+    if (m_endedFrames <= m_frameNumber) {
+        endFrame();
+    }
+    m_frameNumber++;
+
+    // the slot was last used by the frame framesInFlight() before this one
+    uint64_t framesInFlight = m_fences.size();
+    retire(m_frameNumber + 1 > framesInFlight ? m_frameNumber + 1 - framesInFlight : 0);
+    m_deletionQueue.release(m_completedFrames);
+
+    uint32_t index = frameIndex();
+    for (FrameResource* resource: m_resources) {
+        resource->recycle(index);
+    }
+}
+
+void FrameContext::endFrame() {
+    m_fences[frameIndex()] = m_rhi.createFence();
+    m_endedFrames = m_frameNumber + 1;
+
+    // commands submitted after the fence are fenced with the next frame
+    m_deletionQueue.setFrame(m_endedFrames);
+}
+
+bool FrameContext::isComplete(uint64_t frameNumber) {
+    if (frameNumber >= m_completedFrames) {
+        retire(0);
+    }
+    return frameNumber < m_completedFrames;
+}
+
+void FrameContext::addResource(FrameResource& resource) {
+    m_resources.push_back(std::addressof(resource));
+}
+
+void FrameContext::removeResource(FrameResource& resource) {
+    std::erase(m_resources, std::addressof(resource));
+}
+
+void FrameContext::retire(uint64_t waitUntil) {
+    for (; m_completedFrames < m_endedFrames; m_completedFrames++) {
+        std::unique_ptr<Fence>& fence = m_fences[m_completedFrames % m_fences.size()];
+        if (m_completedFrames < waitUntil) {
+            fence->wait();
+        } else if (!fence->isSignaled()) {
+            break;
+        }
+        fence.reset();
+    }
+}
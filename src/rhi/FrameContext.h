@@ -0,0 +1,130 @@
+#ifndef OPENGL_RENDERER_FRAMECONTEXT_H
+#define OPENGL_RENDERER_FRAMECONTEXT_H
+
+#include "DeletionQueue.h"
+#include "Fence.h"
+
+class RHI;
+
+/**
+ * Memory that is split into a slot for each frame in flight, such as a ring of uniforms, and that is
+ * reused once the gpu has finished the frame that last used a slot.
+ */
+class FrameResource {
+public:
+    virtual ~FrameResource() = default;
+
+    /**
+     * Begins using the given slot for the new frame. The gpu has finished reading the slot, so all
+     * memory written to it during earlier frames can be overwritten.
+     *
+     * @param frameIndex the slot of the new frame
+     */
+    virtual void recycle(uint32_t frameIndex) = 0;
+};
+
+/**
+ * Paces the cpu so that it records at most a fixed number of frames ahead of the gpu.
+ *
+ * Each frame is fenced once it ends, and is given a slot that cycles through the frames in flight.
+ * Beginning a frame waits on the fence of the frame that last used its slot, then recycles the slot of
+ * every registered frame resource, so per-frame memory is reused without waiting for the gpu to go idle.
+ * Frame numbers count every frame begun, and frames whose fences have signaled are known to be complete,
+ * so resources freed in a frame can be deleted once the frame is complete. Beginning a frame runs the
+ * deleters of the deletion queue whose frames are complete.
+ */
+class FrameContext {
+public:
+    static constexpr uint32_t defaultFramesInFlight = 3;
+
+    /**
+     * Constructs a frame context, which begins the 0th frame in the 0th slot.
+     *
+     * @param rhi the render api to fence frames with
+     * @param framesInFlight the number of frames the cpu may record ahead of the gpu
+     * @throws std::invalid_argument if the number of frames is zero
+     */
+    FrameContext(RHI& rhi, uint32_t framesInFlight);
+
+    FrameContext(const FrameContext&) = delete;
+
+    /**
+     * Begins a new frame, waiting until the gpu has finished the frame that last used its slot. The
+     * current frame is ended first if it has not been.
+     */
+    void beginFrame();
+
+    /**
+     * Ends the current frame, fencing every command submitted during it.
+     */
+    void endFrame();
+
+    /**
+     * @returns the slot of the current frame, in [0, framesInFlight())
+     */
+    uint32_t frameIndex() const {
+        return (uint32_t)(m_frameNumber % m_fences.size());
+    }
+
+    /**
+     * @returns the number of the current frame, counting every frame begun
+     */
+    uint64_t frameNumber() const {
+        return m_frameNumber;
+    }
+
+    /**
+     * @returns the number of frames the cpu may record ahead of the gpu
+     */
+    uint32_t framesInFlight() const {
+        return (uint32_t)m_fences.size();
+    }
+
+    /**
+     * Checks whether the gpu has finished a frame, without blocking.
+     *
+     * @param frameNumber the number of the frame
+     * @returns whether the frame and every frame before it have been completed
+     */
+    bool isComplete(uint64_t frameNumber);
+
+    /**
+     * Registers a resource to be recycled as frames begin.
+     *
+     * @param resource the resource, which must be removed before it is destroyed
+     */
+    void addResource(FrameResource& resource);
+
+    /**
+     * Stops recycling a resource.
+     *
+     * @param resource the resource
+     */
+    void removeResource(FrameResource& resource);
+
+    /**
+     * @returns the queue of api objects to delete once the frames that may use them are complete
+     */
+    DeletionQueue& deletionQueue() {
+        return m_deletionQueue;
+    }
+
+private:
+    /**
+     * Advances the completed frames past the ended frames whose fences have signaled.
+     *
+     * @param waitUntil the number of the first frame not to wait for, as frames before it are waited on
+     */
+    void retire(uint64_t waitUntil);
+
+    RHI& m_rhi;
+    uint64_t m_frameNumber;
+    uint64_t m_endedFrames; // the frames before this number have ended
+    uint64_t m_completedFrames; // the frames before this number are complete
+    std::vector<std::unique_ptr<Fence>> m_fences; // per slot, nullptr if its frame has not ended or has retired
+    std::vector<FrameResource*> m_resources;
+    DeletionQueue m_deletionQueue;
+};
+
+
+#endif //OPENGL_RENDERER_FRAMECONTEXT_H
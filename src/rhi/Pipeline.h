@@ -8,9 +8,120 @@ enum class Topology {
     Points, Lines, Triangles
 };
 
+enum class CompareOp {
+    Never, Less, Equal, LessOrEqual, Greater, NotEqual, GreaterOrEqual, Always
+};
+
+/**
+ * How a pipeline tests and writes depth. Fragments pass the test if comparing their depth to the
+ * stored depth is true.
+ */
+struct DepthState {
+    bool testEnabled = true;
+    bool writeEnabled = true;
+    CompareOp compareOp = CompareOp::Less;
+
+    bool operator==(const DepthState&) const = default;
+};
+
+enum class StencilOp {
+    Keep, Zero, Replace, IncrementClamp, DecrementClamp, Invert, IncrementWrap, DecrementWrap
+};
+
+/**
+ * How a pipeline tests and writes stencil, for both front and back faces. Fragments pass the test if
+ * comparing the reference to the stored stencil, both masked by the compare mask, is true. Without a
+ * stencil attachment, the test always passes and nothing is written.
+ */
+struct StencilState {
+    bool testEnabled = false;
+    CompareOp compareOp = CompareOp::Always;
+    StencilOp failOp = StencilOp::Keep; // when the stencil test fails
+    StencilOp depthFailOp = StencilOp::Keep; // when the stencil test passes but the depth test fails
+    StencilOp passOp = StencilOp::Keep; // when both tests pass
+    uint8_t reference = 0;
+    uint8_t compareMask = 0xFF;
+    uint8_t writeMask = 0xFF;
+
+    bool operator==(const StencilState&) const = default;
+};
+
+enum class BlendFactor {
+    Zero, One,
+    SrcColor, OneMinusSrcColor, DstColor, OneMinusDstColor,
+    SrcAlpha, OneMinusSrcAlpha, DstAlpha, OneMinusDstAlpha,
+};
+
+enum class BlendOp {
+    Add, Subtract, ReverseSubtract, Min, Max
+};
+
+/**
+ * How a pipeline blends the colors of fragments with the colors already in the color attachment. Each
+ * of the color and alpha is the fragment's value times its source factor, combined by the op with the
+ * stored value times its destination factor. Min and max ignore the factors.
+ */
+struct BlendState {
+    bool enabled = false;
+    BlendFactor srcColorFactor = BlendFactor::One;
+    BlendFactor dstColorFactor = BlendFactor::Zero;
+    BlendOp colorOp = BlendOp::Add;
+    BlendFactor srcAlphaFactor = BlendFactor::One;
+    BlendFactor dstAlphaFactor = BlendFactor::Zero;
+    BlendOp alphaOp = BlendOp::Add;
+
+    bool operator==(const BlendState&) const = default;
+
+    /**
+     * @returns the state that draws fragments over what is already drawn by their alpha, which is not premultiplied
+     */
+    static constexpr BlendState alpha() {
+        return BlendState{
+            .enabled = true,
+            .srcColorFactor = BlendFactor::SrcAlpha,
+            .dstColorFactor = BlendFactor::OneMinusSrcAlpha,
+            .colorOp = BlendOp::Add,
+            .srcAlphaFactor = BlendFactor::One,
+            .dstAlphaFactor = BlendFactor::OneMinusSrcAlpha,
+            .alphaOp = BlendOp::Add,
+        };
+    }
+};
+
+enum class CullMode {
+    None, Front, Back
+};
+
+enum class FrontFace {
+    CounterClockwise, Clockwise
+};
+
+enum class PolygonMode {
+    Fill, Line, Point
+};
+
+/**
+ * How a pipeline rasterizes triangles. Faces are front faces if their corners are wound in the given
+ * order in the viewport, and culled faces are not drawn. Depth bias offsets the depth of each fragment
+ * by a constant, in units of the smallest resolvable difference in depth, plus a factor of the
+ * triangle's greatest depth slope, such as to draw decals or shadow maps without depth fighting.
+ */
+struct RasterState {
+    CullMode cullMode = CullMode::None;
+    FrontFace frontFace = FrontFace::CounterClockwise;
+    PolygonMode polygonMode = PolygonMode::Fill;
+    float depthBiasConstant = 0.0f;
+    float depthBiasSlope = 0.0f;
+
+    bool operator==(const RasterState&) const = default;
+};
+
 class Pipeline {
 public:
-    explicit Pipeline(Topology topology) : m_topology(topology) {};
+    Pipeline(Topology topology, DepthState depthState, StencilState stencilState, BlendState blendState,
+             RasterState rasterState, bool colorWriteEnabled)
+        : m_topology(topology), m_depthState(depthState), m_stencilState(stencilState), m_blendState(blendState),
+          m_rasterState(rasterState), m_colorWriteEnabled(colorWriteEnabled) {};
 
     virtual ~Pipeline() = default;
 
@@ -20,8 +131,64 @@ public:
     Topology topology() const {
         return m_topology;
     }
+
+    /**
+     * @returns how the pipeline tests and writes depth
+     */
+    const DepthState& depthState() const {
+        return m_depthState;
+    }
+
+    /**
+     * @returns how the pipeline tests and writes stencil
+     */
+    const StencilState& stencilState() const {
+        return m_stencilState;
+    }
+
+    /**
+     * @returns how the pipeline blends colors into the color attachment
+     */
+    const BlendState& blendState() const {
+        return m_blendState;
+    }
+
+    /**
+     * @returns how the pipeline rasterizes triangles
+     */
+    const RasterState& rasterState() const {
+        return m_rasterState;
+    }
+
+    /**
+     * @returns whether the pipeline writes to color attachments
+     */
+    bool colorWriteEnabled() const {
+        return m_colorWriteEnabled;
+    }
+
+    /**
+     * Pipelines are built in the background where the api allows, and binding one that is still being
+     * built waits for it to finish.
+     *
+     * @returns whether the pipeline has finished building, or true if the api cannot tell without waiting
+     */
+    virtual bool isReady() const {
+        return true;
+    }
+
+    /**
+     * Waits for the pipeline to finish building, as binding it would, so that binding it later does not.
+     */
+    virtual void wait() const {}
+
 private:
     Topology m_topology;
+    DepthState m_depthState;
+    StencilState m_stencilState;
+    BlendState m_blendState;
+    RasterState m_rasterState;
+    bool m_colorWriteEnabled;
 };
 
 class PipelineBuilder {
@@ -36,6 +203,56 @@ public:
 
     virtual PipelineBuilder* setVertexLayout(const VertexLayout& layout) = 0;
 
+    /**
+     * Sets how the pipeline tests and writes depth. By default, depth is tested with less than and written.
+     *
+     * @param depthState the depth state
+     */
+    virtual PipelineBuilder* setDepthState(const DepthState& depthState) = 0;
+
+    /**
+     * Sets how the pipeline tests and writes stencil. By default, stencil is not tested.
+     *
+     * @param stencilState the stencil state
+     */
+    virtual PipelineBuilder* setStencilState(const StencilState& stencilState) = 0;
+
+    /**
+     * Sets how the pipeline blends colors into the color attachment. By default, colors replace those stored.
+     *
+     * @param blendState the blend state
+     */
+    virtual PipelineBuilder* setBlendState(const BlendState& blendState) = 0;
+
+    /**
+     * Sets how the pipeline rasterizes triangles. By default, triangles are filled, not culled and not biased.
+     *
+     * @param rasterState the raster state
+     */
+    virtual PipelineBuilder* setRasterState(const RasterState& rasterState) = 0;
+
+    /**
+     * Sets whether the pipeline writes to color attachments, such as to disable it for depth-only passes.
+     * By default, color is written.
+     *
+     * @param enabled whether color is written
+     */
+    virtual PipelineBuilder* setColorWriteEnabled(bool enabled) = 0;
+
+    /**
+     * Sets a binary retrieved by RHI::pipelineBinary() to build the pipeline's program from, in place of
+     * linking its shaders, which then need not be set. The binary is not copied, and must outlive build().
+     *
+     * @param binary the program binary
+     * @throws std::domain_error if the api does not support pipeline binaries
+     */
+    virtual PipelineBuilder* setBinary(std::span<const uint8_t> binary) = 0;
+
+    /**
+     * Builds the pipeline, without waiting for its shaders to compile and link where the api allows.
+     *
+     * @returns the pipeline, or nullptr if its binary was set but rejected by the driver
+     */
     virtual std::unique_ptr<Pipeline> build() = 0;
 };
 
@@ -0,0 +1,321 @@
+#include "PipelineCache.h"
+
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+
+namespace {
+    constexpr uint32_t binaryMagic = 0x42504C50; // "PLPB" when read in little endian order
+
+    /**
+     * Hashes values with 64-bit FNV-1a, which, unlike std::hash, gives the same hash on every launch, so
+     * that it can name persisted programs.
+     */
+    class Hasher {
+    public:
+        void add(const void* data, size_t size) {
+            auto bytes = (const uint8_t*)data;
+            for (size_t i = 0; i < size; i++) {
+                m_hash = (m_hash ^ bytes[i]) * 0x100000001B3;
+            }
+        }
+
+        void add(const std::string& value) {
+            add((uint64_t)value.size());
+            add(value.data(), value.size());
+        }
+
+        // values are added one field at a time, as the padding within structs is not initialized
+        template<typename T>
+        void add(T value) requires std::is_arithmetic_v<T> || std::is_enum_v<T> {
+            add(&value, sizeof(T));
+        }
+
+        uint64_t hash() const {
+            return m_hash;
+        }
+
+    private:
+        uint64_t m_hash = 0xCBF29CE484222325;
+    };
+}
+
+PipelineCache::PipelineCache(RHI& rhi) : m_rhi(rhi), m_numCompiled(0) {
+    m_binaryVersion = m_rhi.pipelineBinaryVersion();
+    m_rhi.frameContext().addResource(*this);
+}
+
+PipelineCache::~PipelineCache() {
+    m_rhi.frameContext().removeResource(*this);
+    wait();
+}
+
+void PipelineCache::recycle(uint32_t) {
+    poll();
+}
+
+void PipelineCache::setDirectory(std::filesystem::path directory) {
+    if (!directory.empty()) {
+        std::error_code error;
+        std::filesystem::create_directories(directory, error);
+        if (error) {
+            std::cerr << "ERR: failed to create pipeline cache directory: " << directory << std::endl;
+        }
+    }
+
+    m_directory = std::move(directory);
+}
+
+std::shared_ptr<Pipeline> PipelineCache::get(const PipelineDescription& description) {
+    uint64_t programHash = hashProgram(description);
+    uint64_t hash = hashState(description, programHash);
+
+    auto [first, last] = m_pipelines.equal_range(hash);
+    for (auto it = first; it != last; ++it) {
+        if (it->second.description == description) {
+            return it->second.pipeline;
+        }
+    }
+
+    std::shared_ptr<Pipeline> pipeline = build(description, programHash);
+    m_pipelines.emplace(hash, Entry{
+        .description = description,
+        .pipeline = pipeline,
+    });
+    return pipeline;
+}
+
+size_t PipelineCache::poll() {
+    for (auto it = m_pendingPrograms.begin(); it != m_pendingPrograms.end();) {
+        const std::vector<std::shared_ptr<Pipeline>>& pipelines = it->second.pipelines;
+        if (std::ranges::all_of(pipelines, [](const auto& pipeline) { return pipeline->isReady(); })) {
+            finish(it->first, it->second);
+            it = m_pendingPrograms.erase(it);
+        } else {
+            ++it;
+        }
+    }
+
+    return m_pendingPrograms.size();
+}
+
+void PipelineCache::wait() {
+    for (auto& [programHash, program]: m_pendingPrograms) {
+        finish(programHash, program);
+    }
+    m_pendingPrograms.clear();
+}
+
+uint64_t PipelineCache::hashProgram(const PipelineDescription& description) {
+    Hasher hasher;
+    for (const ShaderSource* source: {&description.vertexShader, &description.fragmentShader}) {
+        hasher.add(source->type);
+        hasher.add(source->name);
+        hasher.add(source->code);
+    }
+    return hasher.hash();
+}
+
+uint64_t PipelineCache::hashState(const PipelineDescription& description, uint64_t programHash) {
+    Hasher hasher;
+    hasher.add(programHash);
+
+    for (const VertexBinding& binding: description.vertexLayout.bindings) {
+        hasher.add(binding.binding);
+        hasher.add(binding.stride);
+        for (const VertexAttribute& attribute: binding.attributes) {
+            hasher.add(attribute.location);
+            hasher.add(attribute.format);
+            hasher.add(attribute.offset);
+        }
+    }
+    hasher.add(description.topology);
+
+    const DepthState& depth = description.depthState;
+    hasher.add(depth.testEnabled);
+    hasher.add(depth.writeEnabled);
+    hasher.add(depth.compareOp);
+
+    const StencilState& stencil = description.stencilState;
+    hasher.add(stencil.testEnabled);
+    hasher.add(stencil.compareOp);
+    hasher.add(stencil.failOp);
+    hasher.add(stencil.depthFailOp);
+    hasher.add(stencil.passOp);
+    hasher.add(stencil.reference);
+    hasher.add(stencil.compareMask);
+    hasher.add(stencil.writeMask);
+
+    const BlendState& blend = description.blendState;
+    hasher.add(blend.enabled);
+    hasher.add(blend.srcColorFactor);
+    hasher.add(blend.dstColorFactor);
+    hasher.add(blend.colorOp);
+    hasher.add(blend.srcAlphaFactor);
+    hasher.add(blend.dstAlphaFactor);
+    hasher.add(blend.alphaOp);
+
+    const RasterState& raster = description.rasterState;
+    hasher.add(raster.cullMode);
+    hasher.add(raster.frontFace);
+    hasher.add(raster.polygonMode);
+    hasher.add(raster.depthBiasConstant);
+    hasher.add(raster.depthBiasSlope);
+
+    hasher.add(description.colorWriteEnabled);
+    return hasher.hash();
+}
+
+std::shared_ptr<Pipeline> PipelineCache::build(const PipelineDescription& description, uint64_t programHash) {
+    if (!m_binaryVersion.empty()) {
+        // the program may already be linked for a pipeline of other state, or persisted by an earlier launch
+        auto binary = m_binaries.find(programHash);
+        if (binary == m_binaries.end()) {
+            binary = m_binaries.emplace(programHash, loadBinary(programHash)).first;
+        }
+
+        if (!binary->second.empty()) {
+            std::unique_ptr<Pipeline> pipeline = buildFromBinary(description, binary->second);
+            if (pipeline != nullptr) {
+                return pipeline;
+            }
+        }
+    }
+
+    // while the program is building, its binary cannot be retrieved, so its shaders are linked again
+    std::unique_ptr<Shader> vertexShader;
+    std::unique_ptr<Shader> fragmentShader;
+    Shader* vertex;
+    Shader* fragment;
+    auto pending = m_pendingPrograms.find(programHash);
+    if (pending != m_pendingPrograms.end()) {
+        vertex = pending->second.vertexShader.get();
+        fragment = pending->second.fragmentShader.get();
+    } else {
+        const ShaderSource& vertexSource = description.vertexShader;
+        const ShaderSource& fragmentSource = description.fragmentShader;
+        vertexShader = m_rhi.createShader(vertexSource.code.data(), vertexSource.code.size(), vertexSource.type,
+                                          vertexSource.name);
+        fragmentShader = m_rhi.createShader(fragmentSource.code.data(), fragmentSource.code.size(),
+                                            fragmentSource.type, fragmentSource.name);
+        vertex = vertexShader.get();
+        fragment = fragmentShader.get();
+        m_numCompiled++;
+    }
+
+    std::shared_ptr<Pipeline> pipeline = m_rhi.createPipelineBuilder()
+        ->setTopology(description.topology)
+        ->setVertexLayout(description.vertexLayout)
+        ->setVertexShader(*vertex)
+        ->setFragmentShader(*fragment)
+        ->setDepthState(description.depthState)
+        ->setStencilState(description.stencilState)
+        ->setBlendState(description.blendState)
+        ->setRasterState(description.rasterState)
+        ->setColorWriteEnabled(description.colorWriteEnabled)
+        ->build();
+
+    // every linked pipeline is tracked until it finishes building, whether or not binaries are supported,
+    // so that wait() finishes it before it is first bound
+    if (pending != m_pendingPrograms.end()) {
+        pending->second.pipelines.push_back(pipeline);
+    } else {
+        m_pendingPrograms.emplace(programHash, PendingProgram{
+            .vertexShader = std::move(vertexShader),
+            .fragmentShader = std::move(fragmentShader),
+            .pipelines = {pipeline},
+        });
+    }
+
+    return pipeline;
+}
+
+void PipelineCache::finish(uint64_t programHash, const PendingProgram& program) {
+    for (const std::shared_ptr<Pipeline>& pipeline: program.pipelines) {
+        pipeline->wait();
+    }
+    if (m_binaryVersion.empty()) {
+        return;
+    }
+
+    // the pipelines share a program, so the binary of the first serves them all
+    std::vector<uint8_t> binary = m_rhi.pipelineBinary(*program.pipelines.front());
+    if (!binary.empty()) {
+        storeBinary(programHash, binary);
+    }
+    m_binaries[programHash] = std::move(binary);
+}
+
+std::unique_ptr<Pipeline> PipelineCache::buildFromBinary(const PipelineDescription& description,
+                                                         const std::vector<uint8_t>& binary) {
+    return m_rhi.createPipelineBuilder()
+        ->setTopology(description.topology)
+        ->setVertexLayout(description.vertexLayout)
+        ->setDepthState(description.depthState)
+        ->setStencilState(description.stencilState)
+        ->setBlendState(description.blendState)
+        ->setRasterState(description.rasterState)
+        ->setColorWriteEnabled(description.colorWriteEnabled)
+        ->setBinary(binary)
+        ->build();
+}
+
+std::vector<uint8_t> PipelineCache::loadBinary(uint64_t programHash) const {
+    if (m_directory.empty()) {
+        return {};
+    }
+
+    // a missing or unreadable file is a cache miss, as is a program persisted by another driver
+    std::ifstream file(binaryPath(programHash), std::ios::binary);
+    uint32_t magic = 0;
+    uint32_t versionSize = 0;
+    file.read((char*)&magic, sizeof(magic));
+    file.read((char*)&versionSize, sizeof(versionSize));
+    if (!file || magic != binaryMagic || versionSize != m_binaryVersion.size()) {
+        return {};
+    }
+
+    std::string version(versionSize, '\0');
+    file.read(version.data(), versionSize);
+    if (!file || version != m_binaryVersion) {
+        return {};
+    }
+
+    std::vector<uint8_t> binary((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    return binary;
+}
+
+void PipelineCache::storeBinary(uint64_t programHash, const std::vector<uint8_t>& binary) const {
+    if (m_directory.empty()) {
+        return;
+    }
+
+    // the program is written beside its file and then renamed over it, so a partly written file is never read
+    std::filesystem::path path = binaryPath(programHash);
+    std::filesystem::path temporaryPath = path;
+    temporaryPath += ".tmp";
+    {
+        std::ofstream file(temporaryPath, std::ios::binary | std::ios::trunc);
+        auto versionSize = (uint32_t)m_binaryVersion.size();
+        file.write((const char*)&binaryMagic, sizeof(binaryMagic));
+        file.write((const char*)&versionSize, sizeof(versionSize));
+        file.write(m_binaryVersion.data(), versionSize);
+        file.write((const char*)binary.data(), (std::streamsize)binary.size());
+        if (!file) {
+            std::cerr << "ERR: failed to write pipeline binary: " << temporaryPath << std::endl;
+            return;
+        }
+    }
+
+    std::error_code error;
+    std::filesystem::rename(temporaryPath, path, error);
+    if (error) {
+        std::cerr << "ERR: failed to write pipeline binary: " << path << std::endl;
+    }
+}
+
+std::filesystem::path PipelineCache::binaryPath(uint64_t programHash) const {
+    std::ostringstream name;
+    name << std::hex << std::setw(16) << std::setfill('0') << programHash << ".bin";
+    return m_directory / name.str();
+}
@@ -0,0 +1,133 @@
+#ifndef OPENGL_RENDERER_PIPELINECACHE_H
+#define OPENGL_RENDERER_PIPELINECACHE_H
+
+#include <filesystem>
+#include <unordered_map>
+
+#include "RHI.h"
+
+/**
+ * Everything a pipeline is built from, by which a pipeline cache finds pipelines that are the same.
+ */
+struct PipelineDescription {
+    ShaderSource vertexShader;
+    ShaderSource fragmentShader;
+    VertexLayout vertexLayout;
+    Topology topology = Topology::Triangles;
+    DepthState depthState{};
+    StencilState stencilState{};
+    BlendState blendState{};
+    RasterState rasterState{};
+    bool colorWriteEnabled = true;
+
+    bool operator==(const PipelineDescription&) const = default;
+};
+
+/**
+ * Shares pipelines between everything that builds them from the same shader source and state, such as
+ * materials created repeatedly, so each is compiled and linked once.
+ *
+ * If the cache has a directory and the api supports pipeline binaries, the linked program of each pair
+ * of shaders is written to the directory, named by a hash of their source. Later launches load programs
+ * from there in place of compiling shaders, unless the driver has changed since they were written, in
+ * which case they are rebuilt and overwritten. Pipelines that differ only in state share a program.
+ *
+ * Pipelines are returned without waiting for their shaders to compile, so that the driver can build
+ * many at once. Programs that were linked rather than loaded are tracked until they have finished
+ * building, checked at the start of each frame, and then persisted if binaries are supported. While
+ * loading, every pipeline should be requested before any is used, then wait() finishes them all so that
+ * the first frame does not wait on the driver.
+ *
+ * The cache is used on the thread that owns the api.
+ */
+class PipelineCache : public FrameResource {
+public:
+    explicit PipelineCache(RHI& rhi);
+
+    PipelineCache(const PipelineCache&) = delete;
+
+    /**
+     * Waits for the pipelines still building, to persist their programs.
+     */
+    ~PipelineCache() override;
+
+    void recycle(uint32_t frameIndex) override;
+
+    /**
+     * Sets the directory that programs are persisted to, created if it does not exist. By default,
+     * programs are not persisted.
+     *
+     * @param directory the directory, or empty to not persist programs
+     */
+    void setDirectory(std::filesystem::path directory);
+
+    /**
+     * Finds the pipeline built from the given description, starting to build it if it is not cached.
+     *
+     * @param description the shaders and state of the pipeline
+     * @returns the pipeline, shared with every other user of the same description, which may still be
+     *          building
+     */
+    std::shared_ptr<Pipeline> get(const PipelineDescription& description);
+
+    /**
+     * Checks and persists the programs that have finished building, without waiting for the others.
+     *
+     * @returns the number of programs still building
+     */
+    size_t poll();
+
+    /**
+     * Waits for every program still building, and persists them.
+     */
+    void wait();
+
+    /**
+     * @returns the number of pipelines in the cache
+     */
+    size_t size() const {
+        return m_pipelines.size();
+    }
+
+    /**
+     * @returns the number of programs that were compiled from shaders, rather than loaded as binaries
+     */
+    uint32_t numCompiled() const {
+        return m_numCompiled;
+    }
+
+private:
+    struct Entry {
+        PipelineDescription description;
+        std::shared_ptr<Pipeline> pipeline;
+    };
+
+    // a program that is building, whose shaders are linked by pipelines of other state until it is done
+    struct PendingProgram {
+        std::unique_ptr<Shader> vertexShader;
+        std::unique_ptr<Shader> fragmentShader;
+        std::vector<std::shared_ptr<Pipeline>> pipelines; // every pipeline linked from the shaders, in order
+    };
+
+    static uint64_t hashProgram(const PipelineDescription& description);
+    static uint64_t hashState(const PipelineDescription& description, uint64_t programHash);
+
+    std::shared_ptr<Pipeline> build(const PipelineDescription& description, uint64_t programHash);
+    void finish(uint64_t programHash, const PendingProgram& program);
+    std::unique_ptr<Pipeline> buildFromBinary(const PipelineDescription& description,
+                                              const std::vector<uint8_t>& binary);
+    std::vector<uint8_t> loadBinary(uint64_t programHash) const;
+    void storeBinary(uint64_t programHash, const std::vector<uint8_t>& binary) const;
+    std::filesystem::path binaryPath(uint64_t programHash) const;
+
+    RHI& m_rhi;
+    std::filesystem::path m_directory;
+    std::string m_binaryVersion; // of the api's driver, or empty if binaries are not supported
+    std::unordered_multimap<uint64_t, Entry> m_pipelines;
+    std::unordered_map<uint64_t, std::vector<uint8_t>> m_binaries; // by program hash, for pipelines of other state
+    std::unordered_map<uint64_t, PendingProgram> m_pendingPrograms; // by program hash, until they finish building
+    uint32_t m_numCompiled;
+};
+
+
+#endif //OPENGL_RENDERER_PIPELINECACHE_H
@@ -1,10 +1,79 @@
 #include "RHI.h"
+#include "UploadQueue.h"
+#include "PipelineCache.h"
+#ifndef RHI_WITHOUT_OPENGL
 #include "opengl/OpenGLRHI.h"
+#endif
+#include "null/NullRHI.h"
+#include "software/SoftwareRHI.h"
+
+namespace {
+    /**
+     * Checks a copy from a buffer to a region of a level of a texture, given the region covering the level.
+     *
+     * @returns the size of the copied pixels, in bytes
+     */
+    uint32_t checkRegionCopy(const Buffer& source, uint32_t sourceOffset, Format format,
+                             const TextureRegion& levelRegion, const TextureRegion& region) {
+        if ((uint64_t)region.x + region.width > levelRegion.width ||
+            (uint64_t)region.y + region.height > levelRegion.height) {
+            throw std::out_of_range("The region must be within the level.");
+        }
+
+        // blocks past the edge of a level hold pixels that are never sampled
+        if (isBlockCompressed(format) && (region.x % 4 != 0 || region.y % 4 != 0 ||
+            (region.width % 4 != 0 && region.x + region.width != levelRegion.width) ||
+            (region.height % 4 != 0 && region.y + region.height != levelRegion.height))) {
+            throw std::invalid_argument("Regions of block-compressed textures must be aligned to blocks.");
+        }
+
+        uint64_t size = imageSize(format, region.width, region.height);
+        if (sourceOffset + size > source.size()) {
+            throw std::out_of_range("The pixels must be within the source buffer.");
+        }
+        return (uint32_t)size;
+    }
+}
 
 std::unique_ptr<RHI> RHI::currentAPI(nullptr);
 
-void RHI::create() {
-    currentAPI = std::make_unique<OpenGLRHI>();
+RHI::RHI() : m_frameContext(*this, FrameContext::defaultFramesInFlight) {}
+
+RHI::~RHI() = default;
+
+UploadQueue& RHI::uploadQueue() {
+    if (m_uploadQueue == nullptr) {
+        m_uploadQueue = std::make_unique<UploadQueue>(*this, UploadQueue::defaultCapacity);
+    }
+
+    return *m_uploadQueue;
+}
+
+PipelineCache& RHI::pipelineCache() {
+    if (m_pipelineCache == nullptr) {
+        m_pipelineCache = std::make_unique<PipelineCache>(*this);
+    }
+
+    return *m_pipelineCache;
+}
+
+void RHI::create(Backend backend) {
+    destroy();
+    switch (backend) {
+#ifndef RHI_WITHOUT_OPENGL
+        case Backend::OpenGL:
+            currentAPI = std::make_unique<OpenGLRHI>();
+            break;
+#endif
+        case Backend::Null:
+            currentAPI = std::make_unique<NullRHI>();
+            break;
+        case Backend::Software:
+            currentAPI = std::make_unique<SoftwareRHI>();
+            break;
+        default:
+            throw std::invalid_argument("The render api is not supported.");
+    }
 }
 
 RHI& RHI::current() {
@@ -16,5 +85,54 @@ RHI& RHI::current() {
 }
 
 void RHI::destroy() {
+    if (currentAPI != nullptr) {
+        // the queue's staging buffer and the cached pipelines are freed through the api, so must go before it
+        currentAPI->m_uploadQueue.reset();
+        currentAPI->m_pipelineCache.reset();
+        currentAPI->m_frameContext.deletionQueue().releaseAll();
+    }
     currentAPI.reset(nullptr);
 }
+
+void RHI::checkTexture2D(Format format, uint32_t width, uint32_t height, uint32_t numSamples,
+                         uint32_t numLevels) {
+    if (numSamples == 0) {
+        throw std::invalid_argument("Textures must have at least one sample per pixel.");
+    }
+    if (numLevels == 0 || numLevels > 32 || (std::max(width, height) >> (numLevels - 1)) == 0) {
+        throw std::invalid_argument("Textures must have at least one level, each at least one pixel in size.");
+    }
+    if (numSamples > 1 && (numLevels > 1 || isBlockCompressed(format))) {
+        throw std::invalid_argument("Multi-sampled textures must have one level and an uncompressed format.");
+    }
+}
+
+uint32_t RHI::checkTextureCopy(const Buffer& source, uint32_t sourceOffset, const Texture2D& destination,
+                               uint32_t level, const TextureRegion& region) {
+    if (destination.numSamples() != 1) {
+        throw std::invalid_argument("Pixels can only be copied to single-sampled textures.");
+    }
+    if (level >= destination.numLevels()) {
+        throw std::out_of_range("The level must be within the texture.");
+    }
+    return checkRegionCopy(source, sourceOffset, destination.format(), destination.region(level), region);
+}
+
+uint32_t RHI::checkTextureCopy(const Buffer& source, uint32_t sourceOffset, const Texture2DArray& destination,
+                               uint32_t layer, uint32_t level, const TextureRegion& region) {
+    if (layer >= destination.numLayers()) {
+        throw std::out_of_range("The layer must be within the texture array.");
+    }
+    if (level >= destination.numLevels()) {
+        throw std::out_of_range("The level must be within the texture array.");
+    }
+    return checkRegionCopy(source, sourceOffset, destination.format(), destination.region(level), region);
+}
+
+void RHI::release(std::function<void()> deleter) {
+    if (currentAPI != nullptr) {
+        currentAPI->m_frameContext.deletionQueue().push(std::move(deleter));
+    } else {
+        deleter();
+    }
+}
@@ -3,48 +3,86 @@
 
 #include "Buffer.h"
 #include "Texture2D.h"
+#include "Texture2DArray.h"
 #include "Shader.h"
 #include "Pipeline.h"
 #include "Framebuffer.h"
 #include "VertexLayout.h"
 #include "Uniform.h"
 #include "DescriptorSet.h"
+#include "Fence.h"
+#include "FrameContext.h"
+#include "TimerQuery.h"
+#include "CommandList.h"
+#include "../util/Profiler.h"
+
+class UploadQueue;
+class PipelineCache;
 
 /**
  * Base class for platform-specific render api implementations.
  */
 class RHI {
 public:
-    virtual ~RHI() = default;
+    RHI();
+    virtual ~RHI();
 
     /**
-     * Creates a buffer object of the given size.
+     * Creates a buffer object of the given size. Static buffers cannot be mapped, and are filled by
+     * copying into them, generally through uploadQueue().
      *
      * @param size the size of the buffer, in bytes
      * @param stride the stride (distance between elements) of the buffer, in bytes
+     * @param usage how the buffer is written and read
      * @returns the constructed buffer object
      */
-    virtual std::unique_ptr<Buffer> createBuffer(uint32_t size, uint32_t stride) = 0;
+    virtual std::unique_ptr<Buffer> createBuffer(uint32_t size, uint32_t stride,
+                                                 BufferUsage usage = BufferUsage::Dynamic) = 0;
 
     /**
-     * Creates a 2d texture object with the given width and height.
+     * Creates a 2d texture object with the given width and height. Multi-sampled textures can only
+     * be used as framebuffer attachments, and must be resolved to be sampled. Textures of block-compressed
+     * formats can only be sampled.
      *
      * @param format the format for the texture's pixels
      * @param width the width of the texture, in pixels
      * @param height the height of the texture, in pixels
+     * @param numSamples the number of samples per pixel
+     * @param numLevels the number of mip-map levels, which are filled by copyBufferToTexture2D()
      * @returns the constructed texture object
+     * @throws std::invalid_argument if there are no samples or levels, more levels than the size allows, or
+     *                               a multi-sampled texture has more than one level or a compressed format
      */
-    virtual std::unique_ptr<Texture2D> createTexture2D(Format format, uint32_t width, uint32_t height) = 0;
+    virtual std::unique_ptr<Texture2D> createTexture2D(Format format, uint32_t width, uint32_t height,
+                                                       uint32_t numSamples = 1, uint32_t numLevels = 1) = 0;
 
     /**
-     * Creates a shader module for the given stage from the given code.
+     * Creates an array of single-sampled 2d textures of the same format and size.
+     *
+     * @param format the format for the pixels of each layer
+     * @param width the width of each layer, in pixels
+     * @param height the height of each layer, in pixels
+     * @param numLayers the number of layers
+     * @param numLevels the number of mip-map levels of each layer, which are filled by copyBufferToTexture2DArray()
+     * @returns the constructed texture array
+     * @throws std::invalid_argument if the number of layers or levels is zero, or there are more levels than the
+     *                               size allows
+     */
+    virtual std::unique_ptr<Texture2DArray> createTexture2DArray(Format format, uint32_t width, uint32_t height,
+                                                                 uint32_t numLayers, uint32_t numLevels = 1) = 0;
+
+    /**
+     * Creates a shader module for the given stage from the given code. The name identifies the shader
+     * to apis that do not compile code, such as the software api, and labels it for debuggers.
      *
      * @param code the code to be used to generate the shader
      * @param codeSize the size of the code, in bytes
      * @param type the type of the shader
+     * @param name the name of the shader, such as the file name it was loaded from
      * @returns the constructed shader module
      */
-    virtual std::unique_ptr<Shader> createShader(const void* code, size_t codeSize, ShaderType type) = 0;
+    virtual std::unique_ptr<Shader> createShader(const void* code, size_t codeSize, ShaderType type,
+                                                 std::string_view name = {}) = 0;
 
     /**
      * Creates a descriptor set using the given bindings.
@@ -54,11 +92,40 @@ public:
      */
     virtual std::unique_ptr<DescriptorSet> createDescriptorSet(std::vector<DescriptorSetBinding> bindings) = 0;
 
+    /**
+     * Creates a fence that is signaled once all previously submitted commands have completed.
+     *
+     * @returns the constructed fence
+     */
+    virtual std::unique_ptr<Fence> createFence() = 0;
+
+    /**
+     * @returns a timer query for measuring time spent on the gpu
+     */
+    virtual std::unique_ptr<TimerQuery> createTimerQuery() = 0;
+
     /**
      * @returns a builder for creating pipelines
      */
     virtual std::unique_ptr<PipelineBuilder> createPipelineBuilder() = 0;
 
+    /**
+     * Identifies the driver that compiles pipelines, such as by its vendor, renderer and version. Pipeline
+     * binaries may only be loaded by the driver that retrieved them.
+     *
+     * @returns the identity of the driver, or an empty string if pipeline binaries are not supported
+     */
+    virtual std::string pipelineBinaryVersion() = 0;
+
+    /**
+     * Retrieves the compiled program of a pipeline, from which PipelineBuilder::setBinary() builds pipelines
+     * without compiling their shaders.
+     *
+     * @param pipeline the pipeline
+     * @returns the program binary, or empty if it cannot be retrieved
+     */
+    virtual std::vector<uint8_t> pipelineBinary(const Pipeline& pipeline) = 0;
+
     /**
      * @returns a builder for creating framebuffers
      */
@@ -74,20 +141,114 @@ public:
     virtual void copyBufferToTexture2D(Buffer& source, Texture2D& destination) = 0;
 
     /**
-     * Resolves a multi-sampled 2d texture into a single-sampled texture.
+     * Transfers pixels of the texture's format from a buffer to a region of a level of a 2d texture,
+     * leaving the other levels unchanged. Rows are tightly packed, and rows of blocks for block-compressed
+     * formats, whose regions must be aligned to blocks except where they meet the edge of the level.
+     *
+     * @param source the source buffer, must not be mapped
+     * @param sourceOffset the offset of the pixels in the source, in bytes
+     * @param destination the destination texture, which must be single-sampled
+     * @param level the mip-map level to write
+     * @param region the region of the level to write
+     * @throws std::out_of_range if the region is not within the level, or the pixels are not within the source
+     * @throws std::invalid_argument if the region is not aligned to blocks, or the texture is multi-sampled
+     */
+    virtual void copyBufferToTexture2D(Buffer& source, uint32_t sourceOffset, Texture2D& destination,
+                                       uint32_t level, const TextureRegion& region) = 0;
+
+    /**
+     * Transfers pixels of the array's format from a buffer to a region of a level of a layer of a 2d texture
+     * array, leaving the other layers and levels unchanged. Pixels are laid out as for copyBufferToTexture2D().
+     *
+     * @param source the source buffer, must not be mapped
+     * @param sourceOffset the offset of the pixels in the source, in bytes
+     * @param destination the destination texture array
+     * @param layer the layer of the array to write
+     * @param level the mip-map level to write
+     * @param region the region of the level to write
+     * @throws std::out_of_range if the layer, level or region is not within the array, or the pixels are not
+     *                           within the source
+     * @throws std::invalid_argument if the region is not aligned to blocks
+     */
+    virtual void copyBufferToTexture2DArray(Buffer& source, uint32_t sourceOffset, Texture2DArray& destination,
+                                            uint32_t layer, uint32_t level, const TextureRegion& region) = 0;
+
+    /**
+     * Copies a range of one buffer into another on the gpu. The copy happens after previously submitted
+     * commands, and before those submitted after it.
      *
-     * @param source the source multi-sampled texture
-     * @param destination the destination single-sampled texture
+     * @param source the buffer to copy from
+     * @param sourceOffset the offset of the range in the source, in bytes
+     * @param destination the buffer to copy to, which may be static
+     * @param destinationOffset the offset of the range in the destination, in bytes
+     * @param size the size of the range, in bytes
+     * @throws std::out_of_range if either range is not within its buffer
+     */
+    virtual void copyBuffer(const Buffer& source, uint32_t sourceOffset, Buffer& destination,
+                            uint32_t destinationOffset, uint32_t size) = 0;
+
+    /**
+     * @returns the queue that fills static buffers through a shared staging ring, created on first use
+     */
+    UploadQueue& uploadQueue();
+
+    /**
+     * @returns the cache that shares pipelines built from the same shaders and state, created on first use
      */
-    virtual void resolveTexture2D(Texture2D& source, Texture2D& destination) = 0;
+    PipelineCache& pipelineCache();
 
     /**
-     * Binds a buffer for use as a vertex buffer at the given binding location.
+     * @returns the frame context that paces frames, which the application begins and ends each frame
+     */
+    FrameContext& frameContext() {
+        return m_frameContext;
+    }
+
+    /**
+     * Resolves a multi-sampled 2d texture into a single-sampled texture, or scales a single-sampled
+     * texture into another, filtering linearly if the textures hold color.
+     *
+     * @param source the source texture
+     * @param destination the destination single-sampled texture, of the same format if the source is multi-sampled
+     */
+    void resolveTexture2D(Texture2D& source, Texture2D& destination) {
+        resolveTexture2D(source, source.region(), destination, destination.region());
+    }
+
+    /**
+     * Resolves a region of a multi-sampled 2d texture into a region of a single-sampled texture, or
+     * scales a region of a single-sampled texture into a region of another, filtering linearly if the
+     * textures hold color. Multi-sampled textures can only be resolved into regions of the same size.
+     *
+     * @param source the source texture
+     * @param sourceRegion the region of the source texture to read
+     * @param destination the destination single-sampled texture, of the same format if the source is multi-sampled
+     * @param destinationRegion the region of the destination texture to write
+     */
+    virtual void resolveTexture2D(Texture2D& source, const TextureRegion& sourceRegion, Texture2D& destination,
+                                  const TextureRegion& destinationRegion) = 0;
+
+    /**
+     * Binds a buffer for use as a vertex buffer at the given binding location, with vertices the
+     * buffer's stride apart from its start.
      *
      * @param buffer the vertex buffer to bind
      * @param binding the binding location
      */
-    virtual void bindVertexBuffer(const Buffer& buffer, uint32_t binding) = 0;
+    void bindVertexBuffer(const Buffer& buffer, uint32_t binding) {
+        bindVertexBuffer(buffer, binding, 0, buffer.stride());
+    }
+
+    /**
+     * Binds a range of a buffer for use as a vertex buffer at the given binding location, such as
+     * vertices written into part of a shared buffer.
+     *
+     * @param buffer the vertex buffer to bind
+     * @param binding the binding location
+     * @param offset the offset of the 0th vertex in the buffer, in bytes
+     * @param stride the distance between vertices, in bytes
+     */
+    virtual void bindVertexBuffer(const Buffer& buffer, uint32_t binding, uint32_t offset, uint32_t stride) = 0;
 
     /**
      * Binds a buffer for use as the index buffer.
@@ -106,11 +267,15 @@ public:
     virtual void bindUniforms(UniformBlock& uniformBlock) = 0;
 
     /**
-     * Binds a descriptor set for sourcing texture and buffer bindings for draw calls.
+     * Binds a descriptor set for sourcing texture and buffer bindings for draw calls. Each dynamic
+     * uniform buffer in the set has the next dynamic offset, in order of binding index, added to
+     * the offset it was bound with.
      *
      * @param descriptorSet the descriptor set to bind
+     * @param dynamicOffsets the offsets for each dynamic uniform buffer in the set, in bytes
+     * @throws std::invalid_argument if there are fewer offsets than dynamic uniform buffers
      */
-    virtual void bindDescriptorSet(const DescriptorSet& descriptorSet) = 0;
+    virtual void bindDescriptorSet(const DescriptorSet& descriptorSet, std::span<const uint32_t> dynamicOffsets = {}) = 0;
 
     /**
      * Binds a pipeline for subsequent draw calls.
@@ -122,6 +287,16 @@ public:
     virtual void bindFramebuffer(Framebuffer& framebuffer) = 0;
     virtual void bindDefaultFramebuffer() = 0;
 
+    /**
+     * Issues the commands of a command list in the order they were recorded. Command lists are
+     * executed in the order they are submitted, and may be submitted more than once.
+     *
+     * @param commandList the command list to execute
+     */
+    virtual void submit(const CommandList& commandList) {
+        commandList.execute(*this);
+    }
+
     // set rendering parameters
     /**
      * Sets the viewport for subsequent draw calls to the currently bound framebuffer. The coordinates are
@@ -163,10 +338,55 @@ public:
      */
     virtual void drawIndexed(uint32_t indexCount, uint32_t baseIndex, uint32_t baseVertex) = 0;
 
+    // profiling
+    /**
+     * Begins timing a named scope, such as a render pass, on both the cpu and gpu. Scopes may be nested,
+     * and their times are recorded in the profiler once the gpu has reached their end, without waiting for it.
+     *
+     * @param name the name of the scope
+     */
+    virtual void beginGpuScope(std::string_view name) = 0;
+
     /**
-     * Sets the current api to be the default render api for the platform.
+     * Ends the most recently begun scope.
      */
-    static void create();
+    virtual void endGpuScope() = 0;
+
+    /**
+     * @returns the profiler that the times of scopes are recorded in
+     */
+    Profiler& profiler() {
+        return m_profiler;
+    }
+
+    // device limits
+    /**
+     * @returns the alignment required for offsets of uniform buffer bindings, in bytes
+     */
+    virtual uint32_t uniformBufferAlignment() const = 0;
+
+    /**
+     * @returns the alignment required for offsets of storage buffer bindings, in bytes
+     */
+    virtual uint32_t storageBufferAlignment() const = 0;
+
+    /**
+     * The render apis that can be created.
+     */
+    enum class Backend {
+        OpenGL, // requires a current OpenGL context
+        Null, // draws nothing, for measuring cpu costs without a gpu
+        Software, // rasterizes on the cpu, into framebuffers only
+    };
+
+    /**
+     * Sets the current api to be the given render api, by default the one for the platform.
+     *
+     * @param backend the render api to create
+     * @throws std::invalid_argument if the api is not built, as OpenGL is not when RHI_WITHOUT_OPENGL is
+     *                               defined, so that tools measuring only the cpu need no gl libraries
+     */
+    static void create(Backend backend = Backend::OpenGL);
 
     /**
      * @returns the current api that is in use
@@ -175,12 +395,91 @@ public:
     static RHI& current();
 
     /**
-     * Destroys the current api.
+     * Destroys the current api, first running every deleter left in its deletion queue.
      */
     static void destroy();
 
+    /**
+     * Frees the api objects of a destroyed resource once the gpu has finished the frames that may use them,
+     * through the current api's deletion queue. Resources may be destroyed from any thread. Without a
+     * current api, the objects are freed immediately.
+     *
+     * @param deleter frees the api objects
+     */
+    static void release(std::function<void()> deleter);
+
+protected:
+    /**
+     * Checks that a range of a buffer is within it.
+     *
+     * @param buffer the buffer
+     * @param offset the offset of the range, in bytes
+     * @param size the size of the range, in bytes
+     * @throws std::out_of_range if the range is not within the buffer
+     */
+    static void checkBufferRange(const Buffer& buffer, uint32_t offset, uint32_t size) {
+        if ((uint64_t)offset + size > buffer.size()) {
+            throw std::out_of_range("The buffer range must be within the buffer.");
+        }
+    }
+
+    /**
+     * Checks the parameters of a 2d texture, as described by createTexture2D().
+     *
+     * @throws std::invalid_argument if the parameters are not valid
+     */
+    static void checkTexture2D(Format format, uint32_t width, uint32_t height, uint32_t numSamples,
+                               uint32_t numLevels);
+
+    /**
+     * Checks a copy from a buffer to a region of a level of a 2d texture, as described by
+     * copyBufferToTexture2D().
+     *
+     * @returns the size of the copied pixels, in bytes
+     * @throws std::out_of_range if the copy is not within the level or the source
+     * @throws std::invalid_argument if the region is not aligned to blocks, or the texture is multi-sampled
+     */
+    static uint32_t checkTextureCopy(const Buffer& source, uint32_t sourceOffset, const Texture2D& destination,
+                                     uint32_t level, const TextureRegion& region);
+
+    /**
+     * Checks a copy from a buffer to a region of a level of a layer of a 2d texture array, as described by
+     * copyBufferToTexture2DArray().
+     *
+     * @returns the size of the copied pixels, in bytes
+     * @throws std::out_of_range if the copy is not within the array or the source
+     * @throws std::invalid_argument if the region is not aligned to blocks
+     */
+    static uint32_t checkTextureCopy(const Buffer& source, uint32_t sourceOffset, const Texture2DArray& destination,
+                                     uint32_t layer, uint32_t level, const TextureRegion& region);
+
+    Profiler m_profiler;
+
 private:
     static std::unique_ptr<RHI> currentAPI;
+
+    FrameContext m_frameContext;
+    std::unique_ptr<UploadQueue> m_uploadQueue; // destroyed before the api, as its buffer needs the api
+    std::unique_ptr<PipelineCache> m_pipelineCache; // destroyed before the api, as its pipelines need the api
+};
+
+/**
+ * Times a scope on the cpu and gpu for as long as it is alive.
+ */
+class GpuScope {
+public:
+    GpuScope(RHI& rhi, std::string_view name) : m_rhi(rhi) {
+        m_rhi.beginGpuScope(name);
+    }
+
+    GpuScope(const GpuScope&) = delete;
+
+    ~GpuScope() {
+        m_rhi.endGpuScope();
+    }
+
+private:
+    RHI& m_rhi;
 };
 
 
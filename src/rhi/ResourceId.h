@@ -0,0 +1,18 @@
+#ifndef OPENGL_RENDERER_RESOURCEID_H
+#define OPENGL_RENDERER_RESOURCEID_H
+
+#include <atomic>
+
+/**
+ * Generates an id that identifies a resource for the lifetime of the program, unlike its address, which
+ * may be reused by a resource created after it is destroyed. Thread-safe.
+ *
+ * @returns a new id, never zero
+ */
+inline uint64_t nextResourceId() {
+    static std::atomic<uint64_t> nextId(1);
+    return nextId.fetch_add(1, std::memory_order_relaxed);
+}
+
+
+#endif //OPENGL_RENDERER_RESOURCEID_H
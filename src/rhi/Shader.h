@@ -6,6 +6,18 @@ enum class ShaderType {
     Vertex, Fragment, Compute
 };
 
+/**
+ * The code of a shader before it is created, from which a pipeline cache builds pipelines. The name
+ * identifies the shader as in RHI::createShader().
+ */
+struct ShaderSource {
+    ShaderType type;
+    std::string name;
+    std::string code;
+
+    bool operator==(const ShaderSource&) const = default;
+};
+
 class Shader {
 public:
     explicit Shader(ShaderType type) : m_type(type) {}
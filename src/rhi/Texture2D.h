@@ -2,15 +2,35 @@
 #define OPENGL_RENDERER_TEXTURE2D_H
 
 #include "Format.h"
+#include "ResourceId.h"
 #include "../util/Vector.h"
 
 // TODO: add enum for sampling types
 
+/**
+ * A rectangular region of a 2d texture, in pixels from its origin.
+ */
+struct TextureRegion {
+    uint32_t x;
+    uint32_t y;
+    uint32_t width;
+    uint32_t height;
+};
+
 class Texture2D {
 public:
-    Texture2D(Format format, uint32_t width, uint32_t height) : m_format(format), m_width(width), m_height(height) {}
+    Texture2D(Format format, uint32_t width, uint32_t height, uint32_t numSamples = 1, uint32_t numLevels = 1)
+        : m_id(nextResourceId()), m_format(format), m_width(width), m_height(height), m_numSamples(numSamples),
+          m_numLevels(numLevels) {}
     virtual ~Texture2D() = default;
 
+    /**
+     * @returns the id of the texture, which is unique among all resources ever created
+     */
+    uint64_t id() const {
+        return m_id;
+    }
+
     /**
      * @returns the 3d dimensions of the texture
      */
@@ -29,12 +49,38 @@ public:
      * @returns the number of samples per pixel in the texture
      */
     uint32_t numSamples() const {
-        return 1;
+        return m_numSamples;
     };
+
+    /**
+     * @returns the number of mip-map levels in the texture
+     */
+    uint32_t numLevels() const {
+        return m_numLevels;
+    }
+
+    /**
+     * @param level a mip-map level of the texture
+     * @returns the region covering the whole level, each of whose dimensions is half that of the last
+     */
+    TextureRegion region(uint32_t level) const {
+        return {0, 0, std::max(m_width >> level, 1u), std::max(m_height >> level, 1u)};
+    }
+
+    /**
+     * @returns the region covering the whole texture
+     */
+    TextureRegion region() const {
+        return {0, 0, m_width, m_height};
+    }
+
 private:
+    const uint64_t m_id;
     const Format m_format;
     const uint32_t m_width;
     const uint32_t m_height;
+    const uint32_t m_numSamples;
+    const uint32_t m_numLevels;
 };
 
 
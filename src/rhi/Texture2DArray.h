@@ -0,0 +1,72 @@
+#ifndef OPENGL_RENDERER_TEXTURE2DARRAY_H
+#define OPENGL_RENDERER_TEXTURE2DARRAY_H
+
+#include "Texture2D.h"
+#include "ResourceId.h"
+#include "../util/Vector.h"
+
+/**
+ * An array of 2d textures of the same format and size, sampled with a layer index, so that draws of
+ * textures in different layers can share a descriptor set.
+ */
+class Texture2DArray {
+public:
+    Texture2DArray(Format format, uint32_t width, uint32_t height, uint32_t numLayers, uint32_t numLevels = 1)
+        : m_id(nextResourceId()), m_format(format), m_width(width), m_height(height), m_numLayers(numLayers),
+          m_numLevels(numLevels) {}
+    virtual ~Texture2DArray() = default;
+
+    /**
+     * @returns the id of the texture array, which is unique among all resources ever created
+     */
+    uint64_t id() const {
+        return m_id;
+    }
+
+    /**
+     * @returns the width and height of each layer, then the number of layers
+     */
+    Vector<uint32_t, 3> dimensions() const {
+        return {m_width, m_height, m_numLayers};
+    }
+
+    /**
+     * @returns the format of the pixels in each layer
+     */
+    Format format() const {
+        return m_format;
+    }
+
+    /**
+     * @returns the number of layers in the array
+     */
+    uint32_t numLayers() const {
+        return m_numLayers;
+    }
+
+    /**
+     * @returns the number of mip-map levels of each layer
+     */
+    uint32_t numLevels() const {
+        return m_numLevels;
+    }
+
+    /**
+     * @param level a mip-map level of the layers
+     * @returns the region covering the whole level of a layer, each of whose dimensions is half that of the last
+     */
+    TextureRegion region(uint32_t level) const {
+        return {0, 0, std::max(m_width >> level, 1u), std::max(m_height >> level, 1u)};
+    }
+
+private:
+    const uint64_t m_id;
+    const Format m_format;
+    const uint32_t m_width;
+    const uint32_t m_height;
+    const uint32_t m_numLayers;
+    const uint32_t m_numLevels;
+};
+
+
+#endif //OPENGL_RENDERER_TEXTURE2DARRAY_H
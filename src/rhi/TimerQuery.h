@@ -0,0 +1,40 @@
+#ifndef OPENGL_RENDERER_TIMERQUERY_H
+#define OPENGL_RENDERER_TIMERQUERY_H
+
+
+/**
+ * A query of the time the gpu spends executing the commands submitted between its begin and end.
+ * Results arrive some time after the commands are submitted, and should be polled for rather than
+ * waited on. Timer queries cannot be nested.
+ */
+class TimerQuery {
+public:
+    TimerQuery() = default;
+    TimerQuery(const TimerQuery&) = delete;
+    virtual ~TimerQuery() = default;
+
+    /**
+     * Begins timing subsequently submitted commands, discarding any previous result.
+     */
+    virtual void begin() = 0;
+
+    /**
+     * Ends timing submitted commands.
+     */
+    virtual void end() = 0;
+
+    /**
+     * @returns whether the result of the last begin() and end() is available, without blocking
+     */
+    virtual bool isAvailable() = 0;
+
+    /**
+     * Gets the result of the query, blocking until it is available.
+     *
+     * @returns the time the gpu spent executing the timed commands, in nanoseconds
+     */
+    virtual uint64_t elapsed() = 0;
+};
+
+
+#endif //OPENGL_RENDERER_TIMERQUERY_H
@@ -0,0 +1,50 @@
+#include "TransientAllocator.h"
+
+TransientAllocator::TransientAllocator(uint32_t frameCapacity)
+    : m_frameCapacity(frameCapacity), m_head(0), m_frameContext(RHI::current().frameContext()) {
+    if (frameCapacity == 0) {
+        throw std::invalid_argument("TransientAllocator requires a non-zero capacity.");
+    }
+
+    m_frame = m_frameContext.frameIndex();
+    m_buffer = RHI::current().createBuffer(m_frameCapacity * m_frameContext.framesInFlight(), 1,
+                                           BufferUsage::Stream);
+    m_data = (uint8_t*)m_buffer->map();
+    m_frameContext.addResource(*this);
+}
+
+TransientAllocator::~TransientAllocator() {
+    m_frameContext.removeResource(*this);
+    m_buffer->unmap();
+}
+
+void TransientAllocator::recycle(uint32_t frameIndex) {
+    m_frame = frameIndex;
+    m_head = 0;
+}
+
+TransientAllocation TransientAllocator::allocate(uint32_t size, uint32_t alignment) {
+    if (alignment == 0) {
+        throw std::invalid_argument("Transient allocations require a non-zero alignment.");
+    }
+
+    // the offset is aligned within the whole buffer, which segments need not be aligned to
+    uint32_t base = m_frame * m_frameCapacity;
+    uint32_t head = m_head.load(std::memory_order_relaxed);
+    uint32_t offset;
+    do {
+        offset = (base + head + alignment - 1) / alignment * alignment - base;
+        if ((uint64_t)offset + size > m_frameCapacity) {
+            throw std::length_error("TransientAllocator frame capacity exceeded.");
+        }
+    } while (!m_head.compare_exchange_weak(head, offset + size, std::memory_order_relaxed));
+
+    // allocations are filled before the frame is submitted, so the range is flushed as it is allocated
+    offset += base;
+    m_buffer->flush(offset, size);
+    return TransientAllocation{
+        .data = m_data + offset,
+        .buffer = m_buffer.get(),
+        .offset = offset,
+    };
+}
@@ -0,0 +1,85 @@
+#ifndef OPENGL_RENDERER_TRANSIENTALLOCATOR_H
+#define OPENGL_RENDERER_TRANSIENTALLOCATOR_H
+
+#include <atomic>
+
+#include "RHI.h"
+
+/**
+ * Memory for data that is written by the cpu and read by the gpu within a single frame.
+ */
+struct TransientAllocation {
+    void* data; // where the cpu writes the data, valid until the end of the frame
+    const Buffer* buffer; // the buffer the gpu reads the data from
+    uint32_t offset; // of the data in the buffer, in bytes
+};
+
+/**
+ * A linear allocator of memory for dynamic geometry, such as ui quads, debug lines and particles, that
+ * is rewritten every frame. Memory is sub-allocated from a persistently mapped ring buffer, so writing
+ * it never maps a buffer or waits on the draws that read earlier allocations.
+ *
+ * The buffer is split into a segment for each frame in flight of the api's frame context. A frame
+ * allocates only from its own segment, which is recycled once the gpu has finished the frame that last
+ * used it, so memory still being read by the gpu is never overwritten. Allocations are freed together
+ * when the segment is recycled.
+ */
+class TransientAllocator : public FrameResource {
+public:
+    /**
+     * Constructs a transient allocator with the given capacity for each frame.
+     *
+     * @param frameCapacity the number of bytes that can be allocated each frame
+     * @throws std::invalid_argument if the capacity is zero
+     */
+    explicit TransientAllocator(uint32_t frameCapacity);
+
+    TransientAllocator(const TransientAllocator&) = delete;
+    ~TransientAllocator() override;
+
+    void recycle(uint32_t frameIndex) override;
+
+    /**
+     * Allocates memory from the current frame's segment. Memory may be allocated from multiple threads
+     * at once, but not concurrently with a frame beginning.
+     *
+     * @param size the size of the allocation, in bytes
+     * @param alignment the alignment of the allocation's offset in the buffer, such as the stride of
+     *                  the vertices written to it, in bytes
+     * @returns the allocation
+     * @throws std::length_error if the frame's segment is full
+     */
+    TransientAllocation allocate(uint32_t size, uint32_t alignment = 16);
+
+    /**
+     * Allocates memory for an array of elements from the current frame's segment, aligned to the size
+     * of the elements so that they can be bound as vertices.
+     *
+     * @param count the number of elements
+     * @returns the allocation
+     * @throws std::length_error if the frame's segment is full
+     */
+    template<typename T>
+    TransientAllocation allocate(uint32_t count) {
+        static_assert(std::is_trivially_copyable_v<T>, "Transient data must be trivially copyable.");
+        return allocate(count * sizeof(T), std::max<uint32_t>(alignof(T), sizeof(T)));
+    }
+
+    /**
+     * @returns the buffer that memory is allocated from
+     */
+    const Buffer& buffer() const {
+        return *m_buffer;
+    }
+
+private:
+    uint32_t m_frameCapacity;
+    uint32_t m_frame;
+    std::atomic<uint32_t> m_head;
+    std::unique_ptr<Buffer> m_buffer;
+    FrameContext& m_frameContext;
+    uint8_t* m_data;
+};
+
+
+#endif //OPENGL_RENDERER_TRANSIENTALLOCATOR_H
@@ -169,11 +169,29 @@ public:
 
 };
 
+/**
+ * A struct of uniforms laid out by the std140 rules. The offsets of its fields are computed once when it is
+ * constructed, as the fields never change. Structs whose layout is known at compile time can instead be
+ * declared as plain C++ structs, checked with hasBufferLayout(), and copied with a single memcpy.
+ */
 template<class T>
 class StructUniform : public Uniform {
 public:
     explicit StructUniform(std::vector<Uniform*> uniforms)
-            : Uniform(nullptr), m_uniforms(std::move(uniforms)) {}
+            : Uniform(nullptr), m_uniforms(std::move(uniforms)), m_offsets(m_uniforms.size()) {
+        uint32_t offset = 0;
+        uint32_t maxAlignment = 16; // std140 aligns structs to at least 16 bytes
+        for (uint32_t i = 0; i < m_uniforms.size(); i++) {
+            offset = roundUp(offset, m_uniforms[i]->alignment());
+            m_offsets[i] = offset;
+            offset += m_uniforms[i]->size();
+            maxAlignment = std::max(maxAlignment, m_uniforms[i]->alignment());
+        }
+        m_alignment = roundUp(maxAlignment, 16);
+        m_size = roundUp(offset, m_alignment);
+    }
+
+    StructUniform(const StructUniform&) = delete;
 
     ~StructUniform() override {
         for (auto uniform: m_uniforms) {
@@ -182,32 +200,32 @@ public:
     }
 
     uint32_t size() const override {
-        uint32_t offset = 0;
-        for (auto uniform: m_uniforms) {
-            offset = roundUp(offset, uniform->alignment());
-            offset += uniform->size();
-        }
-        return roundUp(offset, alignment());
+        return m_size;
     }
 
     uint32_t alignment() const override {
-        uint32_t maxAlignment = 0;
-        for (auto uniform: m_uniforms) {
-            maxAlignment = std::max(maxAlignment, uniform->alignment());
-        }
-        return roundUp(maxAlignment, 16); // only for std140
+        return m_alignment;
     }
 
     void write(void* destination) const override {
         auto byteDestination = static_cast<unsigned char*>(destination);
-        uint32_t offset = 0;
-        for (auto uniform: m_uniforms) {
-            offset = roundUp(offset, uniform->alignment());
-            uniform->write(byteDestination + offset);
-            offset += uniform->size();
+        for (uint32_t i = 0; i < m_uniforms.size(); i++) {
+            m_uniforms[i]->write(byteDestination + m_offsets[i]);
         }
     }
 
+    /**
+     * @returns the offset of the field at the given index, in bytes
+     * @throws std::out_of_range if there is no field at the index
+     */
+    uint32_t offset(uint32_t index) const {
+        if (index >= m_offsets.size()) {
+            throw std::out_of_range("Uniform index out of range.");
+        }
+
+        return m_offsets[index];
+    }
+
     const Uniform& operator[](uint32_t index) {
         if (index >= m_uniforms.size()) {
             throw std::out_of_range("Uniform index out of range.");
@@ -225,6 +243,9 @@ public:
 
 private:
     std::vector<Uniform*> m_uniforms;
+    std::vector<uint32_t> m_offsets;
+    uint32_t m_size;
+    uint32_t m_alignment;
 };
 
 using UniformBlock = StructUniform<void>;
@@ -0,0 +1,103 @@
+#ifndef OPENGL_RENDERER_UNIFORMLAYOUT_H
+#define OPENGL_RENDERER_UNIFORMLAYOUT_H
+
+#include "Uniform.h"
+
+/**
+ * The rules that lay out the members of uniform and storage blocks in memory.
+ */
+enum class BufferLayout {
+    Std140, // uniform blocks, where arrays and structs are aligned to 16 bytes
+    Std430 // storage blocks, where arrays and structs are aligned as their members
+};
+
+/**
+ * The alignment and size of a type, in bytes, as laid out in a block by the given rules. Specialized for
+ * each type a block can hold: 32-bit scalars, vectors, float matrices, and arrays of them.
+ */
+template<typename T, BufferLayout L>
+struct BufferLayoutTraits;
+
+template<typename T, BufferLayout L> requires (std::is_arithmetic_v<T> && sizeof(T) == 4)
+struct BufferLayoutTraits<T, L> {
+    static constexpr uint32_t alignment = 4;
+    static constexpr uint32_t size = 4;
+};
+
+template<typename T, unsigned int S, BufferLayout L>
+struct BufferLayoutTraits<Vector<T, S>, L> {
+    static_assert(sizeof(T) == 4, "Vectors in blocks only hold int, uint, and float.");
+
+    static constexpr uint32_t alignment = S == 2 ? 8 : 16;
+    static constexpr uint32_t size = S * 4;
+};
+
+template<typename T, uint32_t N, BufferLayout L>
+struct BufferLayoutTraits<T[N], L> {
+    static constexpr uint32_t alignment = L == BufferLayout::Std140
+            ? Uniform::roundUp(BufferLayoutTraits<T, L>::alignment, 16)
+            : BufferLayoutTraits<T, L>::alignment;
+    static constexpr uint32_t stride = Uniform::roundUp(BufferLayoutTraits<T, L>::size, alignment);
+    static constexpr uint32_t size = N * stride;
+};
+
+template<typename T, size_t N, BufferLayout L>
+struct BufferLayoutTraits<std::array<T, N>, L> : BufferLayoutTraits<T[N], L> {};
+
+/**
+ * Matrices are laid out as an array of their column vectors.
+ */
+template<unsigned int C, unsigned int R, BufferLayout L>
+struct BufferLayoutTraits<Matrix<float, C, R>, L> : BufferLayoutTraits<Vector<float, R>[C], L> {};
+
+/**
+ * A member of a C++ struct that is copied as is into a uniform or storage block.
+ */
+template<typename S, typename F>
+struct BufferField {
+    /**
+     * @param member the member, which only gives the struct and member types
+     * @param offset the offset of the member, from offsetof()
+     */
+    constexpr BufferField([[maybe_unused]] F S::*member, size_t offset) : offset(offset) {}
+
+    size_t offset;
+};
+
+/**
+ * Checks at compile time that a C++ struct matches the layout of a block of the given rules, so it can be
+ * copied into a buffer with a single memcpy. Each member is checked to start at the offset the rules give
+ * it, and to be the same size as the shader reads, and the struct is checked to have no trailing members
+ * or padding that the rules do not. Structs are written with plain members, such as:
+ *
+ * static_assert(hasBufferLayout<BufferLayout::Std140>(
+ *         BufferField(&DrawUniforms::modelViewProjection, offsetof(DrawUniforms, modelViewProjection)),
+ *         BufferField(&DrawUniforms::model, offsetof(DrawUniforms, model))),
+ *     "DrawUniforms must follow the std140 layout.");
+ *
+ * @tparam L the layout rules of the block
+ * @param fields every member of the struct, in order of declaration
+ * @returns whether the struct matches the layout
+ */
+template<BufferLayout L, typename S, typename... F>
+consteval bool hasBufferLayout(BufferField<S, F>... fields) {
+    static_assert(std::is_standard_layout_v<S> && std::is_trivially_copyable_v<S>,
+                  "Structs copied into blocks must be standard layout and trivially copyable.");
+
+    uint32_t offset = 0;
+    uint32_t alignment = L == BufferLayout::Std140 ? 16 : 1;
+    bool matches = true;
+    auto check = [&]<typename T>(const BufferField<S, T>& field) {
+        using Traits = BufferLayoutTraits<std::remove_cv_t<T>, L>;
+        offset = Uniform::roundUp(offset, Traits::alignment);
+        matches = matches && field.offset == offset && sizeof(T) == Traits::size;
+        offset += Traits::size;
+        alignment = std::max(alignment, Traits::alignment);
+    };
+    (check(fields), ...);
+
+    return matches && sizeof(S) == Uniform::roundUp(offset, alignment);
+}
+
+
+#endif //OPENGL_RENDERER_UNIFORMLAYOUT_H
@@ -0,0 +1,52 @@
+#include "UniformRing.h"
+
+UniformRing::UniformRing(uint32_t frameCapacity)
+    : m_head(0), m_frameContext(RHI::current().frameContext()) {
+    if (frameCapacity == 0) {
+        throw std::invalid_argument("UniformRing requires a non-zero capacity.");
+    }
+
+    RHI& rhi = RHI::current();
+    uint32_t framesInFlight = m_frameContext.framesInFlight();
+    m_frame = m_frameContext.frameIndex();
+    m_alignment = std::max({rhi.uniformBufferAlignment(), rhi.storageBufferAlignment(), 1u});
+
+    // round each segment to the alignment so that every segment starts aligned, and leave room at the
+    // end of the buffer so that the bound range never runs past it
+    m_frameCapacity = (frameCapacity + m_alignment - 1) / m_alignment * m_alignment;
+    m_buffer = rhi.createBuffer(m_frameCapacity * framesInFlight + maxRange, m_alignment, BufferUsage::Stream);
+    m_data = (uint8_t*)m_buffer->map();
+
+    m_descriptorSet = rhi.createDescriptorSet({
+        DescriptorSetBinding{
+            .binding = binding,
+            .type = DescriptorType::UniformBufferDynamic,
+        },
+    });
+    m_descriptorSet->bindUniformBuffer(binding, *m_buffer, 0, maxRange);
+    m_frameContext.addResource(*this);
+}
+
+UniformRing::~UniformRing() {
+    m_frameContext.removeResource(*this);
+    m_buffer->unmap();
+}
+
+void UniformRing::recycle(uint32_t frameIndex) {
+    m_frame = frameIndex;
+    m_head = 0;
+}
+
+uint32_t UniformRing::push(const void* data, uint32_t size) {
+    // reserve whole multiples of the alignment so that every offset stays aligned without a lock
+    uint32_t alignedSize = (size + m_alignment - 1) / m_alignment * m_alignment;
+    uint32_t offset = m_head.fetch_add(alignedSize, std::memory_order_relaxed);
+    if (offset + size > m_frameCapacity) {
+        throw std::length_error("UniformRing frame capacity exceeded.");
+    }
+
+    offset += m_frame * m_frameCapacity;
+    std::memcpy(m_data + offset, data, size);
+    m_buffer->flush(offset, size);
+    return offset;
+}
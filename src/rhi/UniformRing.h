@@ -0,0 +1,105 @@
+#ifndef OPENGL_RENDERER_UNIFORMRING_H
+#define OPENGL_RENDERER_UNIFORMRING_H
+
+#include <atomic>
+
+#include "RHI.h"
+
+/**
+ * A ring of uniform buffer memory for per-draw data, persistently mapped so that uniforms are written
+ * with a single copy and bound as a range of one buffer using a dynamic offset.
+ *
+ * The buffer is split into a segment for each frame in flight of the api's frame context. A frame writes
+ * only into its own segment, which is recycled once the gpu has finished the frame that last used it, so
+ * memory still being read by the gpu is never overwritten.
+ *
+ * Offsets are aligned for both uniform and storage buffer bindings, so other per-frame data, such as
+ * arrays read by shaders, can be pushed and bound as ranges of buffer().
+ */
+class UniformRing : public FrameResource {
+public:
+    /**
+     * Constructs a uniform ring with the given capacity for each frame.
+     *
+     * @param frameCapacity the number of bytes that can be pushed each frame
+     * @throws std::invalid_argument if the capacity is zero
+     */
+    explicit UniformRing(uint32_t frameCapacity);
+
+    UniformRing(const UniformRing&) = delete;
+    ~UniformRing() override;
+
+    void recycle(uint32_t frameIndex) override;
+
+    /**
+     * Copies uniform data into the current frame's segment. Data may be pushed from multiple threads
+     * at once, but not concurrently with a frame beginning.
+     *
+     * @param data the uniform data, laid out as the shader expects (generally std140)
+     * @param size the size of the data, in bytes
+     * @returns the offset of the data, to be passed as the dynamic offset when binding
+     * @throws std::length_error if the frame's segment is full
+     */
+    uint32_t push(const void* data, uint32_t size);
+
+    /**
+     * Copies a uniform struct into the current frame's segment and binds it at the ring's binding index.
+     *
+     * @param uniforms the uniform struct, laid out as the shader expects (generally std140)
+     */
+    template<typename T>
+    void bind(const T& uniforms) {
+        static_assert(std::is_trivially_copyable_v<T>, "Uniform structs must be trivially copyable.");
+        static_assert(sizeof(T) <= maxRange, "Uniform struct is larger than the bound range.");
+
+        uint32_t offset = push(std::addressof(uniforms), sizeof(T));
+        RHI::current().bindDescriptorSet(*m_descriptorSet, std::span<const uint32_t>(&offset, 1));
+    }
+
+    /**
+     * Copies a uniform struct into the current frame's segment and records binding it at the ring's
+     * binding index. This may be called from multiple threads at once.
+     *
+     * @param commandList the command list to record the bind in
+     * @param uniforms the uniform struct, laid out as the shader expects (generally std140)
+     */
+    template<typename T>
+    void record(CommandList& commandList, const T& uniforms) {
+        static_assert(std::is_trivially_copyable_v<T>, "Uniform structs must be trivially copyable.");
+        static_assert(sizeof(T) <= maxRange, "Uniform struct is larger than the bound range.");
+
+        uint32_t offset = push(std::addressof(uniforms), sizeof(T));
+        commandList.bindDescriptorSet(*m_descriptorSet, std::span<const uint32_t>(&offset, 1));
+    }
+
+    /**
+     * @returns the buffer that pushed data is written to
+     */
+    const Buffer& buffer() const {
+        return *m_buffer;
+    }
+
+    /**
+     * The binding index uniforms are bound at by bind().
+     */
+    static constexpr uint32_t binding = 0;
+
+    /**
+     * The largest uniform struct that can be bound by bind(), in bytes. This is the minimum uniform
+     * block size guaranteed by every api.
+     */
+    static constexpr uint32_t maxRange = 16384;
+
+private:
+    uint32_t m_frameCapacity;
+    uint32_t m_alignment;
+    uint32_t m_frame;
+    std::atomic<uint32_t> m_head;
+    std::unique_ptr<Buffer> m_buffer;
+    std::unique_ptr<DescriptorSet> m_descriptorSet;
+    FrameContext& m_frameContext;
+    uint8_t* m_data;
+};
+
+
+#endif //OPENGL_RENDERER_UNIFORMRING_H
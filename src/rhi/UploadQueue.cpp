@@ -0,0 +1,156 @@
+#include "UploadQueue.h"
+
+UploadQueue::UploadQueue(RHI& rhi, uint32_t capacity)
+    : m_rhi(rhi), m_head(0), m_used(0), m_pending(0) {
+    if (capacity == 0) {
+        throw std::invalid_argument("UploadQueue requires a non-zero capacity.");
+    }
+
+    m_capacity = (capacity + alignment - 1) / alignment * alignment;
+    m_buffer = m_rhi.createBuffer(m_capacity, 1, BufferUsage::Staging);
+    m_data = (uint8_t*)m_buffer->map();
+}
+
+UploadQueue::~UploadQueue() {
+    m_buffer->unmap();
+}
+
+std::unique_ptr<Buffer> UploadQueue::createBuffer(const void* data, uint32_t size, uint32_t stride) {
+    std::unique_ptr<Buffer> buffer = m_rhi.createBuffer(size, stride, BufferUsage::Static);
+    upload(*buffer, 0, data, size);
+    return buffer;
+}
+
+void UploadQueue::upload(Buffer& destination, uint32_t offset, const void* data, uint32_t size) {
+    if ((uint64_t)offset + size > destination.size()) {
+        throw std::out_of_range("The uploaded range must be within the buffer.");
+    }
+
+    reclaim();
+
+    // uploads larger than the ring are copied a ring at a time, each waiting for the last to be copied
+    auto source = static_cast<const uint8_t*>(data);
+    while (size > 0) {
+        uint32_t chunkSize = std::min(size, m_capacity);
+        uint32_t stagingOffset = reserve(chunkSize);
+        std::memcpy(m_data + stagingOffset, source, chunkSize);
+        m_buffer->flush(stagingOffset, chunkSize);
+        m_rhi.copyBuffer(*m_buffer, stagingOffset, destination, offset, chunkSize);
+
+        source += chunkSize;
+        offset += chunkSize;
+        size -= chunkSize;
+    }
+
+    submit();
+}
+
+void UploadQueue::uploadTexture2D(Texture2D& destination, uint32_t level, const void* data, uint64_t size) {
+    if (level >= destination.numLevels()) {
+        throw std::out_of_range("The uploaded level must be within the texture.");
+    }
+
+    uploadLevel(destination.format(), destination.region(level), data, size,
+                [&](uint32_t stagingOffset, const TextureRegion& band) {
+        m_rhi.copyBufferToTexture2D(*m_buffer, stagingOffset, destination, level, band);
+    });
+}
+
+void UploadQueue::uploadTexture2DArray(Texture2DArray& destination, uint32_t layer, uint32_t level, const void* data,
+                                       uint64_t size) {
+    if (layer >= destination.numLayers() || level >= destination.numLevels()) {
+        throw std::out_of_range("The uploaded layer and level must be within the texture array.");
+    }
+
+    uploadLevel(destination.format(), destination.region(level), data, size,
+                [&](uint32_t stagingOffset, const TextureRegion& band) {
+        m_rhi.copyBufferToTexture2DArray(*m_buffer, stagingOffset, destination, layer, level, band);
+    });
+}
+
+void UploadQueue::uploadLevel(Format format, const TextureRegion& region, const void* data, uint64_t size,
+                              const std::function<void(uint32_t, const TextureRegion&)>& copy) {
+    if (size != imageSize(format, region.width, region.height)) {
+        throw std::invalid_argument("The uploaded pixels must be the size of the level.");
+    }
+
+    reclaim();
+
+    // bands are whole rows of pixels, or of blocks for block-compressed formats
+    uint32_t rowHeight = isBlockCompressed(format) ? 4 : 1;
+    uint64_t rowSize = imageSize(format, region.width, 1);
+    if (rowSize > m_capacity) {
+        throw std::invalid_argument("The rows of the uploaded level must fit in the staging ring.");
+    }
+    auto bandHeight = (uint32_t)(m_capacity / rowSize) * rowHeight;
+
+    auto source = static_cast<const uint8_t*>(data);
+    for (uint32_t y = 0; y < region.height; y += bandHeight) {
+        TextureRegion band = {0, y, region.width, std::min(bandHeight, region.height - y)};
+        auto bandSize = (uint32_t)imageSize(format, band.width, band.height);
+        uint32_t stagingOffset = reserve(bandSize);
+        std::memcpy(m_data + stagingOffset, source, bandSize);
+        m_buffer->flush(stagingOffset, bandSize);
+        copy(stagingOffset, band);
+        source += bandSize;
+    }
+
+    submit();
+}
+
+void UploadQueue::submit() {
+    if (m_pending > 0) {
+        m_batches.push_back(Batch{
+            .fence = m_rhi.createFence(),
+            .size = m_pending,
+        });
+        m_pending = 0;
+    }
+}
+
+uint32_t UploadQueue::reserve(uint32_t size) {
+    uint32_t alignedSize = std::min((size + alignment - 1) / alignment * alignment, m_capacity);
+
+    // ranges never wrap, so the space left at the end of the ring is skipped if the range does not fit
+    uint32_t skipped;
+    while (true) {
+        if (m_used == 0) {
+            m_head = 0;
+        }
+        skipped = m_head + alignedSize > m_capacity ? m_capacity - m_head : 0;
+        if (m_used + skipped + alignedSize <= m_capacity) {
+            break;
+        }
+
+        if (m_batches.empty()) {
+            // only the current upload holds the ring, so fence its copies before reusing their memory
+            m_batches.push_back(Batch{
+                .fence = m_rhi.createFence(),
+                .size = m_pending,
+            });
+            m_pending = 0;
+        }
+
+        Batch& batch = m_batches.front();
+        batch.fence->wait();
+        m_used -= batch.size;
+        m_batches.pop_front();
+    }
+
+    if (skipped > 0) {
+        m_head = 0;
+    }
+
+    uint32_t offset = m_head;
+    m_head = (m_head + alignedSize) % m_capacity;
+    m_used += skipped + alignedSize;
+    m_pending += skipped + alignedSize;
+    return offset;
+}
+
+void UploadQueue::reclaim() {
+    while (!m_batches.empty() && m_batches.front().fence->isSignaled()) {
+        m_used -= m_batches.front().size;
+        m_batches.pop_front();
+    }
+}
@@ -0,0 +1,141 @@
+#ifndef OPENGL_RENDERER_UPLOADQUEUE_H
+#define OPENGL_RENDERER_UPLOADQUEUE_H
+
+#include <deque>
+
+#include "RHI.h"
+
+/**
+ * Fills static buffers, which cannot be mapped, by writing data into a persistently mapped staging ring
+ * and copying it into them on the gpu.
+ *
+ * Each upload is fenced once its copies are submitted. The ring is reused from the front as earlier
+ * uploads complete, and only waits on the gpu when it is full of copies that have not yet run. Uploads
+ * larger than the ring are split into several copies. The queue is used from the thread that owns the
+ * render api.
+ */
+class UploadQueue {
+public:
+    static constexpr uint32_t defaultCapacity = 8 * 1024 * 1024;
+
+    /**
+     * Constructs an upload queue with a staging ring of the given capacity.
+     *
+     * @param rhi the render api to upload through
+     * @param capacity the size of the staging ring, in bytes
+     * @throws std::invalid_argument if the capacity is zero
+     */
+    UploadQueue(RHI& rhi, uint32_t capacity);
+
+    UploadQueue(const UploadQueue&) = delete;
+    ~UploadQueue();
+
+    /**
+     * Creates a static buffer holding the given data.
+     *
+     * @param data the data of the buffer
+     * @param size the size of the data and buffer, in bytes
+     * @param stride the stride (distance between elements) of the buffer, in bytes
+     * @returns the buffer, which can be used immediately
+     */
+    std::unique_ptr<Buffer> createBuffer(const void* data, uint32_t size, uint32_t stride);
+
+    /**
+     * Copies data into a range of a buffer. Draws submitted afterward read the new data, and draws
+     * submitted before read the old data.
+     *
+     * @param destination the buffer to write, which may be static
+     * @param offset the offset of the range in the buffer, in bytes
+     * @param data the data to write
+     * @param size the size of the data, in bytes
+     * @throws std::out_of_range if the range is not within the buffer
+     */
+    void upload(Buffer& destination, uint32_t offset, const void* data, uint32_t size);
+
+    /**
+     * Copies the pixels of a whole level of a 2d texture, in the texture's format with tightly packed rows.
+     * Levels larger than the ring are copied a band of rows at a time.
+     *
+     * @param destination the texture to write
+     * @param level the mip-map level to write
+     * @param data the pixels of the level
+     * @param size the size of the pixels, in bytes
+     * @throws std::out_of_range if the level is not within the texture
+     * @throws std::invalid_argument if the size is not that of the level
+     */
+    void uploadTexture2D(Texture2D& destination, uint32_t level, const void* data, uint64_t size);
+
+    /**
+     * Copies the pixels of a whole level of a layer of a 2d texture array, as uploadTexture2D() does.
+     *
+     * @param destination the texture array to write
+     * @param layer the layer to write
+     * @param level the mip-map level to write
+     * @param data the pixels of the level
+     * @param size the size of the pixels, in bytes
+     * @throws std::out_of_range if the layer or level is not within the array
+     * @throws std::invalid_argument if the size is not that of the level
+     */
+    void uploadTexture2DArray(Texture2DArray& destination, uint32_t layer, uint32_t level, const void* data,
+                              uint64_t size);
+
+    /**
+     * @returns the size of the staging ring, in bytes
+     */
+    uint32_t capacity() const {
+        return m_capacity;
+    }
+
+private:
+    static constexpr uint32_t alignment = 16;
+
+    /**
+     * The staging memory of an upload, which is reused once its fence is signaled.
+     */
+    struct Batch {
+        std::unique_ptr<Fence> fence;
+        uint32_t size; // in bytes, including any space skipped at the end of the ring
+    };
+
+    /**
+     * Reserves a range of the ring, waiting for earlier uploads to complete if it is full.
+     *
+     * @param size the size of the range, at most the capacity
+     * @returns the offset of the range
+     */
+    uint32_t reserve(uint32_t size);
+
+    /**
+     * Copies the pixels of a level of a texture through the ring, a band of rows at a time.
+     *
+     * @param format the format of the texture
+     * @param region the region covering the level
+     * @param data the pixels of the level
+     * @param size the size of the pixels, in bytes
+     * @param copy records the copy of a band from the given offset in the ring to the given region of the level
+     */
+    void uploadLevel(Format format, const TextureRegion& region, const void* data, uint64_t size,
+                     const std::function<void(uint32_t, const TextureRegion&)>& copy);
+
+    /**
+     * Fences the copies of the current upload, so that its staging memory is reused once they complete.
+     */
+    void submit();
+
+    /**
+     * Frees the staging memory of uploads that have completed, without waiting.
+     */
+    void reclaim();
+
+    RHI& m_rhi;
+    uint32_t m_capacity;
+    std::unique_ptr<Buffer> m_buffer;
+    uint8_t* m_data;
+    uint32_t m_head; // the offset that the next upload is written at
+    uint32_t m_used; // the bytes of the ring held by uploads that may still be copying
+    uint32_t m_pending; // the bytes reserved by the current upload, not yet fenced
+    std::deque<Batch> m_batches; // in order of submission
+};
+
+
+#endif //OPENGL_RENDERER_UPLOADQUEUE_H
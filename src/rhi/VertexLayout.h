@@ -10,6 +10,8 @@ struct VertexAttribute {
     const uint32_t location;
     const Format format;
     const uint32_t offset;
+
+    bool operator==(const VertexAttribute&) const = default;
 };
 
 struct VertexBinding {
@@ -20,6 +22,8 @@ struct VertexBinding {
     const uint32_t stride;
     const std::vector<VertexAttribute> attributes;
     // TODO: add per vertex / per instance setting
+
+    bool operator==(const VertexBinding&) const = default;
 };
 
 struct VertexLayout {
@@ -27,6 +31,8 @@ struct VertexLayout {
         : bindings(std::move(bindings)) {};
 
     const std::vector<VertexBinding> bindings;
+
+    bool operator==(const VertexLayout&) const = default;
 };
 
 
@@ -0,0 +1,46 @@
+#include "NullBuffer.h"
+
+void* NullBuffer::map(uint32_t offset, uint32_t size) {
+    if (!isMappable()) {
+        throw std::domain_error("Static buffers cannot be mapped.");
+    }
+    if ((uint64_t)offset + size > m_data.size()) {
+        throw std::out_of_range("The mapped range must be within the buffer.");
+    }
+
+    m_isMapped = true;
+    return m_data.data() + offset;
+}
+
+void NullBuffer::unmap() {
+    m_isMapped = false;
+}
+
+bool NullBuffer::isMapped() const {
+    return m_isMapped;
+}
+
+void NullBuffer::flush(uint32_t offset, uint32_t size) {
+    if ((uint64_t)offset + size > m_data.size()) {
+        throw std::out_of_range("The flushed range must be within the buffer.");
+    }
+    if (usage() != BufferUsage::Staging) {
+        m_rhi.countUpload(size);
+    }
+}
+
+std::unique_ptr<Buffer> NullRHI::createBuffer(uint32_t size, uint32_t stride, BufferUsage usage) {
+    return std::make_unique<NullBuffer>(*this, size, stride, usage);
+}
+
+void NullRHI::copyBuffer(const Buffer& source, uint32_t sourceOffset, Buffer& destination,
+                         uint32_t destinationOffset, uint32_t size) {
+    checkBufferRange(source, sourceOffset, size);
+    checkBufferRange(destination, destinationOffset, size);
+
+    std::memmove(NullBuffer::from(destination).data().data() + destinationOffset,
+                 NullBuffer::from(source).data().data() + sourceOffset, size);
+    if (source.usage() == BufferUsage::Staging) {
+        countUpload(size);
+    }
+}
@@ -0,0 +1,47 @@
+#ifndef OPENGL_RENDERER_NULLBUFFER_H
+#define OPENGL_RENDERER_NULLBUFFER_H
+
+#include "NullRHI.h"
+
+/**
+ * A buffer stored in host memory. Ranges are counted as uploaded as they are flushed, so writes through a
+ * persistent mapping are counted each time, except for staging buffers, whose ranges are counted as they
+ * are copied from.
+ */
+class NullBuffer : public Buffer {
+public:
+    NullBuffer(NullRHI& rhi, uint32_t size, uint32_t stride, BufferUsage usage)
+        : Buffer(size, stride, usage), m_rhi(rhi), m_data(size), m_isMapped(false) {}
+
+    void* map(uint32_t offset, uint32_t size) override;
+    void unmap() override;
+    bool isMapped() const override;
+    void flush(uint32_t offset, uint32_t size) override;
+
+    /**
+     * @returns the contents of the buffer
+     */
+    const std::vector<uint8_t>& data() const {
+        return m_data;
+    }
+
+    std::vector<uint8_t>& data() {
+        return m_data;
+    }
+
+    static NullBuffer& from(Buffer& buffer) {
+        return dynamic_cast<NullBuffer&>(buffer);
+    }
+
+    static const NullBuffer& from(const Buffer& buffer) {
+        return dynamic_cast<const NullBuffer&>(buffer);
+    }
+
+private:
+    NullRHI& m_rhi;
+    std::vector<uint8_t> m_data;
+    bool m_isMapped;
+};
+
+
+#endif //OPENGL_RENDERER_NULLBUFFER_H
@@ -0,0 +1,54 @@
+#include "NullDescriptorSet.h"
+
+std::unique_ptr<DescriptorSet> NullRHI::createDescriptorSet(std::vector<DescriptorSetBinding> bindings) {
+    return std::make_unique<NullDescriptorSet>(DescriptorSetLayout(bindings));
+}
+
+void NullDescriptorSet::bindTexture2D(uint32_t binding, Texture2D& texture2D) {
+    if (texture2D.numSamples() != 1) {
+        throw std::invalid_argument("Multi-sampled textures cannot be sampled.");
+    }
+    writeBinding(binding, DescriptorType::Texture2D);
+
+    m_descriptors[binding] = NullDescriptor{
+        .resource = std::addressof(texture2D),
+        .offset = 0,
+        .range = 0,
+    };
+}
+
+void NullDescriptorSet::bindTexture2DArray(uint32_t binding, Texture2DArray& textureArray) {
+    writeBinding(binding, DescriptorType::Texture2DArray);
+
+    m_descriptors[binding] = NullDescriptor{
+        .resource = std::addressof(textureArray),
+        .offset = 0,
+        .range = 0,
+    };
+}
+
+void NullDescriptorSet::bindUniformBuffer(uint32_t binding, const Buffer& buffer, uint32_t offset, uint32_t range) {
+    if ((uint64_t)offset + range > buffer.size()) {
+        throw std::out_of_range("The bound range must be within the buffer.");
+    }
+    writeBinding(binding, DescriptorType::UniformBuffer);
+
+    m_descriptors[binding] = NullDescriptor{
+        .resource = std::addressof(buffer),
+        .offset = offset,
+        .range = range,
+    };
+}
+
+void NullDescriptorSet::bindStorageBuffer(uint32_t binding, const Buffer& buffer, uint32_t offset, uint32_t range) {
+    if ((uint64_t)offset + range > buffer.size()) {
+        throw std::out_of_range("The bound range must be within the buffer.");
+    }
+    writeBinding(binding, DescriptorType::StorageBuffer);
+
+    m_descriptors[binding] = NullDescriptor{
+        .resource = std::addressof(buffer),
+        .offset = offset,
+        .range = range,
+    };
+}
@@ -0,0 +1,40 @@
+#ifndef OPENGL_RENDERER_NULLDESCRIPTORSET_H
+#define OPENGL_RENDERER_NULLDESCRIPTORSET_H
+
+#include "NullRHI.h"
+
+struct NullDescriptor {
+    const void* resource;
+    uint32_t offset;
+    uint32_t range;
+};
+
+/**
+ * A descriptor set that validates its descriptors against its bindings, as other apis would.
+ */
+class NullDescriptorSet : public DescriptorSet {
+public:
+    explicit NullDescriptorSet(DescriptorSetLayout layout) : DescriptorSet(layout) {}
+
+    void bindTexture2D(uint32_t binding, Texture2D& texture2D) override;
+    void bindTexture2DArray(uint32_t binding, Texture2DArray& textureArray) override;
+    void bindUniformBuffer(uint32_t binding, const Buffer& buffer, uint32_t offset, uint32_t range) override;
+    void bindStorageBuffer(uint32_t binding, const Buffer& buffer, uint32_t offset, uint32_t range) override;
+
+    /**
+     * @returns the descriptors of the set, indexed by binding
+     */
+    const std::array<NullDescriptor, DescriptorSetLayout::maxBindings>& descriptors() const {
+        return m_descriptors;
+    }
+
+    static const NullDescriptorSet& from(const DescriptorSet& descriptorSet) {
+        return dynamic_cast<const NullDescriptorSet&>(descriptorSet);
+    }
+
+private:
+    std::array<NullDescriptor, DescriptorSetLayout::maxBindings> m_descriptors{};
+};
+
+
+#endif //OPENGL_RENDERER_NULLDESCRIPTORSET_H
@@ -0,0 +1,350 @@
+#include "NullRHI.h"
+#include "NullBuffer.h"
+#include "NullDescriptorSet.h"
+
+namespace {
+
+    class NullFence : public Fence {
+    public:
+        bool isSignaled() override {
+            return true;
+        }
+
+        void wait() override {}
+    };
+
+    class NullTimerQuery : public TimerQuery {
+    public:
+        void begin() override {
+            m_hasResult = false;
+        }
+
+        void end() override {
+            m_hasResult = true;
+        }
+
+        bool isAvailable() override {
+            return m_hasResult;
+        }
+
+        uint64_t elapsed() override {
+            if (!m_hasResult) {
+                throw std::domain_error("A timer query must be ended before its result is read.");
+            }
+            return 0;
+        }
+
+    private:
+        bool m_hasResult = false;
+    };
+
+    class NullPipelineBuilder : public PipelineBuilder {
+    public:
+        PipelineBuilder* setTopology(Topology topology) override {
+            m_topology = topology;
+            return this;
+        }
+
+        PipelineBuilder* setVertexShader(Shader& shader) override {
+            m_vertexShader = std::addressof(shader);
+            return this;
+        }
+
+        PipelineBuilder* setFragmentShader(Shader& shader) override {
+            m_fragmentShader = std::addressof(shader);
+            return this;
+        }
+
+        PipelineBuilder* setVertexLayout(const VertexLayout& layout) override {
+            m_vertexLayout = std::addressof(layout);
+            return this;
+        }
+
+        PipelineBuilder* setDepthState(const DepthState& depthState) override {
+            m_depthState = depthState;
+            return this;
+        }
+
+        PipelineBuilder* setStencilState(const StencilState& stencilState) override {
+            m_stencilState = stencilState;
+            return this;
+        }
+
+        PipelineBuilder* setBlendState(const BlendState& blendState) override {
+            m_blendState = blendState;
+            return this;
+        }
+
+        PipelineBuilder* setRasterState(const RasterState& rasterState) override {
+            m_rasterState = rasterState;
+            return this;
+        }
+
+        PipelineBuilder* setColorWriteEnabled(bool enabled) override {
+            m_colorWriteEnabled = enabled;
+            return this;
+        }
+
+        PipelineBuilder* setBinary(std::span<const uint8_t> binary) override {
+            throw std::domain_error("The api does not support pipeline binaries.");
+        }
+
+        std::unique_ptr<Pipeline> build() override {
+            if (m_vertexShader == nullptr || m_vertexShader->type() != ShaderType::Vertex ||
+                m_fragmentShader == nullptr || m_fragmentShader->type() != ShaderType::Fragment) {
+                throw std::invalid_argument("A pipeline requires a vertex and fragment shader.");
+            }
+            if (m_vertexLayout == nullptr) {
+                throw std::invalid_argument("A pipeline requires a vertex layout.");
+            }
+
+            return std::make_unique<Pipeline>(m_topology, m_depthState, m_stencilState, m_blendState, m_rasterState,
+                                              m_colorWriteEnabled);
+        }
+
+    private:
+        Topology m_topology = Topology::Triangles;
+        Shader* m_vertexShader = nullptr;
+        Shader* m_fragmentShader = nullptr;
+        const VertexLayout* m_vertexLayout = nullptr;
+        DepthState m_depthState;
+        StencilState m_stencilState;
+        BlendState m_blendState;
+        RasterState m_rasterState;
+        bool m_colorWriteEnabled = true;
+    };
+
+    class NullFramebufferBuilder : public FramebufferBuilder {
+    public:
+        FramebufferBuilder* setDimensions(uint32_t width, uint32_t height) override {
+            m_width = width;
+            m_height = height;
+            return this;
+        }
+
+        FramebufferBuilder* setColorAttachment(std::unique_ptr<Texture2D> attachment) override {
+            m_colorAttachment = std::move(attachment);
+            return this;
+        }
+
+        FramebufferBuilder* setDepthAttachment(std::unique_ptr<Texture2D> attachment) override {
+            m_depthAttachment = std::move(attachment);
+            return this;
+        }
+
+        std::unique_ptr<Framebuffer> build() override {
+            if (m_colorAttachment == nullptr || m_width == 0 || m_height == 0) {
+                throw std::invalid_argument("A framebuffer requires a color attachment and positive dimensions.");
+            }
+
+            return std::make_unique<Framebuffer>(m_width, m_height, std::move(m_colorAttachment),
+                                                 std::move(m_depthAttachment));
+        }
+
+    private:
+        uint32_t m_width = 0;
+        uint32_t m_height = 0;
+        std::unique_ptr<Texture2D> m_colorAttachment;
+        std::unique_ptr<Texture2D> m_depthAttachment;
+    };
+
+} // namespace
+
+NullRHI::NullRHI() : m_statistics{}, m_pipeline(nullptr), m_vertexBuffers{}, m_indexBuffer(nullptr),
+                     m_textures{}, m_uniformBuffers{}, m_storageBuffers{}, m_framebuffer(nullptr), m_viewport{} {}
+
+std::unique_ptr<Texture2D> NullRHI::createTexture2D(Format format, uint32_t width, uint32_t height,
+                                                    uint32_t numSamples, uint32_t numLevels) {
+    checkTexture2D(format, width, height, numSamples, numLevels);
+
+    return std::make_unique<Texture2D>(format, width, height, numSamples, numLevels);
+}
+
+std::unique_ptr<Texture2DArray> NullRHI::createTexture2DArray(Format format, uint32_t width, uint32_t height,
+                                                              uint32_t numLayers, uint32_t numLevels) {
+    if (numLayers == 0) {
+        throw std::invalid_argument("Texture arrays must have at least one layer.");
+    }
+    checkTexture2D(format, width, height, 1, numLevels);
+
+    return std::make_unique<Texture2DArray>(format, width, height, numLayers, numLevels);
+}
+
+std::unique_ptr<Shader> NullRHI::createShader(const void* code, size_t codeSize, ShaderType type,
+                                             std::string_view name) {
+    return std::make_unique<Shader>(type);
+}
+
+std::unique_ptr<Fence> NullRHI::createFence() {
+    return std::make_unique<NullFence>();
+}
+
+std::unique_ptr<TimerQuery> NullRHI::createTimerQuery() {
+    return std::make_unique<NullTimerQuery>();
+}
+
+std::unique_ptr<PipelineBuilder> NullRHI::createPipelineBuilder() {
+    return std::make_unique<NullPipelineBuilder>();
+}
+
+std::string NullRHI::pipelineBinaryVersion() {
+    // pipelines are not compiled, so are as fast to build as to load
+    return {};
+}
+
+std::vector<uint8_t> NullRHI::pipelineBinary(const Pipeline& pipeline) {
+    return {};
+}
+
+std::unique_ptr<FramebufferBuilder> NullRHI::createFramebufferBuilder() {
+    return std::make_unique<NullFramebufferBuilder>();
+}
+
+void NullRHI::copyBufferToTexture2D(Buffer& source, Texture2D& destination) {
+    Vector<uint32_t, 3> size = destination.dimensions();
+    countUpload((uint64_t)size.x * size.y * 4);
+}
+
+void NullRHI::copyBufferToTexture2D(Buffer& source, uint32_t sourceOffset, Texture2D& destination, uint32_t level,
+                                    const TextureRegion& region) {
+    countUpload(checkTextureCopy(source, sourceOffset, destination, level, region));
+}
+
+void NullRHI::copyBufferToTexture2DArray(Buffer& source, uint32_t sourceOffset, Texture2DArray& destination,
+                                         uint32_t layer, uint32_t level, const TextureRegion& region) {
+    countUpload(checkTextureCopy(source, sourceOffset, destination, layer, level, region));
+}
+
+void NullRHI::resolveTexture2D(Texture2D& source, const TextureRegion& sourceRegion, Texture2D& destination,
+                               const TextureRegion& destinationRegion) {
+    bool isScaled = sourceRegion.width != destinationRegion.width || sourceRegion.height != destinationRegion.height;
+    if (destination.numSamples() != 1) {
+        throw std::invalid_argument("The destination of a resolve must be single-sampled.");
+    }
+    if (source.numSamples() > 1 && (isScaled || source.format() != destination.format())) {
+        throw std::invalid_argument("Multi-sampled textures can only be resolved into regions of the same size and format.");
+    }
+}
+
+void NullRHI::bindVertexBuffer(const Buffer& buffer, uint32_t binding, uint32_t offset, uint32_t stride) {
+    if (binding >= maxVertexBindings) {
+        throw std::invalid_argument("the vertex buffer binding is not supported");
+    }
+
+    VertexBufferBinding vertexBuffer{std::addressof(buffer), offset, stride};
+    countBind(m_vertexBuffers[binding] != vertexBuffer);
+    m_vertexBuffers[binding] = vertexBuffer;
+}
+
+void NullRHI::bindIndexBuffer(const Buffer& buffer) {
+    countBind(m_indexBuffer != std::addressof(buffer));
+    m_indexBuffer = std::addressof(buffer);
+}
+
+void NullRHI::bindUniforms(UniformBlock& uniformBlock) {
+    // uniforms are set directly, so always change state
+    for (uint32_t i = 0; i < uniformBlock.numFields(); i++) {
+        countBind(true);
+        countUpload(uniformBlock[i].size());
+    }
+}
+
+void NullRHI::bindDescriptorSet(const DescriptorSet& descriptorSet, std::span<const uint32_t> dynamicOffsets) {
+    const NullDescriptorSet& nullDescriptorSet = NullDescriptorSet::from(descriptorSet);
+    const DescriptorSetLayout& layout = nullDescriptorSet.layout();
+    uint32_t written = nullDescriptorSet.writtenBindings();
+    uint32_t dynamicBindings = written & layout.bindings(DescriptorType::UniformBufferDynamic);
+    if ((size_t)std::popcount(dynamicBindings) > dynamicOffsets.size()) {
+        throw std::invalid_argument("A dynamic offset is required for each dynamic uniform buffer.");
+    }
+
+    // each run of consecutive bindings of a class of resource is bound with one call, as in other apis
+    size_t dynamicIndex = 0;
+    auto bindRanges = [&](uint32_t bindings, std::array<BoundDescriptor, DescriptorSetLayout::maxBindings>& bound) {
+        DescriptorSetLayout::forEachRange(bindings, [&](uint32_t first, uint32_t count) {
+            bool changed = false;
+            for (uint32_t binding = first; binding < first + count; binding++) {
+                const NullDescriptor& descriptor = nullDescriptorSet.descriptors()[binding];
+                BoundDescriptor current{descriptor.resource, descriptor.offset, descriptor.range};
+                if ((dynamicBindings & (1u << binding)) != 0) {
+                    current.offset += dynamicOffsets[dynamicIndex++];
+                }
+                changed |= bound[binding] != current;
+                bound[binding] = current;
+            }
+            countBind(changed);
+        });
+    };
+    bindRanges(written & (layout.bindings(DescriptorType::Texture2D) | layout.bindings(DescriptorType::Texture2DArray)),
+               m_textures);
+    bindRanges(written & (layout.bindings(DescriptorType::UniformBuffer) | dynamicBindings), m_uniformBuffers);
+    bindRanges(written & layout.bindings(DescriptorType::StorageBuffer), m_storageBuffers);
+}
+
+void NullRHI::bindPipeline(const Pipeline& pipeline) {
+    countBind(m_pipeline != std::addressof(pipeline));
+    m_pipeline = std::addressof(pipeline);
+}
+
+void NullRHI::bindFramebuffer(Framebuffer& framebuffer) {
+    countBind(m_framebuffer != std::addressof(framebuffer));
+    m_framebuffer = std::addressof(framebuffer);
+}
+
+void NullRHI::bindDefaultFramebuffer() {
+    countBind(m_framebuffer != nullptr);
+    m_framebuffer = nullptr;
+}
+
+void NullRHI::submit(const CommandList& commandList) {
+    m_statistics.commandLists++;
+    commandList.execute(*this);
+}
+
+void NullRHI::setViewport(uint32_t x, uint32_t y, uint32_t width, uint32_t height) {
+    std::array<uint32_t, 4> viewport = {x, y, width, height};
+    if (m_viewport != viewport) {
+        m_statistics.stateChanges++;
+    }
+    m_viewport = viewport;
+}
+
+void NullRHI::clearAttachments(float r, float g, float b, float a, float depth) {}
+
+void NullRHI::draw(uint32_t vertexCount, uint32_t baseVertex) {
+    if (m_pipeline == nullptr) {
+        throw std::domain_error("A pipeline must be bound for draw calls.");
+    }
+
+    m_statistics.draws++;
+    m_statistics.vertices += vertexCount;
+}
+
+void NullRHI::drawIndexed(uint32_t indexCount, uint32_t baseIndex, uint32_t baseVertex) {
+    if (m_pipeline == nullptr) {
+        throw std::domain_error("A pipeline must be bound for draw calls.");
+    }
+    if (m_indexBuffer == nullptr) {
+        throw std::domain_error("An index buffer must be bound for indexed draw calls.");
+    }
+    if ((uint64_t)(baseIndex + indexCount) * m_indexBuffer->stride() > m_indexBuffer->size()) {
+        throw std::out_of_range("The drawn indices must be within the index buffer.");
+    }
+
+    m_statistics.draws++;
+    m_statistics.vertices += indexCount;
+}
+
+void NullRHI::beginGpuScope(std::string_view name) {
+    m_openScopes.emplace_back(std::string(name), std::chrono::steady_clock::now());
+}
+
+void NullRHI::endGpuScope() {
+    if (m_openScopes.empty()) {
+        throw std::domain_error("There is no scope to end.");
+    }
+
+    auto& [name, begin] = m_openScopes.back();
+    m_profiler.record(name, std::chrono::steady_clock::now() - begin, Duration::zero());
+    m_openScopes.pop_back();
+}
@@ -0,0 +1,160 @@
+#ifndef OPENGL_RENDERER_NULLRHI_H
+#define OPENGL_RENDERER_NULLRHI_H
+
+#include <atomic>
+
+#include "../RHI.h"
+
+/**
+ * A render api that draws nothing, used to measure the cpu cost of rendering without a gpu or window.
+ *
+ * Buffers are stored in host memory, resources are validated as they would be by other apis, and
+ * calls are counted. Writes through persistently mapped buffers, such as uniform rings, are counted as
+ * uploaded each time a range is flushed. Binds are also compared to what was already bound, to count the
+ * state changes a real api would make. Scopes are timed on the cpu only, with gpu times of zero.
+ */
+class NullRHI : public RHI {
+public:
+    /**
+     * Counts of the calls made to the api.
+     */
+    struct Statistics {
+        uint64_t binds; // binds of pipelines, buffers, descriptor sets, uniforms and framebuffers
+        uint64_t stateChanges; // binds and viewports that changed what was bound
+        uint64_t draws;
+        uint64_t vertices; // vertices or indices drawn
+        uint64_t bytesUploaded; // bytes of flushed buffer ranges, staging copies, uniforms and texture copies
+        uint64_t commandLists;
+    };
+
+    NullRHI();
+
+    std::unique_ptr<Buffer> createBuffer(uint32_t size, uint32_t stride, BufferUsage usage) override;
+    std::unique_ptr<Texture2D> createTexture2D(Format format, uint32_t width, uint32_t height,
+                                               uint32_t numSamples, uint32_t numLevels) override;
+    std::unique_ptr<Texture2DArray> createTexture2DArray(Format format, uint32_t width, uint32_t height,
+                                                         uint32_t numLayers, uint32_t numLevels) override;
+    std::unique_ptr<Shader> createShader(const void* code, size_t codeSize, ShaderType type,
+                                         std::string_view name) override;
+    std::unique_ptr<DescriptorSet> createDescriptorSet(std::vector<DescriptorSetBinding> bindings) override;
+    std::unique_ptr<Fence> createFence() override;
+    std::unique_ptr<TimerQuery> createTimerQuery() override;
+
+    std::unique_ptr<PipelineBuilder> createPipelineBuilder() override;
+    std::string pipelineBinaryVersion() override;
+    std::vector<uint8_t> pipelineBinary(const Pipeline& pipeline) override;
+    std::unique_ptr<FramebufferBuilder> createFramebufferBuilder() override;
+
+    void copyBufferToTexture2D(Buffer& source, Texture2D& destination) override;
+    void copyBufferToTexture2D(Buffer& source, uint32_t sourceOffset, Texture2D& destination, uint32_t level,
+                               const TextureRegion& region) override;
+    void copyBufferToTexture2DArray(Buffer& source, uint32_t sourceOffset, Texture2DArray& destination,
+                                    uint32_t layer, uint32_t level, const TextureRegion& region) override;
+    void copyBuffer(const Buffer& source, uint32_t sourceOffset, Buffer& destination, uint32_t destinationOffset,
+                    uint32_t size) override;
+    using RHI::resolveTexture2D;
+    void resolveTexture2D(Texture2D& source, const TextureRegion& sourceRegion, Texture2D& destination,
+                          const TextureRegion& destinationRegion) override;
+
+    using RHI::bindVertexBuffer;
+    void bindVertexBuffer(const Buffer& buffer, uint32_t binding, uint32_t offset, uint32_t stride) override;
+    void bindIndexBuffer(const Buffer& buffer) override;
+    void bindUniforms(UniformBlock& uniformBlock) override;
+    void bindDescriptorSet(const DescriptorSet& descriptorSet, std::span<const uint32_t> dynamicOffsets) override;
+    void bindPipeline(const Pipeline& pipeline) override;
+    void bindFramebuffer(Framebuffer& framebuffer) override;
+    void bindDefaultFramebuffer() override;
+
+    void submit(const CommandList& commandList) override;
+
+    void setViewport(uint32_t x, uint32_t y, uint32_t width, uint32_t height) override;
+    void clearAttachments(float r, float g, float b, float a, float depth) override;
+
+    void draw(uint32_t vertexCount, uint32_t baseVertex) override;
+    void drawIndexed(uint32_t indexCount, uint32_t baseIndex, uint32_t baseVertex) override;
+
+    void beginGpuScope(std::string_view name) override;
+    void endGpuScope() override;
+
+    uint32_t uniformBufferAlignment() const override {
+        return 256; // the largest alignment commonly required, so that offsets are valid for any api
+    }
+
+    uint32_t storageBufferAlignment() const override {
+        return 256;
+    }
+
+    /**
+     * @returns the counts of calls made since the statistics were last reset
+     */
+    const Statistics& statistics() const {
+        return m_statistics;
+    }
+
+    void resetStatistics() {
+        m_statistics = Statistics{};
+    }
+
+    /**
+     * Counts bytes written to host memory that a real api would upload. This is called by buffers as
+     * ranges are flushed, which rings may do from multiple threads at once.
+     *
+     * @param size the number of bytes
+     */
+    void countUpload(uint64_t size) {
+        std::atomic_ref<uint64_t>(m_statistics.bytesUploaded).fetch_add(size, std::memory_order_relaxed);
+    }
+
+    static NullRHI& from(RHI& rhi) {
+        return dynamic_cast<NullRHI&>(rhi);
+    }
+
+private:
+    static constexpr uint32_t maxVertexBindings = 16;
+
+    /**
+     * The resource bound at a binding index of a descriptor set, compared to count state changes.
+     */
+    struct BoundDescriptor {
+        const void* resource;
+        uint32_t offset;
+        uint32_t range;
+
+        bool operator==(const BoundDescriptor&) const = default;
+    };
+
+    /**
+     * The range of a buffer bound at a vertex binding, compared to count state changes.
+     */
+    struct VertexBufferBinding {
+        const Buffer* buffer;
+        uint32_t offset;
+        uint32_t stride;
+
+        bool operator==(const VertexBufferBinding&) const = default;
+    };
+
+    /**
+     * Counts a bind, and a state change if it changes what is bound.
+     *
+     * @param changed whether the bind changes what is bound
+     */
+    void countBind(bool changed) {
+        m_statistics.binds++;
+        if (changed) m_statistics.stateChanges++;
+    }
+
+    Statistics m_statistics;
+    const Pipeline* m_pipeline;
+    std::array<VertexBufferBinding, maxVertexBindings> m_vertexBuffers;
+    const Buffer* m_indexBuffer;
+    std::array<BoundDescriptor, DescriptorSetLayout::maxBindings> m_textures; // 2d or arrays
+    std::array<BoundDescriptor, DescriptorSetLayout::maxBindings> m_uniformBuffers; // dynamic or not
+    std::array<BoundDescriptor, DescriptorSetLayout::maxBindings> m_storageBuffers;
+    const Framebuffer* m_framebuffer; // nullptr for the default framebuffer
+    std::array<uint32_t, 4> m_viewport;
+    std::vector<std::pair<std::string, Timestamp>> m_openScopes;
+};
+
+
+#endif //OPENGL_RENDERER_NULLRHI_H
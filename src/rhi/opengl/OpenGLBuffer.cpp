@@ -1,8 +1,12 @@
 #include "OpenGLBuffer.h"
 
 void* OpenGLBuffer::map(uint32_t offset, uint32_t size) {
+    if (!isMappable()) {
+        throw std::domain_error("Static buffers cannot be mapped.");
+    }
+
     m_isMapped = true;
-    return glMapNamedBufferRange(m_handle, offset, size, mapFlags);
+    return glMapNamedBufferRange(m_handle, offset, size, mapFlags(usage()));
 }
 
 void OpenGLBuffer::unmap() {
@@ -14,10 +18,49 @@ bool OpenGLBuffer::isMapped() const {
     return m_isMapped;
 }
 
-std::unique_ptr<Buffer> OpenGLRHI::createBuffer(uint32_t size, uint32_t stride) {
+GLbitfield OpenGLBuffer::mapFlags(BufferUsage usage) {
+    switch (usage) {
+        case BufferUsage::Static:
+            return 0;
+        case BufferUsage::Dynamic:
+        case BufferUsage::Stream:
+        case BufferUsage::Staging:
+            return GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+        case BufferUsage::Readback:
+            return GL_MAP_READ_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+        default:
+            throw std::invalid_argument("Invalid buffer usage.");
+    }
+}
+
+GLbitfield OpenGLBuffer::storageFlags(BufferUsage usage) {
+    switch (usage) {
+        case BufferUsage::Static:
+            return 0;
+        case BufferUsage::Dynamic:
+            return mapFlags(usage);
+        case BufferUsage::Stream:
+        case BufferUsage::Staging:
+        case BufferUsage::Readback:
+            return mapFlags(usage) | GL_CLIENT_STORAGE_BIT;
+        default:
+            throw std::invalid_argument("Invalid buffer usage.");
+    }
+}
+
+std::unique_ptr<Buffer> OpenGLRHI::createBuffer(uint32_t size, uint32_t stride, BufferUsage usage) {
     GLuint handle;
     glCreateBuffers(1, &handle);
-    glNamedBufferStorage(handle, size, nullptr, OpenGLBuffer::mapFlags);
+    glNamedBufferStorage(handle, size, nullptr, OpenGLBuffer::storageFlags(usage));
+
+    return std::make_unique<OpenGLBuffer>(handle, size, stride, usage);
+}
+
+void OpenGLRHI::copyBuffer(const Buffer& source, uint32_t sourceOffset, Buffer& destination,
+                           uint32_t destinationOffset, uint32_t size) {
+    checkBufferRange(source, sourceOffset, size);
+    checkBufferRange(destination, destinationOffset, size);
 
-    return std::make_unique<OpenGLBuffer>(handle, size, stride);
+    glCopyNamedBufferSubData(OpenGLBuffer::from(source).handle(), OpenGLBuffer::from(destination).handle(),
+                             sourceOffset, destinationOffset, size);
 }
\ No newline at end of file
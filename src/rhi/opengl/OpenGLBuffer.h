@@ -3,13 +3,23 @@
 
 #include "OpenGLRHI.h"
 
+/**
+ * A buffer with immutable storage, placed by its usage. Static buffers have no access flags so that they
+ * can be placed in memory only the gpu can reach, while the others are mapped persistently and coherently,
+ * with client storage hinted for those read mainly by copies or the cpu.
+ */
 class OpenGLBuffer : public Buffer, public Resource<GLuint> {
 public:
-    explicit OpenGLBuffer(GLuint handle, uint32_t size, uint32_t stride)
-            : Buffer(size, stride), Resource<GLuint>(handle), m_isMapped(false) {}
+    OpenGLBuffer(GLuint handle, uint32_t size, uint32_t stride, BufferUsage usage)
+            : Buffer(size, stride, usage), Resource<GLuint>(handle), m_isMapped(false) {}
 
     ~OpenGLBuffer() override {
-        glDeleteBuffers(1, &m_handle);
+        RHI::release([handle = m_handle] {
+            if (OpenGLStateCache* stateCache = OpenGLStateCache::current()) {
+                stateCache->invalidateBuffer(handle);
+            }
+            glDeleteBuffers(1, &handle);
+        });
     }
 
     void* map(uint32_t offset, uint32_t size) override;
@@ -24,7 +34,16 @@ public:
         return dynamic_cast<const OpenGLBuffer&>(buffer);
     }
 
-    static constexpr GLbitfield mapFlags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+    /**
+     * @returns the flags that buffers of the given usage are mapped with, or 0 if they cannot be mapped
+     */
+    static GLbitfield mapFlags(BufferUsage usage);
+
+    /**
+     * @returns the flags of the storage of buffers with the given usage
+     */
+    static GLbitfield storageFlags(BufferUsage usage);
+
 private:
     bool m_isMapped;
 };
@@ -3,30 +3,42 @@
 
 #include "../RHI.h"
 
-struct OpenGLDescriptor {
-    DescriptorType type;
-    union {
-        struct BufferInfo {
-            GLuint handle;
-            uint32_t offset;
-            uint32_t range;
-        } bufferInfo;
-        struct TextureInfo {
-            GLuint handle;
-        } textureInfo;
-    };
+/**
+ * The buffer ranges of a class of buffer descriptors, indexed by binding, laid out as the arrays passed to
+ * glBindBuffersRange.
+ */
+struct OpenGLBufferDescriptors {
+    std::array<GLuint, DescriptorSetLayout::maxBindings> handles{};
+    std::array<GLintptr, DescriptorSetLayout::maxBindings> offsets{};
+    std::array<GLsizeiptr, DescriptorSetLayout::maxBindings> ranges{};
 };
 
+/**
+ * A descriptor set that keeps its descriptors in flat arrays per class of resource, indexed by binding,
+ * so each run of consecutive bindings of a class is bound with one multi-bind call.
+ */
 class OpenGLDescriptorSet : public DescriptorSet {
 public:
-    explicit OpenGLDescriptorSet(std::map<uint32_t, DescriptorType> bindings) : m_bindings(std::move(bindings)) {}
+    explicit OpenGLDescriptorSet(DescriptorSetLayout layout) : DescriptorSet(layout) {}
 
     void bindTexture2D(uint32_t binding, Texture2D& texture2D) override;
+    void bindTexture2DArray(uint32_t binding, Texture2DArray& textureArray) override;
     void bindUniformBuffer(uint32_t binding, const Buffer& buffer, uint32_t offset, uint32_t range) override;
     void bindStorageBuffer(uint32_t binding, const Buffer& buffer, uint32_t offset, uint32_t range) override;
 
-    const std::map<uint32_t, OpenGLDescriptor>& descriptors() const {
-        return m_descriptors;
+    /**
+     * @returns the 2d textures and 2d texture arrays of the set, which share texture units
+     */
+    const std::array<GLuint, DescriptorSetLayout::maxBindings>& textures() const {
+        return m_textures;
+    }
+
+    const OpenGLBufferDescriptors& uniformBuffers() const {
+        return m_uniformBuffers;
+    }
+
+    const OpenGLBufferDescriptors& storageBuffers() const {
+        return m_storageBuffers;
     }
 
     static OpenGLDescriptorSet& from(DescriptorSet& descriptorSet) {
@@ -38,8 +50,9 @@ public:
     }
 
 private:
-    std::map<uint32_t, DescriptorType> m_bindings;
-    std::map<uint32_t, OpenGLDescriptor> m_descriptors;
+    std::array<GLuint, DescriptorSetLayout::maxBindings> m_textures{};
+    OpenGLBufferDescriptors m_uniformBuffers;
+    OpenGLBufferDescriptors m_storageBuffers;
 };
 
 
@@ -0,0 +1,29 @@
+#include "OpenGLFence.h"
+
+std::unique_ptr<Fence> OpenGLRHI::createFence() {
+    GLsync handle = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+
+    return std::make_unique<OpenGLFence>(handle);
+}
+
+bool OpenGLFence::isSignaled() {
+    if (!m_isSignaled) {
+        GLenum result = glClientWaitSync(m_handle, 0, 0);
+        m_isSignaled = result == GL_ALREADY_SIGNALED || result == GL_CONDITION_SATISFIED;
+    }
+
+    return m_isSignaled;
+}
+
+void OpenGLFence::wait() {
+    // flush on the first wait so the fence is guaranteed to eventually signal
+    GLbitfield flags = GL_SYNC_FLUSH_COMMANDS_BIT;
+    while (!m_isSignaled) {
+        GLenum result = glClientWaitSync(m_handle, flags, 1000000); // 1 ms
+        if (result == GL_WAIT_FAILED) {
+            throw std::runtime_error("Failed to wait for fence.");
+        }
+        m_isSignaled = result == GL_ALREADY_SIGNALED || result == GL_CONDITION_SATISFIED;
+        flags = 0;
+    }
+}
@@ -0,0 +1,22 @@
+#ifndef OPENGL_RENDERER_OPENGLFENCE_H
+#define OPENGL_RENDERER_OPENGLFENCE_H
+
+#include "OpenGLRHI.h"
+
+class OpenGLFence : public Fence, public Resource<GLsync> {
+public:
+    explicit OpenGLFence(GLsync handle) : Resource<GLsync>(handle), m_isSignaled(false) {}
+
+    ~OpenGLFence() override {
+        glDeleteSync(m_handle);
+    }
+
+    bool isSignaled() override;
+    void wait() override;
+
+private:
+    bool m_isSignaled;
+};
+
+
+#endif //OPENGL_RENDERER_OPENGLFENCE_H
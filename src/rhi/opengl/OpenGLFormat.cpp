@@ -8,6 +8,27 @@ GLenum toOpenGLFormat(Format format) {
         case Format::RGB32F: return GL_RGB32F;
         case Format::RGBA32F: return GL_RGBA32F;
         case Format::D32F: return GL_DEPTH_COMPONENT32F;
+        case Format::RGBA16F: return GL_RGBA16F;
+        case Format::R11G11B10F: return GL_R11F_G11F_B10F;
+        case Format::BC1: return GL_COMPRESSED_RGBA_S3TC_DXT1_EXT;
+        case Format::BC3: return GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+        case Format::BC4: return GL_COMPRESSED_RED_RGTC1;
+        case Format::BC5: return GL_COMPRESSED_RG_RGTC2;
+        case Format::BC7: return GL_COMPRESSED_RGBA_BPTC_UNORM;
         default: throw std::invalid_argument("OpenGL does not support that format.");
     }
 }
+
+OpenGLPixelTransfer toOpenGLPixelTransfer(Format format) {
+    switch (format) {
+        case Format::RGB8: return {GL_RGB, GL_UNSIGNED_BYTE};
+        case Format::RGBA8: return {GL_RGBA, GL_UNSIGNED_BYTE};
+        case Format::RG32F: return {GL_RG, GL_FLOAT};
+        case Format::RGB32F: return {GL_RGB, GL_FLOAT};
+        case Format::RGBA32F: return {GL_RGBA, GL_FLOAT};
+        case Format::D32F: return {GL_DEPTH_COMPONENT, GL_FLOAT};
+        case Format::RGBA16F: return {GL_RGBA, GL_HALF_FLOAT};
+        case Format::R11G11B10F: return {GL_RGB, GL_UNSIGNED_INT_10F_11F_11F_REV};
+        default: throw std::invalid_argument("Block-compressed pixels are not transferred by format and type.");
+    }
+}
@@ -3,7 +3,22 @@
 
 #include "../Format.h"
 
+/**
+ * The format and type of the pixels passed to or read from OpenGL.
+ */
+struct OpenGLPixelTransfer {
+    GLenum format;
+    GLenum type;
+};
+
 GLenum toOpenGLFormat(Format format);
 
+/**
+ * @param format an uncompressed format
+ * @returns the transfer format and type of pixels stored in the format
+ * @throws std::invalid_argument if the format is block-compressed
+ */
+OpenGLPixelTransfer toOpenGLPixelTransfer(Format format);
+
 
 #endif //OPENGL_RENDERER_OPENGLFORMAT_H
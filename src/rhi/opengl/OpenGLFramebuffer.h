@@ -11,7 +11,12 @@ public:
               Resource<GLuint>(handle) {};
 
     ~OpenGLFramebuffer() override {
-        glDeleteFramebuffers(1, &m_handle);
+        RHI::release([handle = m_handle] {
+            if (OpenGLStateCache* stateCache = OpenGLStateCache::current()) {
+                stateCache->invalidateFramebuffer(handle);
+            }
+            glDeleteFramebuffers(1, &handle);
+        });
     }
 
     constexpr static OpenGLFramebuffer& from(Framebuffer& framebuffer) {
@@ -4,22 +4,254 @@ std::unique_ptr<PipelineBuilder> OpenGLRHI::createPipelineBuilder() {
     return std::make_unique<OpenGLPipelineBuilder>();
 }
 
+std::string OpenGLRHI::pipelineBinaryVersion() {
+    GLint numFormats = 0;
+    glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &numFormats);
+    if (numFormats == 0) {
+        return {};
+    }
+
+    // binaries are only guaranteed to load into the driver build that produced them
+    std::string version;
+    for (GLenum name: {GL_VENDOR, GL_RENDERER, GL_VERSION, GL_SHADING_LANGUAGE_VERSION}) {
+        version += (const char*)glGetString(name);
+        version += '\n';
+    }
+    return version;
+}
+
+std::vector<uint8_t> OpenGLRHI::pipelineBinary(const Pipeline& pipeline) {
+    const OpenGLPipeline& glPipeline = OpenGLPipeline::from(pipeline);
+    glPipeline.checkStatus();
+
+    // programs that failed to link have no binary worth keeping
+    GLuint handle = glPipeline.handle();
+    GLint linked;
+    GLint length = 0;
+    glGetProgramiv(handle, GL_LINK_STATUS, &linked);
+    if (linked == GL_TRUE) {
+        glGetProgramiv(handle, GL_PROGRAM_BINARY_LENGTH, &length);
+    }
+    if (length == 0) {
+        return {};
+    }
+
+    // the binary is prefixed with its format, which is needed to load it
+    std::vector<uint8_t> binary(sizeof(GLenum) + length);
+    GLenum format;
+    glGetProgramBinary(handle, length, &length, &format, binary.data() + sizeof(GLenum));
+    std::memcpy(binary.data(), &format, sizeof(GLenum));
+    binary.resize(sizeof(GLenum) + length);
+    return binary;
+}
+
 std::unique_ptr<Pipeline> OpenGLPipelineBuilder::build() {
     GLuint handle = glCreateProgram();
 
+    if (!m_binary.empty()) {
+        GLenum format = 0;
+        if (m_binary.size() > sizeof(GLenum)) {
+            std::memcpy(&format, m_binary.data(), sizeof(GLenum));
+            glProgramBinary(handle, format, m_binary.data() + sizeof(GLenum),
+                            (GLsizei)(m_binary.size() - sizeof(GLenum)));
+        }
+
+        // drivers reject binaries they no longer accept, such as after an update, which are then rebuilt
+        GLint success;
+        glGetProgramiv(handle, GL_LINK_STATUS, &success);
+        if (format == 0 || success != GL_TRUE) {
+            glDeleteProgram(handle);
+            return nullptr;
+        }
+
+        auto pipeline = std::make_unique<OpenGLPipeline>(handle, m_topology, m_depthState, m_stencilState,
+                                                         m_blendState, m_rasterState, m_colorWriteEnabled,
+                                                         *m_vertexLayout);
+        pipeline->m_statusChecked = true;
+        return pipeline;
+    }
+
+    // the status is not queried until the pipeline is used, so that the driver can compile and link many
+    // programs at once, and the shaders stay attached until then to report their errors
     glAttachShader(handle, m_vertexShader->handle());
     glAttachShader(handle, m_fragmentShader->handle());
+    glProgramParameteri(handle, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
     glLinkProgram(handle);
 
+    return std::make_unique<OpenGLPipeline>(handle, m_topology, m_depthState, m_stencilState, m_blendState,
+                                            m_rasterState, m_colorWriteEnabled, *m_vertexLayout);
+}
+
+OpenGLPipeline::OpenGLPipeline(GLuint handle, Topology topology, DepthState depthState, StencilState stencilState,
+                               BlendState blendState, RasterState rasterState, bool colorWriteEnabled,
+                               VertexLayout vertexLayout)
+        : Pipeline(topology, depthState, stencilState, blendState, rasterState, colorWriteEnabled),
+          Resource<GLuint>(handle), m_vertexLayout(std::move(vertexLayout)),
+          m_depthFunc(toOpenGLCompareOp(depthState.compareOp)), m_statusChecked(false) {
+    // the state is translated once, so that binding only compares it with the current state
+    m_stencil = OpenGLStateCache::Stencil{
+        .func = toOpenGLCompareOp(stencilState.compareOp),
+        .reference = stencilState.reference,
+        .compareMask = stencilState.compareMask,
+        .failOp = toOpenGLStencilOp(stencilState.failOp),
+        .depthFailOp = toOpenGLStencilOp(stencilState.depthFailOp),
+        .passOp = toOpenGLStencilOp(stencilState.passOp),
+    };
+    m_blend = OpenGLStateCache::Blend{
+        .srcColor = toOpenGLBlendFactor(blendState.srcColorFactor),
+        .dstColor = toOpenGLBlendFactor(blendState.dstColorFactor),
+        .colorEquation = toOpenGLBlendOp(blendState.colorOp),
+        .srcAlpha = toOpenGLBlendFactor(blendState.srcAlphaFactor),
+        .dstAlpha = toOpenGLBlendFactor(blendState.dstAlphaFactor),
+        .alphaEquation = toOpenGLBlendOp(blendState.alphaOp),
+    };
+    m_cullFace = rasterState.cullMode == CullMode::Front ? GL_FRONT : GL_BACK;
+    m_frontFace = rasterState.frontFace == FrontFace::Clockwise ? GL_CW : GL_CCW;
+    switch (rasterState.polygonMode) {
+        case PolygonMode::Fill:
+            m_polygonMode = GL_FILL;
+            break;
+        case PolygonMode::Line:
+            m_polygonMode = GL_LINE;
+            break;
+        case PolygonMode::Point:
+            m_polygonMode = GL_POINT;
+            break;
+        default:
+            throw std::invalid_argument("the polygon mode is not supported");
+    }
+}
+
+bool OpenGLPipeline::isReady() const {
+    if (m_statusChecked) {
+        return true;
+    }
+    if (!GLEW_KHR_parallel_shader_compile && !GLEW_ARB_parallel_shader_compile) {
+        return true;
+    }
+
+    GLint complete;
+    glGetProgramiv(m_handle, GL_COMPLETION_STATUS_KHR, &complete);
+    return complete == GL_TRUE;
+}
+
+void OpenGLPipeline::checkStatus() const {
+    if (m_statusChecked) {
+        return;
+    }
+    m_statusChecked = true;
+
+    GLuint shaders[2];
+    GLsizei numShaders = 0;
+    glGetAttachedShaders(m_handle, 2, &numShaders, shaders);
+
     GLint success;
-    glGetProgramiv(handle, GL_LINK_STATUS, &success);
+    glGetProgramiv(m_handle, GL_LINK_STATUS, &success);
     if (success != GL_TRUE) {
+        for (GLsizei i = 0; i < numShaders; i++) {
+            glGetShaderiv(shaders[i], GL_COMPILE_STATUS, &success);
+            if (success != GL_TRUE) {
+                char name[256];
+                glGetObjectLabel(GL_SHADER, shaders[i], sizeof(name), nullptr, name);
+                // TODO: make this an exception in the future
+                std::cerr << "ERR: shader failed to compile: " << name << std::endl;
+            }
+        }
         // TODO: update to use exceptions
         std::cerr << "ERR: program failed to link." << std::endl;
     }
 
-    glDetachShader(handle, m_vertexShader->handle());
-    glDetachShader(handle, m_fragmentShader->handle());
+    for (GLsizei i = 0; i < numShaders; i++) {
+        glDetachShader(m_handle, shaders[i]);
+    }
+}
+
+GLenum OpenGLPipeline::toOpenGLCompareOp(CompareOp compareOp) {
+    switch (compareOp) {
+        case CompareOp::Never:
+            return GL_NEVER;
+        case CompareOp::Less:
+            return GL_LESS;
+        case CompareOp::Equal:
+            return GL_EQUAL;
+        case CompareOp::LessOrEqual:
+            return GL_LEQUAL;
+        case CompareOp::Greater:
+            return GL_GREATER;
+        case CompareOp::NotEqual:
+            return GL_NOTEQUAL;
+        case CompareOp::GreaterOrEqual:
+            return GL_GEQUAL;
+        case CompareOp::Always:
+            return GL_ALWAYS;
+        default:
+            throw std::invalid_argument("the compare op is not supported");
+    }
+}
+
+GLenum OpenGLPipeline::toOpenGLStencilOp(StencilOp stencilOp) {
+    switch (stencilOp) {
+        case StencilOp::Keep:
+            return GL_KEEP;
+        case StencilOp::Zero:
+            return GL_ZERO;
+        case StencilOp::Replace:
+            return GL_REPLACE;
+        case StencilOp::IncrementClamp:
+            return GL_INCR;
+        case StencilOp::DecrementClamp:
+            return GL_DECR;
+        case StencilOp::Invert:
+            return GL_INVERT;
+        case StencilOp::IncrementWrap:
+            return GL_INCR_WRAP;
+        case StencilOp::DecrementWrap:
+            return GL_DECR_WRAP;
+        default:
+            throw std::invalid_argument("the stencil op is not supported");
+    }
+}
+
+GLenum OpenGLPipeline::toOpenGLBlendFactor(BlendFactor blendFactor) {
+    switch (blendFactor) {
+        case BlendFactor::Zero:
+            return GL_ZERO;
+        case BlendFactor::One:
+            return GL_ONE;
+        case BlendFactor::SrcColor:
+            return GL_SRC_COLOR;
+        case BlendFactor::OneMinusSrcColor:
+            return GL_ONE_MINUS_SRC_COLOR;
+        case BlendFactor::DstColor:
+            return GL_DST_COLOR;
+        case BlendFactor::OneMinusDstColor:
+            return GL_ONE_MINUS_DST_COLOR;
+        case BlendFactor::SrcAlpha:
+            return GL_SRC_ALPHA;
+        case BlendFactor::OneMinusSrcAlpha:
+            return GL_ONE_MINUS_SRC_ALPHA;
+        case BlendFactor::DstAlpha:
+            return GL_DST_ALPHA;
+        case BlendFactor::OneMinusDstAlpha:
+            return GL_ONE_MINUS_DST_ALPHA;
+        default:
+            throw std::invalid_argument("the blend factor is not supported");
+    }
+}
 
-    return std::make_unique<OpenGLPipeline>(handle, m_topology, *m_vertexLayout);
+GLenum OpenGLPipeline::toOpenGLBlendOp(BlendOp blendOp) {
+    switch (blendOp) {
+        case BlendOp::Add:
+            return GL_FUNC_ADD;
+        case BlendOp::Subtract:
+            return GL_FUNC_SUBTRACT;
+        case BlendOp::ReverseSubtract:
+            return GL_FUNC_REVERSE_SUBTRACT;
+        case BlendOp::Min:
+            return GL_MIN;
+        case BlendOp::Max:
+            return GL_MAX;
+        default:
+            throw std::invalid_argument("the blend op is not supported");
+    }
 }
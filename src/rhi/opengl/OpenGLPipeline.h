@@ -6,17 +6,70 @@
 
 class OpenGLPipeline : public Pipeline, public Resource<GLuint> {
 public:
-    OpenGLPipeline(GLuint handle, Topology topology, VertexLayout vertexLayout)
-            : Pipeline(topology), Resource<GLuint>(handle), m_vertexLayout(std::move(vertexLayout)) {};
+    OpenGLPipeline(GLuint handle, Topology topology, DepthState depthState, StencilState stencilState,
+                   BlendState blendState, RasterState rasterState, bool colorWriteEnabled, VertexLayout vertexLayout);
 
     ~OpenGLPipeline() override {
-        glDeleteProgram(m_handle);
+        RHI::release([handle = m_handle] {
+            if (OpenGLStateCache* stateCache = OpenGLStateCache::current()) {
+                stateCache->invalidateProgram(handle);
+            }
+            glDeleteProgram(handle);
+        });
     }
 
     const VertexLayout& vertexLayout() const {
         return m_vertexLayout;
     }
 
+    /**
+     * @returns the OpenGL depth function of the pipeline's depth compare op
+     */
+    GLenum depthFunc() const {
+        return m_depthFunc;
+    }
+
+    /**
+     * @returns the OpenGL stencil functions of the pipeline's stencil state
+     */
+    const OpenGLStateCache::Stencil& stencil() const {
+        return m_stencil;
+    }
+
+    /**
+     * @returns the OpenGL blend functions of the pipeline's blend state
+     */
+    const OpenGLStateCache::Blend& blend() const {
+        return m_blend;
+    }
+
+    /**
+     * @returns the OpenGL face culled by the pipeline, which only applies if culling is enabled
+     */
+    GLenum cullFace() const {
+        return m_cullFace;
+    }
+
+    GLenum frontFace() const {
+        return m_frontFace;
+    }
+
+    GLenum polygonMode() const {
+        return m_polygonMode;
+    }
+
+    bool isReady() const override;
+
+    void wait() const override {
+        checkStatus();
+    }
+
+    /**
+     * Waits for the program to finish linking, then reports any error in it or its shaders, which are
+     * detached. Errors are only checked once, so later calls return immediately.
+     */
+    void checkStatus() const;
+
     constexpr static OpenGLPipeline& from(Pipeline& pipeline) {
         return dynamic_cast<OpenGLPipeline&>(pipeline);
     }
@@ -28,14 +81,27 @@ public:
 private:
     friend class OpenGLPipelineBuilder;
 
+    static GLenum toOpenGLCompareOp(CompareOp compareOp);
+    static GLenum toOpenGLStencilOp(StencilOp stencilOp);
+    static GLenum toOpenGLBlendFactor(BlendFactor blendFactor);
+    static GLenum toOpenGLBlendOp(BlendOp blendOp);
+
     VertexLayout m_vertexLayout;
+    GLenum m_depthFunc;
+    OpenGLStateCache::Stencil m_stencil;
+    OpenGLStateCache::Blend m_blend;
+    GLenum m_cullFace;
+    GLenum m_frontFace;
+    GLenum m_polygonMode;
+    mutable bool m_statusChecked;
 };
 
 class OpenGLPipelineBuilder : public PipelineBuilder {
 public:
     OpenGLPipelineBuilder()
             : m_topology(Topology::Triangles), m_vertexShader(nullptr), m_fragmentShader(nullptr),
-              m_vertexLayout(nullptr) {};
+              m_vertexLayout(nullptr), m_depthState(), m_stencilState(), m_blendState(), m_rasterState(),
+              m_colorWriteEnabled(true) {};
 
     PipelineBuilder* setTopology(Topology topology) override {
         m_topology = topology;
@@ -57,6 +123,36 @@ public:
         return this;
     }
 
+    PipelineBuilder* setDepthState(const DepthState& depthState) override {
+        m_depthState = depthState;
+        return this;
+    }
+
+    PipelineBuilder* setStencilState(const StencilState& stencilState) override {
+        m_stencilState = stencilState;
+        return this;
+    }
+
+    PipelineBuilder* setBlendState(const BlendState& blendState) override {
+        m_blendState = blendState;
+        return this;
+    }
+
+    PipelineBuilder* setRasterState(const RasterState& rasterState) override {
+        m_rasterState = rasterState;
+        return this;
+    }
+
+    PipelineBuilder* setColorWriteEnabled(bool enabled) override {
+        m_colorWriteEnabled = enabled;
+        return this;
+    }
+
+    PipelineBuilder* setBinary(std::span<const uint8_t> binary) override {
+        m_binary = binary;
+        return this;
+    }
+
     std::unique_ptr<Pipeline> build() override;
 
 private:
@@ -64,6 +160,12 @@ private:
     OpenGLShader* m_vertexShader;
     OpenGLShader* m_fragmentShader;
     const VertexLayout* m_vertexLayout;
+    DepthState m_depthState;
+    StencilState m_stencilState;
+    BlendState m_blendState;
+    RasterState m_rasterState;
+    bool m_colorWriteEnabled;
+    std::span<const uint8_t> m_binary;
 };
 
 
@@ -1,11 +1,13 @@
 #include "OpenGLRHI.h"
 #include "OpenGLBuffer.h"
 #include "OpenGLTexture2D.h"
+#include "OpenGLTexture2DArray.h"
 #include "OpenGLShader.h"
 #include "OpenGLPipeline.h"
 #include "OpenGLFramebuffer.h"
 #include "OpenGLUniformVisitor.h"
 #include "OpenGLDescriptorSet.h"
+#include "OpenGLFormat.h"
 
 void OpenGLRHI::copyBufferToTexture2D(Buffer& source, Texture2D& destination) {
     OpenGLBuffer& glSource = OpenGLBuffer::from(source);
@@ -26,18 +28,91 @@ void OpenGLRHI::copyBufferToTexture2D(Buffer& source, Texture2D& destination) {
     glGenerateTextureMipmap(glDest.handle());
 }
 
-void OpenGLRHI::resolveTexture2D(Texture2D& source, Texture2D& destination) {
-    throw std::runtime_error("resolveTexture2D() is not implemented.");
+void OpenGLRHI::copyBufferToTexture2D(Buffer& source, uint32_t sourceOffset, Texture2D& destination,
+                                      uint32_t level, const TextureRegion& region) {
+    uint32_t size = checkTextureCopy(source, sourceOffset, destination, level, region);
+    GLuint handle = OpenGLTexture2D::from(destination).handle();
+    Format format = destination.format();
+
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, OpenGLBuffer::from(source).handle());
+    auto offset = (const void*)(uintptr_t)sourceOffset;
+    if (isBlockCompressed(format)) {
+        glCompressedTextureSubImage2D(handle, (GLint)level, (GLint)region.x, (GLint)region.y, (GLsizei)region.width,
+                                      (GLsizei)region.height, toOpenGLFormat(format), (GLsizei)size, offset);
+    } else {
+        OpenGLPixelTransfer transfer = toOpenGLPixelTransfer(format);
+        glTextureSubImage2D(handle, (GLint)level, (GLint)region.x, (GLint)region.y, (GLsizei)region.width,
+                            (GLsizei)region.height, transfer.format, transfer.type, offset);
+    }
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
 }
 
-void OpenGLRHI::bindVertexBuffer(const Buffer& buffer, uint32_t binding) {
-    // assure that buffer stride matching the binding stride
-    // assert(buffer.stride() == 0000);
+void OpenGLRHI::copyBufferToTexture2DArray(Buffer& source, uint32_t sourceOffset, Texture2DArray& destination,
+                                           uint32_t layer, uint32_t level, const TextureRegion& region) {
+    uint32_t size = checkTextureCopy(source, sourceOffset, destination, layer, level, region);
+    GLuint handle = OpenGLTexture2DArray::from(destination).handle();
+    Format format = destination.format();
 
-    const OpenGLBuffer& glBuffer = OpenGLBuffer::from(buffer);
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, OpenGLBuffer::from(source).handle());
+    auto offset = (const void*)(uintptr_t)sourceOffset;
+    if (isBlockCompressed(format)) {
+        glCompressedTextureSubImage3D(handle, (GLint)level, (GLint)region.x, (GLint)region.y, (GLint)layer,
+                                      (GLsizei)region.width, (GLsizei)region.height, 1, toOpenGLFormat(format),
+                                      (GLsizei)size, offset);
+    } else {
+        OpenGLPixelTransfer transfer = toOpenGLPixelTransfer(format);
+        glTextureSubImage3D(handle, (GLint)level, (GLint)region.x, (GLint)region.y, (GLint)layer,
+                            (GLsizei)region.width, (GLsizei)region.height, 1, transfer.format, transfer.type, offset);
+    }
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+}
+
+void OpenGLRHI::resolveTexture2D(Texture2D& source, const TextureRegion& sourceRegion, Texture2D& destination,
+                                 const TextureRegion& destinationRegion) {
+    bool isScaled = sourceRegion.width != destinationRegion.width || sourceRegion.height != destinationRegion.height;
+    bool isDepth = source.format() == Format::D32F;
+    if (destination.numSamples() != 1) {
+        throw std::invalid_argument("The destination of a resolve must be single-sampled.");
+    }
+    if (isDepth != (destination.format() == Format::D32F)) {
+        throw std::invalid_argument("Depth textures can only be resolved into depth textures.");
+    }
+    if (source.numSamples() > 1 && (isScaled || source.format() != destination.format())) {
+        throw std::invalid_argument("Multi-sampled textures can only be resolved into regions of the same size and format.");
+    }
+
+    // blits are masked like draws, so the last pipeline bound must not prevent them
+    m_stateCache.setDepthMask(true);
+    m_stateCache.setColorMask(true);
+
+    GLuint readFramebuffer = m_resolveFramebuffers[0];
+    GLuint drawFramebuffer = m_resolveFramebuffers[1];
+    GLenum attachment = isDepth ? GL_DEPTH_ATTACHMENT : GL_COLOR_ATTACHMENT0;
+    glNamedFramebufferTexture(readFramebuffer, attachment, OpenGLTexture2D::from(source).handle(), 0);
+    glNamedFramebufferTexture(drawFramebuffer, attachment, OpenGLTexture2D::from(destination).handle(), 0);
+    if (!isDepth) {
+        glNamedFramebufferReadBuffer(readFramebuffer, GL_COLOR_ATTACHMENT0);
+        glNamedFramebufferDrawBuffer(drawFramebuffer, GL_COLOR_ATTACHMENT0);
+    }
 
-    // TODO: support for binding with offset (atm assumed to be 0)
-    glBindVertexBuffer(binding, glBuffer.handle(), 0, (GLint)glBuffer.stride());
+    // depth cannot be filtered, so is always copied from the nearest sample
+    glBlitNamedFramebuffer(readFramebuffer, drawFramebuffer,
+                           (GLint)sourceRegion.x, (GLint)sourceRegion.y,
+                           (GLint)(sourceRegion.x + sourceRegion.width), (GLint)(sourceRegion.y + sourceRegion.height),
+                           (GLint)destinationRegion.x, (GLint)destinationRegion.y,
+                           (GLint)(destinationRegion.x + destinationRegion.width),
+                           (GLint)(destinationRegion.y + destinationRegion.height),
+                           isDepth ? GL_DEPTH_BUFFER_BIT : GL_COLOR_BUFFER_BIT,
+                           isScaled && !isDepth ? GL_LINEAR : GL_NEAREST);
+
+    // detach the textures so that deleting them frees their storage
+    glNamedFramebufferTexture(readFramebuffer, attachment, 0, 0);
+    glNamedFramebufferTexture(drawFramebuffer, attachment, 0, 0);
+}
+
+void OpenGLRHI::bindVertexBuffer(const Buffer& buffer, uint32_t binding, uint32_t offset, uint32_t stride) {
+    const OpenGLBuffer& glBuffer = OpenGLBuffer::from(buffer);
+    m_stateCache.bindVertexBuffer(binding, glBuffer.handle(), offset, (GLsizei)stride);
 }
 
 void OpenGLRHI::bindIndexBuffer(const Buffer& buffer) {
@@ -46,7 +121,7 @@ void OpenGLRHI::bindIndexBuffer(const Buffer& buffer) {
 
     const OpenGLBuffer& glBuffer = OpenGLBuffer::from(buffer);
 
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, glBuffer.handle());
+    m_stateCache.bindIndexBuffer(glBuffer.handle());
     m_binds.indexBuffer = std::addressof(buffer);
 }
 
@@ -60,49 +135,78 @@ void OpenGLRHI::bindUniforms(UniformBlock& uniformBlock) {
     }
 }
 
-void OpenGLRHI::bindDescriptorSet(const DescriptorSet& descriptorSet) {
+void OpenGLRHI::bindDescriptorSet(const DescriptorSet& descriptorSet, std::span<const uint32_t> dynamicOffsets) {
     const OpenGLDescriptorSet& glDescriptorSet = OpenGLDescriptorSet::from(descriptorSet);
+    const DescriptorSetLayout& layout = glDescriptorSet.layout();
+    uint32_t written = glDescriptorSet.writtenBindings();
+
+    // each run of consecutive bindings of a class of resource is bound with one call
+    const std::array<GLuint, DescriptorSetLayout::maxBindings>& textures = glDescriptorSet.textures();
+    uint32_t textureBindings = layout.bindings(DescriptorType::Texture2D) |
+                               layout.bindings(DescriptorType::Texture2DArray);
+    DescriptorSetLayout::forEachRange(written & textureBindings, [&](uint32_t first, uint32_t count) {
+        m_stateCache.bindTextureUnits(first, count, textures.data() + first);
+    });
+
+    const OpenGLBufferDescriptors& uniformBuffers = glDescriptorSet.uniformBuffers();
+    const GLintptr* uniformOffsets = uniformBuffers.offsets.data();
+    std::array<GLintptr, DescriptorSetLayout::maxBindings> dynamicUniformOffsets;
+    uint32_t dynamicBindings = written & layout.bindings(DescriptorType::UniformBufferDynamic);
+    if (dynamicBindings != 0) {
+        // dynamic offsets are consumed in order of binding index
+        if ((size_t)std::popcount(dynamicBindings) > dynamicOffsets.size()) {
+            throw std::invalid_argument("A dynamic offset is required for each dynamic uniform buffer.");
+        }
 
-    for (auto& descriptorPair: glDescriptorSet.descriptors()) {
-        uint32_t binding = descriptorPair.first;
-        OpenGLDescriptor descriptor = descriptorPair.second;
-
-        switch (descriptor.type) {
-            case DescriptorType::Texture2D:
-                glBindTextureUnit(binding, descriptor.textureInfo.handle);
-                break;
-            case DescriptorType::UniformBuffer:
-                glBindBufferRange(GL_UNIFORM_BUFFER, binding, descriptor.bufferInfo.handle,
-                                  descriptor.bufferInfo.offset, descriptor.bufferInfo.range);
-                break;
-            case DescriptorType::StorageBuffer:
-                glBindBufferRange(GL_SHADER_STORAGE_BUFFER, binding, descriptor.bufferInfo.handle,
-                                  descriptor.bufferInfo.offset, descriptor.bufferInfo.range);
-                break;
+        dynamicUniformOffsets = uniformBuffers.offsets;
+        size_t dynamicIndex = 0;
+        for (uint32_t bindings = dynamicBindings; bindings != 0; bindings &= bindings - 1) {
+            dynamicUniformOffsets[std::countr_zero(bindings)] += dynamicOffsets[dynamicIndex++];
         }
+        uniformOffsets = dynamicUniformOffsets.data();
     }
+    uint32_t uniformBindings = written & (layout.bindings(DescriptorType::UniformBuffer) | dynamicBindings);
+    DescriptorSetLayout::forEachRange(uniformBindings, [&](uint32_t first, uint32_t count) {
+        m_stateCache.bindBuffersRange(GL_UNIFORM_BUFFER, first, count, uniformBuffers.handles.data() + first,
+                                      uniformOffsets + first, uniformBuffers.ranges.data() + first);
+    });
+
+    const OpenGLBufferDescriptors& storageBuffers = glDescriptorSet.storageBuffers();
+    DescriptorSetLayout::forEachRange(written & layout.bindings(DescriptorType::StorageBuffer),
+                                      [&](uint32_t first, uint32_t count) {
+        m_stateCache.bindBuffersRange(GL_SHADER_STORAGE_BUFFER, first, count, storageBuffers.handles.data() + first,
+                                      storageBuffers.offsets.data() + first, storageBuffers.ranges.data() + first);
+    });
 }
 
 void OpenGLRHI::bindPipeline(const Pipeline& pipeline) {
     const OpenGLPipeline& glPipeline = OpenGLPipeline::from(pipeline);
+    glPipeline.checkStatus();
 
+    uint32_t enabledAttributes = 0;
     for (const auto& binding: glPipeline.vertexLayout().bindings) {
         for (auto attribute: binding.attributes) {
-            glEnableVertexAttribArray(attribute.location);
-            glVertexAttribBinding(attribute.location, binding.binding);
+            if (attribute.location >= OpenGLStateCache::maxVertexAttribs) {
+                throw std::invalid_argument("the vertex attribute location is not supported");
+            }
+            enabledAttributes |= 1u << attribute.location;
+
             switch (attribute.format) {
                 case Format::RGB8:
                 case Format::RGBA8:
                     throw std::runtime_error("RGB(A)8 format not supported");
                     break;
                 case Format::RG32F:
-                    glVertexAttribFormat(attribute.location, 2, GL_FLOAT, GL_FALSE, attribute.offset);
+                    m_stateCache.setVertexAttribFormat(attribute.location, binding.binding, 2, GL_FLOAT,
+                                                       attribute.offset);
                     break;
                 case Format::RGB32F:
-                    glVertexAttribFormat(attribute.location, 3, GL_FLOAT, GL_FALSE, attribute.offset);
+                    m_stateCache.setVertexAttribFormat(attribute.location, binding.binding, 3, GL_FLOAT,
+                                                       attribute.offset);
                     break;
                 case Format::RGBA32F:
-                    glVertexAttribFormat(attribute.location, 4, GL_FLOAT, GL_FALSE, attribute.offset);
+                    m_stateCache.setVertexAttribFormat(attribute.location, binding.binding, 4, GL_FLOAT,
+                                                       attribute.offset);
                     break;
                 default:
                     throw std::invalid_argument("the vertex attribute type is not supported");
@@ -110,25 +214,44 @@ void OpenGLRHI::bindPipeline(const Pipeline& pipeline) {
             }
         }
     }
+    m_stateCache.setEnabledVertexAttribs(enabledAttributes);
 
-    glUseProgram(glPipeline.handle());
+    const DepthState& depthState = glPipeline.depthState();
+    m_stateCache.setDepthTest(depthState.testEnabled, glPipeline.depthFunc());
+    m_stateCache.setDepthMask(depthState.writeEnabled);
+    m_stateCache.setColorMask(glPipeline.colorWriteEnabled());
+
+    // the state cache only issues the calls for state that differs from the last pipeline's
+    m_stateCache.setStencilTest(glPipeline.stencilState().testEnabled, glPipeline.stencil());
+    m_stateCache.setStencilMask(glPipeline.stencilState().writeMask);
+    m_stateCache.setBlend(glPipeline.blendState().enabled, glPipeline.blend());
+    const RasterState& rasterState = glPipeline.rasterState();
+    m_stateCache.setCullFace(rasterState.cullMode != CullMode::None, glPipeline.cullFace(), glPipeline.frontFace());
+    m_stateCache.setPolygonMode(glPipeline.polygonMode());
+    m_stateCache.setPolygonOffset(rasterState.depthBiasSlope, rasterState.depthBiasConstant);
+
+    m_stateCache.useProgram(glPipeline.handle());
     m_binds.pipeline = std::addressof(pipeline);
 }
 
 void OpenGLRHI::bindFramebuffer(Framebuffer& framebuffer) {
-    glBindFramebuffer(GL_FRAMEBUFFER, OpenGLFramebuffer::from(framebuffer).handle());
+    m_stateCache.bindFramebuffer(OpenGLFramebuffer::from(framebuffer).handle());
 }
 
 void OpenGLRHI::bindDefaultFramebuffer() {
-    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    m_stateCache.bindFramebuffer(0);
 }
 
 void OpenGLRHI::setViewport(uint32_t x, uint32_t y, uint32_t width, uint32_t height) {
     // TODO: atm does not match the exact spec
-    glViewport((GLint)x, (GLint)y, (GLsizei)width, (GLsizei)height);
+    m_stateCache.setViewport((GLint)x, (GLint)y, (GLsizei)width, (GLsizei)height);
 }
 
 void OpenGLRHI::clearAttachments(float r, float g, float b, float a, float depth) {
+    // clears are masked like writes, so the last pipeline bound must not prevent them
+    m_stateCache.setDepthMask(true);
+    m_stateCache.setColorMask(true);
+
     glClearColor(r, g, b, a);
     glClearDepth(depth);
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
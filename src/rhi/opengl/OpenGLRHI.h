@@ -3,47 +3,91 @@
 
 #include "../RHI.h"
 #include "../Resource.h"
+#include "OpenGLStateCache.h"
+#include "OpenGLScopeTimer.h"
 
 class OpenGLRHI : public RHI {
 public:
-    OpenGLRHI() : m_vertexArray(0), m_binds{nullptr, nullptr} {
+    OpenGLRHI() : m_binds{nullptr, nullptr}, m_vertexArray(0), m_resolveFramebuffers{0, 0},
+                  m_uniformBufferAlignment(0), m_storageBufferAlignment(0), m_scopeTimer(m_profiler) {
         // load opengl pointers from glew
+        // glew built for glx reports a missing display under headless egl contexts, after loading the pointers
         glewExperimental = GL_TRUE;
-        if (glewInit() != GLEW_OK) {
+        GLenum result = glewInit();
+        if (result != GLEW_OK && result != GLEW_ERROR_NO_GLX_DISPLAY) {
             throw std::runtime_error("Failed to load OpenGL.");
         }
 
-        // enable depth test and multisampling
-        glEnable(GL_DEPTH_TEST);
+        // let the driver compile shaders on as many threads as it likes, so that pipelines build in parallel
+        if (GLEW_KHR_parallel_shader_compile) {
+            glMaxShaderCompilerThreadsKHR(0xFFFFFFFF);
+        } else if (GLEW_ARB_parallel_shader_compile) {
+            glMaxShaderCompilerThreadsARB(0xFFFFFFFF);
+        }
+
+        // depth, stencil, blend and raster state are set by each pipeline, and only multisampling is global
         glEnable(GL_MULTISAMPLE);
 
+        // pixels copied into textures have tightly packed rows, even of 3-byte pixels
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
         // uses only one vertex array, changing its values
         glCreateVertexArrays(1, &m_vertexArray);
         glBindVertexArray(m_vertexArray);
+        m_stateCache.reset();
+
+        // resolves blit between a pair of framebuffers, which textures are attached to as needed
+        glCreateFramebuffers(2, m_resolveFramebuffers);
 
         // use [0, 1] z coords for NDCs
         glClipControl(GL_LOWER_LEFT, GL_ZERO_TO_ONE);
+
+        GLint uniformBufferAlignment;
+        glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &uniformBufferAlignment);
+        m_uniformBufferAlignment = (uint32_t)uniformBufferAlignment;
+
+        GLint storageBufferAlignment;
+        glGetIntegerv(GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT, &storageBufferAlignment);
+        m_storageBufferAlignment = (uint32_t)storageBufferAlignment;
     }
 
     ~OpenGLRHI() override {
+        glDeleteFramebuffers(2, m_resolveFramebuffers);
         glDeleteVertexArrays(1, &m_vertexArray);
     }
 
-    std::unique_ptr<Buffer> createBuffer(uint32_t size, uint32_t stride) override;
-    std::unique_ptr<Texture2D> createTexture2D(Format format, uint32_t width, uint32_t height) override;
-    std::unique_ptr<Shader> createShader(const void* code, size_t codeSize, ShaderType type) override;
+    std::unique_ptr<Buffer> createBuffer(uint32_t size, uint32_t stride, BufferUsage usage) override;
+    std::unique_ptr<Texture2D> createTexture2D(Format format, uint32_t width, uint32_t height,
+                                               uint32_t numSamples, uint32_t numLevels) override;
+    std::unique_ptr<Texture2DArray> createTexture2DArray(Format format, uint32_t width, uint32_t height,
+                                                         uint32_t numLayers, uint32_t numLevels) override;
+    std::unique_ptr<Shader> createShader(const void* code, size_t codeSize, ShaderType type,
+                                         std::string_view name) override;
     std::unique_ptr<DescriptorSet> createDescriptorSet(std::vector<DescriptorSetBinding> bindings) override;
+    std::unique_ptr<Fence> createFence() override;
+    std::unique_ptr<TimerQuery> createTimerQuery() override;
 
     std::unique_ptr<PipelineBuilder> createPipelineBuilder() override;
+    std::string pipelineBinaryVersion() override;
+    std::vector<uint8_t> pipelineBinary(const Pipeline& pipeline) override;
     std::unique_ptr<FramebufferBuilder> createFramebufferBuilder() override;
 
     void copyBufferToTexture2D(Buffer& source, Texture2D& destination) override;
-    void resolveTexture2D(Texture2D& source, Texture2D& destination) override;
+    void copyBufferToTexture2D(Buffer& source, uint32_t sourceOffset, Texture2D& destination, uint32_t level,
+                               const TextureRegion& region) override;
+    void copyBufferToTexture2DArray(Buffer& source, uint32_t sourceOffset, Texture2DArray& destination,
+                                    uint32_t layer, uint32_t level, const TextureRegion& region) override;
+    void copyBuffer(const Buffer& source, uint32_t sourceOffset, Buffer& destination, uint32_t destinationOffset,
+                    uint32_t size) override;
+    using RHI::resolveTexture2D;
+    void resolveTexture2D(Texture2D& source, const TextureRegion& sourceRegion, Texture2D& destination,
+                          const TextureRegion& destinationRegion) override;
 
-    void bindVertexBuffer(const Buffer& buffer, uint32_t binding) override;
+    using RHI::bindVertexBuffer;
+    void bindVertexBuffer(const Buffer& buffer, uint32_t binding, uint32_t offset, uint32_t stride) override;
     void bindIndexBuffer(const Buffer& buffer) override;
     void bindUniforms(UniformBlock& uniformBlock) override;
-    void bindDescriptorSet(const DescriptorSet& descriptorSet) override;
+    void bindDescriptorSet(const DescriptorSet& descriptorSet, std::span<const uint32_t> dynamicOffsets) override;
     void bindPipeline(const Pipeline& pipeline) override;
     void bindFramebuffer(Framebuffer& framebuffer) override;
     void bindDefaultFramebuffer() override;
@@ -54,12 +98,44 @@ public:
     void draw(uint32_t vertexCount, uint32_t baseVertex) override;
     void drawIndexed(uint32_t indexCount, uint32_t baseIndex, uint32_t baseVertex) override;
 
+    void beginGpuScope(std::string_view name) override {
+        m_scopeTimer.begin(name);
+    }
+
+    void endGpuScope() override {
+        m_scopeTimer.end();
+    }
+
+    uint32_t uniformBufferAlignment() const override {
+        return m_uniformBufferAlignment;
+    }
+
+    uint32_t storageBufferAlignment() const override {
+        return m_storageBufferAlignment;
+    }
+
+    /**
+     * @returns the cache used to filter redundant state changes, which counts the calls it filters
+     */
+    OpenGLStateCache& stateCache() {
+        return m_stateCache;
+    }
+
+    static OpenGLRHI& from(RHI& rhi) {
+        return dynamic_cast<OpenGLRHI&>(rhi);
+    }
+
 private:
     struct {
         const Buffer* indexBuffer;
         const Pipeline* pipeline;
     } m_binds;
     GLuint m_vertexArray;
+    GLuint m_resolveFramebuffers[2]; // read and draw
+    uint32_t m_uniformBufferAlignment;
+    uint32_t m_storageBufferAlignment;
+    OpenGLStateCache m_stateCache;
+    OpenGLScopeTimer m_scopeTimer;
 };
 
 
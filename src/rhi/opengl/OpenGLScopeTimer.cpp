@@ -0,0 +1,78 @@
+#include "OpenGLScopeTimer.h"
+
+OpenGLScopeTimer::OpenGLScopeTimer(Profiler& profiler) : m_profiler(profiler), m_numDropped(0) {}
+
+OpenGLScopeTimer::~OpenGLScopeTimer() {
+    for (const PendingScope& scope: m_pending) {
+        m_freeQueries.push_back(scope.beginQuery);
+        m_freeQueries.push_back(scope.endQuery);
+    }
+    glDeleteQueries((GLsizei)m_freeQueries.size(), m_freeQueries.data());
+}
+
+void OpenGLScopeTimer::begin(std::string_view name) {
+    poll();
+
+    if (m_pending.size() >= maxPendingScopes) {
+        m_open.push_back(nullptr);
+        m_numDropped++;
+        return;
+    }
+
+    PendingScope& scope = m_pending.emplace_back(PendingScope{
+        .name = std::string(name),
+        .beginQuery = acquireQuery(),
+        .endQuery = acquireQuery(),
+        .cpuBegin = std::chrono::steady_clock::now(),
+        .cpuTime = Duration::zero(),
+        .isEnded = false,
+    });
+    glQueryCounter(scope.beginQuery, GL_TIMESTAMP);
+    m_open.push_back(std::addressof(scope)); // deques keep references valid when adding to the ends
+}
+
+void OpenGLScopeTimer::end() {
+    if (m_open.empty()) {
+        throw std::domain_error("There is no scope to end.");
+    }
+
+    PendingScope* scope = m_open.back();
+    m_open.pop_back();
+    if (scope == nullptr) return;
+
+    glQueryCounter(scope->endQuery, GL_TIMESTAMP);
+    scope->cpuTime = std::chrono::steady_clock::now() - scope->cpuBegin;
+    scope->isEnded = true;
+}
+
+void OpenGLScopeTimer::poll() {
+    // the gpu writes timestamps in order, so later scopes cannot be ready before the first pending one
+    while (!m_pending.empty() && m_pending.front().isEnded) {
+        PendingScope& scope = m_pending.front();
+
+        GLint available;
+        glGetQueryObjectiv(scope.endQuery, GL_QUERY_RESULT_AVAILABLE, &available);
+        if (available != GL_TRUE) break;
+
+        GLuint64 beginTime, endTime;
+        glGetQueryObjectui64v(scope.beginQuery, GL_QUERY_RESULT, &beginTime);
+        glGetQueryObjectui64v(scope.endQuery, GL_QUERY_RESULT, &endTime);
+        m_profiler.record(scope.name, scope.cpuTime, std::chrono::duration<double, std::nano>(endTime - beginTime));
+
+        m_freeQueries.push_back(scope.beginQuery);
+        m_freeQueries.push_back(scope.endQuery);
+        m_pending.pop_front();
+    }
+}
+
+GLuint OpenGLScopeTimer::acquireQuery() {
+    if (m_freeQueries.empty()) {
+        GLuint query;
+        glCreateQueries(GL_TIMESTAMP, 1, &query);
+        return query;
+    }
+
+    GLuint query = m_freeQueries.back();
+    m_freeQueries.pop_back();
+    return query;
+}
@@ -0,0 +1,58 @@
+#ifndef OPENGL_RENDERER_OPENGLSCOPETIMER_H
+#define OPENGL_RENDERER_OPENGLSCOPETIMER_H
+
+#include <deque>
+#include "../../util/Profiler.h"
+
+/**
+ * Times nested scopes on the gpu with timestamp queries, alongside their cpu times.
+ *
+ * Scopes are queued in the order they begin, and are read in that order once the gpu has written their
+ * end timestamp, so results arrive a few frames late but are never waited on. Queries are recycled
+ * from a pool, and scopes begun while too many are pending are not timed, so that a stalled gpu cannot
+ * grow the queue without bound.
+ */
+class OpenGLScopeTimer {
+public:
+    explicit OpenGLScopeTimer(Profiler& profiler);
+    OpenGLScopeTimer(const OpenGLScopeTimer&) = delete;
+    ~OpenGLScopeTimer();
+
+    void begin(std::string_view name);
+    void end();
+
+    /**
+     * Records the times of the scopes whose results have arrived, without waiting for the others.
+     */
+    void poll();
+
+    /**
+     * @returns the number of scopes that were not timed because too many were pending
+     */
+    uint64_t numDropped() const {
+        return m_numDropped;
+    }
+
+private:
+    static constexpr size_t maxPendingScopes = 256;
+
+    struct PendingScope {
+        std::string name;
+        GLuint beginQuery;
+        GLuint endQuery;
+        Timestamp cpuBegin;
+        Duration cpuTime;
+        bool isEnded;
+    };
+
+    GLuint acquireQuery();
+
+    Profiler& m_profiler;
+    std::deque<PendingScope> m_pending; // in the order the scopes began
+    std::vector<PendingScope*> m_open; // the scopes not yet ended, innermost last, or nullptr if not timed
+    std::vector<GLuint> m_freeQueries;
+    uint64_t m_numDropped;
+};
+
+
+#endif //OPENGL_RENDERER_OPENGLSCOPETIMER_H
@@ -1,6 +1,7 @@
 #include "OpenGLShader.h"
 
-std::unique_ptr<Shader> OpenGLRHI::createShader(const void* code, size_t codeSize, ShaderType type) {
+std::unique_ptr<Shader> OpenGLRHI::createShader(const void* code, size_t codeSize, ShaderType type,
+                                               std::string_view name) {
     GLenum glType;
     switch (type) {
         case ShaderType::Vertex:
@@ -17,12 +18,10 @@ std::unique_ptr<Shader> OpenGLRHI::createShader(const void* code, size_t codeSiz
     auto size = (GLint)codeSize;
     glShaderSource(handle, 1, &str, &size);
     glCompileShader(handle);
-
-    GLint success;
-    glGetShaderiv(handle, GL_COMPILE_STATUS, &success);
-    if (success != GL_TRUE) {
-        // TODO: make this an exception in the future
-        std::cerr << "ERR: shader failed to compile." << std::endl;
+    if (!name.empty()) {
+        glObjectLabel(GL_SHADER, handle, (GLsizei)name.size(), name.data());
     }
+
+    // the compile status is checked by the pipelines the shader is linked into, when they are first used
     return std::make_unique<OpenGLShader>(handle, type);
 }
@@ -8,7 +8,9 @@ public:
     OpenGLShader(GLuint handle, ShaderType type) : Resource<GLuint>(handle), Shader(type) {};
 
     ~OpenGLShader() override {
-        glDeleteShader(m_handle);
+        RHI::release([handle = m_handle] {
+            glDeleteShader(handle);
+        });
     }
 
     constexpr static OpenGLShader& from(Shader& shader) {
@@ -0,0 +1,329 @@
+#include "OpenGLStateCache.h"
+
+#include <bit>
+
+OpenGLStateCache* OpenGLStateCache::currentCache(nullptr);
+
+OpenGLStateCache::OpenGLStateCache() : m_statistics{} {
+    reset();
+    currentCache = this;
+}
+
+OpenGLStateCache::~OpenGLStateCache() {
+    if (currentCache == this) {
+        currentCache = nullptr;
+    }
+}
+
+void OpenGLStateCache::useProgram(GLuint program) {
+    if (issue(m_program != program)) {
+        glUseProgram(program);
+        m_program = program;
+    }
+}
+
+void OpenGLStateCache::setVertexAttribFormat(GLuint location, GLuint binding, GLint size, GLenum type,
+                                             GLuint offset) {
+    VertexAttribFormat format{binding, size, type, offset};
+    if (location < maxVertexAttribs && !issue(m_vertexAttribFormats[location] != format, 2)) {
+        return;
+    }
+
+    glVertexAttribBinding(location, binding);
+    glVertexAttribFormat(location, size, type, GL_FALSE, offset);
+    if (location < maxVertexAttribs) {
+        m_vertexAttribFormats[location] = format;
+    }
+}
+
+void OpenGLStateCache::setEnabledVertexAttribs(uint32_t mask) {
+    // only toggle the attributes whose state differs, or is unknown, and count the enables of attributes
+    // that are already enabled as filtered; attributes that stay disabled would never be toggled at all
+    uint32_t changed = ((mask ^ m_enabledVertexAttribs) | ~m_knownVertexAttribs) & ((1u << maxVertexAttribs) - 1);
+    m_statistics.issued += std::popcount(changed);
+    m_statistics.filtered += std::popcount(mask & ~changed);
+    for (uint32_t location = 0; location < maxVertexAttribs; location++) {
+        uint32_t bit = 1u << location;
+        if (!(changed & bit)) continue;
+
+        if (mask & bit) {
+            glEnableVertexAttribArray(location);
+        } else {
+            glDisableVertexAttribArray(location);
+        }
+    }
+    m_enabledVertexAttribs = mask;
+    m_knownVertexAttribs = (1u << maxVertexAttribs) - 1;
+}
+
+void OpenGLStateCache::bindVertexBuffer(GLuint binding, GLuint buffer, GLintptr offset, GLsizei stride) {
+    VertexBufferBinding vertexBuffer{buffer, offset, stride};
+    if (binding < maxVertexBindings && !issue(m_vertexBuffers[binding] != vertexBuffer)) {
+        return;
+    }
+
+    glBindVertexBuffer(binding, buffer, offset, stride);
+    if (binding < maxVertexBindings) {
+        m_vertexBuffers[binding] = vertexBuffer;
+    }
+}
+
+void OpenGLStateCache::bindIndexBuffer(GLuint buffer) {
+    if (issue(m_indexBuffer != buffer)) {
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, buffer);
+        m_indexBuffer = buffer;
+    }
+}
+
+void OpenGLStateCache::bindTextureUnit(GLuint unit, GLuint texture) {
+    if (unit < maxTextureUnits && !issue(m_textureUnits[unit] != texture)) {
+        return;
+    }
+
+    glBindTextureUnit(unit, texture);
+    if (unit < maxTextureUnits) {
+        m_textureUnits[unit] = texture;
+    }
+}
+
+void OpenGLStateCache::bindBufferRange(GLenum target, GLuint index, GLuint buffer, GLintptr offset,
+                                       GLsizeiptr size) {
+    std::array<BufferRange, maxBufferBindings>* ranges = bufferRanges(target);
+    BufferRange range{buffer, offset, size};
+    bool isCached = ranges != nullptr && index < maxBufferBindings;
+    if (isCached && !issue((*ranges)[index] != range)) {
+        return;
+    }
+
+    glBindBufferRange(target, index, buffer, offset, size);
+    if (isCached) {
+        (*ranges)[index] = range;
+    }
+}
+
+void OpenGLStateCache::bindTextureUnits(GLuint first, GLsizei count, const GLuint* textures) {
+    bool isCached = first + count <= maxTextureUnits;
+    if (isCached && !issue(!std::equal(textures, textures + count, m_textureUnits.begin() + first))) {
+        return;
+    }
+
+    glBindTextures(first, count, textures);
+    if (isCached) {
+        std::copy(textures, textures + count, m_textureUnits.begin() + first);
+    }
+}
+
+void OpenGLStateCache::bindBuffersRange(GLenum target, GLuint first, GLsizei count, const GLuint* buffers,
+                                        const GLintptr* offsets, const GLsizeiptr* sizes) {
+    std::array<BufferRange, maxBufferBindings>* ranges = bufferRanges(target);
+    bool isCached = ranges != nullptr && first + count <= maxBufferBindings;
+    if (isCached) {
+        bool changed = false;
+        for (GLsizei i = 0; i < count && !changed; i++) {
+            changed = (*ranges)[first + i] != BufferRange{buffers[i], offsets[i], sizes[i]};
+        }
+        if (!issue(changed)) {
+            return;
+        }
+    }
+
+    glBindBuffersRange(target, first, count, buffers, offsets, sizes);
+    if (isCached) {
+        for (GLsizei i = 0; i < count; i++) {
+            (*ranges)[first + i] = BufferRange{buffers[i], offsets[i], sizes[i]};
+        }
+    }
+}
+
+void OpenGLStateCache::bindFramebuffer(GLuint framebuffer) {
+    if (issue(m_framebuffer != framebuffer)) {
+        glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+        m_framebuffer = framebuffer;
+    }
+}
+
+void OpenGLStateCache::setViewport(GLint x, GLint y, GLsizei width, GLsizei height) {
+    std::array<GLint, 4> viewport = {x, y, width, height};
+    if (issue(m_viewport != viewport)) {
+        glViewport(x, y, width, height);
+        m_viewport = viewport;
+    }
+}
+
+void OpenGLStateCache::setDepthTest(bool enabled, GLenum func) {
+    if (issue(m_depthTest != (GLint)enabled)) {
+        enabled ? glEnable(GL_DEPTH_TEST) : glDisable(GL_DEPTH_TEST);
+        m_depthTest = enabled;
+    }
+
+    // the function is kept while the test is disabled, so is only set when it applies
+    if (enabled && issue(m_depthFunc != func)) {
+        glDepthFunc(func);
+        m_depthFunc = func;
+    }
+}
+
+void OpenGLStateCache::setDepthMask(bool enabled) {
+    if (issue(m_depthMask != (GLint)enabled)) {
+        glDepthMask(enabled ? GL_TRUE : GL_FALSE);
+        m_depthMask = enabled;
+    }
+}
+
+void OpenGLStateCache::setColorMask(bool enabled) {
+    if (issue(m_colorMask != (GLint)enabled)) {
+        GLboolean mask = enabled ? GL_TRUE : GL_FALSE;
+        glColorMask(mask, mask, mask, mask);
+        m_colorMask = enabled;
+    }
+}
+
+void OpenGLStateCache::setStencilTest(bool enabled, const Stencil& stencil) {
+    if (issue(m_stencilTest != (GLint)enabled)) {
+        enabled ? glEnable(GL_STENCIL_TEST) : glDisable(GL_STENCIL_TEST);
+        m_stencilTest = enabled;
+    }
+
+    // as for depth, the functions only apply while the test is enabled
+    if (enabled && issue(m_stencil != stencil, 2)) {
+        glStencilFunc(stencil.func, stencil.reference, stencil.compareMask);
+        glStencilOp(stencil.failOp, stencil.depthFailOp, stencil.passOp);
+        m_stencil = stencil;
+    }
+}
+
+void OpenGLStateCache::setStencilMask(GLuint mask) {
+    // unlike the functions, the write mask also applies to clears, so is set whether or not the test is enabled
+    if (issue(m_stencilMask != (GLint64)mask)) {
+        glStencilMask(mask);
+        m_stencilMask = mask;
+    }
+}
+
+void OpenGLStateCache::setBlend(bool enabled, const Blend& blend) {
+    if (issue(m_blend != (GLint)enabled)) {
+        enabled ? glEnable(GL_BLEND) : glDisable(GL_BLEND);
+        m_blend = enabled;
+    }
+
+    if (enabled && issue(m_blendFuncs != blend, 2)) {
+        glBlendFuncSeparate(blend.srcColor, blend.dstColor, blend.srcAlpha, blend.dstAlpha);
+        glBlendEquationSeparate(blend.colorEquation, blend.alphaEquation);
+        m_blendFuncs = blend;
+    }
+}
+
+void OpenGLStateCache::setCullFace(bool enabled, GLenum face, GLenum frontFace) {
+    if (issue(m_cullFace != (GLint)enabled)) {
+        enabled ? glEnable(GL_CULL_FACE) : glDisable(GL_CULL_FACE);
+        m_cullFace = enabled;
+    }
+
+    // the front face also applies to gl_FrontFacing, which no shader reads, so is only set for culling
+    if (enabled && issue(m_cullMode != face)) {
+        glCullFace(face);
+        m_cullMode = face;
+    }
+    if (enabled && issue(m_frontFace != frontFace)) {
+        glFrontFace(frontFace);
+        m_frontFace = frontFace;
+    }
+}
+
+void OpenGLStateCache::setPolygonMode(GLenum mode) {
+    if (issue(m_polygonMode != mode)) {
+        glPolygonMode(GL_FRONT_AND_BACK, mode);
+        m_polygonMode = mode;
+    }
+}
+
+void OpenGLStateCache::setPolygonOffset(GLfloat factor, GLfloat units) {
+    // the offset is enabled for every polygon mode at once, only while it is not zero
+    bool enabled = factor != 0.0f || units != 0.0f;
+    if (issue(m_polygonOffset != (GLint)enabled, 3)) {
+        if (enabled) {
+            glEnable(GL_POLYGON_OFFSET_FILL);
+            glEnable(GL_POLYGON_OFFSET_LINE);
+            glEnable(GL_POLYGON_OFFSET_POINT);
+        } else {
+            glDisable(GL_POLYGON_OFFSET_FILL);
+            glDisable(GL_POLYGON_OFFSET_LINE);
+            glDisable(GL_POLYGON_OFFSET_POINT);
+        }
+        m_polygonOffset = enabled;
+    }
+
+    std::array<GLfloat, 2> values = {factor, units};
+    if (enabled && issue(m_polygonOffsetValues != values)) {
+        glPolygonOffset(factor, units);
+        m_polygonOffsetValues = values;
+    }
+}
+
+std::array<OpenGLStateCache::BufferRange, OpenGLStateCache::maxBufferBindings>*
+OpenGLStateCache::bufferRanges(GLenum target) {
+    switch (target) {
+        case GL_UNIFORM_BUFFER:
+            return &m_uniformBuffers;
+        case GL_SHADER_STORAGE_BUFFER:
+            return &m_storageBuffers;
+        default:
+            return nullptr;
+    }
+}
+
+void OpenGLStateCache::invalidateBuffer(GLuint buffer) {
+    for (VertexBufferBinding& vertexBuffer: m_vertexBuffers) {
+        if (vertexBuffer.buffer == buffer) vertexBuffer.buffer = unknown;
+    }
+    if (m_indexBuffer == buffer) m_indexBuffer = unknown;
+    for (BufferRange& range: m_uniformBuffers) {
+        if (range.buffer == buffer) range.buffer = unknown;
+    }
+    for (BufferRange& range: m_storageBuffers) {
+        if (range.buffer == buffer) range.buffer = unknown;
+    }
+}
+
+void OpenGLStateCache::invalidateTexture(GLuint texture) {
+    for (GLuint& unit: m_textureUnits) {
+        if (unit == texture) unit = unknown;
+    }
+}
+
+void OpenGLStateCache::invalidateProgram(GLuint program) {
+    if (m_program == program) m_program = unknown;
+}
+
+void OpenGLStateCache::invalidateFramebuffer(GLuint framebuffer) {
+    if (m_framebuffer == framebuffer) m_framebuffer = unknown;
+}
+
+void OpenGLStateCache::reset() {
+    m_program = unknown;
+    m_vertexAttribFormats.fill(VertexAttribFormat{unknown, 0, 0, 0});
+    m_enabledVertexAttribs = 0;
+    m_knownVertexAttribs = 0;
+    m_vertexBuffers.fill(VertexBufferBinding{unknown, 0, 0});
+    m_indexBuffer = unknown;
+    m_textureUnits.fill(unknown);
+    m_uniformBuffers.fill(BufferRange{unknown, 0, 0});
+    m_storageBuffers.fill(BufferRange{unknown, 0, 0});
+    m_framebuffer = unknown;
+    m_viewport = {-1, -1, -1, -1};
+    m_depthTest = -1;
+    m_depthFunc = unknown;
+    m_depthMask = -1;
+    m_colorMask = -1;
+    m_stencilTest = -1;
+    m_stencil = Stencil{unknown, 0, 0, unknown, unknown, unknown};
+    m_stencilMask = -1;
+    m_blend = -1;
+    m_blendFuncs = Blend{unknown, unknown, unknown, unknown, unknown, unknown};
+    m_cullFace = -1;
+    m_cullMode = unknown;
+    m_frontFace = unknown;
+    m_polygonMode = unknown;
+    m_polygonOffset = -1;
+    m_polygonOffsetValues = {NAN, NAN};
+}
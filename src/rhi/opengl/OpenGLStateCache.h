@@ -0,0 +1,196 @@
+#ifndef OPENGL_RENDERER_OPENGLSTATECACHE_H
+#define OPENGL_RENDERER_OPENGLSTATECACHE_H
+
+
+/**
+ * A shadow copy of the OpenGL state set by the rhi, used to skip calls that would not change it.
+ *
+ * Each function issues its OpenGL calls only if the cached state differs, and counts each call as
+ * either issued or filtered. State that has not been set through the cache, or that may have been
+ * changed by deleting an object, is unknown and always issued. Bindings past the cached ranges are
+ * passed through without filtering.
+ */
+class OpenGLStateCache {
+public:
+    /**
+     * Counts of the calls made through the cache.
+     */
+    struct Statistics {
+        uint64_t issued;
+        uint64_t filtered;
+    };
+
+    /**
+     * The stencil test and operations, as set by glStencilFunc and glStencilOp.
+     */
+    struct Stencil {
+        GLenum func;
+        GLint reference;
+        GLuint compareMask;
+        GLenum failOp;
+        GLenum depthFailOp;
+        GLenum passOp;
+
+        bool operator==(const Stencil&) const = default;
+    };
+
+    /**
+     * The blend functions and equations, as set by glBlendFuncSeparate and glBlendEquationSeparate.
+     */
+    struct Blend {
+        GLenum srcColor;
+        GLenum dstColor;
+        GLenum colorEquation;
+        GLenum srcAlpha;
+        GLenum dstAlpha;
+        GLenum alphaEquation;
+
+        bool operator==(const Blend&) const = default;
+    };
+
+    OpenGLStateCache();
+    OpenGLStateCache(const OpenGLStateCache&) = delete;
+    ~OpenGLStateCache();
+
+    void useProgram(GLuint program);
+    void setVertexAttribFormat(GLuint location, GLuint binding, GLint size, GLenum type, GLuint offset);
+    void setEnabledVertexAttribs(uint32_t mask);
+    void bindVertexBuffer(GLuint binding, GLuint buffer, GLintptr offset, GLsizei stride);
+    void bindIndexBuffer(GLuint buffer);
+    void bindTextureUnit(GLuint unit, GLuint texture);
+    void bindBufferRange(GLenum target, GLuint index, GLuint buffer, GLintptr offset, GLsizeiptr size);
+
+    // multi-bind calls, issued whole if any binding in the range changes
+    void bindTextureUnits(GLuint first, GLsizei count, const GLuint* textures);
+    void bindBuffersRange(GLenum target, GLuint first, GLsizei count, const GLuint* buffers,
+                          const GLintptr* offsets, const GLsizeiptr* sizes);
+    void bindFramebuffer(GLuint framebuffer);
+    void setViewport(GLint x, GLint y, GLsizei width, GLsizei height);
+    void setDepthTest(bool enabled, GLenum func);
+    void setDepthMask(bool enabled);
+    void setColorMask(bool enabled);
+    void setStencilTest(bool enabled, const Stencil& stencil);
+    void setStencilMask(GLuint mask);
+    void setBlend(bool enabled, const Blend& blend);
+    void setCullFace(bool enabled, GLenum face, GLenum frontFace);
+    void setPolygonMode(GLenum mode);
+    void setPolygonOffset(GLfloat factor, GLfloat units);
+
+    /**
+     * Forgets any cached bindings of an object that is being deleted, since OpenGL resets them and
+     * may reuse the object's name.
+     *
+     * @param buffer the buffer being deleted
+     */
+    void invalidateBuffer(GLuint buffer);
+    void invalidateTexture(GLuint texture);
+    void invalidateProgram(GLuint program);
+    void invalidateFramebuffer(GLuint framebuffer);
+
+    /**
+     * Forgets all cached state, such as after OpenGL calls made outside of the cache.
+     */
+    void reset();
+
+    /**
+     * @returns the counts of calls issued and filtered since the statistics were last reset
+     */
+    const Statistics& statistics() const {
+        return m_statistics;
+    }
+
+    void resetStatistics() {
+        m_statistics = Statistics{};
+    }
+
+    /**
+     * @returns the cache of the current context, or nullptr if there is none
+     */
+    static OpenGLStateCache* current() {
+        return currentCache;
+    }
+
+    static constexpr uint32_t maxVertexAttribs = 16; // the minimum guaranteed by OpenGL
+    static constexpr uint32_t maxVertexBindings = 16;
+    static constexpr uint32_t maxTextureUnits = 32;
+    static constexpr uint32_t maxBufferBindings = 32;
+
+private:
+    static constexpr GLuint unknown = ~0u;
+
+    struct VertexAttribFormat {
+        GLuint binding;
+        GLint size;
+        GLenum type;
+        GLuint offset;
+
+        bool operator==(const VertexAttribFormat&) const = default;
+    };
+
+    struct VertexBufferBinding {
+        GLuint buffer;
+        GLintptr offset;
+        GLsizei stride;
+
+        bool operator==(const VertexBufferBinding&) const = default;
+    };
+
+    struct BufferRange {
+        GLuint buffer;
+        GLintptr offset;
+        GLsizeiptr size;
+
+        bool operator==(const BufferRange&) const = default;
+    };
+
+    /**
+     * @param target the indexed buffer target
+     * @returns the cached ranges bound to the target, or nullptr if they are not cached
+     */
+    std::array<BufferRange, maxBufferBindings>* bufferRanges(GLenum target);
+
+    /**
+     * Counts the calls that set a piece of state as issued if the state changed, or filtered otherwise.
+     *
+     * @param changed whether the calls change the state
+     * @param numCalls the number of OpenGL calls that set the state
+     * @returns whether the calls should be issued
+     */
+    bool issue(bool changed, uint32_t numCalls = 1) {
+        (changed ? m_statistics.issued : m_statistics.filtered) += numCalls;
+        return changed;
+    }
+
+    GLuint m_program;
+    std::array<VertexAttribFormat, maxVertexAttribs> m_vertexAttribFormats;
+    uint32_t m_enabledVertexAttribs;
+    uint32_t m_knownVertexAttribs; // the attributes whose enabled state is known
+    std::array<VertexBufferBinding, maxVertexBindings> m_vertexBuffers;
+    GLuint m_indexBuffer;
+    std::array<GLuint, maxTextureUnits> m_textureUnits;
+    std::array<BufferRange, maxBufferBindings> m_uniformBuffers;
+    std::array<BufferRange, maxBufferBindings> m_storageBuffers;
+    GLuint m_framebuffer;
+    std::array<GLint, 4> m_viewport;
+    GLint m_depthTest; // -1 if unknown
+    GLenum m_depthFunc;
+    GLint m_depthMask;
+    GLint m_colorMask;
+    GLint m_stencilTest;
+    Stencil m_stencil;
+    GLint64 m_stencilMask; // -1 if unknown
+    GLint m_blend;
+    Blend m_blendFuncs;
+    GLint m_cullFace;
+    GLenum m_cullMode;
+    GLenum m_frontFace;
+    GLenum m_polygonMode;
+    GLint m_polygonOffset;
+    std::array<GLfloat, 2> m_polygonOffsetValues; // the factor and units
+    Statistics m_statistics;
+
+    static OpenGLStateCache* currentCache;
+};
+
+
+#endif //OPENGL_RENDERER_OPENGLSTATECACHE_H
@@ -1,18 +1,29 @@
 #include "OpenGLTexture2D.h"
 #include "OpenGLFormat.h"
 
-std::unique_ptr<Texture2D> OpenGLRHI::createTexture2D(Format format, uint32_t width, uint32_t height) {
+std::unique_ptr<Texture2D> OpenGLRHI::createTexture2D(Format format, uint32_t width, uint32_t height,
+                                                      uint32_t numSamples, uint32_t numLevels) {
+    checkTexture2D(format, width, height, numSamples, numLevels);
+
     GLuint handle;
+    if (numSamples > 1) {
+        // multi-sampled textures cannot be sampled with filtering, so have no sampling parameters
+        glCreateTextures(GL_TEXTURE_2D_MULTISAMPLE, 1, &handle);
+        glTextureStorage2DMultisample(handle, (GLsizei)numSamples, toOpenGLFormat(format), (GLsizei)width,
+                                      (GLsizei)height, GL_TRUE);
+
+        return std::make_unique<OpenGLTexture2D>(handle, format, width, height, numSamples);
+    }
+
     glCreateTextures(GL_TEXTURE_2D, 1, &handle);
 
     // set texture parameters
     glTextureParameteri(handle, GL_TEXTURE_WRAP_S, GL_REPEAT);
     glTextureParameteri(handle, GL_TEXTURE_WRAP_T, GL_REPEAT);
-    glTextureParameteri(handle, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
-    glTextureParameteri(handle, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTextureParameteri(handle, GL_TEXTURE_MIN_FILTER, numLevels > 1 ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR);
 
     // allocate the texture storage
-    glTextureStorage2D(handle, 1, toOpenGLFormat(format), (GLsizei)width, (GLsizei)height);
+    glTextureStorage2D(handle, (GLsizei)numLevels, toOpenGLFormat(format), (GLsizei)width, (GLsizei)height);
 
-    return std::make_unique<OpenGLTexture2D>(handle, format, width, height);
+    return std::make_unique<OpenGLTexture2D>(handle, format, width, height, numSamples, numLevels);
 }
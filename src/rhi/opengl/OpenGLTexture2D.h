@@ -5,11 +5,17 @@
 
 class OpenGLTexture2D : public Texture2D, public Resource<GLuint> {
 public:
-    OpenGLTexture2D(GLuint handle, Format format, uint32_t width, uint32_t height)
-            : Resource<GLuint>(handle), Texture2D(format, width, height) {}
+    OpenGLTexture2D(GLuint handle, Format format, uint32_t width, uint32_t height, uint32_t numSamples,
+                    uint32_t numLevels = 1)
+            : Texture2D(format, width, height, numSamples, numLevels), Resource<GLuint>(handle) {}
 
     ~OpenGLTexture2D() override {
-        glDeleteTextures(1, &m_handle);
+        RHI::release([handle = m_handle] {
+            if (OpenGLStateCache* stateCache = OpenGLStateCache::current()) {
+                stateCache->invalidateTexture(handle);
+            }
+            glDeleteTextures(1, &handle);
+        });
     }
 
     constexpr static OpenGLTexture2D& from(Texture2D& texture2D) {
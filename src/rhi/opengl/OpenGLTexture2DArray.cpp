@@ -0,0 +1,23 @@
+#include "OpenGLTexture2DArray.h"
+#include "OpenGLFormat.h"
+
+std::unique_ptr<Texture2DArray> OpenGLRHI::createTexture2DArray(Format format, uint32_t width, uint32_t height,
+                                                                uint32_t numLayers, uint32_t numLevels) {
+    if (numLayers == 0) {
+        throw std::invalid_argument("Texture arrays must have at least one layer.");
+    }
+    checkTexture2D(format, width, height, 1, numLevels);
+
+    GLuint handle;
+    glCreateTextures(GL_TEXTURE_2D_ARRAY, 1, &handle);
+
+    // sampled as each layer would be as a 2d texture
+    glTextureParameteri(handle, GL_TEXTURE_WRAP_S, GL_REPEAT);
+    glTextureParameteri(handle, GL_TEXTURE_WRAP_T, GL_REPEAT);
+    glTextureParameteri(handle, GL_TEXTURE_MIN_FILTER, numLevels > 1 ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR);
+
+    glTextureStorage3D(handle, (GLsizei)numLevels, toOpenGLFormat(format), (GLsizei)width, (GLsizei)height,
+                       (GLsizei)numLayers);
+
+    return std::make_unique<OpenGLTexture2DArray>(handle, format, width, height, numLayers, numLevels);
+}
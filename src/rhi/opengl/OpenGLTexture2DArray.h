@@ -0,0 +1,27 @@
+#ifndef OPENGL_RENDERER_OPENGLTEXTURE2DARRAY_H
+#define OPENGL_RENDERER_OPENGLTEXTURE2DARRAY_H
+
+#include "OpenGLRHI.h"
+
+class OpenGLTexture2DArray : public Texture2DArray, public Resource<GLuint> {
+public:
+    OpenGLTexture2DArray(GLuint handle, Format format, uint32_t width, uint32_t height, uint32_t numLayers,
+                         uint32_t numLevels)
+            : Texture2DArray(format, width, height, numLayers, numLevels), Resource<GLuint>(handle) {}
+
+    ~OpenGLTexture2DArray() override {
+        RHI::release([handle = m_handle] {
+            if (OpenGLStateCache* stateCache = OpenGLStateCache::current()) {
+                stateCache->invalidateTexture(handle);
+            }
+            glDeleteTextures(1, &handle);
+        });
+    }
+
+    constexpr static OpenGLTexture2DArray& from(Texture2DArray& textureArray) {
+        return dynamic_cast<OpenGLTexture2DArray&>(textureArray);
+    }
+};
+
+
+#endif //OPENGL_RENDERER_OPENGLTEXTURE2DARRAY_H
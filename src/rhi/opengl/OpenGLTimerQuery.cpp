@@ -0,0 +1,38 @@
+#include "OpenGLTimerQuery.h"
+
+std::unique_ptr<TimerQuery> OpenGLRHI::createTimerQuery() {
+    GLuint handle;
+    glCreateQueries(GL_TIME_ELAPSED, 1, &handle);
+
+    return std::make_unique<OpenGLTimerQuery>(handle);
+}
+
+void OpenGLTimerQuery::begin() {
+    glBeginQuery(GL_TIME_ELAPSED, m_handle);
+    m_hasResult = false;
+}
+
+void OpenGLTimerQuery::end() {
+    glEndQuery(GL_TIME_ELAPSED);
+    m_hasResult = true;
+}
+
+bool OpenGLTimerQuery::isAvailable() {
+    if (!m_hasResult) {
+        return false;
+    }
+
+    GLint available;
+    glGetQueryObjectiv(m_handle, GL_QUERY_RESULT_AVAILABLE, &available);
+    return available == GL_TRUE;
+}
+
+uint64_t OpenGLTimerQuery::elapsed() {
+    if (!m_hasResult) {
+        throw std::domain_error("A timer query must be ended before its result is read.");
+    }
+
+    GLuint64 elapsed;
+    glGetQueryObjectui64v(m_handle, GL_QUERY_RESULT, &elapsed);
+    return elapsed;
+}
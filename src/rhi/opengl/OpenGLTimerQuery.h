@@ -0,0 +1,24 @@
+#ifndef OPENGL_RENDERER_OPENGLTIMERQUERY_H
+#define OPENGL_RENDERER_OPENGLTIMERQUERY_H
+
+#include "OpenGLRHI.h"
+
+class OpenGLTimerQuery : public TimerQuery, public Resource<GLuint> {
+public:
+    explicit OpenGLTimerQuery(GLuint handle) : Resource<GLuint>(handle), m_hasResult(false) {}
+
+    ~OpenGLTimerQuery() override {
+        glDeleteQueries(1, &m_handle);
+    }
+
+    void begin() override;
+    void end() override;
+    bool isAvailable() override;
+    uint64_t elapsed() override;
+
+private:
+    bool m_hasResult; // whether the query has been ended since it was created
+};
+
+
+#endif //OPENGL_RENDERER_OPENGLTIMERQUERY_H
@@ -0,0 +1,43 @@
+#include "SoftwareBuffer.h"
+#include "SoftwareRHI.h"
+
+SoftwareBuffer::~SoftwareBuffer() {
+    m_rhi.flush();
+}
+
+void* SoftwareBuffer::map(uint32_t offset, uint32_t size) {
+    if (!isMappable()) {
+        throw std::domain_error("Static buffers cannot be mapped.");
+    }
+    if ((uint64_t)offset + size > m_data.size()) {
+        throw std::out_of_range("The mapped range must be within the buffer.");
+    }
+
+    // writes through the mapping must not change what pending draws read
+    m_rhi.flush();
+    m_isMapped = true;
+    return m_data.data() + offset;
+}
+
+void SoftwareBuffer::unmap() {
+    m_isMapped = false;
+}
+
+bool SoftwareBuffer::isMapped() const {
+    return m_isMapped;
+}
+
+std::unique_ptr<Buffer> SoftwareRHI::createBuffer(uint32_t size, uint32_t stride, BufferUsage usage) {
+    return std::make_unique<SoftwareBuffer>(*this, size, stride, usage);
+}
+
+void SoftwareRHI::copyBuffer(const Buffer& source, uint32_t sourceOffset, Buffer& destination,
+                             uint32_t destinationOffset, uint32_t size) {
+    checkBufferRange(source, sourceOffset, size);
+    checkBufferRange(destination, destinationOffset, size);
+
+    // pending draws must read the destination as it was when they were issued
+    flush();
+    std::memmove(SoftwareBuffer::from(destination).data() + destinationOffset,
+                 SoftwareBuffer::from(source).data() + sourceOffset, size);
+}
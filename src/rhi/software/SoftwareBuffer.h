@@ -0,0 +1,49 @@
+#ifndef OPENGL_RENDERER_SOFTWAREBUFFER_H
+#define OPENGL_RENDERER_SOFTWAREBUFFER_H
+
+#include "../Buffer.h"
+
+class SoftwareRHI;
+
+/**
+ * A buffer stored in host memory, which draws read from directly. Pending draws are finished before
+ * the buffer is mapped or freed, so that they read the data they were issued with.
+ */
+class SoftwareBuffer : public Buffer {
+public:
+    SoftwareBuffer(SoftwareRHI& rhi, uint32_t size, uint32_t stride, BufferUsage usage)
+        : Buffer(size, stride, usage), m_rhi(rhi), m_data(size), m_isMapped(false) {}
+
+    ~SoftwareBuffer() override;
+
+    void* map(uint32_t offset, uint32_t size) override;
+    void unmap() override;
+    bool isMapped() const override;
+
+    /**
+     * @returns the contents of the buffer
+     */
+    const uint8_t* data() const {
+        return m_data.data();
+    }
+
+    uint8_t* data() {
+        return m_data.data();
+    }
+
+    static SoftwareBuffer& from(Buffer& buffer) {
+        return dynamic_cast<SoftwareBuffer&>(buffer);
+    }
+
+    static const SoftwareBuffer& from(const Buffer& buffer) {
+        return dynamic_cast<const SoftwareBuffer&>(buffer);
+    }
+
+private:
+    SoftwareRHI& m_rhi;
+    std::vector<uint8_t> m_data;
+    bool m_isMapped;
+};
+
+
+#endif //OPENGL_RENDERER_SOFTWAREBUFFER_H
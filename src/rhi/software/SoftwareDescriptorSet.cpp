@@ -0,0 +1,71 @@
+#include "SoftwareDescriptorSet.h"
+#include "SoftwareTexture2DArray.h"
+
+std::unique_ptr<DescriptorSet> SoftwareRHI::createDescriptorSet(std::vector<DescriptorSetBinding> bindings) {
+    for (auto binding : bindings) {
+        if (binding.binding >= SoftwareResources::maxBindings) {
+            throw std::invalid_argument("The binding index is not supported.");
+        }
+    }
+
+    return std::make_unique<SoftwareDescriptorSet>(DescriptorSetLayout(bindings));
+}
+
+void SoftwareDescriptorSet::bindTexture2D(uint32_t binding, Texture2D& texture2D) {
+    if (texture2D.numSamples() != 1) {
+        throw std::invalid_argument("Multi-sampled textures cannot be sampled.");
+    }
+    writeBinding(binding, DescriptorType::Texture2D);
+
+    m_descriptors[binding] = SoftwareDescriptor{
+        .buffer = nullptr,
+        .texture = &SoftwareTexture2D::from(texture2D),
+        .textureArray = nullptr,
+        .offset = 0,
+        .range = 0,
+    };
+}
+
+void SoftwareDescriptorSet::bindTexture2DArray(uint32_t binding, Texture2DArray& textureArray) {
+    writeBinding(binding, DescriptorType::Texture2DArray);
+
+    m_descriptors[binding] = SoftwareDescriptor{
+        .buffer = nullptr,
+        .texture = nullptr,
+        .textureArray = &SoftwareTexture2DArray::from(textureArray),
+        .offset = 0,
+        .range = 0,
+    };
+}
+
+void SoftwareDescriptorSet::bindUniformBuffer(uint32_t binding, const Buffer& buffer, uint32_t offset,
+                                              uint32_t range) {
+    if ((uint64_t)offset + range > buffer.size()) {
+        throw std::out_of_range("The bound range must be within the buffer.");
+    }
+    writeBinding(binding, DescriptorType::UniformBuffer);
+
+    m_descriptors[binding] = SoftwareDescriptor{
+        .buffer = &SoftwareBuffer::from(buffer),
+        .texture = nullptr,
+        .textureArray = nullptr,
+        .offset = offset,
+        .range = range,
+    };
+}
+
+void SoftwareDescriptorSet::bindStorageBuffer(uint32_t binding, const Buffer& buffer, uint32_t offset,
+                                              uint32_t range) {
+    if ((uint64_t)offset + range > buffer.size()) {
+        throw std::out_of_range("The bound range must be within the buffer.");
+    }
+    writeBinding(binding, DescriptorType::StorageBuffer);
+
+    m_descriptors[binding] = SoftwareDescriptor{
+        .buffer = &SoftwareBuffer::from(buffer),
+        .texture = nullptr,
+        .textureArray = nullptr,
+        .offset = offset,
+        .range = range,
+    };
+}
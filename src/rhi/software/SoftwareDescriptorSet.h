@@ -0,0 +1,41 @@
+#ifndef OPENGL_RENDERER_SOFTWAREDESCRIPTORSET_H
+#define OPENGL_RENDERER_SOFTWAREDESCRIPTORSET_H
+
+#include "SoftwareRHI.h"
+#include "SoftwareBuffer.h"
+
+struct SoftwareDescriptor {
+    const SoftwareBuffer* buffer; // nullptr for textures
+    const SoftwareTexture2D* texture; // nullptr unless binding a 2d texture
+    const SoftwareTexture2DArray* textureArray; // nullptr unless binding a 2d texture array
+    uint32_t offset;
+    uint32_t range;
+};
+
+/**
+ * A descriptor set that validates its descriptors against its bindings, and keeps them indexed by binding,
+ * so that dynamic offsets are applied in order of binding index when bound.
+ */
+class SoftwareDescriptorSet : public DescriptorSet {
+public:
+    explicit SoftwareDescriptorSet(DescriptorSetLayout layout) : DescriptorSet(layout) {}
+
+    void bindTexture2D(uint32_t binding, Texture2D& texture2D) override;
+    void bindTexture2DArray(uint32_t binding, Texture2DArray& textureArray) override;
+    void bindUniformBuffer(uint32_t binding, const Buffer& buffer, uint32_t offset, uint32_t range) override;
+    void bindStorageBuffer(uint32_t binding, const Buffer& buffer, uint32_t offset, uint32_t range) override;
+
+    const std::array<SoftwareDescriptor, SoftwareResources::maxBindings>& descriptors() const {
+        return m_descriptors;
+    }
+
+    static const SoftwareDescriptorSet& from(const DescriptorSet& descriptorSet) {
+        return dynamic_cast<const SoftwareDescriptorSet&>(descriptorSet);
+    }
+
+private:
+    std::array<SoftwareDescriptor, SoftwareResources::maxBindings> m_descriptors{};
+};
+
+
+#endif //OPENGL_RENDERER_SOFTWAREDESCRIPTORSET_H
@@ -0,0 +1,53 @@
+#ifndef OPENGL_RENDERER_SOFTWAREPIPELINE_H
+#define OPENGL_RENDERER_SOFTWAREPIPELINE_H
+
+#include "../Pipeline.h"
+#include "SoftwareShader.h"
+
+/**
+ * A pipeline of software shaders, which keeps its vertex layout to fetch attributes with.
+ */
+class SoftwarePipeline : public Pipeline {
+public:
+    SoftwarePipeline(Topology topology, DepthState depthState, StencilState stencilState, BlendState blendState,
+                     RasterState rasterState, bool colorWriteEnabled, const VertexLayout& layout,
+                     const SoftwareShader& vertexShader, const SoftwareShader& fragmentShader)
+        : Pipeline(topology, depthState, stencilState, blendState, rasterState, colorWriteEnabled), m_layout(layout),
+          m_vertexShader(vertexShader.vertexShader()), m_fragmentShader(fragmentShader.fragmentShader()),
+          m_numVaryings(fragmentShader.numVaryings()) {}
+
+    /**
+     * @returns the layout of the vertex attributes in the bound vertex buffers
+     */
+    const VertexLayout& layout() const {
+        return m_layout;
+    }
+
+    const SoftwareVertexShader& vertexShader() const {
+        return m_vertexShader;
+    }
+
+    const SoftwareFragmentShader& fragmentShader() const {
+        return m_fragmentShader;
+    }
+
+    /**
+     * @returns the number of varyings interpolated for the fragment shader
+     */
+    uint32_t numVaryings() const {
+        return m_numVaryings;
+    }
+
+    static const SoftwarePipeline& from(const Pipeline& pipeline) {
+        return dynamic_cast<const SoftwarePipeline&>(pipeline);
+    }
+
+private:
+    VertexLayout m_layout;
+    SoftwareVertexShader m_vertexShader;
+    SoftwareFragmentShader m_fragmentShader;
+    uint32_t m_numVaryings;
+};
+
+
+#endif //OPENGL_RENDERER_SOFTWAREPIPELINE_H
@@ -0,0 +1,601 @@
+#include "SoftwareRHI.h"
+#include "SoftwareBuffer.h"
+#include "SoftwareDescriptorSet.h"
+#include "SoftwareTexture2DArray.h"
+#include "SoftwareShaders.h"
+
+namespace {
+
+    /**
+     * Writes rgba8 pixels into a texture, as the source of a copy holds for every api, converting them
+     * to the texture's format.
+     *
+     * @param pixels the pixels, in rows from the bottom of the texture
+     * @param texture the texture to write
+     */
+    void storePixels(const uint8_t* pixels, SoftwareTexture2D& texture) {
+        Vector<uint32_t, 3> size = texture.dimensions();
+        for (uint32_t y = 0; y < size.y; y++) {
+            for (uint32_t x = 0; x < size.x; x++) {
+                texture.store(x, y, SoftwareTexture2D::loadPixel(Format::RGBA8, pixels + ((size_t)y * size.x + x) * 4));
+            }
+        }
+    }
+
+    /**
+     * Copies pixels of a texture's format to a region of it. The pixels are stored in the same format, so rows
+     * are copied as they are.
+     */
+    void copyPixels(const uint8_t* pixels, SoftwareTexture2D& texture, const TextureRegion& region) {
+        uint32_t width = texture.dimensions().x;
+        uint32_t rowSize = region.width * texture.pixelSize();
+        for (uint32_t y = 0; y < region.height; y++) {
+            std::memcpy(texture.data() + ((size_t)(region.y + y) * width + region.x) * texture.pixelSize(),
+                        pixels + (size_t)y * rowSize, rowSize);
+        }
+    }
+
+    /**
+     * A fence created after flushing every draw before it, so is already signaled.
+     */
+    class SoftwareFence : public Fence {
+    public:
+        bool isSignaled() override {
+            return true;
+        }
+
+        void wait() override {}
+    };
+
+    /**
+     * A timer query of the time spent rasterizing the draws issued between its begin and end, which are
+     * flushed at each end so that they are timed on their own.
+     */
+    class SoftwareTimerQuery : public TimerQuery {
+    public:
+        explicit SoftwareTimerQuery(SoftwareRHI& rhi) : m_rhi(rhi) {}
+
+        void begin() override {
+            m_rhi.flush();
+            m_begin = m_rhi.executionTime();
+            m_hasResult = false;
+        }
+
+        void end() override {
+            m_rhi.flush();
+            m_elapsed = m_rhi.executionTime() - m_begin;
+            m_hasResult = true;
+        }
+
+        bool isAvailable() override {
+            return m_hasResult;
+        }
+
+        uint64_t elapsed() override {
+            if (!m_hasResult) {
+                throw std::domain_error("A timer query must be ended before its result is read.");
+            }
+            return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(m_elapsed).count();
+        }
+
+    private:
+        SoftwareRHI& m_rhi;
+        Duration m_begin{};
+        Duration m_elapsed{};
+        bool m_hasResult = false;
+    };
+
+    class SoftwarePipelineBuilder : public PipelineBuilder {
+    public:
+        PipelineBuilder* setTopology(Topology topology) override {
+            m_topology = topology;
+            return this;
+        }
+
+        PipelineBuilder* setVertexShader(Shader& shader) override {
+            m_vertexShader = std::addressof(shader);
+            return this;
+        }
+
+        PipelineBuilder* setFragmentShader(Shader& shader) override {
+            m_fragmentShader = std::addressof(shader);
+            return this;
+        }
+
+        PipelineBuilder* setVertexLayout(const VertexLayout& layout) override {
+            m_vertexLayout = std::addressof(layout);
+            return this;
+        }
+
+        PipelineBuilder* setDepthState(const DepthState& depthState) override {
+            m_depthState = depthState;
+            return this;
+        }
+
+        PipelineBuilder* setStencilState(const StencilState& stencilState) override {
+            m_stencilState = stencilState;
+            return this;
+        }
+
+        PipelineBuilder* setBlendState(const BlendState& blendState) override {
+            m_blendState = blendState;
+            return this;
+        }
+
+        PipelineBuilder* setRasterState(const RasterState& rasterState) override {
+            m_rasterState = rasterState;
+            return this;
+        }
+
+        PipelineBuilder* setColorWriteEnabled(bool enabled) override {
+            m_colorWriteEnabled = enabled;
+            return this;
+        }
+
+        PipelineBuilder* setBinary(std::span<const uint8_t> binary) override {
+            throw std::domain_error("The api does not support pipeline binaries.");
+        }
+
+        std::unique_ptr<Pipeline> build() override {
+            if (m_vertexShader == nullptr || m_vertexShader->type() != ShaderType::Vertex ||
+                m_fragmentShader == nullptr || m_fragmentShader->type() != ShaderType::Fragment) {
+                throw std::invalid_argument("A pipeline requires a vertex and fragment shader.");
+            }
+            if (m_vertexLayout == nullptr) {
+                throw std::invalid_argument("A pipeline requires a vertex layout.");
+            }
+            if (m_rasterState.polygonMode != PolygonMode::Fill) {
+                throw std::invalid_argument("Software pipelines can only fill triangles.");
+            }
+            for (const VertexBinding& binding: m_vertexLayout->bindings) {
+                for (const VertexAttribute& attribute: binding.attributes) {
+                    if (attribute.location >= SoftwareVertexInput::maxAttributes) {
+                        throw std::invalid_argument("The vertex attribute location is not supported.");
+                    }
+                }
+            }
+
+            const SoftwareShader& vertexShader = SoftwareShader::from(*m_vertexShader);
+            const SoftwareShader& fragmentShader = SoftwareShader::from(*m_fragmentShader);
+            if (fragmentShader.numVaryings() > vertexShader.numVaryings()) {
+                throw std::invalid_argument("The fragment shader reads varyings the vertex shader does not write.");
+            }
+
+            return std::make_unique<SoftwarePipeline>(m_topology, m_depthState, m_stencilState, m_blendState,
+                                                      m_rasterState, m_colorWriteEnabled, *m_vertexLayout,
+                                                      vertexShader, fragmentShader);
+        }
+
+    private:
+        Topology m_topology = Topology::Triangles;
+        Shader* m_vertexShader = nullptr;
+        Shader* m_fragmentShader = nullptr;
+        const VertexLayout* m_vertexLayout = nullptr;
+        DepthState m_depthState;
+        StencilState m_stencilState;
+        BlendState m_blendState;
+        RasterState m_rasterState;
+        bool m_colorWriteEnabled = true;
+    };
+
+    class SoftwareFramebufferBuilder : public FramebufferBuilder {
+    public:
+        FramebufferBuilder* setDimensions(uint32_t width, uint32_t height) override {
+            m_width = width;
+            m_height = height;
+            return this;
+        }
+
+        FramebufferBuilder* setColorAttachment(std::unique_ptr<Texture2D> attachment) override {
+            m_colorAttachment = std::move(attachment);
+            return this;
+        }
+
+        FramebufferBuilder* setDepthAttachment(std::unique_ptr<Texture2D> attachment) override {
+            m_depthAttachment = std::move(attachment);
+            return this;
+        }
+
+        std::unique_ptr<Framebuffer> build() override {
+            if (m_colorAttachment == nullptr || m_width == 0 || m_height == 0) {
+                throw std::invalid_argument("A framebuffer requires a color attachment and positive dimensions.");
+            }
+
+            // the attachments are written directly, so must cover the framebuffer
+            auto covers = [this](const Texture2D& attachment) {
+                Vector<uint32_t, 3> dimensions = attachment.dimensions();
+                return dimensions.x >= m_width && dimensions.y >= m_height;
+            };
+            if (m_colorAttachment->format() == Format::D32F || !covers(*m_colorAttachment)) {
+                throw std::invalid_argument("The color attachment must hold color and cover the framebuffer.");
+            }
+            if (m_depthAttachment != nullptr && (m_depthAttachment->format() != Format::D32F ||
+                                                 !covers(*m_depthAttachment))) {
+                throw std::invalid_argument("The depth attachment must hold depth and cover the framebuffer.");
+            }
+
+            return std::make_unique<Framebuffer>(m_width, m_height, std::move(m_colorAttachment),
+                                                 std::move(m_depthAttachment));
+        }
+
+    private:
+        uint32_t m_width = 0;
+        uint32_t m_height = 0;
+        std::unique_ptr<Texture2D> m_colorAttachment;
+        std::unique_ptr<Texture2D> m_depthAttachment;
+    };
+
+} // namespace
+
+SoftwareRHI::SoftwareRHI() : m_pipeline(nullptr), m_vertexBuffers{}, m_indexBuffer(nullptr), m_resourcesChanged(true),
+                             m_framebuffer(nullptr), m_viewport{}, m_executionTime(Duration::zero()) {
+    registerSoftwareShaders(*this);
+}
+
+std::unique_ptr<Shader> SoftwareRHI::createShader(const void* code, size_t codeSize, ShaderType type,
+                                                  std::string_view name) {
+    auto shader = m_shaders.find(name);
+    if (shader == m_shaders.end() || shader->second.type() != type) {
+        throw std::invalid_argument("No software shader of the type is registered as '" + std::string(name) + "'.");
+    }
+
+    return std::make_unique<SoftwareShader>(shader->second);
+}
+
+std::unique_ptr<Fence> SoftwareRHI::createFence() {
+    flush();
+    return std::make_unique<SoftwareFence>();
+}
+
+std::unique_ptr<TimerQuery> SoftwareRHI::createTimerQuery() {
+    return std::make_unique<SoftwareTimerQuery>(*this);
+}
+
+std::unique_ptr<PipelineBuilder> SoftwareRHI::createPipelineBuilder() {
+    return std::make_unique<SoftwarePipelineBuilder>();
+}
+
+std::string SoftwareRHI::pipelineBinaryVersion() {
+    // pipelines are not compiled, so are as fast to build as to load
+    return {};
+}
+
+std::vector<uint8_t> SoftwareRHI::pipelineBinary(const Pipeline& pipeline) {
+    return {};
+}
+
+std::unique_ptr<FramebufferBuilder> SoftwareRHI::createFramebufferBuilder() {
+    return std::make_unique<SoftwareFramebufferBuilder>();
+}
+
+void SoftwareRHI::copyBufferToTexture2D(Buffer& source, Texture2D& destination) {
+    flush();
+
+    SoftwareTexture2D& texture = SoftwareTexture2D::from(destination);
+    Vector<uint32_t, 3> size = texture.dimensions();
+    if ((uint64_t)size.x * size.y * 4 > source.size()) {
+        throw std::out_of_range("The source buffer must hold every pixel of the texture.");
+    }
+
+    storePixels(SoftwareBuffer::from(source).data(), texture);
+}
+
+void SoftwareRHI::copyBufferToTexture2D(Buffer& source, uint32_t sourceOffset, Texture2D& destination,
+                                        uint32_t level, const TextureRegion& region) {
+    checkTextureCopy(source, sourceOffset, destination, level, region);
+    if (level != 0) {
+        return;
+    }
+    flush();
+
+    copyPixels(SoftwareBuffer::from(source).data() + sourceOffset, SoftwareTexture2D::from(destination), region);
+}
+
+void SoftwareRHI::copyBufferToTexture2DArray(Buffer& source, uint32_t sourceOffset, Texture2DArray& destination,
+                                             uint32_t layer, uint32_t level, const TextureRegion& region) {
+    checkTextureCopy(source, sourceOffset, destination, layer, level, region);
+    if (level != 0) {
+        return;
+    }
+    flush();
+
+    copyPixels(SoftwareBuffer::from(source).data() + sourceOffset,
+               SoftwareTexture2DArray::from(destination).layer(layer), region);
+}
+
+void SoftwareRHI::resolveTexture2D(Texture2D& source, const TextureRegion& sourceRegion, Texture2D& destination,
+                                   const TextureRegion& destinationRegion) {
+    bool isScaled = sourceRegion.width != destinationRegion.width || sourceRegion.height != destinationRegion.height;
+    bool isDepth = source.format() == Format::D32F;
+    if (destination.numSamples() != 1) {
+        throw std::invalid_argument("The destination of a resolve must be single-sampled.");
+    }
+    if (isDepth != (destination.format() == Format::D32F)) {
+        throw std::invalid_argument("Depth textures can only be resolved into depth textures.");
+    }
+    if (source.numSamples() > 1 && (isScaled || source.format() != destination.format())) {
+        throw std::invalid_argument("Multi-sampled textures can only be resolved into regions of the same size and format.");
+    }
+    if (destinationRegion.width == 0 || destinationRegion.height == 0) return;
+
+    flush();
+
+    // multi-sampled textures hold one sample per pixel, so are resolved by copying
+    const SoftwareTexture2D& softwareSource = SoftwareTexture2D::from(source);
+    SoftwareTexture2D& softwareDestination = SoftwareTexture2D::from(destination);
+    Vector<uint32_t, 3> sourceSize = softwareSource.dimensions();
+    float scaleX = (float)sourceRegion.width / (float)destinationRegion.width;
+    float scaleY = (float)sourceRegion.height / (float)destinationRegion.height;
+    ThreadPool::shared().parallelFor(destinationRegion.height, [&](uint32_t row) {
+        float sourceY = (float)sourceRegion.y + ((float)row + 0.5f) * scaleY;
+        for (uint32_t column = 0; column < destinationRegion.width; column++) {
+            float sourceX = (float)sourceRegion.x + ((float)column + 0.5f) * scaleX;
+
+            // depth cannot be filtered, so is always copied from the nearest pixel
+            Vec4 value;
+            if (isScaled && !isDepth) {
+                value = softwareSource.sample({sourceX / (float)sourceSize.x, sourceY / (float)sourceSize.y});
+            } else {
+                value = softwareSource.load(std::min((uint32_t)sourceX, sourceSize.x - 1),
+                                            std::min((uint32_t)sourceY, sourceSize.y - 1));
+            }
+            softwareDestination.store(destinationRegion.x + column, destinationRegion.y + row, value);
+        }
+    });
+}
+
+void SoftwareRHI::bindVertexBuffer(const Buffer& buffer, uint32_t binding, uint32_t offset, uint32_t stride) {
+    if (binding >= maxVertexBindings) {
+        throw std::invalid_argument("the vertex buffer binding is not supported");
+    }
+
+    m_vertexBuffers[binding] = VertexBufferBinding{&SoftwareBuffer::from(buffer), offset, stride};
+}
+
+void SoftwareRHI::bindIndexBuffer(const Buffer& buffer) {
+    m_indexBuffer = &SoftwareBuffer::from(buffer);
+}
+
+void SoftwareRHI::bindUniforms(UniformBlock& uniformBlock) {
+    if (uniformBlock.numFields() > SoftwareResources::maxUniformLocations) {
+        throw std::invalid_argument("The uniform block has more uniforms than are supported.");
+    }
+
+    // each uniform is at the location of its index, as for OpenGL
+    for (uint32_t i = 0; i < uniformBlock.numFields(); i++) {
+        const Uniform& uniform = uniformBlock[i];
+        if (uniform.size() > SoftwareResources::uniformLocationSize) {
+            throw std::invalid_argument("Uniforms can be at most the size of a mat4.");
+        }
+        uniform.write(m_resources.m_uniforms[i].data());
+    }
+    m_resourcesChanged = true;
+}
+
+void SoftwareRHI::bindDescriptorSet(const DescriptorSet& descriptorSet, std::span<const uint32_t> dynamicOffsets) {
+    const SoftwareDescriptorSet& softwareDescriptorSet = SoftwareDescriptorSet::from(descriptorSet);
+    const DescriptorSetLayout& layout = softwareDescriptorSet.layout();
+    size_t dynamicIndex = 0;
+
+    // bindings are walked in order of binding index, so dynamic offsets are applied in order
+    for (uint32_t bindings = softwareDescriptorSet.writtenBindings(); bindings != 0; bindings &= bindings - 1) {
+        uint32_t binding = std::countr_zero(bindings);
+        const SoftwareDescriptor& descriptor = softwareDescriptorSet.descriptors()[binding];
+        DescriptorType type = layout.type(binding);
+        if (type == DescriptorType::Texture2D) {
+            m_resources.m_textures[binding] = descriptor.texture;
+            continue;
+        }
+        if (type == DescriptorType::Texture2DArray) {
+            m_resources.m_textureArrays[binding] = descriptor.textureArray;
+            continue;
+        }
+
+        uint32_t offset = descriptor.offset;
+        if (type == DescriptorType::UniformBufferDynamic) {
+            if (dynamicIndex >= dynamicOffsets.size()) {
+                throw std::invalid_argument("A dynamic offset is required for each dynamic uniform buffer.");
+            }
+            offset += dynamicOffsets[dynamicIndex++];
+            if ((uint64_t)offset + descriptor.range > descriptor.buffer->size()) {
+                throw std::out_of_range("The bound range must be within the buffer.");
+            }
+        }
+
+        SoftwareResources::Range range{descriptor.buffer->data() + offset, descriptor.range};
+        if (type == DescriptorType::StorageBuffer) {
+            m_resources.m_storageBuffers[binding] = range;
+        } else {
+            m_resources.m_uniformBuffers[binding] = range;
+        }
+    }
+    m_resourcesChanged = true;
+}
+
+void SoftwareRHI::bindPipeline(const Pipeline& pipeline) {
+    m_pipeline = &SoftwarePipeline::from(pipeline);
+}
+
+void SoftwareRHI::bindFramebuffer(Framebuffer& framebuffer) {
+    if (m_framebuffer != std::addressof(framebuffer)) {
+        flush();
+    }
+    m_framebuffer = std::addressof(framebuffer);
+}
+
+void SoftwareRHI::bindDefaultFramebuffer() {
+    if (m_framebuffer != nullptr) {
+        flush();
+    }
+    m_framebuffer = nullptr;
+}
+
+void SoftwareRHI::setViewport(uint32_t x, uint32_t y, uint32_t width, uint32_t height) {
+    if (x + width > SoftwareTexture2D::maxDimension || y + height > SoftwareTexture2D::maxDimension) {
+        throw std::invalid_argument("Software viewports must be within 4096 pixels of the origin.");
+    }
+
+    m_viewport = {x, y, width, height};
+}
+
+void SoftwareRHI::clearAttachments(float r, float g, float b, float a, float depth) {
+    if (m_framebuffer == nullptr) return;
+
+    // the draws before the clear must be drawn before it
+    flush();
+    Timestamp begin = std::chrono::steady_clock::now();
+    ThreadPool& pool = ThreadPool::shared();
+    SoftwareRasterizer::clear(SoftwareTexture2D::from(m_framebuffer->colorAttachment()), {r, g, b, a}, pool);
+    if (m_framebuffer->depthAttachment() != nullptr) {
+        SoftwareRasterizer::clear(SoftwareTexture2D::from(*m_framebuffer->depthAttachment()), {depth, 0, 0, 0}, pool);
+    }
+    m_executionTime += std::chrono::steady_clock::now() - begin;
+}
+
+void SoftwareRHI::draw(uint32_t vertexCount, uint32_t baseVertex) {
+    if (m_pipeline == nullptr) {
+        throw std::domain_error("A pipeline must be bound for draw calls.");
+    }
+    if (m_framebuffer == nullptr || vertexCount == 0) return;
+
+    SoftwareDraw draw{};
+    draw.first = 0;
+    draw.count = vertexCount;
+    draw.baseVertex = baseVertex;
+    draw.indices = nullptr;
+    draw.indexSize = 0;
+    recordDraw(draw);
+}
+
+void SoftwareRHI::drawIndexed(uint32_t indexCount, uint32_t baseIndex, uint32_t baseVertex) {
+    if (m_indexBuffer == nullptr || m_pipeline == nullptr) {
+        throw std::domain_error("An index buffer and pipeline must be bound for indexed draw calls.");
+    }
+    uint32_t indexStride = m_indexBuffer->stride();
+    if (indexStride != 2 && indexStride != 4) {
+        throw std::domain_error("Only index sizes of 2 and 4 bytes are supported.");
+    }
+    if ((uint64_t)(baseIndex + indexCount) * indexStride > m_indexBuffer->size()) {
+        throw std::out_of_range("The drawn indices must be within the index buffer.");
+    }
+    if (m_framebuffer == nullptr || indexCount == 0) return;
+
+    SoftwareDraw draw{};
+    draw.first = baseIndex;
+    draw.count = indexCount;
+    draw.baseVertex = baseVertex;
+    draw.indices = m_indexBuffer->data();
+    draw.indexSize = indexStride;
+    recordDraw(draw);
+}
+
+void SoftwareRHI::recordDraw(SoftwareDraw& draw) {
+    // fetch each attribute from its binding, and limit the vertices to those every binding holds
+    draw.pipeline = m_pipeline;
+    draw.numVertices = UINT32_MAX;
+    for (const VertexBinding& binding: m_pipeline->layout().bindings) {
+        VertexBufferBinding bound{};
+        if (binding.binding < maxVertexBindings) {
+            bound = m_vertexBuffers[binding.binding];
+        }
+        if (bound.buffer == nullptr) {
+            throw std::domain_error("A vertex buffer must be bound for each binding of the pipeline.");
+        }
+
+        // vertices are the bound stride apart, as for OpenGL, rather than the stride of the layout
+        const SoftwareBuffer* buffer = bound.buffer;
+        uint32_t stride = bound.stride;
+        for (const VertexAttribute& attribute: binding.attributes) {
+            uint64_t end = (uint64_t)bound.offset + attribute.offset + formatSize(attribute.format);
+            uint32_t numVertices = 0;
+            if (buffer->size() >= end) {
+                numVertices = stride == 0 ? UINT32_MAX : (uint32_t)((buffer->size() - end) / stride + 1);
+            }
+            draw.numVertices = std::min(draw.numVertices, numVertices);
+            draw.attributes[attribute.location] = buffer->data() + bound.offset + attribute.offset;
+            draw.strides[attribute.location] = stride;
+            draw.attributeMask |= 1u << attribute.location;
+        }
+    }
+    if (draw.attributeMask == 0) {
+        draw.numVertices = draw.baseVertex + draw.count;
+    }
+
+    // draws with the same resources share a copy of them
+    if (m_resourcesChanged || m_pendingResources.empty()) {
+        m_pendingResources.push_back(m_resources);
+        m_resourcesChanged = false;
+    }
+    draw.resources = &m_pendingResources.back();
+
+    draw.viewport = m_viewport;
+    m_pendingDraws.push_back(draw);
+}
+
+void SoftwareRHI::beginGpuScope(std::string_view name) {
+    flush();
+    m_openScopes.push_back(OpenScope{
+        .name = std::string(name),
+        .begin = std::chrono::steady_clock::now(),
+        .executionTime = m_executionTime,
+    });
+}
+
+void SoftwareRHI::endGpuScope() {
+    if (m_openScopes.empty()) {
+        throw std::domain_error("There is no scope to end.");
+    }
+
+    flush();
+    const OpenScope& scope = m_openScopes.back();
+    m_profiler.record(scope.name, std::chrono::steady_clock::now() - scope.begin,
+                      m_executionTime - scope.executionTime);
+    m_openScopes.pop_back();
+}
+
+void SoftwareRHI::registerVertexShader(const std::string& name, SoftwareVertexShader shader, uint32_t numVaryings) {
+    if (numVaryings > SoftwareVertex::maxVaryings) {
+        throw std::invalid_argument("Software shaders can have at most 12 varyings.");
+    }
+
+    m_shaders.erase(name);
+    m_shaders.emplace(name, SoftwareShader(std::move(shader), numVaryings));
+}
+
+void SoftwareRHI::registerFragmentShader(const std::string& name, SoftwareFragmentShader shader,
+                                         uint32_t numVaryings) {
+    if (numVaryings > SoftwareVertex::maxVaryings) {
+        throw std::invalid_argument("Software shaders can have at most 12 varyings.");
+    }
+
+    m_shaders.erase(name);
+    m_shaders.emplace(name, SoftwareShader(std::move(shader), numVaryings));
+}
+
+void SoftwareRHI::flush() {
+    if (m_pendingDraws.empty()) return;
+
+    // the pending draws are dropped even if a shader throws, as their resources may no longer be valid
+    Timestamp begin = std::chrono::steady_clock::now();
+    try {
+        Framebuffer& framebuffer = *m_framebuffer;
+        Texture2D* depthAttachment = framebuffer.depthAttachment();
+        Vector<uint32_t, 2> dimensions = framebuffer.dimensions();
+        SoftwareTarget target{
+            .color = &SoftwareTexture2D::from(framebuffer.colorAttachment()),
+            .depth = depthAttachment != nullptr ? &SoftwareTexture2D::from(*depthAttachment) : nullptr,
+            .width = dimensions.x,
+            .height = dimensions.y,
+        };
+        m_rasterizer.draw(m_pendingDraws, target, ThreadPool::shared());
+    } catch (...) {
+        m_pendingDraws.clear();
+        m_pendingResources.clear();
+        m_resourcesChanged = true;
+        throw;
+    }
+    m_pendingDraws.clear();
+    m_pendingResources.clear();
+    m_resourcesChanged = true;
+    m_executionTime += std::chrono::steady_clock::now() - begin;
+}
@@ -0,0 +1,164 @@
+#ifndef OPENGL_RENDERER_SOFTWARERHI_H
+#define OPENGL_RENDERER_SOFTWARERHI_H
+
+#include <deque>
+#include "../RHI.h"
+#include "SoftwareRasterizer.h"
+
+class SoftwareBuffer;
+
+/**
+ * A render api that rasterizes on the cpu, across the shared thread pool, without a gpu or window.
+ *
+ * Shaders are C++ functions registered by name, which createShader() looks up in place of compiling
+ * code, so that the engine's pipelines are built unchanged. Ports of the engine's shaders are registered
+ * when the api is created, and applications can register their own.
+ *
+ * Draws are recorded with the resources bound when they were issued, and rasterized in batches when
+ * their results are needed: when the framebuffer changes or is cleared, when textures are copied or
+ * resolved, when buffers are mapped or resources are freed, and when fences, timer queries and scopes
+ * are created or ended. Fences are therefore always signaled, and gpu times are the time spent
+ * rasterizing. There is no window, so draws to the default framebuffer are discarded. Framebuffers have
+ * no stencil, so stencil state has no effect, and triangles can only be filled.
+ */
+class SoftwareRHI : public RHI {
+public:
+    SoftwareRHI();
+
+    std::unique_ptr<Buffer> createBuffer(uint32_t size, uint32_t stride, BufferUsage usage) override;
+    std::unique_ptr<Texture2D> createTexture2D(Format format, uint32_t width, uint32_t height,
+                                               uint32_t numSamples, uint32_t numLevels) override;
+    std::unique_ptr<Texture2DArray> createTexture2DArray(Format format, uint32_t width, uint32_t height,
+                                                         uint32_t numLayers, uint32_t numLevels) override;
+    std::unique_ptr<Shader> createShader(const void* code, size_t codeSize, ShaderType type,
+                                         std::string_view name) override;
+    std::unique_ptr<DescriptorSet> createDescriptorSet(std::vector<DescriptorSetBinding> bindings) override;
+    std::unique_ptr<Fence> createFence() override;
+    std::unique_ptr<TimerQuery> createTimerQuery() override;
+
+    std::unique_ptr<PipelineBuilder> createPipelineBuilder() override;
+    std::string pipelineBinaryVersion() override;
+    std::vector<uint8_t> pipelineBinary(const Pipeline& pipeline) override;
+    std::unique_ptr<FramebufferBuilder> createFramebufferBuilder() override;
+
+    void copyBufferToTexture2D(Buffer& source, Texture2D& destination) override;
+    void copyBufferToTexture2D(Buffer& source, uint32_t sourceOffset, Texture2D& destination, uint32_t level,
+                               const TextureRegion& region) override;
+    void copyBufferToTexture2DArray(Buffer& source, uint32_t sourceOffset, Texture2DArray& destination,
+                                    uint32_t layer, uint32_t level, const TextureRegion& region) override;
+    void copyBuffer(const Buffer& source, uint32_t sourceOffset, Buffer& destination, uint32_t destinationOffset,
+                    uint32_t size) override;
+    using RHI::resolveTexture2D;
+    void resolveTexture2D(Texture2D& source, const TextureRegion& sourceRegion, Texture2D& destination,
+                          const TextureRegion& destinationRegion) override;
+
+    using RHI::bindVertexBuffer;
+    void bindVertexBuffer(const Buffer& buffer, uint32_t binding, uint32_t offset, uint32_t stride) override;
+    void bindIndexBuffer(const Buffer& buffer) override;
+    void bindUniforms(UniformBlock& uniformBlock) override;
+    void bindDescriptorSet(const DescriptorSet& descriptorSet, std::span<const uint32_t> dynamicOffsets) override;
+    void bindPipeline(const Pipeline& pipeline) override;
+    void bindFramebuffer(Framebuffer& framebuffer) override;
+    void bindDefaultFramebuffer() override;
+
+    void setViewport(uint32_t x, uint32_t y, uint32_t width, uint32_t height) override;
+    void clearAttachments(float r, float g, float b, float a, float depth) override;
+
+    void draw(uint32_t vertexCount, uint32_t baseVertex) override;
+    void drawIndexed(uint32_t indexCount, uint32_t baseIndex, uint32_t baseVertex) override;
+
+    void beginGpuScope(std::string_view name) override;
+    void endGpuScope() override;
+
+    uint32_t uniformBufferAlignment() const override {
+        return 16; // shaders read host memory directly, which only needs to be aligned for vectors
+    }
+
+    uint32_t storageBufferAlignment() const override {
+        return 16;
+    }
+
+    /**
+     * Registers a vertex shader, which shaders created with the given name will run.
+     *
+     * @param name the name of the shader, such as the file name of the shader it replaces
+     * @param shader the function of the shader
+     * @param numVaryings the number of varyings the shader writes
+     * @throws std::invalid_argument if the shader writes too many varyings
+     */
+    void registerVertexShader(const std::string& name, SoftwareVertexShader shader, uint32_t numVaryings);
+
+    /**
+     * Registers a fragment shader, which shaders created with the given name will run.
+     *
+     * @param name the name of the shader, such as the file name of the shader it replaces
+     * @param shader the function of the shader
+     * @param numVaryings the number of varyings the shader reads
+     * @throws std::invalid_argument if the shader reads too many varyings
+     */
+    void registerFragmentShader(const std::string& name, SoftwareFragmentShader shader, uint32_t numVaryings);
+
+    /**
+     * Rasterizes the draws issued since the last flush, waiting for them to finish.
+     */
+    void flush();
+
+    /**
+     * @returns the total time spent rasterizing draws
+     */
+    Duration executionTime() const {
+        return m_executionTime;
+    }
+
+    static SoftwareRHI& from(RHI& rhi) {
+        return dynamic_cast<SoftwareRHI&>(rhi);
+    }
+
+private:
+    static constexpr uint32_t maxVertexBindings = 16;
+
+    /**
+     * The range of a buffer bound at a vertex binding.
+     */
+    struct VertexBufferBinding {
+        const SoftwareBuffer* buffer; // nullptr if none is bound
+        uint32_t offset;
+        uint32_t stride;
+    };
+
+    /**
+     * A scope that is timed once it ends, when its draws are flushed.
+     */
+    struct OpenScope {
+        std::string name;
+        Timestamp begin;
+        Duration executionTime; // the total when the scope began
+    };
+
+    /**
+     * Fetches the bound vertex buffers and resources for a draw, and records it to be rasterized.
+     *
+     * @param draw the draw, with its range of vertices or indices set
+     * @throws std::domain_error if a binding of the pipeline's vertex layout has no vertex buffer bound
+     */
+    void recordDraw(SoftwareDraw& draw);
+
+    std::map<std::string, SoftwareShader, std::less<>> m_shaders;
+    SoftwareRasterizer m_rasterizer;
+
+    const SoftwarePipeline* m_pipeline;
+    std::array<VertexBufferBinding, maxVertexBindings> m_vertexBuffers;
+    const SoftwareBuffer* m_indexBuffer;
+    SoftwareResources m_resources;
+    bool m_resourcesChanged; // since they were last recorded for a draw
+    Framebuffer* m_framebuffer; // nullptr for the default framebuffer
+    TextureRegion m_viewport;
+
+    std::deque<SoftwareResources> m_pendingResources; // kept at the same addresses as they are added
+    std::vector<SoftwareDraw> m_pendingDraws;
+    Duration m_executionTime;
+    std::vector<OpenScope> m_openScopes;
+};
+
+
+#endif //OPENGL_RENDERER_SOFTWARERHI_H
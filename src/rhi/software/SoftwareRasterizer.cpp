@@ -0,0 +1,834 @@
+#include "SoftwareRasterizer.h"
+#include <bit>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define SOFTWARE_RASTERIZER_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace {
+    constexpr int32_t subpixelScale = 16; // positions are snapped to 4 bits of sub-pixel precision
+    constexpr int32_t subpixelCenter = subpixelScale / 2;
+    constexpr float guardBand = 2.0f; // the multiple of the viewport that primitives are clipped to
+    constexpr float minW = 1e-5f;
+    constexpr int64_t edgeLimit = int64_t(1) << 30; // edges are stepped in 32 bits across a tile from within this
+    constexpr uint64_t minChunkPrimitives = 1024; // fewer are not worth a task of their own
+    constexpr uint32_t noVertex = UINT32_MAX;
+    constexpr uint32_t maxClippedVertices = 3 + 7; // each clip plane can add a vertex
+
+    /**
+     * The planes of the clip volume, and of the guard band around it, as bits of a vertex's outcode.
+     */
+    enum ClipPlane : uint32_t {
+        Left = 1 << 0,
+        Right = 1 << 1,
+        Bottom = 1 << 2,
+        Top = 1 << 3,
+        Near = 1 << 4,
+        Far = 1 << 5,
+        GuardLeft = 1 << 6,
+        GuardRight = 1 << 7,
+        GuardBottom = 1 << 8,
+        GuardTop = 1 << 9,
+        Behind = 1 << 10, // too close to w = 0 to divide by
+    };
+
+    // primitives crossing the sides of the clip volume are rasterized within the viewport instead of clipped
+    constexpr uint32_t clippedPlanes = Near | Far | GuardLeft | GuardRight | GuardBottom | GuardTop | Behind;
+
+    /**
+     * @param position a position in clip space
+     * @param plane a clip plane
+     * @returns the distance of the position inside of the plane, which is negative outside of it
+     */
+    float planeDistance(const Vec4& position, uint32_t plane) {
+        switch (plane) {
+            case Left: return position.x + position.w;
+            case Right: return position.w - position.x;
+            case Bottom: return position.y + position.w;
+            case Top: return position.w - position.y;
+            case Near: return position.z;
+            case Far: return position.w - position.z;
+            case GuardLeft: return position.x + guardBand * position.w;
+            case GuardRight: return guardBand * position.w - position.x;
+            case GuardBottom: return position.y + guardBand * position.w;
+            case GuardTop: return guardBand * position.w - position.y;
+            default: return position.w - minW;
+        }
+    }
+
+    /**
+     * @param position a position in clip space
+     * @returns the planes the position is outside of
+     */
+    uint32_t outcode(const Vec4& position) {
+        uint32_t code = 0;
+        for (uint32_t plane = Left; plane <= Behind; plane <<= 1) {
+            if (planeDistance(position, plane) < 0.0f) code |= plane;
+        }
+        return code;
+    }
+
+    uint32_t verticesPerPrimitive(Topology topology) {
+        switch (topology) {
+            case Topology::Points:
+                return 1;
+            case Topology::Lines:
+                return 2;
+            case Topology::Triangles:
+                return 3;
+        }
+        return 3;
+    }
+
+    uint32_t readIndex(const SoftwareDraw& draw, uint32_t element) {
+        if (draw.indexSize == 2) {
+            uint16_t index;
+            std::memcpy(&index, draw.indices + (size_t)element * 2, sizeof(index));
+            return index;
+        }
+        uint32_t index;
+        std::memcpy(&index, draw.indices + (size_t)element * 4, sizeof(index));
+        return index;
+    }
+
+    bool compareDepth(CompareOp op, float depth, float stored) {
+        switch (op) {
+            case CompareOp::Never: return false;
+            case CompareOp::Less: return depth < stored;
+            case CompareOp::Equal: return depth == stored;
+            case CompareOp::LessOrEqual: return depth <= stored;
+            case CompareOp::Greater: return depth > stored;
+            case CompareOp::NotEqual: return depth != stored;
+            case CompareOp::GreaterOrEqual: return depth >= stored;
+            case CompareOp::Always: return true;
+        }
+        return true;
+    }
+
+#ifdef SOFTWARE_RASTERIZER_SSE2
+    __m128 compareDepth(CompareOp op, __m128 depth, __m128 stored) {
+        switch (op) {
+            case CompareOp::Never: return _mm_setzero_ps();
+            case CompareOp::Less: return _mm_cmplt_ps(depth, stored);
+            case CompareOp::Equal: return _mm_cmpeq_ps(depth, stored);
+            case CompareOp::LessOrEqual: return _mm_cmple_ps(depth, stored);
+            case CompareOp::Greater: return _mm_cmpgt_ps(depth, stored);
+            case CompareOp::NotEqual: return _mm_cmpneq_ps(depth, stored);
+            case CompareOp::GreaterOrEqual: return _mm_cmpge_ps(depth, stored);
+            case CompareOp::Always: return _mm_castsi128_ps(_mm_set1_epi32(-1));
+        }
+        return _mm_castsi128_ps(_mm_set1_epi32(-1));
+    }
+#endif
+
+    float blendFactor(BlendFactor factor, float source, float destination, float sourceAlpha,
+                      float destinationAlpha) {
+        switch (factor) {
+            case BlendFactor::Zero: return 0.0f;
+            case BlendFactor::One: return 1.0f;
+            case BlendFactor::SrcColor: return source;
+            case BlendFactor::OneMinusSrcColor: return 1.0f - source;
+            case BlendFactor::DstColor: return destination;
+            case BlendFactor::OneMinusDstColor: return 1.0f - destination;
+            case BlendFactor::SrcAlpha: return sourceAlpha;
+            case BlendFactor::OneMinusSrcAlpha: return 1.0f - sourceAlpha;
+            case BlendFactor::DstAlpha: return destinationAlpha;
+            case BlendFactor::OneMinusDstAlpha: return 1.0f - destinationAlpha;
+        }
+        return 1.0f;
+    }
+
+    float blendComponent(BlendOp op, float source, float sourceFactor, float destination, float destinationFactor) {
+        switch (op) {
+            case BlendOp::Add: return source * sourceFactor + destination * destinationFactor;
+            case BlendOp::Subtract: return source * sourceFactor - destination * destinationFactor;
+            case BlendOp::ReverseSubtract: return destination * destinationFactor - source * sourceFactor;
+            case BlendOp::Min: return std::min(source, destination);
+            case BlendOp::Max: return std::max(source, destination);
+        }
+        return source;
+    }
+
+    /**
+     * Blends a fragment's color with the stored color, as OpenGL does.
+     */
+    Vec4 blend(const BlendState& state, const Vec4& source, const Vec4& destination) {
+        Vec4 result;
+        for (uint32_t i = 0; i < 4; i++) {
+            bool isAlpha = i == 3;
+            BlendFactor sourceFactor = isAlpha ? state.srcAlphaFactor : state.srcColorFactor;
+            BlendFactor destinationFactor = isAlpha ? state.dstAlphaFactor : state.dstColorFactor;
+            result[i] = blendComponent(isAlpha ? state.alphaOp : state.colorOp,
+                                       source[i], blendFactor(sourceFactor, source[i], destination[i], source.w,
+                                                              destination.w),
+                                       destination[i], blendFactor(destinationFactor, source[i], destination[i],
+                                                                   source.w, destination.w));
+        }
+        return result;
+    }
+
+    /**
+     * @param state the raster state of the triangle
+     * @param depthSlopeX the change in the triangle's depth per pixel in x
+     * @param depthSlopeY the change in the triangle's depth per pixel in y
+     * @param maxDepth the greatest magnitude of depth of the triangle's corners
+     * @returns the bias added to the triangle's depth, as for OpenGL's polygon offset with a floating point depth buffer
+     */
+    float depthBias(const RasterState& state, float depthSlopeX, float depthSlopeY, float maxDepth) {
+        float slope = std::max(std::abs(depthSlopeX), std::abs(depthSlopeY));
+        float resolution = maxDepth > 0.0f ? std::ldexp(1.0f, std::ilogb(maxDepth) - 23) : 0.0f;
+        return state.depthBiasSlope * slope + state.depthBiasConstant * resolution;
+    }
+
+    /**
+     * An attribute that varies linearly over the viewport, relative to a primitive's first corner.
+     */
+    struct Plane {
+        float origin;
+        float dx;
+        float dy;
+
+        float at(float x, float y) const {
+            return origin + dx * x + dy * y;
+        }
+    };
+
+    /**
+     * Where a primitive's fragments are written, and how they are tested.
+     */
+    struct Output {
+        Output(const SoftwareTarget& target, const SoftwareDraw& draw)
+            : color(target.color->data()), colorFormat(target.color->format()),
+              colorPixelSize(target.color->pixelSize()), colorWidth(target.color->dimensions().x),
+              depth(target.depth != nullptr ? (float*)target.depth->data() : nullptr),
+              depthWidth(target.depth != nullptr ? target.depth->dimensions().x : 0),
+              compareOp(draw.pipeline->depthState().compareOp),
+              depthTest(depth != nullptr && draw.pipeline->depthState().testEnabled),
+              depthWrite(depthTest && draw.pipeline->depthState().writeEnabled),
+              colorWrite(draw.pipeline->colorWriteEnabled()), blendState(draw.pipeline->blendState()),
+              fragmentShader(draw.pipeline->fragmentShader()), resources(*draw.resources) {}
+
+        /**
+         * Tests a fragment's depth, writing it if it passes and depth writes are enabled.
+         *
+         * @returns whether the fragment passed
+         */
+        bool testDepth(int32_t x, int32_t y, float z) const {
+            if (!depthTest) return true;
+            float& stored = depth[(size_t)y * depthWidth + x];
+            if (!compareDepth(compareOp, z, stored)) return false;
+            if (depthWrite) stored = z;
+            return true;
+        }
+
+        /**
+         * Shades a fragment and writes its color.
+         */
+        void shade(int32_t x, int32_t y, float z, float invW, const float* varyings) const {
+            SoftwareFragment fragment{
+                .coord = {(float)x + 0.5f, (float)y + 0.5f, z, invW},
+                .varyings = varyings,
+            };
+            Vec4 value = fragmentShader(resources, fragment);
+            uint8_t* pixel = color + ((size_t)y * colorWidth + x) * colorPixelSize;
+            if (blendState.enabled) {
+                value = blend(blendState, value, SoftwareTexture2D::loadPixel(colorFormat, pixel));
+            }
+            SoftwareTexture2D::storePixel(colorFormat, pixel, value);
+        }
+
+        uint8_t* color;
+        Format colorFormat;
+        uint32_t colorPixelSize;
+        uint32_t colorWidth;
+        float* depth;
+        uint32_t depthWidth;
+        CompareOp compareOp;
+        bool depthTest;
+        bool depthWrite;
+        bool colorWrite;
+        const BlendState& blendState;
+        const SoftwareFragmentShader& fragmentShader;
+        const SoftwareResources& resources;
+    };
+}
+
+void SoftwareRasterizer::draw(std::span<const SoftwareDraw> draws, const SoftwareTarget& target, ThreadPool& pool) {
+    if (draws.empty() || target.width == 0 || target.height == 0) return;
+
+    // find where each draw's primitives begin, so that chunks can divide them evenly
+    m_firstPrimitives.resize(draws.size() + 1);
+    m_firstPrimitives[0] = 0;
+    for (size_t i = 0; i < draws.size(); i++) {
+        uint32_t numPrimitives = draws[i].count / verticesPerPrimitive(draws[i].pipeline->topology());
+        m_firstPrimitives[i + 1] = m_firstPrimitives[i] + numPrimitives;
+    }
+    uint64_t numPrimitives = m_firstPrimitives.back();
+    if (numPrimitives == 0) return;
+
+    m_tilesX = (target.width + tileSize - 1) / tileSize;
+    m_tilesY = (target.height + tileSize - 1) / tileSize;
+    uint32_t numTiles = m_tilesX * m_tilesY;
+
+    // several chunks per thread balance the load, as primitives vary in cost
+    uint64_t maxChunks = ((uint64_t)pool.size() + 1) * 4;
+    m_numChunks = (uint32_t)std::clamp<uint64_t>(numPrimitives / minChunkPrimitives, 1, maxChunks);
+    if (m_chunks.size() < m_numChunks) {
+        m_chunks.resize(m_numChunks);
+    }
+    for (uint32_t i = 0; i < m_numChunks; i++) {
+        m_chunks[i].bins.resize(numTiles);
+    }
+
+    pool.parallelFor(m_numChunks, [&](uint32_t index) {
+        uint64_t first = numPrimitives * index / m_numChunks;
+        uint64_t end = numPrimitives * (index + 1) / m_numChunks;
+        processChunk(m_chunks[index], first, end, draws, target);
+    });
+
+    pool.parallelFor(numTiles, [&](uint32_t index) {
+        auto minX = (int32_t)((index % m_tilesX) * tileSize);
+        auto minY = (int32_t)((index / m_tilesX) * tileSize);
+        Tile tile{
+            .minX = minX,
+            .minY = minY,
+            .maxX = std::min(minX + (int32_t)tileSize, (int32_t)target.width) - 1,
+            .maxY = std::min(minY + (int32_t)tileSize, (int32_t)target.height) - 1,
+            .index = index,
+        };
+        rasterizeTile(tile, draws, target);
+    });
+}
+
+void SoftwareRasterizer::clear(SoftwareTexture2D& texture, const Vec4& value, ThreadPool& pool) {
+    Vector<uint32_t, 3> dimensions = texture.dimensions();
+    uint32_t pixelSize = texture.pixelSize();
+    uint8_t pixel[16];
+    SoftwareTexture2D::storePixel(texture.format(), pixel, value);
+
+    // each task fills a band of rows
+    constexpr uint32_t bandHeight = 64;
+    uint32_t numBands = (dimensions.y + bandHeight - 1) / bandHeight;
+    size_t rowSize = (size_t)dimensions.x * pixelSize;
+    pool.parallelFor(numBands, [&](uint32_t band) {
+        uint8_t* begin = texture.data() + band * bandHeight * rowSize;
+        uint8_t* end = texture.data() + std::min((band + 1) * bandHeight, dimensions.y) * rowSize;
+        for (uint8_t* destination = begin; destination < end; destination += pixelSize) {
+            std::memcpy(destination, pixel, pixelSize);
+        }
+    });
+}
+
+void SoftwareRasterizer::processChunk(Chunk& chunk, uint64_t firstPrimitive, uint64_t endPrimitive,
+                                      std::span<const SoftwareDraw> draws, const SoftwareTarget& target) const {
+    chunk.vertices.clear();
+    chunk.primitives.clear();
+    for (auto& bin: chunk.bins) {
+        bin.clear();
+    }
+
+    auto firstDraw = (uint32_t)(std::upper_bound(m_firstPrimitives.begin(), m_firstPrimitives.end(), firstPrimitive)
+                                - m_firstPrimitives.begin() - 1);
+    for (uint32_t d = firstDraw; d < draws.size() && m_firstPrimitives[d] < endPrimitive; d++) {
+        const SoftwareDraw& draw = draws[d];
+        uint64_t begin = std::max(firstPrimitive, m_firstPrimitives[d]) - m_firstPrimitives[d];
+        uint64_t end = std::min(endPrimitive, m_firstPrimitives[d + 1]) - m_firstPrimitives[d];
+        if (begin >= end) continue;
+
+        // vertices are shaded once per chunk, when first used
+        chunk.cache.assign(draw.numVertices, noVertex);
+        uint32_t numVertices = verticesPerPrimitive(draw.pipeline->topology());
+        for (uint64_t primitive = begin; primitive < end; primitive++) {
+            uint32_t vertices[3] = {};
+            bool isValid = true;
+            for (uint32_t i = 0; i < numVertices; i++) {
+                uint32_t element = draw.first + (uint32_t)primitive * numVertices + i;
+                uint32_t index = draw.indices != nullptr ? readIndex(draw, element) : element;
+
+                // vertices outside of the bound buffers are skipped, rather than read out of bounds
+                uint64_t vertex = (uint64_t)index + draw.baseVertex;
+                if (vertex >= draw.numVertices) {
+                    isValid = false;
+                    break;
+                }
+                vertices[i] = shadeVertex(chunk, draw, (uint32_t)vertex);
+            }
+
+            if (isValid) {
+                addPrimitive(chunk, d, draw, vertices, numVertices, target);
+            }
+        }
+    }
+}
+
+/**
+ * Finds the position of a vertex in the viewport, snapped to the sub-pixel grid.
+ */
+static void project(Vec4 position, const TextureRegion& viewport, float& x, float& y, float& z, float& invW,
+                    int32_t& fixedX, int32_t& fixedY) {
+    invW = 1.0f / position.w;
+    float viewportX = (float)viewport.x + (position.x * invW * 0.5f + 0.5f) * (float)viewport.width;
+    float viewportY = (float)viewport.y + (position.y * invW * 0.5f + 0.5f) * (float)viewport.height;
+    fixedX = (int32_t)std::lrint(viewportX * (float)subpixelScale);
+    fixedY = (int32_t)std::lrint(viewportY * (float)subpixelScale);
+    x = (float)fixedX / (float)subpixelScale;
+    y = (float)fixedY / (float)subpixelScale;
+    z = position.z * invW;
+}
+
+uint32_t SoftwareRasterizer::shadeVertex(Chunk& chunk, const SoftwareDraw& draw, uint32_t vertex) const {
+    uint32_t& slot = chunk.cache[vertex];
+    if (slot != noVertex) {
+        return slot;
+    }
+
+    SoftwareVertexInput input;
+    for (uint32_t mask = draw.attributeMask; mask != 0; mask &= mask - 1) {
+        auto location = (uint32_t)std::countr_zero(mask);
+        input.m_attributes[location] = draw.attributes[location] + (size_t)vertex * draw.strides[location];
+    }
+
+    ShadedVertex& shaded = chunk.vertices.emplace_back();
+    draw.pipeline->vertexShader()(*draw.resources, input, shaded.vertex);
+    shaded.outcode = outcode(shaded.vertex.position);
+    if ((shaded.outcode & clippedPlanes) == 0) {
+        project(shaded.vertex.position, draw.viewport, shaded.x, shaded.y, shaded.z, shaded.invW,
+                shaded.fixedX, shaded.fixedY);
+    }
+
+    slot = (uint32_t)chunk.vertices.size() - 1;
+    return slot;
+}
+
+void SoftwareRasterizer::addPrimitive(Chunk& chunk, uint32_t drawIndex, const SoftwareDraw& draw,
+                                      const uint32_t* vertices, uint32_t numVertices,
+                                      const SoftwareTarget& target) const {
+    // discard primitives wholly outside of any plane, and set up those wholly inside the clipped planes directly
+    uint32_t outsideAll = ~0u;
+    uint32_t outsideAny = 0;
+    for (uint32_t i = 0; i < numVertices; i++) {
+        uint32_t code = chunk.vertices[vertices[i]].outcode;
+        outsideAll &= code;
+        outsideAny |= code;
+    }
+    if (outsideAll != 0) return;
+    if ((outsideAny & clippedPlanes) == 0) {
+        setupPrimitive(chunk, drawIndex, draw, {vertices[0], vertices[1], vertices[2]}, numVertices, target);
+        return;
+    }
+
+    // otherwise clip the polygon, or line, against each plane it crosses in turn
+    uint32_t numVaryings = draw.pipeline->numVaryings();
+    auto interpolate = [numVaryings](const ShadedVertex& from, const ShadedVertex& to, float t) {
+        ShadedVertex result;
+        result.vertex.position = from.vertex.position + (to.vertex.position - from.vertex.position) * t;
+        for (uint32_t i = 0; i < numVaryings; i++) {
+            result.vertex.varyings[i] = from.vertex.varyings[i] + (to.vertex.varyings[i] - from.vertex.varyings[i]) * t;
+        }
+        return result;
+    };
+
+    std::array<ShadedVertex, maxClippedVertices> polygons[2];
+    uint32_t count = numVertices;
+    for (uint32_t i = 0; i < numVertices; i++) {
+        polygons[0][i] = chunk.vertices[vertices[i]];
+    }
+
+    uint32_t current = 0;
+    uint32_t numEdges = numVertices == 3 ? 3 : 1; // lines are not closed
+    for (uint32_t plane = Near; plane <= Behind; plane <<= 1) {
+        if ((outsideAny & clippedPlanes & plane) == 0) continue;
+
+        const auto& input = polygons[current];
+        auto& output = polygons[1 - current];
+        uint32_t outputCount = 0;
+        for (uint32_t i = 0; i < count; i++) {
+            const ShadedVertex& from = input[i];
+            float fromDistance = planeDistance(from.vertex.position, plane);
+            if (fromDistance >= 0.0f) {
+                output[outputCount++] = from;
+            }
+            if (i >= numEdges) continue;
+
+            // always interpolate from the inside, so that primitives sharing the edge split it identically
+            const ShadedVertex& to = input[(i + 1) % count];
+            float toDistance = planeDistance(to.vertex.position, plane);
+            if (fromDistance >= 0.0f && toDistance < 0.0f) {
+                output[outputCount++] = interpolate(from, to, fromDistance / (fromDistance - toDistance));
+            } else if (fromDistance < 0.0f && toDistance >= 0.0f) {
+                output[outputCount++] = interpolate(to, from, toDistance / (toDistance - fromDistance));
+            }
+        }
+
+        // a line's endpoints are kept in order, with the inside endpoint first if one was replaced
+        count = outputCount;
+        current = 1 - current;
+        if (count < numVertices) return;
+        if (numVertices == 2) {
+            numEdges = 1;
+            count = 2;
+        } else {
+            numEdges = count;
+        }
+    }
+
+    auto first = (uint32_t)chunk.vertices.size();
+    for (uint32_t i = 0; i < count; i++) {
+        ShadedVertex& vertex = chunk.vertices.emplace_back(polygons[current][i]);
+        project(vertex.vertex.position, draw.viewport, vertex.x, vertex.y, vertex.z, vertex.invW,
+                vertex.fixedX, vertex.fixedY);
+    }
+
+    if (numVertices == 2) {
+        setupPrimitive(chunk, drawIndex, draw, {first, first + 1, 0}, 2, target);
+        return;
+    }
+    for (uint32_t i = 1; i + 1 < count; i++) {
+        setupPrimitive(chunk, drawIndex, draw, {first, first + i, first + i + 1}, 3, target);
+    }
+}
+
+void SoftwareRasterizer::setupPrimitive(Chunk& chunk, uint32_t drawIndex, const SoftwareDraw& draw,
+                                        std::array<uint32_t, 3> vertices, uint32_t numVertices,
+                                        const SoftwareTarget& target) const {
+    // primitives are rasterized within the viewport and target
+    const TextureRegion& viewport = draw.viewport;
+    auto scissorMaxX = (int32_t)std::min(viewport.x + viewport.width, target.width) - 1;
+    auto scissorMaxY = (int32_t)std::min(viewport.y + viewport.height, target.height) - 1;
+
+    Primitive primitive{
+        .draw = drawIndex,
+        .vertices = vertices,
+        .edgeA = {},
+        .edgeB = {},
+        .edgeC = {},
+    };
+
+    if (numVertices == 3) {
+        const ShadedVertex* corners[3] = {&chunk.vertices[vertices[0]], &chunk.vertices[vertices[1]],
+                                          &chunk.vertices[vertices[2]]};
+        int64_t area = (int64_t)(corners[1]->fixedX - corners[0]->fixedX) * (corners[2]->fixedY - corners[0]->fixedY)
+                       - (int64_t)(corners[2]->fixedX - corners[0]->fixedX) * (corners[1]->fixedY - corners[0]->fixedY);
+        if (area == 0) return;
+
+        // culled faces are dropped, and clockwise triangles are reversed so that their edges face inwards
+        const RasterState& rasterState = draw.pipeline->rasterState();
+        bool isFrontFace = (area > 0) == (rasterState.frontFace == FrontFace::CounterClockwise);
+        if ((rasterState.cullMode == CullMode::Front && isFrontFace) ||
+            (rasterState.cullMode == CullMode::Back && !isFrontFace)) {
+            return;
+        }
+        if (area < 0) {
+            std::swap(primitive.vertices[1], primitive.vertices[2]);
+            std::swap(corners[1], corners[2]);
+        }
+
+        for (uint32_t i = 0; i < 3; i++) {
+            const ShadedVertex& from = *corners[i];
+            const ShadedVertex& to = *corners[(i + 1) % 3];
+            int32_t a = from.fixedY - to.fixedY;
+            int32_t b = to.fixedX - from.fixedX;
+            int64_t c = -(int64_t)a * from.fixedX - (int64_t)b * from.fixedY;
+
+            // pixel centers exactly on an edge are covered only by the triangle to its left or above it
+            bool isTopLeft = a > 0 || (a == 0 && b < 0);
+            primitive.edgeA[i] = a;
+            primitive.edgeB[i] = b;
+            primitive.edgeC[i] = isTopLeft ? c : c - 1;
+        }
+
+        // find the range of pixels whose centers the triangle could cover
+        int32_t minX = std::min({corners[0]->fixedX, corners[1]->fixedX, corners[2]->fixedX});
+        int32_t maxX = std::max({corners[0]->fixedX, corners[1]->fixedX, corners[2]->fixedX});
+        int32_t minY = std::min({corners[0]->fixedY, corners[1]->fixedY, corners[2]->fixedY});
+        int32_t maxY = std::max({corners[0]->fixedY, corners[1]->fixedY, corners[2]->fixedY});
+        primitive.minX = (minX - subpixelCenter + subpixelScale - 1) >> 4;
+        primitive.maxX = (maxX - subpixelCenter) >> 4;
+        primitive.minY = (minY - subpixelCenter + subpixelScale - 1) >> 4;
+        primitive.maxY = (maxY - subpixelCenter) >> 4;
+    } else {
+        // lines and points cover the pixels their positions are within
+        const ShadedVertex& from = chunk.vertices[vertices[0]];
+        const ShadedVertex& to = chunk.vertices[vertices[numVertices - 1]];
+        primitive.minX = (int32_t)std::floor(std::min(from.x, to.x));
+        primitive.maxX = (int32_t)std::floor(std::max(from.x, to.x));
+        primitive.minY = (int32_t)std::floor(std::min(from.y, to.y));
+        primitive.maxY = (int32_t)std::floor(std::max(from.y, to.y));
+    }
+
+    primitive.minX = std::max(primitive.minX, (int32_t)viewport.x);
+    primitive.maxX = std::min(primitive.maxX, scissorMaxX);
+    primitive.minY = std::max(primitive.minY, (int32_t)viewport.y);
+    primitive.maxY = std::min(primitive.maxY, scissorMaxY);
+    if (primitive.minX > primitive.maxX || primitive.minY > primitive.maxY) return;
+
+    chunk.primitives.push_back(primitive);
+    binPrimitive(chunk, (uint32_t)chunk.primitives.size() - 1, numVertices == 3);
+}
+
+void SoftwareRasterizer::binPrimitive(Chunk& chunk, uint32_t index, bool testEdges) const {
+    const Primitive& primitive = chunk.primitives[index];
+    uint32_t minTileX = primitive.minX / tileSize;
+    uint32_t maxTileX = primitive.maxX / tileSize;
+    uint32_t minTileY = primitive.minY / tileSize;
+    uint32_t maxTileY = primitive.maxY / tileSize;
+    testEdges = testEdges && (minTileX != maxTileX || minTileY != maxTileY);
+
+    for (uint32_t tileY = minTileY; tileY <= maxTileY; tileY++) {
+        for (uint32_t tileX = minTileX; tileX <= maxTileX; tileX++) {
+            // skip tiles outside of an edge at the pixel center where the edge is largest
+            if (testEdges) {
+                int32_t minX = std::max((int32_t)(tileX * tileSize), primitive.minX);
+                int32_t maxX = std::min((int32_t)((tileX + 1) * tileSize) - 1, primitive.maxX);
+                int32_t minY = std::max((int32_t)(tileY * tileSize), primitive.minY);
+                int32_t maxY = std::min((int32_t)((tileY + 1) * tileSize) - 1, primitive.maxY);
+
+                bool isOutside = false;
+                for (uint32_t i = 0; i < 3 && !isOutside; i++) {
+                    int64_t x = primitive.edgeA[i] > 0 ? maxX : minX;
+                    int64_t y = primitive.edgeB[i] > 0 ? maxY : minY;
+                    int64_t edge = primitive.edgeA[i] * (x * subpixelScale + subpixelCenter)
+                                   + primitive.edgeB[i] * (y * subpixelScale + subpixelCenter) + primitive.edgeC[i];
+                    isOutside = edge < 0;
+                }
+                if (isOutside) continue;
+            }
+
+            chunk.bins[tileY * m_tilesX + tileX].push_back(index);
+        }
+    }
+}
+
+void SoftwareRasterizer::rasterizeTile(const Tile& tile, std::span<const SoftwareDraw> draws,
+                                       const SoftwareTarget& target) const {
+    // chunks are in the order their primitives were drawn
+    for (uint32_t i = 0; i < m_numChunks; i++) {
+        const Chunk& chunk = m_chunks[i];
+        for (uint32_t index: chunk.bins[tile.index]) {
+            const Primitive& primitive = chunk.primitives[index];
+            const SoftwareDraw& draw = draws[primitive.draw];
+            switch (draw.pipeline->topology()) {
+                case Topology::Points:
+                    rasterizePoint(tile, chunk, primitive, draw, target);
+                    break;
+                case Topology::Lines:
+                    rasterizeLine(tile, chunk, primitive, draw, target);
+                    break;
+                case Topology::Triangles:
+                    rasterizeTriangle(tile, chunk, primitive, draw, target);
+                    break;
+            }
+        }
+    }
+}
+
+void SoftwareRasterizer::rasterizeTriangle(const Tile& tile, const Chunk& chunk, const Primitive& primitive,
+                                           const SoftwareDraw& draw, const SoftwareTarget& target) {
+    int32_t minX = std::max(primitive.minX, tile.minX);
+    int32_t maxX = std::min(primitive.maxX, tile.maxX);
+    int32_t minY = std::max(primitive.minY, tile.minY);
+    int32_t maxY = std::min(primitive.maxY, tile.maxY);
+    if (minX > maxX || minY > maxY) return;
+
+    Output output(target, draw);
+    if (!output.colorWrite && !output.depthWrite) return;
+
+    // attributes are planes over the viewport relative to the first corner, perspective-correct once divided by 1 / w
+    const ShadedVertex& v0 = chunk.vertices[primitive.vertices[0]];
+    const ShadedVertex& v1 = chunk.vertices[primitive.vertices[1]];
+    const ShadedVertex& v2 = chunk.vertices[primitive.vertices[2]];
+    float dx1 = v1.x - v0.x, dy1 = v1.y - v0.y;
+    float dx2 = v2.x - v0.x, dy2 = v2.y - v0.y;
+    float invArea = 1.0f / (dx1 * dy2 - dx2 * dy1);
+    auto plane = [&](float a0, float a1, float a2) {
+        float da1 = a1 - a0, da2 = a2 - a0;
+        return Plane{a0, (da1 * dy2 - da2 * dy1) * invArea, (da2 * dx1 - da1 * dx2) * invArea};
+    };
+    Plane depth = plane(v0.z, v1.z, v2.z);
+    const RasterState& rasterState = draw.pipeline->rasterState();
+    if (rasterState.depthBiasConstant != 0.0f || rasterState.depthBiasSlope != 0.0f) {
+        float maxDepth = std::max({std::abs(v0.z), std::abs(v1.z), std::abs(v2.z)});
+        depth.origin += depthBias(rasterState, depth.dx, depth.dy, maxDepth);
+    }
+    Plane invW = plane(v0.invW, v1.invW, v2.invW);
+
+    uint32_t numVaryings = draw.pipeline->numVaryings();
+    std::array<Plane, SoftwareVertex::maxVaryings> varyings;
+    bool hasVaryings = false; // found once a fragment is shaded
+    float values[SoftwareVertex::maxVaryings];
+
+    auto shade = [&](int32_t x, int32_t y, float z) {
+        if (!hasVaryings) {
+            for (uint32_t i = 0; i < numVaryings; i++) {
+                varyings[i] = plane(v0.vertex.varyings[i] * v0.invW, v1.vertex.varyings[i] * v1.invW,
+                                    v2.vertex.varyings[i] * v2.invW);
+            }
+            hasVaryings = true;
+        }
+
+        float relativeX = (float)x + 0.5f - v0.x;
+        float relativeY = (float)y + 0.5f - v0.y;
+        float fragmentInvW = invW.at(relativeX, relativeY);
+        float w = 1.0f / fragmentInvW;
+        for (uint32_t i = 0; i < numVaryings; i++) {
+            values[i] = varyings[i].at(relativeX, relativeY) * w;
+        }
+        output.shade(x, y, z, fragmentInvW, values);
+    };
+
+    // pixels are visited in aligned groups of four, masked to the triangle's range
+    int32_t startX = minX & ~3;
+    for (int32_t y = minY; y <= maxY; y++) {
+        float relativeY = (float)y + 0.5f - v0.y;
+        int64_t sampleY = (int64_t)y * subpixelScale + subpixelCenter;
+        int64_t sampleX = (int64_t)startX * subpixelScale + subpixelCenter;
+        int32_t edges[3];
+        for (uint32_t i = 0; i < 3; i++) {
+            int64_t edge = primitive.edgeA[i] * sampleX + primitive.edgeB[i] * sampleY + primitive.edgeC[i];
+            edges[i] = (int32_t)std::clamp(edge, -edgeLimit, edgeLimit);
+        }
+        float* depthRow = output.depth != nullptr ? output.depth + (size_t)y * output.depthWidth : nullptr;
+
+#ifdef SOFTWARE_RASTERIZER_SSE2
+        __m128i edge[3], edgeStep[3];
+        for (uint32_t i = 0; i < 3; i++) {
+            int32_t step = primitive.edgeA[i] * subpixelScale;
+            edge[i] = _mm_add_epi32(_mm_set1_epi32(edges[i]), _mm_setr_epi32(0, step, 2 * step, 3 * step));
+            edgeStep[i] = _mm_set1_epi32(4 * step);
+        }
+        __m128 laneOffsets = _mm_setr_ps(0.5f, 1.5f, 2.5f, 3.5f);
+        __m128 depthRowValue = _mm_set1_ps(depth.origin + depth.dy * relativeY);
+        __m128 depthDx = _mm_set1_ps(depth.dx);
+#endif
+
+        for (int32_t x = startX; x <= maxX; x += 4) {
+            uint32_t mask = 0xF;
+            if (x < minX) mask &= 0xFu << (minX - x);
+            if (x + 3 > maxX) mask &= 0xFu >> (x + 3 - maxX);
+
+            float z[4];
+#ifdef SOFTWARE_RASTERIZER_SSE2
+            // a pixel is covered if no edge is negative, which is found from their sign bits
+            __m128i outside = _mm_or_si128(_mm_or_si128(edge[0], edge[1]), edge[2]);
+            mask &= ~(uint32_t)_mm_movemask_ps(_mm_castsi128_ps(outside));
+            for (uint32_t i = 0; i < 3; i++) {
+                edge[i] = _mm_add_epi32(edge[i], edgeStep[i]);
+            }
+            if (mask == 0) continue;
+
+            __m128 relativeX = _mm_add_ps(_mm_set1_ps((float)x - v0.x), laneOffsets);
+            __m128 depths = _mm_add_ps(depthRowValue, _mm_mul_ps(depthDx, relativeX));
+            if (output.depthTest) {
+                bool isContiguous = x + 4 <= (int32_t)output.depthWidth;
+                float storedValues[4] = {};
+                if (!isContiguous) {
+                    for (int32_t i = 0; i < 4 && x + i < (int32_t)output.depthWidth; i++) {
+                        storedValues[i] = depthRow[x + i];
+                    }
+                }
+                __m128 stored = isContiguous ? _mm_loadu_ps(depthRow + x) : _mm_loadu_ps(storedValues);
+                mask &= (uint32_t)_mm_movemask_ps(compareDepth(output.compareOp, depths, stored));
+                if (mask == 0) continue;
+
+                // write depth before shading, as fragments cannot change it
+                if (output.depthWrite) {
+                    if (mask == 0xF && isContiguous) {
+                        _mm_storeu_ps(depthRow + x, depths);
+                    } else {
+                        _mm_storeu_ps(z, depths);
+                        for (uint32_t i = 0; i < 4; i++) {
+                            if (mask & (1u << i)) depthRow[x + i] = z[i];
+                        }
+                    }
+                }
+            }
+            _mm_storeu_ps(z, depths);
+#else
+            for (uint32_t i = 0; i < 4; i++) {
+                int32_t step = (int32_t)i * subpixelScale;
+                if ((edges[0] + primitive.edgeA[0] * step) < 0 || (edges[1] + primitive.edgeA[1] * step) < 0 ||
+                    (edges[2] + primitive.edgeA[2] * step) < 0) {
+                    mask &= ~(1u << i);
+                }
+            }
+            for (uint32_t i = 0; i < 3; i++) {
+                edges[i] += primitive.edgeA[i] * subpixelScale * 4;
+            }
+            if (mask == 0) continue;
+
+            for (uint32_t i = 0; i < 4; i++) {
+                if ((mask & (1u << i)) == 0) continue;
+                z[i] = depth.at((float)(x + (int32_t)i) + 0.5f - v0.x, relativeY);
+                if (!output.testDepth(x + (int32_t)i, y, z[i])) mask &= ~(1u << i);
+            }
+#endif
+            if (!output.colorWrite) continue;
+            for (uint32_t i = 0; i < 4; i++) {
+                if (mask & (1u << i)) shade(x + (int32_t)i, y, z[i]);
+            }
+        }
+    }
+}
+
+void SoftwareRasterizer::rasterizeLine(const Tile& tile, const Chunk& chunk, const Primitive& primitive,
+                                       const SoftwareDraw& draw, const SoftwareTarget& target) {
+    Output output(target, draw);
+    const ShadedVertex* from = &chunk.vertices[primitive.vertices[0]];
+    const ShadedVertex* to = &chunk.vertices[primitive.vertices[1]];
+
+    // step along the major axis, one pixel at a time, covering the pixels whose centers the line passes
+    bool isXMajor = std::abs(to->x - from->x) >= std::abs(to->y - from->y);
+    if (isXMajor ? to->x < from->x : to->y < from->y) {
+        std::swap(from, to);
+    }
+    float major0 = isXMajor ? from->x : from->y;
+    float major1 = isXMajor ? to->x : to->y;
+    float minor0 = isXMajor ? from->y : from->x;
+    float minor1 = isXMajor ? to->y : to->x;
+    float length = major1 - major0;
+    if (length <= 0.0f) return;
+
+    int32_t minMajor = std::max(isXMajor ? std::max(primitive.minX, tile.minX) : std::max(primitive.minY, tile.minY),
+                                (int32_t)std::ceil(major0 - 0.5f));
+    int32_t maxMajor = std::min(isXMajor ? std::min(primitive.maxX, tile.maxX) : std::min(primitive.maxY, tile.maxY),
+                                (int32_t)std::ceil(major1 - 0.5f) - 1);
+    int32_t minMinor = isXMajor ? std::max(primitive.minY, tile.minY) : std::max(primitive.minX, tile.minX);
+    int32_t maxMinor = isXMajor ? std::min(primitive.maxY, tile.maxY) : std::min(primitive.maxX, tile.maxX);
+
+    uint32_t numVaryings = draw.pipeline->numVaryings();
+    float values[SoftwareVertex::maxVaryings];
+    for (int32_t major = minMajor; major <= maxMajor; major++) {
+        float t = ((float)major + 0.5f - major0) / length;
+        auto minor = (int32_t)std::floor(minor0 + (minor1 - minor0) * t);
+        if (minor < minMinor || minor > maxMinor) continue;
+
+        int32_t x = isXMajor ? major : minor;
+        int32_t y = isXMajor ? minor : major;
+        float z = from->z + (to->z - from->z) * t;
+        if (!output.testDepth(x, y, z) || !output.colorWrite) continue;
+
+        float invW = from->invW + (to->invW - from->invW) * t;
+        for (uint32_t i = 0; i < numVaryings; i++) {
+            float fromValue = from->vertex.varyings[i] * from->invW;
+            float toValue = to->vertex.varyings[i] * to->invW;
+            values[i] = (fromValue + (toValue - fromValue) * t) / invW;
+        }
+        output.shade(x, y, z, invW, values);
+    }
+}
+
+void SoftwareRasterizer::rasterizePoint(const Tile& tile, const Chunk& chunk, const Primitive& primitive,
+                                        const SoftwareDraw& draw, const SoftwareTarget& target) {
+    // points are a single pixel, which the primitive's range is already limited to
+    if (primitive.minX < tile.minX || primitive.minX > tile.maxX ||
+        primitive.minY < tile.minY || primitive.minY > tile.maxY) {
+        return;
+    }
+
+    Output output(target, draw);
+    const ShadedVertex& vertex = chunk.vertices[primitive.vertices[0]];
+    if (output.testDepth(primitive.minX, primitive.minY, vertex.z) && output.colorWrite) {
+        output.shade(primitive.minX, primitive.minY, vertex.z, vertex.invW, vertex.vertex.varyings.data());
+    }
+}
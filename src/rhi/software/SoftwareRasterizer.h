@@ -0,0 +1,136 @@
+#ifndef OPENGL_RENDERER_SOFTWARERASTERIZER_H
+#define OPENGL_RENDERER_SOFTWARERASTERIZER_H
+
+#include "../../util/ThreadPool.h"
+#include "SoftwarePipeline.h"
+
+/**
+ * A draw call, with everything it reads resolved when it was issued.
+ */
+struct SoftwareDraw {
+    const SoftwarePipeline* pipeline;
+    const SoftwareResources* resources;
+    std::array<const uint8_t*, SoftwareVertexInput::maxAttributes> attributes; // of the 0th vertex, at each location
+    std::array<uint32_t, SoftwareVertexInput::maxAttributes> strides;
+    uint32_t attributeMask; // the locations that have attributes
+    uint32_t numVertices; // the number of vertices whose attributes are within the bound buffers
+    const uint8_t* indices; // nullptr for draws without indices
+    uint32_t indexSize; // in bytes
+    uint32_t first; // the first index, or vertex for draws without indices
+    uint32_t count; // the number of indices or vertices
+    uint32_t baseVertex; // added to each index
+    TextureRegion viewport; // in pixels from the bottom-left corner
+};
+
+/**
+ * The attachments drawn to, where the depth attachment may be nullptr. Both are at least as large as the target.
+ */
+struct SoftwareTarget {
+    SoftwareTexture2D* color;
+    SoftwareTexture2D* depth;
+    uint32_t width;
+    uint32_t height;
+};
+
+/**
+ * Rasterizes batches of draws on the cpu as a sort-middle tiled renderer.
+ *
+ * First, contiguous chunks of primitives are processed in parallel: vertices are shaded once per chunk,
+ * primitives are clipped and set up with fixed point edge functions, and binned into the screen tiles
+ * they overlap. Then, the tiles are rasterized in parallel, each reading the bins of every chunk in
+ * order, so that primitives are drawn in the order they were issued with no synchronization between
+ * tiles. Edge functions and depth tests are evaluated for four pixels at once with SSE2 where available,
+ * and fragment shaders are called for each pixel that passes the depth test.
+ */
+class SoftwareRasterizer {
+public:
+    static constexpr uint32_t tileSize = 64; // in pixels, a multiple of 4
+
+    /**
+     * Draws the given draws into the target, in order.
+     *
+     * @param draws the draws
+     * @param target the attachments to draw to
+     * @param pool the thread pool to draw with, which must not be running the caller
+     */
+    void draw(std::span<const SoftwareDraw> draws, const SoftwareTarget& target, ThreadPool& pool);
+
+    /**
+     * Sets every pixel of a texture to the same value.
+     *
+     * @param texture the texture to clear
+     * @param value the value of the pixels
+     * @param pool the thread pool to clear with, which must not be running the caller
+     */
+    static void clear(SoftwareTexture2D& texture, const Vec4& value, ThreadPool& pool);
+
+private:
+    /**
+     * A shaded vertex, and its position in the viewport once it is known to be within the clip volume.
+     */
+    struct ShadedVertex {
+        SoftwareVertex vertex;
+        float x, y; // in pixels, snapped to the sub-pixel grid
+        float z;
+        float invW;
+        int32_t fixedX, fixedY; // in sub-pixels
+        uint32_t outcode; // the clip planes the vertex is outside of
+    };
+
+    /**
+     * A primitive, set up for rasterization. Triangles are wound counter-clockwise, and have an edge
+     * function from each corner to the next that is non-negative at covered pixel centers.
+     */
+    struct Primitive {
+        uint32_t draw;
+        std::array<uint32_t, 3> vertices; // in the chunk's vertices
+        std::array<int32_t, 3> edgeA; // per sub-pixel step in x
+        std::array<int32_t, 3> edgeB; // per sub-pixel step in y
+        std::array<int64_t, 3> edgeC;
+        int32_t minX, minY, maxX, maxY; // the inclusive range of pixels that may be covered
+    };
+
+    /**
+     * The primitives of a contiguous range of those drawn, and the bins of the tiles they overlap.
+     */
+    struct Chunk {
+        std::vector<ShadedVertex> vertices;
+        std::vector<Primitive> primitives;
+        std::vector<std::vector<uint32_t>> bins; // indices of primitives, per tile
+        std::vector<uint32_t> cache; // the shaded vertex of each vertex of the current draw
+    };
+
+    /**
+     * The pixels of a tile, and the bins of its primitives.
+     */
+    struct Tile {
+        int32_t minX, minY, maxX, maxY; // inclusive
+        uint32_t index;
+    };
+
+    void processChunk(Chunk& chunk, uint64_t firstPrimitive, uint64_t endPrimitive,
+                      std::span<const SoftwareDraw> draws, const SoftwareTarget& target) const;
+    uint32_t shadeVertex(Chunk& chunk, const SoftwareDraw& draw, uint32_t vertex) const;
+    void addPrimitive(Chunk& chunk, uint32_t drawIndex, const SoftwareDraw& draw, const uint32_t* vertices,
+                      uint32_t numVertices, const SoftwareTarget& target) const;
+    void setupPrimitive(Chunk& chunk, uint32_t drawIndex, const SoftwareDraw& draw, std::array<uint32_t, 3> vertices,
+                        uint32_t numVertices, const SoftwareTarget& target) const;
+    void binPrimitive(Chunk& chunk, uint32_t index, bool testEdges) const;
+
+    void rasterizeTile(const Tile& tile, std::span<const SoftwareDraw> draws, const SoftwareTarget& target) const;
+    static void rasterizeTriangle(const Tile& tile, const Chunk& chunk, const Primitive& primitive,
+                                  const SoftwareDraw& draw, const SoftwareTarget& target);
+    static void rasterizeLine(const Tile& tile, const Chunk& chunk, const Primitive& primitive,
+                              const SoftwareDraw& draw, const SoftwareTarget& target);
+    static void rasterizePoint(const Tile& tile, const Chunk& chunk, const Primitive& primitive,
+                               const SoftwareDraw& draw, const SoftwareTarget& target);
+
+    std::vector<Chunk> m_chunks; // reused between draws
+    uint32_t m_numChunks = 0;
+    std::vector<uint64_t> m_firstPrimitives; // of each draw, followed by the total
+    uint32_t m_tilesX = 0;
+    uint32_t m_tilesY = 0;
+};
+
+
+#endif //OPENGL_RENDERER_SOFTWARERASTERIZER_H
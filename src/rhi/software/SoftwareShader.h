@@ -0,0 +1,223 @@
+#ifndef OPENGL_RENDERER_SOFTWARESHADER_H
+#define OPENGL_RENDERER_SOFTWARESHADER_H
+
+#include "../Shader.h"
+#include "SoftwareTexture2DArray.h"
+
+#include <bit>
+
+/**
+ * The resources a draw was issued with, which software shaders read from. Descriptor sets bind
+ * buffers and textures by binding index, and bound uniform blocks set plain uniforms by location.
+ */
+class SoftwareResources {
+public:
+    static constexpr uint32_t maxBindings = 8;
+    static constexpr uint32_t maxUniformLocations = 8;
+    static constexpr uint32_t uniformLocationSize = 64; // enough for a mat4
+
+    SoftwareResources() : m_uniformBuffers{}, m_storageBuffers{}, m_textures{}, m_textureArrays{}, m_uniforms{} {}
+
+    /**
+     * @param binding the binding index of the uniform buffer
+     * @returns the bound range of the uniform buffer, read as a struct matching its std140 layout
+     * @throws std::domain_error if the bound range is smaller than the struct
+     */
+    template<typename T>
+    const T& uniformBuffer(uint32_t binding) const {
+        const Range& range = m_uniformBuffers[binding];
+        if (range.size < sizeof(T)) {
+            throw std::domain_error("The uniform buffer bound is smaller than the shader reads.");
+        }
+        return *reinterpret_cast<const T*>(range.data);
+    }
+
+    /**
+     * @param binding the binding index of the storage buffer
+     * @returns the bound range of the storage buffer, as an array of structs matching their std430 layout
+     */
+    template<typename T>
+    std::span<const T> storageBuffer(uint32_t binding) const {
+        const Range& range = m_storageBuffers[binding];
+        return {reinterpret_cast<const T*>(range.data), range.size / sizeof(T)};
+    }
+
+    /**
+     * Samples the texture bound at the given binding index, which reads as opaque black if none is bound.
+     *
+     * @param binding the binding index of the texture
+     * @param texCoord the texture coordinates
+     * @returns the filtered value
+     */
+    Vec4 sample(uint32_t binding, const Vec2& texCoord) const {
+        const SoftwareTexture2D* texture = m_textures[binding];
+        return texture != nullptr ? texture->sample(texCoord) : Vec4(0.0f, 0.0f, 0.0f, 1.0f);
+    }
+
+    /**
+     * Samples a layer of the texture array bound at the given binding index, which reads as opaque black
+     * if none is bound.
+     *
+     * @param binding the binding index of the texture array
+     * @param texCoord the texture coordinates
+     * @param layer the layer to sample
+     * @returns the filtered value
+     */
+    Vec4 sample(uint32_t binding, const Vec2& texCoord, float layer) const {
+        const SoftwareTexture2DArray* textureArray = m_textureArrays[binding];
+        return textureArray != nullptr ? textureArray->sample(texCoord, layer) : Vec4(0.0f, 0.0f, 0.0f, 1.0f);
+    }
+
+    /**
+     * @param location the location of the plain uniform
+     * @returns the value of the uniform, such as a Vec4 or Mat4
+     */
+    template<typename T>
+    T uniform(uint32_t location) const {
+        static_assert(sizeof(T) <= uniformLocationSize, "Uniforms can be at most the size of a mat4.");
+        T value;
+        std::memcpy(&value, m_uniforms[location].data(), sizeof(T));
+        return value;
+    }
+
+private:
+    friend class SoftwareRHI;
+
+    struct Range {
+        const uint8_t* data;
+        uint32_t size;
+    };
+
+    std::array<Range, maxBindings> m_uniformBuffers;
+    std::array<Range, maxBindings> m_storageBuffers;
+    std::array<const SoftwareTexture2D*, maxBindings> m_textures;
+    std::array<const SoftwareTexture2DArray*, maxBindings> m_textureArrays;
+    std::array<std::array<uint8_t, uniformLocationSize>, maxUniformLocations> m_uniforms;
+};
+
+/**
+ * The attributes of a vertex, fetched from the bound vertex buffers by the pipeline's vertex layout.
+ */
+class SoftwareVertexInput {
+public:
+    static constexpr uint32_t maxAttributes = 16;
+
+    /**
+     * @param location the location of the attribute
+     * @returns the value of the attribute, such as a Vec3 for an RGB32F attribute
+     */
+    template<typename T>
+    T attribute(uint32_t location) const {
+        T value;
+        std::memcpy(&value, m_attributes[location], sizeof(T));
+        return value;
+    }
+
+private:
+    friend class SoftwareRasterizer;
+
+    std::array<const uint8_t*, maxAttributes> m_attributes{};
+};
+
+/**
+ * The outputs of a vertex shader: the clip space position, and varyings that are interpolated
+ * with perspective correction across each primitive for the fragment shader.
+ */
+struct SoftwareVertex {
+    static constexpr uint32_t maxVaryings = 12;
+
+    Vec4 position;
+    std::array<float, maxVaryings> varyings;
+
+    /**
+     * Writes a value to consecutive varyings.
+     *
+     * @param index the index of the first varying
+     * @param value the value, such as a float or Vec3
+     */
+    template<typename T>
+    void setVarying(uint32_t index, const T& value) {
+        static_assert(sizeof(T) % sizeof(float) == 0, "Varyings are made of floats.");
+        std::memcpy(varyings.data() + index, &value, sizeof(T));
+    }
+};
+
+/**
+ * The inputs of a fragment shader.
+ */
+struct SoftwareFragment {
+    Vec4 coord; // the pixel center, depth and inverse clip w, as in gl_FragCoord
+    const float* varyings;
+
+    /**
+     * Reads a value from consecutive interpolated varyings.
+     *
+     * @param index the index of the first varying
+     * @returns the value, such as a float or Vec3
+     */
+    template<typename T>
+    T varying(uint32_t index) const {
+        std::array<float, sizeof(T) / sizeof(float)> values;
+        std::copy_n(varyings + index, values.size(), values.begin());
+        return std::bit_cast<T>(values);
+    }
+};
+
+/**
+ * A vertex shader, which writes the outputs of a vertex given its attributes. Shaders are called
+ * from many threads at once, so must not modify shared state.
+ */
+using SoftwareVertexShader = std::function<void(const SoftwareResources& resources, const SoftwareVertexInput& input,
+                                                SoftwareVertex& output)>;
+
+/**
+ * A fragment shader, which returns the color of a fragment given its interpolated varyings. Shaders are
+ * called from many threads at once, so must not modify shared state.
+ */
+using SoftwareFragmentShader = std::function<Vec4(const SoftwareResources& resources,
+                                                  const SoftwareFragment& fragment)>;
+
+/**
+ * A shader stage implemented by a registered C++ function in place of compiled code.
+ */
+class SoftwareShader : public Shader {
+public:
+    SoftwareShader(SoftwareVertexShader vertexShader, uint32_t numVaryings)
+        : Shader(ShaderType::Vertex), m_vertexShader(std::move(vertexShader)), m_numVaryings(numVaryings) {}
+
+    SoftwareShader(SoftwareFragmentShader fragmentShader, uint32_t numVaryings)
+        : Shader(ShaderType::Fragment), m_fragmentShader(std::move(fragmentShader)), m_numVaryings(numVaryings) {}
+
+    /**
+     * @returns the function of a vertex shader, which is empty for other stages
+     */
+    const SoftwareVertexShader& vertexShader() const {
+        return m_vertexShader;
+    }
+
+    /**
+     * @returns the function of a fragment shader, which is empty for other stages
+     */
+    const SoftwareFragmentShader& fragmentShader() const {
+        return m_fragmentShader;
+    }
+
+    /**
+     * @returns the number of varyings written by a vertex shader, or read by a fragment shader
+     */
+    uint32_t numVaryings() const {
+        return m_numVaryings;
+    }
+
+    static const SoftwareShader& from(const Shader& shader) {
+        return dynamic_cast<const SoftwareShader&>(shader);
+    }
+
+private:
+    SoftwareVertexShader m_vertexShader;
+    SoftwareFragmentShader m_fragmentShader;
+    uint32_t m_numVaryings;
+};
+
+
+#endif //OPENGL_RENDERER_SOFTWARESHADER_H
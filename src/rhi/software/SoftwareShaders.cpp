@@ -0,0 +1,173 @@
+#include "SoftwareShaders.h"
+#include "SoftwareRHI.h"
+#include "../UniformLayout.h"
+
+/*
+ * Each shader mirrors the GLSL shader of the same name in shaders/, and should be changed with it.
+ * Uniform and storage buffers are read as structs matching their std140 and std430 layouts.
+ */
+
+namespace {
+
+    struct DrawUniforms {
+        Mat4 modelViewProjection;
+        Mat4 model;
+    };
+
+    struct PointLight {
+        Vec3 position;
+        float radius;
+        Vec3 color;
+        float intensity;
+    };
+
+    struct LightClusters {
+        Mat4 view;
+        Vector<uint32_t, 4> clusterCounts; // x, y and z counts, then the number of lights
+        Vec4 depthSlicing; // depth scale and bias, then the viewport width and height
+    };
+
+    static_assert(hasBufferLayout<BufferLayout::Std140>(
+            BufferField(&DrawUniforms::modelViewProjection, offsetof(DrawUniforms, modelViewProjection)),
+            BufferField(&DrawUniforms::model, offsetof(DrawUniforms, model))));
+    static_assert(hasBufferLayout<BufferLayout::Std430>(
+            BufferField(&PointLight::position, offsetof(PointLight, position)),
+            BufferField(&PointLight::radius, offsetof(PointLight, radius)),
+            BufferField(&PointLight::color, offsetof(PointLight, color)),
+            BufferField(&PointLight::intensity, offsetof(PointLight, intensity))));
+    static_assert(hasBufferLayout<BufferLayout::Std140>(
+            BufferField(&LightClusters::view, offsetof(LightClusters, view)),
+            BufferField(&LightClusters::clusterCounts, offsetof(LightClusters, clusterCounts)),
+            BufferField(&LightClusters::depthSlicing, offsetof(LightClusters, depthSlicing))));
+
+    Vec4 transform(const Mat4& matrix, const Vec4& vector) {
+        return matrix.column(0) * vector.x + matrix.column(1) * vector.y + matrix.column(2) * vector.z +
+               matrix.column(3) * vector.w;
+    }
+
+    /**
+     * Transforms a position to clip space, as every pass does, so that its depth is the same in each of them.
+     */
+    Vec4 clipPosition(const Mat4& modelViewProjection, const Vec3& position) {
+        return transform(modelViewProjection, {position.x, position.y, position.z, 1.0f});
+    }
+
+    void registerScene(SoftwareRHI& rhi) {
+        rhi.registerVertexShader("shader.vert", [](const SoftwareResources& resources, const SoftwareVertexInput& input,
+                                                   SoftwareVertex& output) {
+            const DrawUniforms& uniforms = resources.uniformBuffer<DrawUniforms>(0);
+            Vec3 position = input.attribute<Vec3>(0);
+            Vec3 normal = input.attribute<Vec3>(2);
+
+            // lighting is computed in world space
+            Vec4 worldPosition = transform(uniforms.model, {position.x, position.y, position.z, 1.0f});
+            Vec4 worldNormal = transform(uniforms.model, {normal.x, normal.y, normal.z, 0.0f});
+            output.setVarying(0, Vec3(worldPosition.x, worldPosition.y, worldPosition.z));
+            output.setVarying(3, input.attribute<Vec2>(1));
+            output.setVarying(5, Vec3(worldNormal.x, worldNormal.y, worldNormal.z));
+            output.position = clipPosition(uniforms.modelViewProjection, position);
+        }, 8);
+
+        rhi.registerFragmentShader("shader.frag", [](const SoftwareResources& resources,
+                                                     const SoftwareFragment& fragment) {
+            const LightClusters& clusters = resources.uniformBuffer<LightClusters>(1);
+            std::span<const PointLight> lights = resources.storageBuffer<PointLight>(2);
+            std::span<const Vector<uint32_t, 2>> ranges = resources.storageBuffer<Vector<uint32_t, 2>>(3);
+            std::span<const uint32_t> lightIndices = resources.storageBuffer<uint32_t>(4);
+            Vec3 position = fragment.varying<Vec3>(0);
+            Vec3 normal = fragment.varying<Vec3>(5);
+
+            Vec3 albedo(0.6f, 0.6f, 0.6f);
+            float ambientLevel = 0.1f;
+
+            // find the cluster of the fragment from its screen position and view depth
+            const Vector<uint32_t, 4>& counts = clusters.clusterCounts;
+            const Vec4& slicing = clusters.depthSlicing;
+            float depth = -transform(clusters.view, {position.x, position.y, position.z, 1.0f}).z;
+            uint32_t clusterX = (uint32_t)(fragment.coord.x / slicing.z * (float)counts.x);
+            uint32_t clusterY = (uint32_t)(fragment.coord.y / slicing.w * (float)counts.y);
+            uint32_t clusterZ = (uint32_t)std::max(std::floor(std::log(depth) * slicing.x + slicing.y), 0.0f);
+            clusterX = std::min(clusterX, counts.x - 1);
+            clusterY = std::min(clusterY, counts.y - 1);
+            clusterZ = std::min(clusterZ, counts.z - 1);
+            size_t cluster = ((size_t)clusterZ * counts.y + clusterY) * counts.x + clusterX;
+            Vector<uint32_t, 2> range = cluster < ranges.size() ? ranges[cluster] : Vector<uint32_t, 2>();
+
+            Vec3 normalDir = normal * (1.0f / std::sqrt(std::max(normal.dot(normal), 1e-12f)));
+            Vec3 lighting(ambientLevel, ambientLevel, ambientLevel);
+            for (uint32_t i = 0; i < range.y && range.x + i < lightIndices.size(); i++) {
+                uint32_t lightIndex = lightIndices[range.x + i];
+                if (lightIndex >= lights.size()) continue;
+                const PointLight& light = lights[lightIndex];
+
+                Vec3 toLight = light.position - position;
+                float lightDistance = std::sqrt(toLight.dot(toLight));
+                float falloff = std::clamp(1.0f - lightDistance / light.radius, 0.0f, 1.0f);
+                float diffuseLevel = std::max(normalDir.dot(toLight * (1.0f / std::max(lightDistance, 1e-4f))), 0.0f);
+
+                lighting = lighting + light.color * (light.intensity * diffuseLevel * falloff * falloff);
+            }
+
+            return Vec4(albedo.x * lighting.x, albedo.y * lighting.y, albedo.z * lighting.z, 1.0f);
+        }, 8);
+
+        rhi.registerVertexShader("depth.vert", [](const SoftwareResources& resources, const SoftwareVertexInput& input,
+                                                  SoftwareVertex& output) {
+            const Mat4& modelViewProjection = resources.uniformBuffer<Mat4>(0);
+            output.position = clipPosition(modelViewProjection, input.attribute<Vec3>(0));
+        }, 0);
+
+        rhi.registerFragmentShader("depth.frag", [](const SoftwareResources& resources,
+                                                    const SoftwareFragment& fragment) {
+            return Vec4(0.0f, 0.0f, 0.0f, 1.0f); // only depth is written
+        }, 0);
+
+        rhi.registerVertexShader("grid.vert", [](const SoftwareResources& resources, const SoftwareVertexInput& input,
+                                                 SoftwareVertex& output) {
+            const DrawUniforms& uniforms = resources.uniformBuffer<DrawUniforms>(0);
+            output.position = clipPosition(uniforms.modelViewProjection, input.attribute<Vec3>(0));
+        }, 0);
+
+        rhi.registerFragmentShader("grid.frag", [](const SoftwareResources& resources,
+                                                   const SoftwareFragment& fragment) {
+            return Vec4(0.7f, 0.7f, 0.7f, 1.0f);
+        }, 0);
+    }
+
+    void registerUI(SoftwareRHI& rhi) {
+        // ui-image and ui-rect are drawn with a projection, at the location of the first plain uniform
+        auto projectedVertex = [](const SoftwareResources& resources, const SoftwareVertexInput& input,
+                                  SoftwareVertex& output) {
+            Vec3 position = input.attribute<Vec3>(0);
+            output.setVarying(0, input.attribute<Vec2>(1));
+            output.position = transform(resources.uniform<Mat4>(0), {position.x, position.y, position.z, 1.0f});
+        };
+        auto texturedFragment = [](const SoftwareResources& resources, const SoftwareFragment& fragment) {
+            Vec4 color = resources.sample(0, fragment.varying<Vec2>(0));
+            return Vec4(color.x, color.y, color.z, 1.0f);
+        };
+
+        rhi.registerVertexShader("ui-image.vert", projectedVertex, 2);
+        rhi.registerFragmentShader("ui-image.frag", texturedFragment, 2);
+
+        rhi.registerVertexShader("ui-rect.vert", projectedVertex, 2);
+        rhi.registerFragmentShader("ui-rect.frag", [](const SoftwareResources& resources,
+                                                      const SoftwareFragment& fragment) {
+            return resources.uniform<Vec4>(1);
+        }, 0);
+
+        rhi.registerVertexShader("ui.vert", [](const SoftwareResources& resources, const SoftwareVertexInput& input,
+                                               SoftwareVertex& output) {
+            Vec3 position = input.attribute<Vec3>(0);
+            output.setVarying(0, input.attribute<Vec2>(1));
+            output.position = {position.x, position.y, position.z, 1.0f};
+        }, 2);
+        rhi.registerFragmentShader("ui.frag", texturedFragment, 2);
+    }
+
+} // namespace
+
+void registerSoftwareShaders(SoftwareRHI& rhi) {
+    registerScene(rhi);
+    registerUI(rhi);
+}
@@ -0,0 +1,14 @@
+#ifndef OPENGL_RENDERER_SOFTWARESHADERS_H
+#define OPENGL_RENDERER_SOFTWARESHADERS_H
+
+class SoftwareRHI;
+
+/**
+ * Registers ports of the engine's shaders, named by the file names of the shaders they replace.
+ *
+ * @param rhi the software api to register the shaders with
+ */
+void registerSoftwareShaders(SoftwareRHI& rhi);
+
+
+#endif //OPENGL_RENDERER_SOFTWARESHADERS_H
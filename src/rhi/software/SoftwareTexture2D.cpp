@@ -0,0 +1,179 @@
+#include "SoftwareTexture2D.h"
+#include "SoftwareRHI.h"
+
+namespace {
+    /**
+     * Encodes a float with a 5-bit exponent and the given number of mantissa bits and no sign, as in the
+     * channels of half and packed float formats, rounding to nearest. Negative values encode as zero, and
+     * values too large for the format as its largest value.
+     */
+    uint32_t encodeSmallFloat(float value, uint32_t mantissaBits) {
+        if (!(value > 0.0f)) {
+            return 0;
+        }
+
+        uint32_t maxBits = (30u << mantissaBits) | ((1u << mantissaBits) - 1);
+        int exponent;
+        float fraction = std::frexp(value, &exponent);
+        int biasedExponent = exponent - 1 + 15;
+        if (biasedExponent >= 31) {
+            return maxBits;
+        }
+        if (biasedExponent <= 0) {
+            return (uint32_t)std::lround(std::ldexp(value, 14 + (int)mantissaBits));
+        }
+
+        // a mantissa that rounds up to the next power of two carries into the exponent
+        auto mantissa = (uint32_t)std::lround((fraction * 2.0f - 1.0f) * (float)(1u << mantissaBits));
+        return std::min(((uint32_t)biasedExponent << mantissaBits) + mantissa, maxBits);
+    }
+
+    float decodeSmallFloat(uint32_t bits, uint32_t mantissaBits) {
+        uint32_t exponent = bits >> mantissaBits;
+        uint32_t mantissa = bits & ((1u << mantissaBits) - 1);
+        if (exponent == 0) {
+            return std::ldexp((float)mantissa, -14 - (int)mantissaBits);
+        }
+        if (exponent == 31) {
+            return mantissa == 0 ? INFINITY : NAN;
+        }
+        return std::ldexp(1.0f + (float)mantissa / (float)(1u << mantissaBits), (int)exponent - 15);
+    }
+
+    uint16_t encodeHalf(float value) {
+        uint16_t sign = std::signbit(value) ? 0x8000 : 0;
+        return sign | (uint16_t)encodeSmallFloat(std::abs(value), 10);
+    }
+
+    float decodeHalf(uint16_t bits) {
+        float value = decodeSmallFloat(bits & 0x7FFF, 10);
+        return (bits & 0x8000) != 0 ? -value : value;
+    }
+}
+
+uint32_t formatSize(Format format) {
+    if (isBlockCompressed(format)) {
+        throw std::invalid_argument("Software textures do not support block-compressed formats.");
+    }
+    return formatBlockSize(format);
+}
+
+SoftwareTexture2D::SoftwareTexture2D(SoftwareRHI& rhi, Format format, uint32_t width, uint32_t height,
+                                     uint32_t numSamples, uint32_t numLevels)
+    : Texture2D(format, width, height, numSamples, numLevels), m_rhi(rhi), m_width(width), m_height(height),
+      m_pixelSize(formatSize(format)), m_data((size_t)width * height * m_pixelSize) {}
+
+SoftwareTexture2D::~SoftwareTexture2D() {
+    m_rhi.flush();
+}
+
+Vec4 SoftwareTexture2D::sample(const Vec2& texCoord) const {
+    if (m_data.empty()) {
+        return {0.0f, 0.0f, 0.0f, 1.0f};
+    }
+
+    // filter between the centers of the four nearest pixels
+    float x = texCoord.x * (float)m_width - 0.5f;
+    float y = texCoord.y * (float)m_height - 0.5f;
+    float floorX = std::floor(x);
+    float floorY = std::floor(y);
+    float fractionX = x - floorX;
+    float fractionY = y - floorY;
+
+    auto wrap = [](float coordinate, uint32_t size) {
+        auto wrapped = (int64_t)coordinate % (int64_t)size;
+        return (uint32_t)(wrapped < 0 ? wrapped + size : wrapped);
+    };
+    uint32_t x0 = wrap(floorX, m_width);
+    uint32_t y0 = wrap(floorY, m_height);
+    uint32_t x1 = x0 + 1 == m_width ? 0 : x0 + 1;
+    uint32_t y1 = y0 + 1 == m_height ? 0 : y0 + 1;
+
+    Vec4 bottom = load(x0, y0) * (1.0f - fractionX) + load(x1, y0) * fractionX;
+    Vec4 top = load(x0, y1) * (1.0f - fractionX) + load(x1, y1) * fractionX;
+    return bottom * (1.0f - fractionY) + top * fractionY;
+}
+
+Vec4 SoftwareTexture2D::loadPixel(Format format, const uint8_t* pixel) {
+    float values[4] = {0.0f, 0.0f, 0.0f, 1.0f};
+    switch (format) {
+        case Format::RGB8:
+        case Format::RGBA8:
+            for (uint32_t i = 0; i < formatSize(format); i++) {
+                values[i] = (float)pixel[i] / 255.0f;
+            }
+            break;
+        case Format::RG32F:
+        case Format::RGB32F:
+        case Format::RGBA32F:
+        case Format::D32F:
+            std::memcpy(values, pixel, formatSize(format));
+            break;
+        case Format::RGBA16F: {
+            uint16_t halves[4];
+            std::memcpy(halves, pixel, sizeof(halves));
+            for (uint32_t i = 0; i < 4; i++) {
+                values[i] = decodeHalf(halves[i]);
+            }
+            break;
+        }
+        case Format::R11G11B10F: {
+            uint32_t packed;
+            std::memcpy(&packed, pixel, sizeof(packed));
+            values[0] = decodeSmallFloat(packed & 0x7FF, 6);
+            values[1] = decodeSmallFloat((packed >> 11) & 0x7FF, 6);
+            values[2] = decodeSmallFloat(packed >> 22, 5);
+            break;
+        }
+        default:
+            throw std::invalid_argument("Software textures do not support block-compressed formats.");
+    }
+    return {values[0], values[1], values[2], values[3]};
+}
+
+void SoftwareTexture2D::storePixel(Format format, uint8_t* pixel, const Vec4& value) {
+    const float values[4] = {value.x, value.y, value.z, value.w};
+    switch (format) {
+        case Format::RGB8:
+        case Format::RGBA8:
+            for (uint32_t i = 0; i < formatSize(format); i++) {
+                pixel[i] = (uint8_t)(std::clamp(values[i], 0.0f, 1.0f) * 255.0f + 0.5f);
+            }
+            break;
+        case Format::RG32F:
+        case Format::RGB32F:
+        case Format::RGBA32F:
+        case Format::D32F:
+            std::memcpy(pixel, values, formatSize(format));
+            break;
+        case Format::RGBA16F: {
+            uint16_t halves[4];
+            for (uint32_t i = 0; i < 4; i++) {
+                halves[i] = encodeHalf(values[i]);
+            }
+            std::memcpy(pixel, halves, sizeof(halves));
+            break;
+        }
+        case Format::R11G11B10F: {
+            uint32_t packed = encodeSmallFloat(values[0], 6) | encodeSmallFloat(values[1], 6) << 11
+                              | encodeSmallFloat(values[2], 5) << 22;
+            std::memcpy(pixel, &packed, sizeof(packed));
+            break;
+        }
+        default:
+            throw std::invalid_argument("Software textures do not support block-compressed formats.");
+    }
+}
+
+std::unique_ptr<Texture2D> SoftwareRHI::createTexture2D(Format format, uint32_t width, uint32_t height,
+                                                        uint32_t numSamples, uint32_t numLevels) {
+    checkTexture2D(format, width, height, numSamples, numLevels);
+    if (isBlockCompressed(format)) {
+        throw std::invalid_argument("Software textures do not support block-compressed formats.");
+    }
+    if (width > SoftwareTexture2D::maxDimension || height > SoftwareTexture2D::maxDimension) {
+        throw std::invalid_argument("Software textures can be at most 4096 pixels wide and high.");
+    }
+
+    return std::make_unique<SoftwareTexture2D>(*this, format, width, height, numSamples, numLevels);
+}
@@ -0,0 +1,116 @@
+#ifndef OPENGL_RENDERER_SOFTWARETEXTURE2D_H
+#define OPENGL_RENDERER_SOFTWARETEXTURE2D_H
+
+#include "../Texture2D.h"
+
+class SoftwareRHI;
+
+/**
+ * @param format a pixel format
+ * @returns the size of a pixel of the format, in bytes
+ */
+uint32_t formatSize(Format format);
+
+/**
+ * A 2d texture stored in host memory, in rows from the bottom of the texture as in OpenGL.
+ *
+ * Multi-sampled textures store a single sample per pixel, so are rendered without anti-aliasing and
+ * resolved by copying. Sampling filters bilinearly and repeats outside of [0, 1], without mip-maps, so
+ * only the first level of textures with several is stored.
+ */
+class SoftwareTexture2D : public Texture2D {
+public:
+    static constexpr uint32_t maxDimension = 4096;
+
+    SoftwareTexture2D(SoftwareRHI& rhi, Format format, uint32_t width, uint32_t height, uint32_t numSamples,
+                      uint32_t numLevels = 1);
+
+    /**
+     * Finishes pending draws before the texture is freed, as they may read or write it.
+     */
+    ~SoftwareTexture2D() override;
+
+    /**
+     * @returns the pixels of the texture
+     */
+    uint8_t* data() {
+        return m_data.data();
+    }
+
+    const uint8_t* data() const {
+        return m_data.data();
+    }
+
+    /**
+     * Reads a pixel, converting it to floating point. Missing color channels read as 0, and alpha as 1.
+     *
+     * @param x the column of the pixel
+     * @param y the row of the pixel, from the bottom
+     * @returns the value of the pixel
+     */
+    Vec4 load(uint32_t x, uint32_t y) const {
+        return loadPixel(format(), m_data.data() + ((size_t)y * m_width + x) * m_pixelSize);
+    }
+
+    /**
+     * Writes a pixel, converting it from floating point. Normalized channels are clamped to [0, 1].
+     *
+     * @param x the column of the pixel
+     * @param y the row of the pixel, from the bottom
+     * @param value the value of the pixel
+     */
+    void store(uint32_t x, uint32_t y, const Vec4& value) {
+        storePixel(format(), m_data.data() + ((size_t)y * m_width + x) * m_pixelSize, value);
+    }
+
+    /**
+     * Samples the texture with bilinear filtering, repeating it outside of [0, 1].
+     *
+     * @param texCoord the texture coordinates, with (0, 0) at the first pixel in memory
+     * @returns the filtered value
+     */
+    Vec4 sample(const Vec2& texCoord) const;
+
+    /**
+     * @returns the size of a pixel, in bytes
+     */
+    uint32_t pixelSize() const {
+        return m_pixelSize;
+    }
+
+    /**
+     * Reads a pixel of the given format from memory.
+     *
+     * @param format the format of the pixel
+     * @param pixel the memory of the pixel
+     * @returns the value of the pixel
+     */
+    static Vec4 loadPixel(Format format, const uint8_t* pixel);
+
+    /**
+     * Writes a pixel of the given format to memory.
+     *
+     * @param format the format of the pixel
+     * @param pixel the memory of the pixel
+     * @param value the value of the pixel
+     */
+    static void storePixel(Format format, uint8_t* pixel, const Vec4& value);
+
+    static SoftwareTexture2D& from(Texture2D& texture) {
+        return dynamic_cast<SoftwareTexture2D&>(texture);
+    }
+
+    static const SoftwareTexture2D& from(const Texture2D& texture) {
+        return dynamic_cast<const SoftwareTexture2D&>(texture);
+    }
+
+private:
+    SoftwareRHI& m_rhi;
+    uint32_t m_width;
+    uint32_t m_height;
+    uint32_t m_pixelSize;
+    std::vector<uint8_t> m_data;
+};
+
+
+#endif //OPENGL_RENDERER_SOFTWARETEXTURE2D_H
@@ -0,0 +1,33 @@
+#include "SoftwareTexture2DArray.h"
+#include "SoftwareRHI.h"
+
+SoftwareTexture2DArray::SoftwareTexture2DArray(SoftwareRHI& rhi, Format format, uint32_t width, uint32_t height,
+                                               uint32_t numLayers, uint32_t numLevels)
+    : Texture2DArray(format, width, height, numLayers, numLevels) {
+    // only the first level of each layer is stored, as the rasterizer samples no other
+    m_layers.reserve(numLayers);
+    for (uint32_t i = 0; i < numLayers; i++) {
+        m_layers.push_back(std::make_unique<SoftwareTexture2D>(rhi, format, width, height, 1));
+    }
+}
+
+Vec4 SoftwareTexture2DArray::sample(const Vec2& texCoord, float layer) const {
+    float index = std::clamp(std::round(layer), 0.0f, (float)(m_layers.size() - 1));
+    return m_layers[(size_t)index]->sample(texCoord);
+}
+
+std::unique_ptr<Texture2DArray> SoftwareRHI::createTexture2DArray(Format format, uint32_t width, uint32_t height,
+                                                                  uint32_t numLayers, uint32_t numLevels) {
+    if (numLayers == 0) {
+        throw std::invalid_argument("Texture arrays must have at least one layer.");
+    }
+    checkTexture2D(format, width, height, 1, numLevels);
+    if (isBlockCompressed(format)) {
+        throw std::invalid_argument("Software textures do not support block-compressed formats.");
+    }
+    if (width > SoftwareTexture2D::maxDimension || height > SoftwareTexture2D::maxDimension) {
+        throw std::invalid_argument("Software textures can be at most 4096 pixels wide and high.");
+    }
+
+    return std::make_unique<SoftwareTexture2DArray>(*this, format, width, height, numLayers, numLevels);
+}
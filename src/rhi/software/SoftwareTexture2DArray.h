@@ -0,0 +1,41 @@
+#ifndef OPENGL_RENDERER_SOFTWARETEXTURE2DARRAY_H
+#define OPENGL_RENDERER_SOFTWARETEXTURE2DARRAY_H
+
+#include "../Texture2DArray.h"
+#include "SoftwareTexture2D.h"
+
+/**
+ * A 2d texture array stored in host memory as a 2d texture per layer, each sampled as a 2d texture is.
+ */
+class SoftwareTexture2DArray : public Texture2DArray {
+public:
+    SoftwareTexture2DArray(SoftwareRHI& rhi, Format format, uint32_t width, uint32_t height, uint32_t numLayers,
+                           uint32_t numLevels);
+
+    /**
+     * @param layer the index of the layer
+     * @returns the layer
+     */
+    SoftwareTexture2D& layer(uint32_t layer) {
+        return *m_layers[layer];
+    }
+
+    /**
+     * Samples a layer with bilinear filtering, repeating it outside of [0, 1].
+     *
+     * @param texCoord the texture coordinates, with (0, 0) at the first pixel in memory
+     * @param layer the layer to sample, rounded to the nearest layer and clamped to the array
+     * @returns the filtered value
+     */
+    Vec4 sample(const Vec2& texCoord, float layer) const;
+
+    static SoftwareTexture2DArray& from(Texture2DArray& textureArray) {
+        return dynamic_cast<SoftwareTexture2DArray&>(textureArray);
+    }
+
+private:
+    std::vector<std::unique_ptr<SoftwareTexture2D>> m_layers;
+};
+
+
+#endif //OPENGL_RENDERER_SOFTWARETEXTURE2DARRAY_H
@@ -3,6 +3,7 @@
 #include "../util/angle.h"
 #include "../engine/StaticMeshLoader.h"
 #include "../engine/Grid.h"
+#include "../engine/Light.h"
 
 struct Transform {
     Mat4 transform;
@@ -14,20 +15,27 @@ struct Motion {
 
 namespace ui {
 
-    App::App()
-        : m_camera(Camera3D::createPerspective(45.0f, 16.0f / 9.0f, 0.1f, 100.0f)), m_renderer(m_camera), m_keys({}) {
-        //: m_camera(Camera3D::createOrthographic(16.0f, 9.0f, 0.1f, 100.0f)), m_renderer(m_camera), m_keys({}) {
+    App::App(Renderer3D::PassMode passMode)
+        : m_camera(Camera3D::createPerspective(45.0f, 16.0f / 9.0f, 0.1f, 100.0f)),
+          m_renderer(std::make_shared<Renderer3D>(m_camera)), m_keys({}) {
+        //: m_camera(Camera3D::createOrthographic(16.0f, 9.0f, 0.1f, 100.0f)), m_renderer(std::make_shared<Renderer3D>(m_camera)), m_keys({}) {
         RHI& rhi = RHI::current();
 
-        uint32_t internalWidth = 2560; // TODO: sync this with the rest of program / remove magic number
-        uint32_t internalHeight = 1440;
-        std::unique_ptr<Texture2D> colorAttachment = rhi.createTexture2D(Format::RGBA8, internalWidth, internalHeight);
-        std::unique_ptr<Texture2D> depthAttachment = rhi.createTexture2D(Format::D32F, internalWidth, internalHeight);
+        // the viewport is rendered multi-sampled into part of a framebuffer the size of the displayed image,
+        // scaled to keep within the gpu budget, then resolved and stretched over the image
+        auto maxWidth = (uint32_t)(viewportWidth * viewportMaxScale);
+        auto maxHeight = (uint32_t)(viewportHeight * viewportMaxScale);
+        std::unique_ptr<Texture2D> colorAttachment = rhi.createTexture2D(Format::RGBA8, maxWidth, maxHeight,
+                                                                         viewportSamples);
+        std::unique_ptr<Texture2D> depthAttachment = rhi.createTexture2D(Format::D32F, maxWidth, maxHeight,
+                                                                         viewportSamples);
         m_framebuffer = rhi.createFramebufferBuilder()
-            ->setDimensions(internalWidth, internalHeight)
+            ->setDimensions(maxWidth, maxHeight)
             ->setColorAttachment(std::move(colorAttachment))
             ->setDepthAttachment(std::move(depthAttachment))
             ->build();
+        m_resolvedColor = rhi.createTexture2D(Format::RGBA8, maxWidth, maxHeight);
+        m_resolution = std::make_shared<DynamicResolution>(viewportFrameTime, viewportMinScale, viewportMaxScale);
 
         m_middleDown = false;
         m_angle = 45.0f;
@@ -48,6 +56,10 @@ namespace ui {
         StaticMesh gridMesh = Grid::make(10.0f, 1.0f);
 
         StaticMeshLoader loader(Material::createDefault());
+        loader.setLodGeneration(4, 0.5f);
+        loader.setOccluderGeneration(true);
+        m_renderer->setPassMode(passMode);
+        m_renderer->setOcclusionCulling(true);
         StaticMesh monkeyMesh = loader.load("../assets/flat-monkey.obj");
 
         // create the grid entity
@@ -56,6 +68,7 @@ namespace ui {
         m_scene.getComponent<StaticMesh>(gridEntity) = std::move(gridMesh);
         m_scene.addComponent<Transform>(gridEntity);
         m_scene.getComponent<Transform>(gridEntity) = Transform{ .transform = Mat4(1.0f) };
+        m_scene.addComponent<LodSelection>(gridEntity);
 
         // create the Suzanne monkey entity
         auto monkeyEntity = m_scene.createEntity();
@@ -63,9 +76,32 @@ namespace ui {
         m_scene.getComponent<StaticMesh>(monkeyEntity) = std::move(monkeyMesh);
         m_scene.addComponent<Transform>(monkeyEntity);
         m_scene.getComponent<Transform>(monkeyEntity) = Transform{ .transform = Mat4(1.0f) };
+        m_scene.addComponent<LodSelection>(monkeyEntity);
         m_scene.addComponent<Motion>(monkeyEntity);
         m_scene.getComponent<Motion>(monkeyEntity) = Motion{ .velocity = Vec3(0.0f, 0.0f, 0.0f) };
 
+        // create a white key light, and a ring of colored lights around the monkey
+        auto keyLightEntity = m_scene.createEntity();
+        m_scene.addComponent<PointLight>(keyLightEntity);
+        m_scene.getComponent<PointLight>(keyLightEntity) = PointLight{
+            .position = Vec3(5.0f, 5.0f, 5.0f), .radius = 30.0f, .color = Vec3(1.0f, 1.0f, 1.0f), .intensity = 1.0f,
+        };
+
+        const std::array<Vec3, 4> ringColors = {
+            Vec3(1.0f, 0.2f, 0.2f), Vec3(0.2f, 1.0f, 0.2f), Vec3(0.2f, 0.2f, 1.0f), Vec3(1.0f, 0.8f, 0.2f),
+        };
+        for (uint32_t i = 0; i < 8; i++) {
+            float angle = degreesToRadians(45.0f * (float)i);
+            auto lightEntity = m_scene.createEntity();
+            m_scene.addComponent<PointLight>(lightEntity);
+            m_scene.getComponent<PointLight>(lightEntity) = PointLight{
+                .position = Vec3(3.0f * std::cos(angle), 1.0f, 3.0f * std::sin(angle)),
+                .radius = 4.0f,
+                .color = ringColors[i % ringColors.size()],
+                .intensity = 1.5f,
+            };
+        }
+
         updateControlSystem = [this](){
             auto meshes = m_scene.view<Motion>();
             meshes.forEach([&](Entity entity, Motion& motion) {
@@ -84,15 +120,22 @@ namespace ui {
             });
         };
 
-        updateRenderSystem = [this](){
-            m_renderer.begin(m_framebuffer);
-
-            auto meshes = m_scene.view<StaticMesh, Transform>();
-            meshes.forEach([&](Entity entity, StaticMesh& staticMesh, Transform& transform){
-                m_renderer.submit(staticMesh, transform.transform);
+        // records the meshes to draw, which are rendered later, possibly on another thread
+        updateRenderSystem = [this](SceneInfo& sceneInfo){
+            // each entity has its own level of detail selection, as entities sharing a mesh are at different distances
+            auto meshes = m_scene.view<StaticMesh, Transform, LodSelection>();
+            meshes.forEach([&](Entity entity, StaticMesh& staticMesh, Transform& transform, LodSelection& lod){
+                sceneInfo.draws.push_back(SceneDraw{
+                    .mesh = std::addressof(staticMesh),
+                    .transform = transform.transform,
+                    .lodSelection = std::addressof(lod),
+                });
             });
 
-            m_renderer.end();
+            auto lights = m_scene.view<PointLight>();
+            lights.forEach([&](Entity entity, PointLight& light){
+                sceneInfo.lights.push_back(light);
+            });
         };
     }
 
@@ -180,9 +223,19 @@ namespace ui {
     }
 
     void App::draw(RenderList& renderList) const {
-        RHI& rhi = RHI::current();
-
-        updateRenderSystem();
+        // the extent is chosen from gpu times of earlier frames, which may be measured on another thread
+        Vector<uint32_t, 2> maxExtent = m_framebuffer->dimensions();
+        Vector<uint32_t, 2> extent = m_resolution->extent(maxExtent);
+        SceneInfo sceneInfo{
+            .renderer = m_renderer,
+            .framebuffer = m_framebuffer,
+            .camera = std::make_shared<const Camera3D>(*m_camera),
+            .extent = extent,
+            .resolve_target = m_resolvedColor,
+            .resolution = m_resolution,
+        };
+        updateRenderSystem(sceneInfo);
+        renderList.submit_scene(std::move(sceneInfo));
 
         renderList.submit_rect(ui::RectInfo{
             .position{0.0f, 0.0f, +0.1f},
@@ -192,8 +245,9 @@ namespace ui {
 
         renderList.submit_image(ui::ImageInfo{
             .position{5.0f, 5.0f, +0.0f},
-            .size{1280.0f, 720.0f},
-            .texture2d = m_framebuffer->colorAttachment()
+            .size{viewportWidth, viewportHeight},
+            .texture2d = *m_resolvedColor,
+            .region{(float)extent.x / (float)maxExtent.x, (float)extent.y / (float)maxExtent.y},
         });
     }
 
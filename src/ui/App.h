@@ -6,12 +6,18 @@
 #include "../rhi/RHI.h"
 #include "../engine/ecs/Scene.h"
 #include "../engine/Renderer3D.h"
+#include "../engine/DynamicResolution.h"
 
 namespace ui {
 
     class App : public Component {
     public:
-        App();
+        /**
+         * Constructs the app and its scene.
+         *
+         * @param passMode how the scene's opaque meshes are ordered and drawn
+         */
+        explicit App(Renderer3D::PassMode passMode = Renderer3D::PassMode::FrontToBack);
         ~App() override = default;
 
         void update(const Timestep& timestep) override;
@@ -28,9 +34,9 @@ namespace ui {
         std::shared_ptr<Camera3D> m_camera;
         std::function<void()> updateCamera;
 
-        Renderer3D m_renderer;
+        std::shared_ptr<Renderer3D> m_renderer;
         Scene m_scene;
-        std::function<void()> updateRenderSystem;
+        std::function<void(SceneInfo&)> updateRenderSystem;
         std::function<void(Duration)> updateMotionSystem;
         std::function<void()> updateControlSystem;
 
@@ -41,7 +47,16 @@ namespace ui {
             bool d;
         } m_keys;
 
+        static constexpr float viewportWidth = 1280.0f; // the displayed size of the viewport
+        static constexpr float viewportHeight = 720.0f;
+        static constexpr uint32_t viewportSamples = 4;
+        static constexpr float viewportFrameTime = 10.0f; // the gpu budget of the viewport, in milliseconds
+        static constexpr float viewportMinScale = 0.5f;
+        static constexpr float viewportMaxScale = 1.0f;
+
         std::shared_ptr<Framebuffer> m_framebuffer;
+        std::shared_ptr<Texture2D> m_resolvedColor;
+        std::shared_ptr<DynamicResolution> m_resolution;
     };
 
 } // ui
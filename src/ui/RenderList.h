@@ -2,6 +2,8 @@
 
 #include "../util/Vector.h"
 #include "../rhi/Texture2D.h"
+#include "../engine/Renderer3D.h"
+#include "../engine/DynamicResolution.h"
 
 /**
  * here is my idea for drawing the 2d elements:
@@ -59,6 +61,7 @@ struct ImageInfo {
     Position position;
     Size size;
     Texture2D& texture2d;
+    Size region{1.0f, 1.0f}; // the fraction of the texture drawn, from its origin
 };
 
 struct TextInfo {
@@ -72,6 +75,36 @@ struct RectInfo {
     Color color;
 };
 
+/**
+ * A mesh of a 3d scene along with its model transform, and the level of detail last rendered for the
+ * instance, which the renderer updates.
+ */
+struct SceneDraw {
+    const StaticMesh* mesh;
+    Mat4 transform;
+    LodSelection* lodSelection = nullptr;
+};
+
+/**
+ * A 3d scene to render into a framebuffer before the ui, so that the framebuffer can be drawn as an image.
+ * The camera is a snapshot, so that it can be changed while the scene is rendered, but the meshes and
+ * level of detail selections are referenced and must remain valid until the render list is rendered.
+ *
+ * The scene may be rendered into only part of the framebuffer, whose color is then resolved into the
+ * same part of a single-sampled texture if one is given. The gpu time of the scene is given to the
+ * dynamic resolution controller, if any, to choose the extent of later frames.
+ */
+struct SceneInfo {
+    std::shared_ptr<Renderer3D> renderer;
+    std::shared_ptr<Framebuffer> framebuffer;
+    std::shared_ptr<const Camera3D> camera;
+    std::vector<SceneDraw> draws;
+    std::vector<PointLight> lights;
+    Vector<uint32_t, 2> extent{}; // zero to render into the whole framebuffer
+    std::shared_ptr<Texture2D> resolve_target;
+    std::shared_ptr<DynamicResolution> resolution;
+};
+
 class RenderList {
 public:
     /**
@@ -122,7 +155,34 @@ public:
         return rects_;
     }
 
+    /**
+     * Submits a 3d scene to be rendered before any ui primitives.
+     *
+     * @param scene_info the information describing the scene
+     */
+    void submit_scene(SceneInfo&& scene_info) {
+        scenes_.push_back(std::move(scene_info));
+    }
+
+    /**
+     * @returns a vector of submitted scenes to be rendered
+     */
+    const std::vector<SceneInfo>& scenes() const {
+        return scenes_;
+    }
+
+    /**
+     * Removes everything submitted, so that the list can be reused for another frame.
+     */
+    void clear() {
+        scenes_.clear();
+        images_.clear();
+        texts_.clear();
+        rects_.clear();
+    }
+
 private:
+    std::vector<SceneInfo> scenes_;
     std::vector<ImageInfo> images_;
     std::vector<TextInfo> texts_;
     std::vector<RectInfo> rects_;
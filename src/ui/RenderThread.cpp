@@ -0,0 +1,110 @@
+#include "RenderThread.h"
+
+namespace ui {
+
+RenderThread::RenderThread(Window& window, Renderer& renderer)
+    : window_(window), renderer_(renderer), writing_(0), waiting_(none), rendering_(none), stopping_(false)
+{
+    window_.release_current();
+    thread_ = std::thread(&RenderThread::run, this);
+    frame_start_ = std::chrono::steady_clock::now();
+}
+
+RenderThread::~RenderThread()
+{
+    stop();
+}
+
+void RenderThread::stop()
+{
+    if (!thread_.joinable()) {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    condition_.notify_all();
+    thread_.join();
+
+    window_.make_current();
+}
+
+RenderList& RenderThread::begin_frame()
+{
+    RenderList& list = packets_[writing_];
+    list.clear();
+    return list;
+}
+
+void RenderThread::end_frame()
+{
+    simulation_times_.record(std::chrono::steady_clock::now() - frame_start_);
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    condition_.wait(lock, [this]() { return waiting_ == none || error_ != nullptr; });
+    if (error_ != nullptr) {
+        std::rethrow_exception(error_);
+    }
+
+    // queue the written packet, and write next into the one neither queued nor being rendered
+    waiting_ = writing_;
+    for (int packet = 0; packet < num_packets; packet++) {
+        if (packet != waiting_ && packet != rendering_) {
+            writing_ = packet;
+            break;
+        }
+    }
+
+    lock.unlock();
+    condition_.notify_all();
+    frame_start_ = std::chrono::steady_clock::now();
+}
+
+void RenderThread::run()
+{
+    window_.make_current();
+
+    try {
+        RHI& rhi = RHI::current();
+        std::unique_ptr<Fence> previous_fence;
+
+        while (true) {
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                rendering_ = none;
+                condition_.wait(lock, [this]() { return waiting_ != none || stopping_; });
+                if (stopping_) {
+                    break;
+                }
+
+                rendering_ = waiting_;
+                waiting_ = none;
+            }
+            condition_.notify_all();
+
+            Timestamp start = std::chrono::steady_clock::now();
+            renderer_.render(packets_[rendering_]);
+            window_.swap();
+
+            // wait for the previous frame on the gpu, so that the gpu is at most one frame behind
+            std::unique_ptr<Fence> fence = rhi.createFence();
+            if (previous_fence != nullptr) {
+                previous_fence->wait();
+            }
+            previous_fence = std::move(fence);
+
+            render_times_.record(std::chrono::steady_clock::now() - start);
+        }
+    } catch (...) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        error_ = std::current_exception();
+        rendering_ = none;
+        condition_.notify_all();
+    }
+
+    window_.release_current();
+}
+
+} // ui
@@ -0,0 +1,98 @@
+#pragma once
+
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+#include "Window.h"
+#include "Renderer.h"
+#include "../util/FrameTimeHistogram.h"
+
+namespace ui {
+
+/**
+ * Runs everything that touches the render api on a dedicated thread, so that simulating a frame
+ * overlaps with rendering the previous one.
+ *
+ * Frames are handed over as render lists in three packets: one being written by the simulation thread,
+ * one waiting to be rendered, and one being rendered. The simulation thread waits while a packet is
+ * already waiting, so it is at most one frame ahead of the render thread. The render thread in turn
+ * waits on a fence for the frame before the one it just submitted, so the gpu is at most one frame
+ * behind it.
+ */
+class RenderThread {
+public:
+    /**
+     * Starts the render thread, moving the window's OpenGL context to it. The renderer and any other
+     * render api objects must be created beforehand.
+     *
+     * @param window the window to present to, whose context is current on the calling thread
+     * @param renderer the renderer to render each frame's render list with
+     */
+    RenderThread(Window& window, Renderer& renderer);
+
+    /**
+     * Stops the render thread, if still running.
+     */
+    ~RenderThread();
+
+    /**
+     * Stops the render thread once it finishes its current frame, and moves the window's OpenGL context
+     * back to the calling thread. Frames waiting to be rendered are dropped.
+     */
+    void stop();
+
+    /**
+     * Begins a frame on the simulation thread.
+     *
+     * @returns an empty render list to write the frame to
+     */
+    RenderList& begin_frame();
+
+    /**
+     * Hands the render list returned by begin_frame() over to be rendered, waiting while the previous
+     * frame has yet to start rendering.
+     *
+     * @throws any exception thrown while rendering a previous frame
+     */
+    void end_frame();
+
+    /**
+     * @returns the time the simulation thread spent on each frame, from the end of one handover to the
+     * start of the next, excluding waiting
+     */
+    const FrameTimeHistogram& simulation_times() const {
+        return simulation_times_;
+    }
+
+    /**
+     * @returns the time the render thread spent rendering each frame, excluding waiting. This must
+     * not be read until the render thread is stopped.
+     */
+    const FrameTimeHistogram& render_times() const {
+        return render_times_;
+    }
+
+private:
+    static constexpr int num_packets = 3;
+    static constexpr int none = -1;
+
+    void run();
+
+    Window& window_;
+    Renderer& renderer_;
+    std::array<RenderList, num_packets> packets_;
+    int writing_;   // the packet being written by the simulation thread
+    int waiting_;   // the packet waiting to be rendered, or none
+    int rendering_; // the packet being rendered, or none
+    bool stopping_;
+    std::exception_ptr error_;
+    std::mutex mutex_;
+    std::condition_variable condition_;
+    Timestamp frame_start_; // when the simulation thread last finished handing over a frame
+    FrameTimeHistogram simulation_times_;
+    FrameTimeHistogram render_times_;
+    std::thread thread_;
+};
+
+} // ui
@@ -1,53 +1,49 @@
 #include "Renderer.h"
 
 #include "../engine/ShaderLoader.h"
+#include "../rhi/UploadQueue.h"
+#include "../rhi/PipelineCache.h"
 
 namespace ui {
 
 Renderer::Renderer(float width, float height)
-    : width_(width), height_(height)
+    : width_(width), height_(height), vertex_allocator_(max_quads * 4 * sizeof(Vertex)),
+      image_descriptor_sets_({
+          DescriptorSetBinding {
+              .binding = 0,
+              .type = DescriptorType::Texture2D,
+          },
+      })
 {
     RHI& rhi = RHI::current();
 
     // constructs an index buffer for quads
-    index_buffer_ = rhi.createBuffer(sizeof(uint32_t) * 6, sizeof(uint32_t));
     std::vector<uint32_t> indices = {
         0, 1, 2,
         2, 3, 0,
     };
-    std::memcpy(index_buffer_->map(), indices.data(), index_buffer_->size());
-    index_buffer_->unmap();
-
-    vertex_buffer_ = rhi.createBuffer(sizeof(Vertex) * 4, sizeof(Vertex));
+    index_buffer_ = rhi.uploadQueue().createBuffer(indices.data(), sizeof(uint32_t) * 6, sizeof(uint32_t));
 
     std::vector<VertexBinding> bindings = {
-        VertexBinding(0, vertex_buffer_->stride(), {
+        VertexBinding(0, sizeof(Vertex), {
             VertexAttribute(0, Format::RGB32F, offsetof(Vertex, position)),
             VertexAttribute(1, Format::RG32F, offsetof(Vertex, texture)),
         })
     };
 
-    VertexLayout layout(std::move(bindings));
-
-    auto vert_shader = shaderFromFile("../shaders/ui-image.vert");
-    auto frag_shader = shaderFromFile("../shaders/ui-image.frag");
-
-    image_pipeline_ = rhi.createPipelineBuilder()
-        ->setTopology(Topology::Triangles)
-        ->setVertexLayout(layout)
-        ->setVertexShader(*vert_shader)
-        ->setFragmentShader(*frag_shader)
-        ->build();
-
-    vert_shader = shaderFromFile("../shaders/ui-rect.vert");
-    frag_shader = shaderFromFile("../shaders/ui-rect.frag");
+    PipelineDescription description{
+        .vertexShader = shaderSourceFromFile("../shaders/ui-image.vert"),
+        .fragmentShader = shaderSourceFromFile("../shaders/ui-image.frag"),
+        .vertexLayout = VertexLayout(std::move(bindings)),
+        .topology = Topology::Triangles,
+    };
+    image_pipeline_ = rhi.pipelineCache().get(description);
 
-    rect_pipeline_ = rhi.createPipelineBuilder()
-        ->setTopology(Topology::Triangles)
-        ->setVertexLayout(layout)
-        ->setVertexShader(*vert_shader)
-        ->setFragmentShader(*frag_shader)
-        ->build();
+    // rects are drawn over images by their color's alpha
+    description.vertexShader = shaderSourceFromFile("../shaders/ui-rect.vert");
+    description.fragmentShader = shaderSourceFromFile("../shaders/ui-rect.frag");
+    description.blendState = BlendState::alpha();
+    rect_pipeline_ = rhi.pipelineCache().get(description);
 };
 
 void Renderer::set_resolution(float width, float height)
@@ -59,6 +55,15 @@ void Renderer::set_resolution(float width, float height)
 void Renderer::render(const RenderList& list)
 {
     RHI& rhi = RHI::current();
+    rhi.frameContext().beginFrame();
+
+    // render scenes first, as their framebuffers may be drawn as images
+    for (const auto& scene : list.scenes()) {
+        GpuScope scope(rhi, "scene");
+        render_scene(scene);
+    }
+
+    GpuScope scope(rhi, "ui");
 
     rhi.bindDefaultFramebuffer();
 
@@ -66,13 +71,6 @@ void Renderer::render(const RenderList& list)
     rhi.setViewport(0, 0, 1290, 730); // TODO: remove magic number here
 
     // render images then rects then text
-    auto descriptor_set = rhi.createDescriptorSet({
-        DescriptorSetBinding {
-            .binding = 0,
-            .type = DescriptorType::Texture2D,
-        },
-    });
-
     // bind the image shader pipeline
     rhi.bindPipeline(*image_pipeline_);
 
@@ -93,62 +91,74 @@ void Renderer::render(const RenderList& list)
     rhi.bindUniforms(uniform_block);
 
     rhi.bindIndexBuffer(*index_buffer_);
-    rhi.bindVertexBuffer(*vertex_buffer_, 0);
-
-    for (auto& image : list.images()) {
-        float left = image.position.x;
-        float right = image.position.x + image.size.width;
-        float top = image.position.y;
-        float bottom = image.position.y + image.size.height;
-        float z = image.position.z;
-
-        // create the vertices for the image
-        std::array<Vertex, 4> vertices = {
-            Vertex{{left, top, z}, {0.0f, 1.0f}}, // top left
-            Vertex{{left, bottom, z}, {0.0f, 0.0f}}, // bottom left
-            Vertex{{right, bottom, z}, {1.0f, 0.0f}}, // bottom right
-            Vertex{{right, top, z}, {1.0f, 1.0f}}, // top right
-        };
-        std::memcpy(vertex_buffer_->map(), vertices.data(), vertex_buffer_->size());
-        vertex_buffer_->unmap();
-
-        // bind the texture
-        descriptor_set->bindTexture2D(0, image.texture2d);
-        rhi.bindDescriptorSet(*descriptor_set);
-
-        // draw the image
-        rhi.drawIndexed(6, 0, 0);
+
+    // the quads of all images are written at once, then each is drawn from its own base vertex
+    const std::vector<ImageInfo>& images = list.images();
+    if (!images.empty()) {
+        TransientAllocation allocation = vertex_allocator_.allocate<Vertex>(images.size() * 4);
+        auto vertices = static_cast<Vertex*>(allocation.data);
+        for (const auto& image : images) {
+            float left = image.position.x;
+            float right = image.position.x + image.size.width;
+            float top = image.position.y;
+            float bottom = image.position.y + image.size.height;
+            float z = image.position.z;
+
+            *vertices++ = Vertex{{left, top, z}, {0.0f, image.region.height}}; // top left
+            *vertices++ = Vertex{{left, bottom, z}, {0.0f, 0.0f}}; // bottom left
+            *vertices++ = Vertex{{right, bottom, z}, {image.region.width, 0.0f}}; // bottom right
+            *vertices++ = Vertex{{right, top, z}, {image.region.width, image.region.height}}; // top right
+        }
+        rhi.bindVertexBuffer(*allocation.buffer, 0, allocation.offset, sizeof(Vertex));
+
+        for (uint32_t i = 0; i < images.size(); i++) {
+            // bind the texture, through a set cached across frames
+            DescriptorWrite descriptor {
+                .binding = 0,
+                .texture2D = &images[i].texture2d,
+                .buffer = nullptr,
+                .offset = 0,
+                .range = 0,
+            };
+            rhi.bindDescriptorSet(image_descriptor_sets_.get({&descriptor, 1}));
+
+            // draw the image
+            rhi.drawIndexed(6, 0, i * 4);
+        }
     }
 
     // bind the rect shader pipeline
     rhi.bindPipeline(*rect_pipeline_);
 
-    for (auto& rect : list.rects()) {
-        float left = rect.position.x;
-        float right = rect.position.x + rect.size.width;
-        float top = rect.position.y;
-        float bottom = rect.position.y + rect.size.height;
-        float z = rect.position.z;
-
-        // create the vertices for the rect
-        std::array<Vertex, 4> vertices = {
-            Vertex{{left, top, z}, {}}, // top left
-            Vertex{{left, bottom, z}, {}}, // bottom left
-            Vertex{{right, bottom, z}, {}}, // bottom right
-            Vertex{{right, top, z}, {}}, // top right
-        };
-        std::memcpy(vertex_buffer_->map(), vertices.data(), vertex_buffer_->size());
-        vertex_buffer_->unmap();
-
-        // update the color uniform
-        color.x = rect.color.r;
-        color.y = rect.color.g;
-        color.z = rect.color.b;
-        color.w = rect.color.a;
-        rhi.bindUniforms(uniform_block);
-
-        // draw the rect
-        rhi.drawIndexed(6, 0, 0);
+    const std::vector<RectInfo>& rects = list.rects();
+    if (!rects.empty()) {
+        TransientAllocation allocation = vertex_allocator_.allocate<Vertex>(rects.size() * 4);
+        auto vertices = static_cast<Vertex*>(allocation.data);
+        for (const auto& rect : rects) {
+            float left = rect.position.x;
+            float right = rect.position.x + rect.size.width;
+            float top = rect.position.y;
+            float bottom = rect.position.y + rect.size.height;
+            float z = rect.position.z;
+
+            *vertices++ = Vertex{{left, top, z}, {}}; // top left
+            *vertices++ = Vertex{{left, bottom, z}, {}}; // bottom left
+            *vertices++ = Vertex{{right, bottom, z}, {}}; // bottom right
+            *vertices++ = Vertex{{right, top, z}, {}}; // top right
+        }
+        rhi.bindVertexBuffer(*allocation.buffer, 0, allocation.offset, sizeof(Vertex));
+
+        for (uint32_t i = 0; i < rects.size(); i++) {
+            // update the color uniform
+            color.x = rects[i].color.r;
+            color.y = rects[i].color.g;
+            color.z = rects[i].color.b;
+            color.w = rects[i].color.a;
+            rhi.bindUniforms(uniform_block);
+
+            // draw the rect
+            rhi.drawIndexed(6, 0, i * 4);
+        }
     }
 
     for (auto text : list.texts()) {
@@ -156,7 +166,37 @@ void Renderer::render(const RenderList& list)
         // should start with the simple letters and numbers
     }
 
-    vertex_buffer_->unmap();
+    rhi.frameContext().endFrame();
+}
+
+void Renderer::render_scene(const SceneInfo& scene)
+{
+    Renderer3D& renderer = *scene.renderer;
+    renderer.setCamera(scene.camera);
+
+    renderer.begin(scene.framebuffer, scene.extent);
+    for (const auto& light : scene.lights) {
+        renderer.submitLight(light);
+    }
+    for (const auto& draw : scene.draws) {
+        renderer.submit(*draw.mesh, draw.transform, draw.lodSelection);
+    }
+    renderer.end();
+
+    // resolve only the rendered part, which the image of the scene samples
+    if (scene.resolve_target != nullptr) {
+        Vector<uint32_t, 2> extent = scene.extent;
+        if (extent.x == 0 && extent.y == 0) {
+            extent = scene.framebuffer->dimensions();
+        }
+        TextureRegion region{0, 0, extent.x, extent.y};
+        GpuScope scope(RHI::current(), "resolve");
+        RHI::current().resolveTexture2D(scene.framebuffer->colorAttachment(), region, *scene.resolve_target, region);
+    }
+
+    if (scene.resolution != nullptr) {
+        scene.resolution->update(renderer.gpuTime());
+    }
 }
 
 } // ui
@@ -2,6 +2,8 @@
 
 #include "RenderList.h"
 #include "../rhi/RHI.h"
+#include "../rhi/DescriptorSetCache.h"
+#include "../rhi/TransientAllocator.h"
 
 namespace ui {
 
@@ -20,23 +22,36 @@ public:
 
     /**
      * Renders the UI components from a render list of UI primitives (rects, images, and texts).
+     * Any 3d scenes in the list are rendered into their framebuffers first. Rendering makes up a
+     * whole frame, so it begins and ends a frame of the api's frame context.
      *
      * @param list the render list to pull ui primitives from.
      */
     void render(const RenderList& list);
 
 private:
+    /**
+     * Renders a 3d scene into its framebuffer.
+     *
+     * @param scene the scene to render
+     */
+    void render_scene(const SceneInfo& scene);
+
     struct Vertex {
         float position[3];
         float texture[2];
     };
 
+    // the most images and rects that can be drawn each frame
+    static constexpr uint32_t max_quads = 4096;
+
     float width_;
     float height_;
     std::unique_ptr<Buffer> index_buffer_;
-    std::unique_ptr<Buffer> vertex_buffer_;
-    std::unique_ptr<Pipeline> image_pipeline_;
-    std::unique_ptr<Pipeline> rect_pipeline_;
+    TransientAllocator vertex_allocator_; // the vertices of each frame's quads
+    DescriptorSetCache image_descriptor_sets_; // a set for each texture drawn as an image
+    std::shared_ptr<Pipeline> image_pipeline_;
+    std::shared_ptr<Pipeline> rect_pipeline_;
 };
 
 } // ui
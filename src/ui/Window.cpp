@@ -306,4 +306,18 @@ void Window::swap() const
     SDL_GL_SwapWindow(window_);
 }
 
+void Window::make_current() const
+{
+    if (SDL_GL_MakeCurrent(window_, context_) != 0) {
+        throw std::runtime_error("Failed to make OpenGL context current.");
+    }
+}
+
+void Window::release_current() const
+{
+    if (SDL_GL_MakeCurrent(window_, nullptr) != 0) {
+        throw std::runtime_error("Failed to release OpenGL context.");
+    }
+}
+
 } // ui
@@ -47,6 +47,18 @@ public:
      */
     void swap() const;
 
+    /**
+     * Makes the window's OpenGL context current on the calling thread, so that it may render.
+     * The context must not be current on any other thread.
+     */
+    void make_current() const;
+
+    /**
+     * Releases the window's OpenGL context from the calling thread, so that it can be made current on
+     * another thread.
+     */
+    void release_current() const;
+
 private:
     static int num_windows_;
 
@@ -0,0 +1,42 @@
+#include "FrameTimeHistogram.h"
+
+#include <cstdio>
+
+void FrameTimeHistogram::record(Duration frameTime) {
+    auto bucket = (uint64_t)std::max(frameTime / bucketWidth, 0.0);
+    m_buckets[std::min(bucket, (uint64_t)numBuckets)]++;
+    m_count++;
+    m_total += frameTime;
+    m_max = std::max(m_max, frameTime);
+}
+
+Duration FrameTimeHistogram::percentile(double percentile) const {
+    if (m_count == 0) {
+        return Duration::zero();
+    }
+
+    // the rank of the sample at the percentile, counting from one
+    auto rank = (uint64_t)std::ceil(percentile / 100.0 * (double)m_count);
+    rank = std::clamp(rank, (uint64_t)1, m_count);
+
+    uint64_t seen = 0;
+    for (uint32_t bucket = 0; bucket < numBuckets; bucket++) {
+        seen += m_buckets[bucket];
+        if (seen >= rank) {
+            return bucketWidth * (double)(bucket + 1);
+        }
+    }
+    return m_max;
+}
+
+std::string FrameTimeHistogram::summary() const {
+    auto milliseconds = [](Duration duration) {
+        return std::chrono::duration<double, std::milli>(duration).count();
+    };
+
+    char buffer[128];
+    std::snprintf(buffer, sizeof(buffer), "%llu frames, mean %.2f ms, p50 %.2f ms, p99 %.2f ms, max %.2f ms",
+                  (unsigned long long)m_count, milliseconds(mean()), milliseconds(percentile(50.0)),
+                  milliseconds(percentile(99.0)), milliseconds(m_max));
+    return buffer;
+}
@@ -0,0 +1,64 @@
+#ifndef OPENGL_RENDERER_FRAMETIMEHISTOGRAM_H
+#define OPENGL_RENDERER_FRAMETIMEHISTOGRAM_H
+
+#include "Timestep.h"
+
+/**
+ * A histogram of frame times with fixed width buckets, used to find percentiles without storing
+ * every sample. Times past the last bucket are counted in an overflow bucket.
+ */
+class FrameTimeHistogram {
+public:
+    /**
+     * Records the time taken by a frame.
+     *
+     * @param frameTime the time taken by the frame
+     */
+    void record(Duration frameTime);
+
+    /**
+     * Finds an upper bound of the given percentile of the recorded times, to the bucket width.
+     *
+     * @param percentile the percentile to find, in [0, 100]
+     * @returns the upper bound of the bucket containing the percentile, or zero if nothing is recorded
+     */
+    Duration percentile(double percentile) const;
+
+    /**
+     * @returns the mean of the recorded times, or zero if nothing is recorded
+     */
+    Duration mean() const {
+        return m_count == 0 ? Duration::zero() : m_total / (double)m_count;
+    }
+
+    /**
+     * @returns the longest time recorded
+     */
+    Duration max() const {
+        return m_max;
+    }
+
+    /**
+     * @returns the number of times recorded
+     */
+    uint64_t count() const {
+        return m_count;
+    }
+
+    /**
+     * @returns a one line summary of the mean, median, 99th percentile and max in milliseconds
+     */
+    std::string summary() const;
+
+    static constexpr Duration bucketWidth = std::chrono::microseconds(250);
+    static constexpr uint32_t numBuckets = 400; // up to 100 ms
+
+private:
+    std::array<uint64_t, numBuckets + 1> m_buckets{};
+    uint64_t m_count = 0;
+    Duration m_total = Duration::zero();
+    Duration m_max = Duration::zero();
+};
+
+
+#endif //OPENGL_RENDERER_FRAMETIMEHISTOGRAM_H
@@ -0,0 +1,88 @@
+#include "MappedFile.h"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#ifdef _WIN32
+
+MappedFile::MappedFile(const std::string& filename) : m_data(nullptr), m_size(0), m_mapping(nullptr) {
+    HANDLE file = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                              FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        throw std::runtime_error("Failed to open file: " + filename);
+    }
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size)) {
+        CloseHandle(file);
+        throw std::runtime_error("Failed to read the size of file: " + filename);
+    }
+    m_size = (size_t)size.QuadPart;
+
+    // empty files cannot be mapped, and are left without data
+    if (m_size > 0) {
+        m_mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (m_mapping != nullptr) {
+            m_data = (const uint8_t*)MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0);
+        }
+    }
+    CloseHandle(file);
+
+    if (m_size > 0 && m_data == nullptr) {
+        if (m_mapping != nullptr) {
+            CloseHandle(m_mapping);
+        }
+        throw std::runtime_error("Failed to map file: " + filename);
+    }
+}
+
+MappedFile::~MappedFile() {
+    if (m_data != nullptr) {
+        UnmapViewOfFile(m_data);
+        CloseHandle(m_mapping);
+    }
+}
+
+#else
+
+MappedFile::MappedFile(const std::string& filename) : m_data(nullptr), m_size(0), m_mapping(nullptr) {
+    int file = open(filename.c_str(), O_RDONLY);
+    if (file < 0) {
+        throw std::runtime_error("Failed to open file: " + filename);
+    }
+
+    struct stat status{};
+    if (fstat(file, &status) != 0) {
+        close(file);
+        throw std::runtime_error("Failed to read the size of file: " + filename);
+    }
+    m_size = (size_t)status.st_size;
+
+    // empty files cannot be mapped, and are left without data
+    if (m_size > 0) {
+        void* data = mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, file, 0);
+        if (data == MAP_FAILED) {
+            close(file);
+            throw std::runtime_error("Failed to map file: " + filename);
+        }
+        m_data = (const uint8_t*)data;
+    }
+
+    // the mapping keeps the file open
+    close(file);
+}
+
+MappedFile::~MappedFile() {
+    if (m_data != nullptr) {
+        munmap((void*)m_data, m_size);
+    }
+}
+
+#endif
@@ -0,0 +1,38 @@
+#ifndef OPENGL_RENDERER_MAPPEDFILE_H
+#define OPENGL_RENDERER_MAPPEDFILE_H
+
+#include <string>
+#include <span>
+
+/**
+ * A file mapped read-only into memory, so that its contents are paged in by the os as they are read
+ * rather than copied into a buffer first. The file stays mapped for the lifetime of the object.
+ */
+class MappedFile {
+public:
+    /**
+     * Maps the whole of a file into memory.
+     *
+     * @param filename the path of the file
+     * @throws std::runtime_error if the file cannot be opened or mapped
+     */
+    explicit MappedFile(const std::string& filename);
+
+    MappedFile(const MappedFile&) = delete;
+    ~MappedFile();
+
+    /**
+     * @returns the contents of the file
+     */
+    std::span<const uint8_t> data() const {
+        return {m_data, m_size};
+    }
+
+private:
+    const uint8_t* m_data;
+    size_t m_size;
+    void* m_mapping; // the handle of the mapping, on platforms that have one
+};
+
+
+#endif //OPENGL_RENDERER_MAPPEDFILE_H
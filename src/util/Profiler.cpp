@@ -0,0 +1,65 @@
+#include "Profiler.h"
+
+#include <cstdio>
+
+void Profiler::record(std::string_view name, Duration cpuTime, Duration gpuTime) {
+    std::lock_guard lock(m_mutex);
+
+    auto samples = std::find_if(m_samples.begin(), m_samples.end(), [&](const Samples& samples) {
+        return samples.name == name;
+    });
+    if (samples == m_samples.end()) {
+        samples = m_samples.insert(m_samples.end(), Samples{.name = std::string(name), .count = 0, .next = 0});
+    }
+
+    samples->cpu[samples->next] = cpuTime;
+    samples->gpu[samples->next] = gpuTime;
+    samples->next = (samples->next + 1) % windowSize;
+    samples->count = std::min(samples->count + 1, windowSize);
+}
+
+std::vector<Profiler::Scope> Profiler::scopes() const {
+    std::lock_guard lock(m_mutex);
+
+    auto statistics = [](const std::array<Duration, windowSize>& times, uint32_t count) {
+        Duration total = Duration::zero();
+        Statistics result{.min = times[0], .mean = Duration::zero(), .max = times[0]};
+        for (uint32_t i = 0; i < count; i++) {
+            total += times[i];
+            result.min = std::min(result.min, times[i]);
+            result.max = std::max(result.max, times[i]);
+        }
+        result.mean = total / (double)count;
+        return result;
+    };
+
+    std::vector<Scope> scopes;
+    scopes.reserve(m_samples.size());
+    for (const Samples& samples: m_samples) {
+        scopes.push_back(Scope{
+            .name = samples.name,
+            .count = samples.count,
+            .cpu = statistics(samples.cpu, samples.count),
+            .gpu = statistics(samples.gpu, samples.count),
+        });
+    }
+    return scopes;
+}
+
+std::string Profiler::summary() const {
+    auto milliseconds = [](Duration duration) {
+        return std::chrono::duration<double, std::milli>(duration).count();
+    };
+
+    std::string summary;
+    for (const Scope& scope: scopes()) {
+        char buffer[192];
+        std::snprintf(buffer, sizeof(buffer),
+                      "%s: cpu %.3f/%.3f/%.3f ms, gpu %.3f/%.3f/%.3f ms (min/mean/max of %u)\n",
+                      scope.name.c_str(), milliseconds(scope.cpu.min), milliseconds(scope.cpu.mean),
+                      milliseconds(scope.cpu.max), milliseconds(scope.gpu.min), milliseconds(scope.gpu.mean),
+                      milliseconds(scope.gpu.max), scope.count);
+        summary += buffer;
+    }
+    return summary;
+}
@@ -0,0 +1,67 @@
+#ifndef OPENGL_RENDERER_PROFILER_H
+#define OPENGL_RENDERER_PROFILER_H
+
+#include <mutex>
+#include "Timestep.h"
+
+/**
+ * Aggregates the cpu and gpu times of named scopes, such as render passes, over a rolling window of
+ * their most recent samples. Samples may be recorded and read from different threads.
+ */
+class Profiler {
+public:
+    /**
+     * The minimum, mean and maximum of a window of times.
+     */
+    struct Statistics {
+        Duration min;
+        Duration mean;
+        Duration max;
+    };
+
+    /**
+     * The statistics of a named scope.
+     */
+    struct Scope {
+        std::string name;
+        uint32_t count; // the number of samples in the window
+        Statistics cpu;
+        Statistics gpu;
+    };
+
+    /**
+     * Records a sample of a scope's times, replacing its oldest sample once the window is full.
+     *
+     * @param name the name of the scope
+     * @param cpuTime the time the cpu took between the beginning and end of the scope
+     * @param gpuTime the time the gpu took between the beginning and end of the scope
+     */
+    void record(std::string_view name, Duration cpuTime, Duration gpuTime);
+
+    /**
+     * @returns the statistics of each scope, in the order they were first recorded
+     */
+    std::vector<Scope> scopes() const;
+
+    /**
+     * @returns a line for each scope describing its statistics
+     */
+    std::string summary() const;
+
+private:
+    static constexpr uint32_t windowSize = 120;
+
+    struct Samples {
+        std::string name;
+        std::array<Duration, windowSize> cpu;
+        std::array<Duration, windowSize> gpu;
+        uint32_t count;
+        uint32_t next; // the sample to replace next
+    };
+
+    mutable std::mutex m_mutex;
+    std::vector<Samples> m_samples; // few scopes are expected, so they are searched linearly
+};
+
+
+#endif //OPENGL_RENDERER_PROFILER_H
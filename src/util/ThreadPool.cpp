@@ -0,0 +1,88 @@
+#include "ThreadPool.h"
+
+ThreadPool::ThreadPool(uint32_t numThreads) : m_stopping(false) {
+    if (numThreads == 0) {
+        throw std::invalid_argument("ThreadPool requires at least one thread.");
+    }
+
+    m_workers.reserve(numThreads);
+    for (uint32_t i = 0; i < numThreads; i++) {
+        m_workers.emplace_back([this]() {
+            while (true) {
+                std::function<void()> task;
+                {
+                    std::unique_lock lock(m_mutex);
+                    m_condition.wait(lock, [this]() { return m_stopping || !m_tasks.empty(); });
+                    if (m_tasks.empty()) return; // only empty once stopping
+                    task = std::move(m_tasks.front());
+                    m_tasks.pop_front();
+                }
+                task();
+            }
+        });
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard lock(m_mutex);
+        m_stopping = true;
+    }
+    m_condition.notify_all();
+
+    for (auto& worker: m_workers) {
+        worker.join();
+    }
+}
+
+void ThreadPool::enqueue(std::function<void()> task) {
+    {
+        std::lock_guard lock(m_mutex);
+        m_tasks.push_back(std::move(task));
+    }
+    m_condition.notify_one();
+}
+
+void ThreadPool::parallelFor(uint32_t count, const std::function<void(uint32_t)>& func) {
+    if (count == 0) return;
+
+    // every participant pulls indices from a shared counter until none remain
+    std::atomic<uint32_t> next = 0;
+    auto work = [&]() {
+        for (uint32_t index = next++; index < count; index = next++) {
+            func(index);
+        }
+    };
+
+    uint32_t numHelpers = std::min(size(), count - 1);
+    std::vector<std::future<void>> helpers;
+    helpers.reserve(numHelpers);
+    for (uint32_t i = 0; i < numHelpers; i++) {
+        helpers.push_back(submit(work));
+    }
+
+    // the helpers reference this stack frame, so they must finish even if a call throws
+    std::exception_ptr exception;
+    try {
+        work();
+    } catch (...) {
+        exception = std::current_exception();
+        next = count;
+    }
+    for (auto& helper: helpers) {
+        try {
+            helper.get();
+        } catch (...) {
+            if (!exception) exception = std::current_exception();
+            next = count;
+        }
+    }
+    if (exception) {
+        std::rethrow_exception(exception);
+    }
+}
+
+ThreadPool& ThreadPool::shared() {
+    static ThreadPool pool(std::max(std::thread::hardware_concurrency(), 2u) - 1);
+    return pool;
+}
@@ -0,0 +1,78 @@
+#ifndef OPENGL_RENDERER_THREADPOOL_H
+#define OPENGL_RENDERER_THREADPOOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <future>
+#include <mutex>
+#include <thread>
+
+/**
+ * A fixed set of worker threads that run submitted tasks in first in, first out order.
+ */
+class ThreadPool {
+public:
+    /**
+     * Constructs a thread pool with the given number of worker threads.
+     *
+     * @param numThreads the number of worker threads, must be at least one
+     */
+    explicit ThreadPool(uint32_t numThreads);
+
+    /**
+     * Finishes all queued tasks, then joins the worker threads.
+     */
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+
+    /**
+     * @returns the number of worker threads in the pool
+     */
+    uint32_t size() const {
+        return m_workers.size();
+    }
+
+    /**
+     * Queues a task to be run by a worker thread.
+     *
+     * @param task the task to run
+     * @returns a future for the result of the task
+     */
+    template<typename F>
+    auto submit(F&& task) -> std::future<decltype(task())> {
+        using R = decltype(task());
+        auto packaged = std::make_shared<std::packaged_task<R()>>(std::forward<F>(task));
+        std::future<R> future = packaged->get_future();
+        enqueue([packaged]() { (*packaged)(); });
+        return future;
+    }
+
+    /**
+     * Calls the given function once for each index in [0, count), spreading the calls across the
+     * worker threads and the calling thread. Returns once every call has finished. Must not be
+     * called from a task running on the same pool.
+     *
+     * @param count the number of indices
+     * @param func the function to call with each index
+     */
+    void parallelFor(uint32_t count, const std::function<void(uint32_t)>& func);
+
+    /**
+     * @returns a pool shared by the engine, with one worker per hardware thread besides the calling one
+     */
+    static ThreadPool& shared();
+
+private:
+    void enqueue(std::function<void()> task);
+
+    std::vector<std::thread> m_workers;
+    std::deque<std::function<void()>> m_tasks;
+    std::mutex m_mutex;
+    std::condition_variable m_condition;
+    bool m_stopping;
+};
+
+
+#endif //OPENGL_RENDERER_THREADPOOL_H
@@ -0,0 +1,112 @@
+#include <fstream>
+
+#include "../src/engine/Ktx2.h"
+#include "../src/engine/MipGenerator.h"
+#include "../src/engine/TextureEncoder.h"
+
+/**
+ * Encodes an image in a block-compressed format with a full chain of mip-map levels, and writes it to a
+ * KTX 2.0 file for TextureLoader::loadKtx2(), so that the art pipeline compresses textures once offline
+ * rather than the engine on every launch.
+ */
+
+static const char* usage =
+    "usage: texture_compress [options] INPUT OUTPUT\n"
+    "  INPUT                       an image readable by stb_image, such as a png or jpeg\n"
+    "  OUTPUT                      the KTX 2.0 file to write\n"
+    "  --format=bc1|bc3|bc4|bc5|bc7|rgba8\n"
+    "                              the format of the texture (default bc7)\n"
+    "  --no-mips                   write only the full size level\n";
+
+struct CompressOptions {
+    Format format = Format::BC7;
+    bool mips = true;
+    std::string input;
+    std::string output;
+};
+
+/**
+ * Parses the command line arguments of the tool.
+ *
+ * @throws std::invalid_argument if an argument is not valid
+ */
+static CompressOptions parse_options(int argc, char** argv) {
+    static const std::map<std::string, Format> formats = {
+        {"bc1", Format::BC1}, {"bc3", Format::BC3}, {"bc4", Format::BC4}, {"bc5", Format::BC5},
+        {"bc7", Format::BC7}, {"rgba8", Format::RGBA8},
+    };
+
+    CompressOptions options;
+    std::vector<std::string> paths;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg.starts_with("--format=")) {
+            auto format = formats.find(arg.substr(9));
+            if (format == formats.end()) {
+                throw std::invalid_argument("unknown format: " + arg.substr(9));
+            }
+            options.format = format->second;
+        } else if (arg == "--no-mips") {
+            options.mips = false;
+        } else if (arg.starts_with("--")) {
+            throw std::invalid_argument("unknown option: " + arg);
+        } else {
+            paths.push_back(arg);
+        }
+    }
+
+    if (paths.size() != 2) {
+        throw std::invalid_argument("expected an input and an output file");
+    }
+    options.input = paths[0];
+    options.output = paths[1];
+    return options;
+}
+
+int main(int argc, char** argv) {
+    CompressOptions options;
+    try {
+        options = parse_options(argc, argv);
+    } catch (const std::invalid_argument& e) {
+        std::cerr << e.what() << "\n" << usage;
+        return 2;
+    }
+
+    int width;
+    int height;
+    int channels;
+    stbi_uc* image = stbi_load(options.input.c_str(), &width, &height, &channels, 4);
+    if (image == nullptr) {
+        std::cerr << "failed to read image " << options.input << ": " << stbi_failure_reason() << std::endl;
+        return 1;
+    }
+    std::vector<uint8_t> pixels(image, image + (size_t)width * height * 4);
+    stbi_image_free(image);
+
+    std::vector<std::vector<uint8_t>> levels;
+    levels.push_back(std::move(pixels));
+    if (options.mips) {
+        // every format is written with a linear transfer function, and bc4 and bc5 hold data such as normals
+        // and masks, so levels average the stored values rather than srgb colors
+        std::vector<std::vector<uint8_t>> mips = generateMips(levels[0].data(), (uint32_t)width, (uint32_t)height,
+                                                              false);
+        levels.insert(levels.end(), std::make_move_iterator(mips.begin()), std::make_move_iterator(mips.end()));
+    }
+
+    if (isBlockCompressed(options.format)) {
+        for (size_t level = 0; level < levels.size(); level++) {
+            uint32_t levelWidth = std::max((uint32_t)width >> level, 1u);
+            uint32_t levelHeight = std::max((uint32_t)height >> level, 1u);
+            levels[level] = encodeBlocks(options.format, levels[level].data(), levelWidth, levelHeight);
+        }
+    }
+
+    std::vector<uint8_t> file = writeKtx2(options.format, (uint32_t)width, (uint32_t)height, levels);
+    std::ofstream output(options.output, std::ios::binary | std::ios::trunc);
+    output.write((const char*)file.data(), (std::streamsize)file.size());
+    if (!output) {
+        std::cerr << "failed to write " << options.output << std::endl;
+        return 1;
+    }
+    return 0;
+}